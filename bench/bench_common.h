@@ -0,0 +1,67 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_BENCH_BENCH_COMMON_H
+#define DECKSTINY_BENCH_BENCH_COMMON_H
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace deckstiny {
+
+class Game;
+class Player;
+
+namespace util {
+class Rng;
+}
+
+namespace bench {
+
+/// Seed of every benchmark's random streams, so runs are comparable
+constexpr uint64_t BENCH_SEED = 42;
+
+/**
+ * @brief Get the number of heap allocations made by the calling thread so far
+ * @return Calls to operator new on this thread
+ */
+uint64_t allocationCount();
+
+/**
+ * @brief Report the allocations made since a count as the allocs/op counter
+ * @param state Benchmark state, after its loop
+ * @param allocationsBefore allocationCount() taken before the loop
+ * @param opsPerIteration Operations each iteration performs
+ */
+void reportAllocations(benchmark::State& state, uint64_t allocationsBefore, int64_t opsPerIteration = 1);
+
+/**
+ * @brief Get the game shared by the benchmarks
+ * @return Game with all content loaded, initialized once by main()
+ */
+Game& benchGame();
+
+/**
+ * @brief Create a player with a given deck
+ * @param game Game providing the templates
+ * @param characterId Character to play
+ * @param deck Card IDs, or empty for the starting deck
+ * @param shuffleRng Generator for the draw pile shuffles
+ * @return Player outside of combat
+ */
+std::unique_ptr<Player> makePlayer(Game& game, const std::string& characterId, const std::vector<std::string>& deck,
+                                   util::Rng* shuffleRng);
+
+/**
+ * @brief Register the benchmarks that depend on loaded content
+ * @param game Game with all content loaded
+ */
+void registerCardBenchmarks(Game& game);
+
+} // namespace bench
+} // namespace deckstiny
+
+#endif // DECKSTINY_BENCH_BENCH_COMMON_H
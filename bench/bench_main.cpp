@@ -0,0 +1,122 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "bench_common.h"
+#include "core/game.h"
+#include "core/player.h"
+#include "sim/sim_driver.h"
+#include "util/logger.h"
+#include "util/rng.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Per thread, because each benchmark thread reports its own allocations and
+// Google Benchmark sums the per-thread counters
+thread_local uint64_t allocations = 0;  ///< Calls to operator new on this thread
+deckstiny::Game* sharedGame = nullptr;  ///< Game loaded by main()
+
+void* countedAllocate(std::size_t size) {
+    ++allocations;
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* countedAllocate(std::size_t size, std::align_val_t alignment) {
+    ++allocations;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    // aligned_alloc wants a multiple of the alignment
+    std::size_t rounded = (size + align - 1) / align * align;
+    if (void* memory = std::aligned_alloc(align, rounded ? rounded : align)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+// Counting replacements of the global allocation functions; the array and
+// nothrow forms forward to these
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return countedAllocate(size, alignment); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+
+namespace deckstiny {
+namespace bench {
+
+uint64_t allocationCount() {
+    return allocations;
+}
+
+void reportAllocations(benchmark::State& state, uint64_t allocationsBefore, int64_t opsPerIteration) {
+    double allocations = static_cast<double>(allocationCount() - allocationsBefore) /
+                         static_cast<double>(opsPerIteration);
+    state.counters["allocs/op"] = benchmark::Counter(allocations, benchmark::Counter::kAvgIterations);
+}
+
+Game& benchGame() {
+    return *sharedGame;
+}
+
+std::unique_ptr<Player> makePlayer(Game& game, const std::string& characterId, const std::vector<std::string>& deck,
+                                   util::Rng* shuffleRng) {
+    const CharacterData& character = game.getAllCharacterData().at(characterId);
+    auto player = std::make_unique<Player>(character.id, character.name, character.max_health,
+                                           character.base_energy, character.initial_hand_size);
+    player->setShuffleRng(shuffleRng);
+    for (const auto& id : deck.empty() ? character.starting_deck : deck) {
+        if (auto card = game.loadCard(id)) {
+            player->addCard(card);
+        }
+    }
+    return player;
+}
+
+} // namespace bench
+} // namespace deckstiny
+
+int main(int argc, char* argv[]) {
+    // Results go to bench_results.json unless --benchmark_out is given, so runs can be diffed
+    std::vector<char*> args(argv, argv + argc);
+    std::string outArg = "--benchmark_out=bench_results.json";
+    std::string formatArg = "--benchmark_out_format=json";
+    bool hasOut = false;
+    for (int i = 1; i < argc; ++i) {
+        hasOut = hasOut || std::strncmp(argv[i], "--benchmark_out=", 16) == 0;
+    }
+    if (!hasOut) {
+        args.push_back(outArg.data());
+        args.push_back(formatArg.data());
+    }
+    int count = static_cast<int>(args.size());
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+        return 2;
+    }
+
+    // Engine benchmarks measure the engine, not the logger
+    deckstiny::util::Logger::getInstance().setEnabled(false);
+
+    deckstiny::sim::SimDriver driver;
+    if (!driver.initialize()) {
+        std::cerr << "Failed to initialize game (run from the build directory, next to data/)" << std::endl;
+        return 1;
+    }
+    sharedGame = driver.getGame();
+    deckstiny::bench::registerCardBenchmarks(*sharedGame);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
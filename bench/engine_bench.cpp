@@ -0,0 +1,292 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "bench_common.h"
+#include "core/card.h"
+#include "core/combat.h"
+#include "core/combat_journal.h"
+#include "core/enemy.h"
+#include "core/game.h"
+#include "core/map.h"
+#include "core/player.h"
+#include "sim/batch_runner.h"
+#include "sim/bot_policy.h"
+#include "util/rng.h"
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace deckstiny {
+namespace bench {
+
+namespace {
+
+/// Health given to benchmark enemies so repeated hits never end the combat
+constexpr int ENEMY_HEALTH = 100000;
+
+/**
+ * @struct CombatFixture
+ * @brief Player and combat in the first player turn, with a journal to return to it
+ */
+struct CombatFixture {
+    util::Rng shuffleRng{BENCH_SEED};               ///< Draw pile shuffles
+    util::Rng aiRng{BENCH_SEED + 1};                ///< Enemy move choices
+    std::unique_ptr<Player> player;                 ///< Player with the benchmark deck
+    std::unique_ptr<Combat> combat;                 ///< Combat against the enemies
+    CombatJournal journal;                          ///< Records changes for rollback
+
+    CombatFixture(Game& game, const std::string& characterId, const std::vector<std::string>& deck,
+                  const std::vector<std::string>& enemies) {
+        player = makePlayer(game, characterId, deck, &shuffleRng);
+        combat = std::make_unique<Combat>(player.get());
+        combat->setHost(&game);
+        combat->setRng(&aiRng);
+        for (const auto& id : enemies) {
+            auto enemy = game.loadEnemy(id);
+            enemy->setMaxHealth(ENEMY_HEALTH);
+            enemy->setHealth(ENEMY_HEALTH);
+            combat->addEnemy(enemy);
+        }
+        player->setCurrentCombat(combat.get());
+        player->beginCombat();
+        combat->start();
+        combat->setJournal(&journal);
+    }
+
+    ~CombatFixture() {
+        combat->setJournal(nullptr);
+    }
+};
+
+/**
+ * @struct CardChoice
+ * @brief Card exercising one effect op, with a character allowed to play it
+ */
+struct CardChoice {
+    std::string cardId;         ///< Card template ID
+    std::string characterId;    ///< Character whose class may use the card
+};
+
+/// For each effect op, the card using it with the fewest other effects, then the cheapest, then the first ID
+std::map<CardEffectOp, CardChoice> cardsByEffect(Game& game) {
+    std::map<CardEffectOp, std::shared_ptr<Card>> chosen;
+    for (const auto& [id, card] : game.getAllCards()) {
+        const auto& effects = card->getEffects();
+        bool supported = std::none_of(effects.begin(), effects.end(), [](const CardEffect& effect) {
+            return effect.op == CardEffectOp::UNSUPPORTED;
+        });
+        if (!supported || card->getCost() < 0) {
+            continue;
+        }
+        for (const CardEffect& effect : effects) {
+            if (effect.op == CardEffectOp::NONE) {
+                continue;
+            }
+            auto it = chosen.find(effect.op);
+            const Card* best = it == chosen.end() ? nullptr : it->second.get();
+            if (!best || std::make_tuple(effects.size(), card->getCost(), card->getId()) <
+                         std::make_tuple(best->getEffects().size(), best->getCost(), best->getId())) {
+                chosen[effect.op] = card;
+            }
+        }
+    }
+
+    std::map<CardEffectOp, CardChoice> choices;
+    for (const auto& [op, card] : chosen) {
+        std::string characterId = card->getClassRestriction();
+        std::transform(characterId.begin(), characterId.end(), characterId.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (!game.getAllCharacterData().count(characterId)) {
+            characterId = "ironclad";
+        }
+        choices[op] = {card->getId(), characterId};
+    }
+    return choices;
+}
+
+const char* effectName(CardEffectOp op) {
+    switch (op) {
+        case CardEffectOp::DAMAGE_TARGET: return "damage_target";
+        case CardEffectOp::DAMAGE_ALL_ENEMIES: return "damage_all_enemies";
+        case CardEffectOp::BLOCK: return "block";
+        case CardEffectOp::DRAW: return "draw";
+        case CardEffectOp::STATUS_TARGET: return "status_target";
+        case CardEffectOp::STATUS_ALL_ENEMIES: return "status_all_enemies";
+        case CardEffectOp::STATUS_SELF: return "status_self";
+        default: return "other";
+    }
+}
+
+std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+} // namespace
+
+// Map generation for act 1, a new fixed seed per map
+static void BM_MapGenerate(benchmark::State& state) {
+    GameMap map;
+    uint64_t seed = BENCH_SEED;
+    uint64_t allocationsBefore = allocationCount();
+    for (auto _ : state) {
+        map.generate(1, seed++);
+        benchmark::DoNotOptimize(map.getAllRooms().size());
+    }
+    reportAllocations(state, allocationsBefore);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MapGenerate);
+
+// Playing one card through Combat::playCard, then rolling the combat back with the journal
+static void runCardPlay(benchmark::State& state, const CardChoice& choice) {
+    std::vector<std::string> deck(10, choice.cardId);
+    CombatFixture fixture(benchGame(), choice.characterId, deck, {"jaw_worm", "cultist"});
+    CombatJournal::Mark mark = fixture.journal.mark();
+
+    uint64_t allocationsBefore = allocationCount();
+    for (auto _ : state) {
+        if (!fixture.combat->playCard(0, 0)) {
+            state.SkipWithError(("could not play " + choice.cardId).c_str());
+            break;
+        }
+        fixture.journal.rollback(mark);
+    }
+    reportAllocations(state, allocationsBefore);
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(choice.cardId);
+}
+
+// Choosing the next enemy move from the combat's AI stream
+static void BM_EnemyChooseNextMove(benchmark::State& state) {
+    CombatFixture fixture(benchGame(), "ironclad", {}, {"jaw_worm"});
+    fixture.combat->setJournal(nullptr);
+    Enemy* enemy = fixture.combat->getEnemy(0);
+
+    uint64_t allocationsBefore = allocationCount();
+    for (auto _ : state) {
+        enemy->chooseNextMove(fixture.combat.get(), fixture.player.get());
+        benchmark::DoNotOptimize(enemy->getCurrentMoveIndex());
+    }
+    reportAllocations(state, allocationsBefore);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EnemyChooseNextMove);
+
+// Executing an enemy move against the player, cycling through a fixed sequence of moves
+static void runEnemyTakeTurn(benchmark::State& state, const std::string& enemyId) {
+    CombatFixture fixture(benchGame(), "ironclad", {}, {enemyId});
+    Enemy* enemy = fixture.combat->getEnemy(0);
+
+    // The journal rolls the AI stream back too, so pick the move sequence up front
+    fixture.combat->setJournal(nullptr);
+    std::vector<int> moves;
+    for (int i = 0; i < 64; ++i) {
+        enemy->chooseNextMove(fixture.combat.get(), fixture.player.get());
+        moves.push_back(enemy->getCurrentMoveIndex());
+    }
+    fixture.combat->setJournal(&fixture.journal);
+    CombatJournal::Mark mark = fixture.journal.mark();
+
+    size_t next = 0;
+    uint64_t allocationsBefore = allocationCount();
+    for (auto _ : state) {
+        enemy->setCurrentMoveIndex(moves[next++ % moves.size()]);
+        enemy->takeTurn(fixture.combat.get(), fixture.player.get());
+        fixture.journal.rollback(mark);
+    }
+    reportAllocations(state, allocationsBefore);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Drawing a hand of five and discarding it; empty draw piles are reshuffled from the discard pile
+static void BM_PlayerDrawDiscard(benchmark::State& state) {
+    util::Rng shuffleRng(BENCH_SEED);
+    std::unique_ptr<Player> player = makePlayer(benchGame(), "ironclad", {}, &shuffleRng);
+    player->beginCombat();
+    player->discardHand();
+
+    uint64_t allocationsBefore = allocationCount();
+    for (auto _ : state) {
+        player->drawCards(5);
+        player->discardHand();
+    }
+    reportAllocations(state, allocationsBefore);
+    state.SetItemsProcessed(state.iterations() * 5);
+}
+BENCHMARK(BM_PlayerDrawDiscard);
+
+// Shuffling a draw pile of state.range(0) cards
+static void BM_PlayerShuffleDrawPile(benchmark::State& state) {
+    util::Rng shuffleRng(BENCH_SEED);
+    std::vector<std::string> deck;
+    const auto& starting = benchGame().getAllCharacterData().at("ironclad").starting_deck;
+    while (deck.size() < static_cast<size_t>(state.range(0))) {
+        deck.push_back(starting[deck.size() % starting.size()]);
+    }
+    std::unique_ptr<Player> player = makePlayer(benchGame(), "ironclad", deck, &shuffleRng);
+    player->beginCombat();
+    player->discardHand();
+
+    uint64_t allocationsBefore = allocationCount();
+    for (auto _ : state) {
+        player->shuffleDrawPile();
+    }
+    reportAllocations(state, allocationsBefore);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(player->getDrawPile().size()));
+}
+BENCHMARK(BM_PlayerShuffleDrawPile)->Arg(10)->Arg(40);
+
+// Whole fights with the greedy bot and the starting deck, as deckstiny_batch plays them
+static void runFight(benchmark::State& state, const std::string& enemies) {
+    sim::FightSpec spec;
+    spec.characterId = "ironclad";
+    spec.enemies = splitList(enemies);
+    sim::BatchRunner runner(benchGame(), 1);
+    sim::GreedyPolicy policy(BENCH_SEED, spec.characterId);
+
+    int fight = 0;
+    int64_t turns = 0;
+    uint64_t allocationsBefore = allocationCount();
+    for (auto _ : state) {
+        policy.beginRun(fight);
+        sim::FightOutcome outcome = runner.runFight(spec, policy, BENCH_SEED + static_cast<uint64_t>(fight));
+        turns += outcome.turns;
+        ++fight;
+    }
+    reportAllocations(state, allocationsBefore);
+    state.SetItemsProcessed(state.iterations());
+    state.counters["turns/fight"] = benchmark::Counter(static_cast<double>(turns), benchmark::Counter::kAvgIterations);
+}
+
+void registerCardBenchmarks(Game& game) {
+    for (const auto& [op, choice] : cardsByEffect(game)) {
+        benchmark::RegisterBenchmark((std::string("BM_CardPlay/") + effectName(op)).c_str(),
+                                     [choice = choice](benchmark::State& state) { runCardPlay(state, choice); });
+    }
+    for (const char* enemy : {"jaw_worm", "gremlin_nob"}) {
+        std::string id = enemy;
+        benchmark::RegisterBenchmark(("BM_EnemyTakeTurn/" + id).c_str(),
+                                     [id](benchmark::State& state) { runEnemyTakeTurn(state, id); });
+    }
+    for (const char* enemies : {"jaw_worm", "gremlin_nob", "cultist,louse"}) {
+        std::string list = enemies;
+        benchmark::RegisterBenchmark(("BM_CombatFight/" + list).c_str(),
+                                     [list](benchmark::State& state) { runFight(state, list); })
+            ->Unit(benchmark::kMicrosecond);
+    }
+}
+
+} // namespace bench
+} // namespace deckstiny
@@ -0,0 +1,96 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "bench_common.h"
+#include "core/game.h"
+#include "sim/headless_ui.h"
+#include "util/logger.h"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace deckstiny {
+namespace bench {
+
+namespace {
+
+// Log to files only, waiting for the writer instead of dropping, so every message is written
+void enableFileLogging(const benchmark::State&) {
+    util::Logger& logger = util::Logger::getInstance();
+    logger.setEnabled(true);
+    logger.setConsoleEnabled(false);
+    logger.setFileEnabled(true);
+    logger.setFileLevel(util::LogLevel::Info);
+    logger.setLogDirectory((std::filesystem::temp_directory_path() / "deckstiny_bench_logs").string());
+    logger.setOverflowPolicy(util::OverflowPolicy::Block);
+}
+
+void disableLogging(const benchmark::State&) {
+    util::Logger& logger = util::Logger::getInstance();
+    logger.flush();
+    logger.setFileEnabled(false);
+    logger.setEnabled(false);
+}
+
+} // namespace
+
+/// Messages logged per iteration of BM_LoggerLog before waiting for the writer
+constexpr int LOG_BATCH = 256;
+
+// Messages accepted by the logger and written to its file by the background writer. Writing is
+// asynchronous, so each iteration logs a batch and waits for the queue to drain, keeping the
+// write time inside the timed loop; allocs/op is per message
+static void BM_LoggerLog(benchmark::State& state) {
+    int64_t value = 0;
+    uint64_t allocationsBefore = allocationCount();
+    for (auto _ : state) {
+        for (int i = 0; i < LOG_BATCH; ++i) {
+            LOG_INFOF("bench", "player {} dealt {} damage to {}", "ironclad", value++, "jaw_worm");
+        }
+        util::Logger::getInstance().flush();
+    }
+    reportAllocations(state, allocationsBefore, LOG_BATCH);
+    state.SetItemsProcessed(state.iterations() * LOG_BATCH);
+}
+BENCHMARK(BM_LoggerLog)
+    ->Setup(enableFileLogging)
+    ->Teardown(disableLogging)
+    ->Threads(1)
+    ->Threads(4)
+    ->UseRealTime(); // the writer thread's time is not in the caller's CPU time
+
+// Messages below every output's level, which should cost one check
+static void BM_LoggerFilteredOut(benchmark::State& state) {
+    int64_t value = 0;
+    uint64_t allocationsBefore = allocationCount();
+    for (auto _ : state) {
+        LOG_DEBUGF("bench", "player {} dealt {} damage to {}", "ironclad", value++, "jaw_worm");
+        benchmark::ClobberMemory();
+    }
+    reportAllocations(state, allocationsBefore);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoggerFilteredOut)->Setup(enableFileLogging)->Teardown(disableLogging);
+
+// Loading all content (Game::initialize runs loadGameData), from the content pack when it exists
+static void BM_GameLoadGameData(benchmark::State& state) {
+    uint64_t allocationsBefore = allocationCount();
+    for (auto _ : state) {
+        auto game = std::make_unique<Game>();
+        if (!game->initialize(std::make_shared<sim::HeadlessUI>())) {
+            state.SkipWithError("could not load game data");
+            break;
+        }
+        // Destroying the templates is not part of loading
+        state.PauseTiming();
+        game.reset();
+        state.ResumeTiming();
+    }
+    reportAllocations(state, allocationsBefore);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GameLoadGameData)->Unit(benchmark::kMillisecond);
+
+} // namespace bench
+} // namespace deckstiny
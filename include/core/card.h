@@ -7,12 +7,15 @@
 #include "core/entity.h"
 #include <memory>
 #include <functional>
+#include <string>
+#include <vector>
 
 namespace deckstiny {
 
 class Character;
 class Player;
 class Combat;
+struct CardState;
 
 /**
  * @enum CardType
@@ -51,6 +54,73 @@ enum class CardTarget {
     ALL_ALLIES
 };
 
+/**
+ * @enum CardEffectOp
+ * @brief Operation performed by a compiled card effect
+ *
+ * Targets are resolved against the card's own target type when the
+ * card is loaded, so each op knows exactly whom it affects.
+ */
+enum class CardEffectOp {
+    NONE,               ///< Empty effect entry, ignored when played
+    DAMAGE_TARGET,      ///< Deal damage to the selected enemy
+    DAMAGE_ALL_ENEMIES, ///< Deal damage to every living enemy
+    BLOCK,              ///< Player gains block
+    DRAW,               ///< Player draws cards
+    STATUS_TARGET,      ///< Apply a status effect to the selected enemy
+    STATUS_ALL_ENEMIES, ///< Apply a status effect to every living enemy
+    STATUS_SELF,        ///< Apply a status effect to the player
+    UNSUPPORTED         ///< Effect this card cannot perform, fails when played
+};
+
+/**
+ * @struct CardEffect
+ * @brief Single instruction of a card's compiled effect program
+ */
+struct CardEffect {
+    CardEffectOp op = CardEffectOp::NONE; ///< Operation to perform
+    int value = 0;                        ///< Value used when played
+    int upgradedValue = 0;                ///< Value after the card is upgraded
+    std::string status;                   ///< Status effect ID for status ops
+    util::Symbol statusSymbol;            ///< Interned status effect ID used when played
+    std::string type;                     ///< Effect type as written in JSON (for diagnostics)
+};
+
+/**
+ * @struct CardDef
+ * @brief Immutable card definition shared by every instance of a card
+ *
+ * Holds the text, base and upgraded stats and the compiled effect programs.
+ * Card instances point at a definition and only keep their own mutable
+ * state, so copying a card does not copy any of this.
+ */
+struct CardDef {
+    std::string name;                        ///< Display name
+    std::string nameUpgraded;                ///< Display name once upgraded
+    std::string description;                 ///< Description text
+    std::string descriptionUpgraded;         ///< Description text once upgraded
+    CardType type = CardType::SKILL;         ///< Card type
+    CardRarity rarity = CardRarity::COMMON;  ///< Card rarity
+    CardTarget target = CardTarget::NONE;    ///< Card target type
+    int cost = 1;                            ///< Energy cost to play
+    int costUpgraded = 1;                    ///< Energy cost once upgraded
+    bool upgradable = true;                  ///< Whether the card can be upgraded
+    std::string classRestriction;            ///< Class restriction (empty if none)
+
+    // Stats loaded from JSON "upgrade_details"
+    bool hasUpgradeDetails = false;
+    int damage = 0;
+    int damageUpgraded = -1;
+    int block = 0;
+    int blockUpgraded = -1;
+    int magicNumber = 0;
+    int magicNumberUpgraded = -1;
+
+    std::vector<CardEffect> effects;          ///< Effect program with base values
+    std::vector<CardEffect> upgradedEffects;  ///< Effect program with upgraded values
+    bool hasEffectProgram = false;            ///< Whether the programs were loaded from JSON
+};
+
 /**
  * @class Card
  * @brief Represents a card in the game
@@ -63,7 +133,7 @@ public:
     /**
      * @brief Default constructor
      */
-    Card() = default;
+    Card();
     
     /**
      * @brief Constructor with card properties
@@ -79,10 +149,35 @@ public:
     Card(const std::string& id, const std::string& name, const std::string& description,
          CardType type, CardRarity rarity, CardTarget target, int cost, bool upgradable);
     
+    /**
+     * @brief Constructor sharing an existing definition
+     * @param id Unique identifier
+     * @param def Card definition
+     */
+    Card(const std::string& id, std::shared_ptr<const CardDef> def);
+    
     /**
      * @brief Virtual destructor
      */
     virtual ~Card() = default;
+
+    /**
+     * @brief Get the card's name, reflecting whether it is upgraded
+     * @return String containing the card's name
+     */
+    const std::string& getName() const override;
+
+    /**
+     * @brief Set the card's name
+     * @param name New name (detaches this card from its shared definition)
+     */
+    void setName(const std::string& name) override;
+
+    /**
+     * @brief Get the shared definition of this card
+     * @return Card definition
+     */
+    const std::shared_ptr<const CardDef>& getDef() const;
     
     /**
      * @brief Get the card's description
@@ -125,6 +220,49 @@ public:
      * @param cost New energy cost
      */
     void setCost(int cost);
+
+    /**
+     * @brief Get the cost change applied for the current combat
+     * @return Cost modifier
+     */
+    int getCombatCostModifier() const;
+
+    /**
+     * @brief Change the card's cost until the end of the current combat
+     * @param modifier Amount added to the cost (result is at least 0)
+     */
+    void setCombatCostModifier(int modifier);
+
+    /**
+     * @brief Clear state that only lasts for one combat
+     */
+    void resetCombatState();
+
+    /**
+     * @brief Save the per-instance values of the card
+     * @param state State to fill
+     */
+    void saveState(CardState& state) const;
+
+    /**
+     * @brief Restore values saved by saveState()
+     * @param state Saved state
+     */
+    void restoreState(const CardState& state);
+
+    /**
+     * @brief Get the index of the card in its combat's card table
+     * @return Table index, or -1 if not registered
+     *
+     * Only a hint: the combat checks that the table entry is this card.
+     */
+    int getCombatSlot() const { return combatSlot_; }
+
+    /**
+     * @brief Set the index of the card in its combat's card table
+     * @param slot Table index
+     */
+    void setCombatSlot(int slot) { combatSlot_ = slot; }
     
     /**
      * @brief Check if card is upgradable
@@ -206,29 +344,48 @@ public:
      */
     bool canUse(Player* player) const;
 
+    /**
+     * @brief Get the compiled effect program of the card
+     * @return Effects in the order they are applied when the card is played
+     */
+    const std::vector<CardEffect>& getEffects() const;
+
+    /**
+     * @brief Check if the card was loaded with an effect program
+     * @return True if effects were compiled from JSON, false if the fallback effect is used
+     */
+    bool hasEffectProgram() const;
+
 protected:
-    std::string description_;         ///< Card description text
-    CardType type_ = CardType::SKILL; ///< Card type
-    CardRarity rarity_ = CardRarity::COMMON; ///< Card rarity
-    CardTarget target_ = CardTarget::NONE;   ///< Card target type
-    int cost_ = 1;                    ///< Energy cost to play
-    bool upgradable_ = true;          ///< Whether card can be upgraded
-    bool upgraded_ = false;           ///< Whether card is upgraded
-    std::string classRestriction_;    ///< Class restriction (empty if none)
-
-    // Fields for upgraded stats, loaded from JSON "upgrade_details"
-    bool hasUpgradeDetails_ = false;
-    std::string nameUpgraded_;
-    std::string descriptionUpgraded_;
-    int costUpgraded_ = -1; // -1 indicates not set or no change
-    int damage_ = 0; // Base damage
-    int damageUpgraded_ = -1;
-    int block_ = 0; // Base block
-    int blockUpgraded_ = -1;
-    int magicNumber_ = 0; // Base magic number
-    int magicNumberUpgraded_ = -1;
-    // Add other specific stats if needed, e.g., drawUpgraded_, energyGainUpgraded_
+    std::shared_ptr<const CardDef> def_;  ///< Shared immutable definition
+    bool upgraded_ = false;               ///< Whether card is upgraded
+    int costOverride_ = -1;               ///< Cost set on this card, -1 uses the definition
+    int combatCostModifier_ = 0;          ///< Cost change until the end of combat
+    int combatSlot_ = -1;                 ///< Index in the combat's card table, -1 if none
+
+    /**
+     * @brief Replace the definition with a private copy for modification
+     * @return Copy owned by this card only
+     */
+    CardDef& detachDef();
     
+    /**
+     * @brief Compile the JSON "effects" array into the effect programs
+     * @param def Definition to store the programs in
+     * @param effectsJson JSON array of effect objects
+     */
+    void compileEffects(CardDef& def, const nlohmann::json& effectsJson) const;
+
+    /**
+     * @brief Deal damage to an enemy and resolve its death
+     * @param player Player dealing the damage
+     * @param combat Current combat instance
+     * @param enemyIndex Index of the enemy to damage
+     * @param damage Base damage before modifiers
+     * @return True if the enemy was killed by this damage
+     */
+    bool dealDamageToEnemy(Player* player, Combat* combat, size_t enemyIndex, int damage);
+
     /**
      * @brief Implementation of card effect
      * @param player Player playing the card
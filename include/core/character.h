@@ -5,11 +5,17 @@
 #define DECKSTINY_CORE_CHARACTER_H
 
 #include "core/entity.h"
+#include "core/status_effect.h"
+#include <array>
 #include <vector>
 #include <unordered_map>
 
 namespace deckstiny {
 
+// Forward declarations
+class CombatJournal;
+struct CharacterState;
+
 /**
  * @class Character
  * @brief Base class for all characters (player and enemies)
@@ -135,6 +141,20 @@ public:
      * @param stacks Number of stacks to add
      */
     void addStatusEffect(const std::string& effect, int stacks);
+
+    /**
+     * @brief Add a status effect
+     * @param effect Interned name of the effect
+     * @param stacks Number of stacks to add
+     */
+    void addStatusEffect(util::Symbol effect, int stacks);
+
+    /**
+     * @brief Add a built-in status effect
+     * @param effect Built-in effect
+     * @param stacks Number of stacks to add
+     */
+    void addStatusEffect(StatusEffect effect, int stacks);
     
     /**
      * @brief Get status effect stacks
@@ -142,6 +162,20 @@ public:
      * @return Number of stacks, 0 if effect not present
      */
     int getStatusEffect(const std::string& effect) const;
+
+    /**
+     * @brief Get status effect stacks
+     * @param effect Interned name of the effect
+     * @return Number of stacks, 0 if effect not present
+     */
+    int getStatusEffect(util::Symbol effect) const;
+
+    /**
+     * @brief Get built-in status effect stacks
+     * @param effect Built-in effect
+     * @return Number of stacks, 0 if effect not present
+     */
+    int getStatusEffect(StatusEffect effect) const;
     
     /**
      * @brief Check if has a specific status effect
@@ -149,12 +183,53 @@ public:
      * @return True if effect is present, false otherwise
      */
     bool hasStatusEffect(const std::string& effect) const;
+
+    /**
+     * @brief Check if has a specific status effect
+     * @param effect Interned name of the effect
+     * @return True if effect is present, false otherwise
+     */
+    bool hasStatusEffect(util::Symbol effect) const;
+
+    /**
+     * @brief Check if has a specific built-in status effect
+     * @param effect Built-in effect
+     * @return True if effect is present, false otherwise
+     */
+    bool hasStatusEffect(StatusEffect effect) const;
     
     /**
      * @brief Get all status effects
-     * @return Map of effect names to stack counts
+     * @return Effect names and stack counts, built-in effects first
+     */
+    StatusEffectList getStatusEffects() const;
+
+    /**
+     * @brief Save health, block, energy and status effects
+     * @param state State to fill
+     * @return False if there are more data-defined effects than the state can hold
+     */
+    bool saveState(CharacterState& state) const;
+
+    /**
+     * @brief Restore values saved by saveState()
+     * @param state Saved state
+     */
+    void restoreState(const CharacterState& state);
+
+    /**
+     * @brief Set the journal that records this character's changes
+     * @param journal Journal, or nullptr to stop recording
+     *
+     * Restoring a saved state is not recorded.
      */
-    const std::unordered_map<std::string, int>& getStatusEffects() const;
+    void setJournal(CombatJournal* journal) { journal_ = journal; }
+
+    /**
+     * @brief Get the journal that records this character's changes
+     * @return Journal, or nullptr if changes are not recorded
+     */
+    CombatJournal* getJournal() const { return journal_; }
     
     /**
      * @brief Start of turn processing
@@ -179,6 +254,19 @@ public:
      */
     std::unique_ptr<Entity> clone() const override;
 
+protected:
+    /**
+     * @brief Replace this character's status effects with another's
+     * @param other Character to copy status effects from
+     */
+    void copyStatusEffects(const Character& other);
+
+    /**
+     * @brief Record a field's value in the journal before changing it
+     * @param field Field about to change
+     */
+    void journalValue(int& field);
+
 private:
     int maxHealth_ = 0;     ///< Maximum health points
     int currentHealth_ = 0; ///< Current health points
@@ -186,8 +274,17 @@ private:
     int baseEnergy_ = 0;    ///< Base energy per turn
     int currentEnergy_ = 0; ///< Current energy points
     
-    /// Status effects and their stack counts
-    std::unordered_map<std::string, int> statusEffects_;
+    std::array<int, STATUS_EFFECT_COUNT> statusStacks_{};              ///< Built-in effect stacks by slot
+    std::vector<std::pair<util::Symbol, int>> customStatusEffects_;    ///< Data-defined effects, first applied first
+    CombatJournal* journal_ = nullptr;                                 ///< Undo log of changes, if recording
+
+    /**
+     * @brief Find the stack counter of a status effect
+     * @param effect Interned name of the effect
+     * @param create Whether to add a custom effect entry if missing
+     * @return Pointer to the counter, or nullptr if missing and not created
+     */
+    int* findStatusStacks(util::Symbol effect, bool create);
 };
 
 } // namespace deckstiny 
@@ -4,11 +4,11 @@
 #ifndef DECKSTINY_CORE_COMBAT_H
 #define DECKSTINY_CORE_COMBAT_H
 
+#include "core/delayed_action_wheel.h"
 #include <vector>
 #include <memory>
-#include <functional>
-#include <queue>
 #include <string>
+#include <string_view>
 
 namespace deckstiny {
 
@@ -16,17 +16,33 @@ namespace deckstiny {
 class Player;
 class Enemy;
 class Card;
-class Game;
+class CombatJournal;
+struct CombatState;
+
+namespace util {
+class Rng;
+}
 
 /**
- * @struct CombatAction
- * @brief Structure representing a delayed combat action
+ * @class CombatHost
+ * @brief Services a combat needs from whatever owns it
+ *
+ * Implemented by Game for combats inside a run and by the batch runner for
+ * standalone fights, so Combat does not depend on a full Game.
  */
-struct CombatAction {
-    std::function<void()> action;      ///< Action to execute
-    int priority = 0;                  ///< Action priority (higher = earlier)
-    int delay = 0;                     ///< Delay in turns
-    std::string source;                ///< Source of the action (for tracking)
+class CombatHost {
+public:
+    /**
+     * @brief Virtual destructor
+     */
+    virtual ~CombatHost() = default;
+
+    /**
+     * @brief Create a fresh enemy from its template, e.g. for summons
+     * @param id Enemy ID
+     * @return New enemy instance, or nullptr if the ID is unknown
+     */
+    virtual std::shared_ptr<Enemy> loadEnemy(const std::string& id) = 0;
 };
 
 /**
@@ -51,7 +67,7 @@ public:
     /**
      * @brief Virtual destructor
      */
-    virtual ~Combat() = default;
+    virtual ~Combat();
     
     /**
      * @brief Set the player character
@@ -66,16 +82,44 @@ public:
     Player* getPlayer() const;
     
     /**
-     * @brief Set the game instance
-     * @param game Pointer to the game instance
+     * @brief Set the owner providing content to the combat
+     * @param host Pointer to the host, not owned
      */
-    void setGame(Game* game);
+    void setHost(CombatHost* host);
     
     /**
-     * @brief Get the game instance
-     * @return Pointer to the game instance
+     * @brief Get the owner providing content to the combat
+     * @return Pointer to the host, or nullptr if none is set
+     */
+    CombatHost* getHost() const;
+
+    /**
+     * @brief Set the generator used for enemy decisions
+     * @param rng AI stream of the run, or nullptr for the per-thread default
      */
-    Game* getGame() const;
+    void setRng(util::Rng* rng);
+
+    /**
+     * @brief Get the generator used for enemy decisions
+     * @return AI stream of the run, or the per-thread default if none is set
+     */
+    util::Rng& getRng() const;
+
+    /**
+     * @brief Record every change to the combat, its player and its enemies in a journal
+     * @param journal Journal, not owned, or nullptr to stop recording
+     *
+     * Roll the journal back to a mark to undo the changes made since in
+     * O(changes), e.g. for depth-first search or undoing the last card.
+     * restore() clears the journal, since states are not journaled.
+     */
+    void setJournal(CombatJournal* journal);
+
+    /**
+     * @brief Get the journal recording changes to the combat
+     * @return Journal, or nullptr if changes are not recorded
+     */
+    CombatJournal* getJournal() const { return journal_; }
     
     /**
      * @brief Add an enemy to the combat
@@ -171,10 +215,19 @@ public:
      * @param action Function to execute
      * @param delay Delay in turns
      * @param priority Action priority
-     * @param source Source description
+     * @param source Source tag; intern fixed tags once, not per call
      */
-    void addDelayedAction(std::function<void()> action, int delay = 0, 
-                          int priority = 0, const std::string& source = std::string());
+    void addDelayedAction(DelayedCallback action, int delay = 0,
+                          int priority = 0, util::Symbol source = util::Symbol());
+
+    /**
+     * @brief Add a delayed action with a source given as text
+     * @param action Function to execute
+     * @param delay Delay in turns
+     * @param priority Action priority
+     * @param source Source description, interned as a symbol on every call
+     */
+    void addDelayedAction(DelayedCallback action, int delay, int priority, std::string_view source);
     
     /**
      * @brief Process delayed actions for current turn
@@ -193,28 +246,68 @@ public:
      */
     void end(bool victorious);
 
+    /**
+     * @brief Save the combat into a flat state
+     * @param state State to fill
+     * @return False if the combat exceeds the state's capacity or has pending delayed actions
+     *
+     * Cards and enemies seen for the first time are added to this combat's
+     * tables, so later snapshots and restores can refer to them by index.
+     */
+    bool snapshot(CombatState& state);
+
+    /**
+     * @brief Return the combat to a saved state
+     * @param state State taken by snapshot() on this combat
+     * @return False if the state does not belong to this combat
+     *
+     * Restores the player, cards, enemies, turn and the AI and shuffle
+     * streams in place; no cards or enemies are created.
+     */
+    bool restore(const CombatState& state);
+
+    /**
+     * @brief Create an independent copy of the combat for lookahead
+     * @param player Copy of this combat's player (e.g. from Player::clone()), used by the copy
+     * @return Combat with cloned cards and enemies in the same table order, or nullptr if
+     *         this combat cannot be snapshotted
+     *
+     * Because the tables line up, states of this combat restore into the copy.
+     * The copy has no generators set; the player's piles are replaced.
+     */
+    std::unique_ptr<Combat> fork(Player& player);
+
 private:
     Player* player_ = nullptr;                           ///< Player character
-    Game* game_ = nullptr;                               ///< Game instance
+    CombatHost* host_ = nullptr;                         ///< Owner providing content, not owned
+    util::Rng* rng_ = nullptr;                           ///< Enemy decision generator, not owned
+    CombatJournal* journal_ = nullptr;                   ///< Undo log of changes, not owned
     std::vector<std::shared_ptr<Enemy>> enemies_;        ///< Enemy characters
+    std::vector<std::shared_ptr<Enemy>> enemyTable_;     ///< Every enemy ever added, indexed by snapshots
+    std::vector<std::shared_ptr<Card>> cardTable_;       ///< Every card seen by snapshot(), indexed by snapshots
     int turn_ = 0;                                       ///< Current turn number
     bool playerTurn_ = true;                             ///< Whether it's player's turn
     bool inCombat_ = false;                              ///< Whether combat is active
-    
+
+    /**
+     * @brief Record a field's value in the journal before changing it
+     * @param field Field about to change
+     */
+    void journalValue(int& field);
+
+    /**
+     * @brief Record a flag's value in the journal before changing it
+     * @param field Flag about to change
+     */
+    void journalValue(bool& field);
+
     /**
-     * @brief Comparator for combat actions
+     * @brief Record the delayed action queue in the journal before changing it
      */
-    struct ActionComparator {
-        bool operator()(const CombatAction& a, const CombatAction& b) const {
-            if (a.delay != b.delay) {
-                return a.delay > b.delay;
-            }
-            return a.priority < b.priority;
-        }
-    };
+    void journalDelayedActions();
     
-    /// Priority queue for delayed actions
-    std::priority_queue<CombatAction, std::vector<CombatAction>, ActionComparator> delayedActions_;
+    /// Delayed actions by the turn they are due on
+    DelayedActionWheel delayedActions_;
 };
 
 } // namespace deckstiny 
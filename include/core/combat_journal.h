@@ -0,0 +1,175 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_CORE_COMBAT_JOURNAL_H
+#define DECKSTINY_CORE_COMBAT_JOURNAL_H
+
+#include "util/rng.h"
+#include "util/symbol.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace deckstiny {
+
+// Forward declarations
+class Card;
+
+/// Card pile as stored by Player
+using CardList = std::vector<std::shared_ptr<Card>>;
+
+/// Data-defined status effects as stored by Character
+using CustomStatusList = std::vector<std::pair<util::Symbol, int>>;
+
+/**
+ * @class CombatJournal
+ * @brief Undo log of combat mutations
+ *
+ * Characters, the player's piles and the combat record the inverse of each
+ * change here before making it while a journal is attached (see
+ * Combat::setJournal). rollback() replays the inverses newest first, so
+ * returning to a mark costs time proportional to the changes made since,
+ * and once the buffers have grown a mark/rollback cycle does not allocate.
+ *
+ * Card costs and relic counters are not journaled; no combat content
+ * changes them.
+ */
+class CombatJournal {
+public:
+    /**
+     * @struct Mark
+     * @brief Position in the journal to roll back to
+     */
+    struct Mark {
+        size_t entries = 0;         ///< Entries recorded before the mark
+        size_t cards = 0;           ///< Saved cards before the mark
+        size_t rngs = 0;            ///< Saved generators before the mark
+        size_t callbacks = 0;       ///< Undo callbacks before the mark
+        uint32_t generation = 0;    ///< Calls of clear() before the mark
+    };
+
+    /**
+     * @brief Get the current position
+     * @return Mark to pass to rollback()
+     */
+    Mark mark() const;
+
+    /**
+     * @brief Undo every change recorded after a mark
+     * @param mark Position taken with mark(); later marks become invalid
+     * @return False, without undoing anything, if the journal was cleared since the mark
+     */
+    bool rollback(const Mark& mark);
+
+    /**
+     * @brief Forget all recorded changes without undoing them
+     *
+     * Marks taken before become invalid.
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of recorded changes
+     * @return Entry count
+     */
+    size_t size() const { return entries_.size(); }
+
+    /**
+     * @brief Record the current value of a field about to change
+     * @param field Field to restore on rollback
+     */
+    void recordValue(int& field);
+
+    /**
+     * @brief Record the current value of a flag about to change
+     * @param field Flag to restore on rollback
+     */
+    void recordValue(bool& field);
+
+    /**
+     * @brief Record the state of a generator about to be used
+     * @param rng Generator to restore on rollback
+     */
+    void recordRng(util::Rng& rng);
+
+    /**
+     * @brief Record a card about to be appended to a pile
+     * @param pile Pile that grows by one card
+     */
+    void recordPush(CardList& pile);
+
+    /**
+     * @brief Record a card about to be removed from a pile
+     * @param pile Pile losing the card
+     * @param index Position of the card
+     */
+    void recordErase(CardList& pile, size_t index);
+
+    /**
+     * @brief Record a whole pile about to be reordered or replaced
+     * @param pile Pile to restore on rollback
+     */
+    void recordPile(CardList& pile);
+
+    /**
+     * @brief Record the stacks of a data-defined status effect about to change
+     * @param effects Effect list
+     * @param index Position of the effect
+     */
+    void recordStatus(CustomStatusList& effects, size_t index);
+
+    /**
+     * @brief Record a data-defined status effect about to be appended
+     * @param effects Effect list that grows by one effect
+     */
+    void recordStatusAdded(CustomStatusList& effects);
+
+    /**
+     * @brief Record an arbitrary undo step
+     * @param undo Function restoring the previous state
+     *
+     * For rare changes without a dedicated entry; the function may allocate.
+     */
+    void recordUndo(std::function<void()> undo);
+
+private:
+    /**
+     * @enum Op
+     * @brief Kind of inverse operation
+     */
+    enum class Op : uint8_t {
+        INT,            ///< Restore an int
+        BOOL,           ///< Restore a bool
+        RNG,            ///< Restore a generator from rngs_
+        CARD_PUSH,      ///< Remove the last card of a pile
+        CARD_ERASE,     ///< Insert a saved card into a pile
+        CARD_PILE,      ///< Replace a pile with saved cards
+        STATUS,         ///< Restore the stacks of a custom effect
+        STATUS_ADDED,   ///< Remove the last custom effect
+        CALLBACK        ///< Call a saved function
+    };
+
+    /**
+     * @struct Entry
+     * @brief One recorded inverse operation
+     */
+    struct Entry {
+        Op op;              ///< What to undo
+        void* target;       ///< Changed object
+        int64_t value;      ///< Old value, position or count
+        size_t index;       ///< Position in a side buffer
+    };
+
+    std::vector<Entry> entries_;                        ///< Recorded changes, oldest first
+    CardList cards_;                                    ///< Cards removed or reordered since the oldest entry
+    std::vector<util::Rng> rngs_;                       ///< Saved generator states
+    std::vector<std::function<void()>> callbacks_;      ///< Undo callbacks
+    uint32_t generation_ = 0;                           ///< Calls of clear() so far
+};
+
+} // namespace deckstiny
+
+#endif // DECKSTINY_CORE_COMBAT_JOURNAL_H
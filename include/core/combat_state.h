@@ -0,0 +1,114 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_CORE_COMBAT_STATE_H
+#define DECKSTINY_CORE_COMBAT_STATE_H
+
+#include "core/status_effect.h"
+#include "util/rng.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace deckstiny {
+
+/// Cards a combat can track, over all piles
+constexpr size_t MAX_COMBAT_CARDS = 128;
+
+/// Enemies a combat can track, including summoned ones
+constexpr size_t MAX_COMBAT_ENEMIES = 8;
+
+/// Data-defined status effects per character
+constexpr size_t MAX_CUSTOM_STATUS_EFFECTS = 4;
+
+/// Relics whose counters are saved
+constexpr size_t MAX_COMBAT_RELICS = 16;
+
+/**
+ * @enum CardPile
+ * @brief Combat piles of the player, in CombatState storage order
+ */
+enum class CardPile : uint8_t {
+    DRAW,
+    HAND,
+    DISCARD,
+    EXHAUST,
+    COUNT
+};
+
+/**
+ * @struct CharacterState
+ * @brief Mutable combat values of a character
+ */
+struct CharacterState {
+    int32_t health = 0;                                         ///< Current health
+    int32_t maxHealth = 0;                                      ///< Maximum health
+    int32_t block = 0;                                          ///< Current block
+    int32_t energy = 0;                                         ///< Current energy
+    std::array<int32_t, STATUS_EFFECT_COUNT> statusStacks{};    ///< Built-in effect stacks by slot
+    std::array<uint32_t, MAX_CUSTOM_STATUS_EFFECTS> customSymbols{};  ///< Data-defined effect symbol handles
+    std::array<int32_t, MAX_CUSTOM_STATUS_EFFECTS> customStacks{};    ///< Stacks of those effects
+    uint8_t customCount = 0;                                    ///< Data-defined effects in use
+};
+
+/**
+ * @struct CardState
+ * @brief Per-instance values of a card; the definition is shared and never copied
+ */
+struct CardState {
+    int16_t costOverride = -1;          ///< Cost set on the card, -1 uses the definition
+    int16_t combatCostModifier = 0;     ///< Cost change until the end of combat
+    uint8_t upgraded = 0;               ///< Whether the card is upgraded
+};
+
+/**
+ * @struct EnemyState
+ * @brief Mutable combat values of an enemy
+ */
+struct EnemyState {
+    CharacterState character;   ///< Health, block and statuses
+    int16_t currentMove = -1;   ///< Index of the intended move
+    uint8_t slot = 0;           ///< Index into the combat's enemy table
+};
+
+/**
+ * @struct CombatState
+ * @brief Flat, trivially copyable image of a combat
+ *
+ * Cards and enemies are stored as indices into tables owned by the Combat
+ * that took the snapshot, so a state can only be restored into that combat.
+ * Copying a state is a plain memcpy; taking and restoring one touch only the
+ * values that can change during a fight.
+ */
+struct CombatState {
+    CharacterState player;                                  ///< Player values
+    int32_t gold = 0;                                       ///< Player gold
+
+    std::array<CardState, MAX_COMBAT_CARDS> cards{};        ///< Card values by table index
+    uint16_t cardCount = 0;                                 ///< Table entries in use
+    std::array<uint8_t, MAX_COMBAT_CARDS> pileCards{};      ///< Card indices, piles stored back to back
+    std::array<uint16_t, static_cast<size_t>(CardPile::COUNT)> pileSizes{};  ///< Cards per pile
+
+    std::array<int32_t, MAX_COMBAT_RELICS> relicCounters{}; ///< Relic counters, in relic order
+    uint8_t relicCount = 0;                                 ///< Relics saved
+
+    std::array<EnemyState, MAX_COMBAT_ENEMIES> enemies{};   ///< Enemies in combat order
+    uint8_t enemyCount = 0;                                 ///< Enemies in combat
+
+    int32_t turn = 0;                                       ///< Current turn
+    uint8_t playerTurn = 0;                                 ///< Whether it is the player's turn
+    uint8_t inCombat = 0;                                   ///< Whether the combat is active
+
+    util::Rng aiRng;                                        ///< Enemy decision stream
+    util::Rng shuffleRng;                                   ///< Draw pile shuffle stream
+    uint8_t hasAiRng = 0;                                   ///< Whether aiRng was saved
+    uint8_t hasShuffleRng = 0;                              ///< Whether shuffleRng was saved
+};
+
+static_assert(std::is_trivially_copyable<CombatState>::value, "CombatState must stay memcpy-copyable");
+static_assert(MAX_COMBAT_CARDS <= 256, "card indices are stored as uint8_t");
+
+} // namespace deckstiny
+
+#endif // DECKSTINY_CORE_COMBAT_STATE_H
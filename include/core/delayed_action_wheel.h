@@ -0,0 +1,114 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_CORE_DELAYED_ACTION_WHEEL_H
+#define DECKSTINY_CORE_DELAYED_ACTION_WHEEL_H
+
+#include "util/inline_function.h"
+#include "util/symbol.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace deckstiny {
+
+/// Callable of a delayed action; captures must fit in 48 bytes
+using DelayedCallback = util::InlineFunction<48>;
+
+/**
+ * @struct CombatAction
+ * @brief Structure representing a delayed combat action
+ */
+struct CombatAction {
+    DelayedCallback action;     ///< Action to execute
+    int priority = 0;           ///< Action priority (higher = earlier)
+    uint32_t dueTick = 0;       ///< Tick of the wheel on which the action runs
+    util::Symbol source;        ///< Source of the action (for tracking)
+};
+
+/**
+ * @class DelayedActionWheel
+ * @brief Turn-bucketed timing wheel of delayed combat actions
+ *
+ * Each slot holds the actions due on the ticks that map to it. Scheduling
+ * appends to one slot, and advance() only visits the slot of the current
+ * tick, so actions waiting for later turns are not touched. Delays longer
+ * than the wheel stay in their slot until the tick they are due on comes
+ * round. Slot buffers keep their capacity, so once warmed up neither
+ * scheduling nor advancing allocates.
+ */
+class DelayedActionWheel {
+public:
+    /// Number of slots; a power of two longer than any delay the content uses
+    static constexpr size_t SLOT_COUNT = 16;
+
+    DelayedActionWheel() = default;
+
+    /**
+     * @brief Copy the scheduled actions and the current tick
+     *
+     * The batch advance() is running is not part of the copy, so a wheel
+     * saved while its actions schedule more actions holds only the pending
+     * ones.
+     * @param other Wheel to copy
+     */
+    DelayedActionWheel(const DelayedActionWheel& other);
+
+    /**
+     * @brief Replace the scheduled actions and the current tick
+     *
+     * Leaves the batch advance() is running in place, so restoring a saved
+     * wheel from one of its actions does not pull the batch from under it.
+     * @param other Wheel to copy
+     * @return This wheel
+     */
+    DelayedActionWheel& operator=(const DelayedActionWheel& other);
+
+    DelayedActionWheel(DelayedActionWheel&&) = default;
+    DelayedActionWheel& operator=(DelayedActionWheel&&) = default;
+
+    /**
+     * @brief Schedule an action
+     * @param action Function to execute
+     * @param delay Ticks to wait; 0 runs on the next advance()
+     * @param priority Actions due on the same tick run highest priority first
+     * @param source Source tag
+     */
+    void schedule(DelayedCallback action, int delay, int priority, util::Symbol source);
+
+    /**
+     * @brief Run the actions due on the current tick, then move to the next tick
+     *
+     * Equal priorities run in scheduling order. Actions scheduled with delay 0
+     * while others run are run in the same advance, after the current batch.
+     */
+    void advance();
+
+    /**
+     * @brief Drop all scheduled actions
+     */
+    void clear();
+
+    /**
+     * @brief Check whether no action is scheduled
+     * @return True if empty
+     */
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * @brief Get the number of scheduled actions
+     * @return Action count
+     */
+    size_t size() const { return size_; }
+
+private:
+    std::array<std::vector<CombatAction>, SLOT_COUNT> slots_;  ///< Pending actions by due tick modulo SLOT_COUNT
+    std::vector<CombatAction> running_;                        ///< Batch being run by advance()
+    uint32_t tick_ = 0;                                        ///< Current tick
+    size_t size_ = 0;                                          ///< Scheduled actions in all slots
+};
+
+} // namespace deckstiny
+
+#endif // DECKSTINY_CORE_DELAYED_ACTION_WHEEL_H
@@ -0,0 +1,122 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_CORE_ENCOUNTER_INDEX_H
+#define DECKSTINY_CORE_ENCOUNTER_INDEX_H
+
+#include "util/rng.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace deckstiny {
+
+// Forward declarations
+class Enemy;
+
+/**
+ * @enum EncounterTier
+ * @brief Room tier an enemy can be encountered in
+ */
+enum class EncounterTier {
+    NORMAL,
+    ELITE,
+    BOSS
+};
+
+/**
+ * @class EncounterIndex
+ * @brief In-memory index used to pick enemies for map rooms
+ *
+ * Built once from the loaded enemy registry. Enemies are bucketed by tier and,
+ * within a tier, the floor axis is cut into segments at every min_floor and
+ * max_floor + 1 boundary. Each segment stores the enemies valid across it and
+ * their cumulative encounter weights, so a room lookup is a binary search for
+ * the segment followed by a binary search for the weighted pick. An enemy
+ * flagged both elite and boss is indexed in both tiers.
+ */
+class EncounterIndex {
+public:
+    /**
+     * @brief Rebuild the index from an enemy registry
+     * @param enemies Loaded enemies keyed by ID
+     */
+    void build(const std::unordered_map<std::string, std::shared_ptr<Enemy>>& enemies);
+
+    /**
+     * @brief Remove all indexed enemies
+     */
+    void clear();
+
+    /**
+     * @brief Pick an enemy valid on a floor, weighted by encounter weight
+     * @param tier Encounter tier
+     * @param floor Floor the room is on
+     * @param rng Random number generator
+     * @return Enemy ID, or empty string if no enemy of the tier is valid on the floor
+     */
+    std::string pick(EncounterTier tier, int floor, util::Rng& rng) const;
+
+    /**
+     * @brief Pick any enemy of a tier by encounter weight, ignoring floor ranges
+     * @param tier Encounter tier
+     * @param rng Random number generator
+     * @param exclude Enemy ID to skip (ignored if it is the only candidate)
+     * @return Enemy ID, or empty string if the tier has no enemy with a positive weight
+     */
+    std::string pickAny(EncounterTier tier, util::Rng& rng, const std::string& exclude = "") const;
+
+    /**
+     * @brief Get the enemies valid on a floor
+     * @param tier Encounter tier
+     * @param floor Floor number
+     * @return Enemy IDs sorted by ID
+     */
+    std::vector<std::string> getCandidates(EncounterTier tier, int floor) const;
+
+    /**
+     * @brief Get the number of enemies indexed for a tier
+     * @param tier Encounter tier
+     * @return Enemy count
+     */
+    size_t getCount(EncounterTier tier) const;
+
+private:
+    /**
+     * @struct Segment
+     * @brief Enemies valid on every floor of a half-open floor interval
+     */
+    struct Segment {
+        std::vector<uint32_t> members;      ///< Indices into TierIndex::ids
+        std::vector<int64_t> cumulative;    ///< Running sum of member weights
+    };
+
+    /**
+     * @struct TierIndex
+     * @brief Floor interval structure for one tier
+     */
+    struct TierIndex {
+        std::vector<std::string> ids;       ///< Enemy IDs, sorted
+        std::vector<int64_t> cumulative;    ///< Running sum of the weights of ids, for picks ignoring floors
+        std::vector<int64_t> breakpoints;   ///< Sorted segment start floors
+        std::vector<Segment> segments;      ///< segments[i] starts at breakpoints[i]
+    };
+
+    std::array<TierIndex, 3> tiers_;        ///< Index per EncounterTier
+
+    /**
+     * @brief Find the segment covering a floor
+     * @param tier Tier index to search
+     * @param floor Floor number
+     * @return Segment, or nullptr if the floor lies outside every range
+     */
+    static const Segment* findSegment(const TierIndex& tier, int floor);
+};
+
+} // namespace deckstiny
+
+#endif // DECKSTINY_CORE_ENCOUNTER_INDEX_H
@@ -9,6 +9,8 @@
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include <limits>
+#include <cstdint>
 
 namespace deckstiny {
 
@@ -16,17 +18,72 @@ namespace deckstiny {
 class Combat;
 class Player;
 
+namespace util {
+class Rng;
+}
+
+/**
+ * @enum IntentKind
+ * @brief Compiled form of an intent's type
+ */
+enum class IntentKind : uint8_t {
+    UNKNOWN,
+    ATTACK,
+    ATTACK_DEFEND,
+    ATTACK_DEBUFF,
+    DEFEND,
+    DEFEND_DEBUFF,
+    BUFF,
+    DEBUFF,
+    SUMMON
+};
+
 /**
  * @struct Intent
  * @brief Structure representing an enemy's intent
  */
 struct Intent {
     std::string type;                           ///< Type of intent (attack, defend, buff, debuff, etc.)
+    IntentKind kind = IntentKind::UNKNOWN;      ///< Compiled type, resolved by Enemy
     int value = 0;                              ///< Primary value (damage, block, etc.)
     int secondaryValue = 0;                     ///< Secondary value (if needed)
     std::string target;                         ///< Target of the intent (player, self, ally, etc.)
     std::string effect;                         ///< Additional effect (if applicable)
-    nlohmann::json associatedEffectsJson;       ///< Raw JSON of the full effects array for this move
+    util::Symbol effectSymbol;                  ///< Interned effect, resolved by Enemy
+};
+
+/**
+ * @enum MoveOp
+ * @brief Operation of a compiled enemy move
+ */
+enum class MoveOp : uint8_t {
+    ATTACK,         ///< Damage the player, reduced by weak
+    BLOCK,          ///< Gain block
+    STATUS_SELF,    ///< Apply a status effect to the enemy itself
+    STATUS_PLAYER,  ///< Apply a status effect to the player
+    SUMMON          ///< Add enemies to the combat
+};
+
+/**
+ * @struct MoveEffect
+ * @brief Single instruction of a compiled enemy move
+ */
+struct MoveEffect {
+    MoveOp op = MoveOp::ATTACK;  ///< Operation to perform
+    int value = 0;               ///< Damage, block, stacks or summon count
+    util::Symbol symbol;         ///< Status effect for status ops, enemy ID for SUMMON
+};
+
+/**
+ * @struct EnemyMove
+ * @brief Enemy move compiled at load time
+ */
+struct EnemyMove {
+    std::string id;                     ///< Move ID
+    util::Symbol idSymbol;              ///< Interned move ID, recorded in traces
+    Intent intent;                      ///< Intent shown to the player
+    std::vector<MoveEffect> program;    ///< Instructions executed by takeTurn
+    std::string description;           ///< Cached intent description
 };
 
 /**
@@ -67,6 +124,18 @@ public:
      * @param intent New intent
      */
     void setIntent(const Intent& intent);
+
+    /**
+     * @brief Get the index of the intended move
+     * @return Index into the move table, -1 for an intent set by setIntent()
+     */
+    int getCurrentMoveIndex() const { return currentMove_; }
+
+    /**
+     * @brief Set the intended move by index
+     * @param index Index into the move table, -1 for the last intent set by setIntent()
+     */
+    void setCurrentMoveIndex(int index);
     
     /**
      * @brief Check if the enemy is elite
@@ -110,12 +179,50 @@ public:
      * @param max Maximum gold
      */
     void setGoldReward(int min, int max);
+
+    /**
+     * @brief Get the first floor this enemy can be encountered on
+     * @return Minimum floor (lowest int if unrestricted)
+     */
+    int getMinFloor() const;
+
+    /**
+     * @brief Get the last floor this enemy can be encountered on
+     * @return Maximum floor (highest int if unrestricted)
+     */
+    int getMaxFloor() const;
+
+    /**
+     * @brief Set the range of floors this enemy can be encountered on
+     * @param minFloor First floor
+     * @param maxFloor Last floor
+     */
+    void setFloorRange(int minFloor, int maxFloor);
+
+    /**
+     * @brief Get the relative weight of this enemy in encounter selection
+     * @return Encounter weight
+     */
+    int getEncounterWeight() const;
+
+    /**
+     * @brief Set the relative weight of this enemy in encounter selection
+     * @param weight Encounter weight
+     */
+    void setEncounterWeight(int weight);
     
     /**
      * @brief Get gold reward for defeating this enemy
      * @return Random gold amount within range
      */
     int rollGoldReward() const;
+
+    /**
+     * @brief Get gold reward for defeating this enemy
+     * @param rng Generator to roll with (the run's reward stream)
+     * @return Random gold amount within range, 0 if the enemy is alive
+     */
+    int rollGoldReward(util::Rng& rng) const;
     
     /**
      * @brief Choose and set the next move
@@ -136,6 +243,13 @@ public:
      * @return Vector of possible move IDs
      */
     const std::vector<std::string>& getPossibleMoves() const;
+
+    /**
+     * @brief Get the compiled program of a possible move
+     * @param index Index into getPossibleMoves()
+     * @return Compiled move, or nullptr if the index is out of range
+     */
+    const EnemyMove* getMove(size_t index) const;
     
     /**
      * @brief Add a possible move
@@ -176,16 +290,35 @@ public:
      * @brief Get a textual description of the current intent
      * @return String describing the intent
      */
-    std::string getIntentDescription() const;
+    const std::string& getIntentDescription() const;
+
+    /**
+     * @brief Compile an intent into a move program
+     * @param id Move ID
+     * @param intent Intent to compile (kind and effect symbol are resolved)
+     * @param summonId Enemy to summon for summon intents
+     * @return Compiled move
+     */
+    static EnemyMove compileMove(const std::string& id, const Intent& intent, util::Symbol summonId = util::Symbol());
     
 private:
-    Intent currentIntent_;                                 ///< Current intent
     std::vector<std::string> moves_;                       ///< Possible moves
-    std::unordered_map<std::string, Intent> moveIntents_;  ///< Map of move IDs to their intent data
+    std::shared_ptr<const std::vector<EnemyMove>> moveTable_;  ///< Compiled moves, index-aligned with moves_, shared by clones
+    EnemyMove customMove_;                                 ///< Move compiled from setIntent()
+    int currentMove_ = -1;                                 ///< Index of the current move, -1 for customMove_
     bool elite_ = false;                                   ///< Whether this is an elite enemy
     bool boss_ = false;                                    ///< Whether this is a boss enemy
     int minGold_ = 10;                                     ///< Minimum gold reward
     int maxGold_ = 20;                                     ///< Maximum gold reward
+    int minFloor_ = std::numeric_limits<int>::min();       ///< First floor the enemy appears on
+    int maxFloor_ = std::numeric_limits<int>::max();       ///< Last floor the enemy appears on
+    int encounterWeight_ = 1;                              ///< Relative weight in encounter selection
+
+    /**
+     * @brief Get the move whose intent is currently shown
+     * @return Current compiled move
+     */
+    const EnemyMove& getCurrentMove() const;
 };
 
 } // namespace deckstiny 
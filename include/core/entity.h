@@ -4,6 +4,7 @@
 #ifndef DECKSTINY_CORE_ENTITY_H
 #define DECKSTINY_CORE_ENTITY_H
 
+#include "util/symbol.h"
 #include <string>
 #include <memory>
 #include <nlohmann/json.hpp>
@@ -41,18 +42,24 @@ public:
      * @return String containing the entity's id
      */
     const std::string& getId() const;
+
+    /**
+     * @brief Get the entity's id as an interned symbol
+     * @return Symbol handle of the entity's id
+     */
+    util::Symbol getIdSymbol() const;
     
     /**
      * @brief Get the entity's name
      * @return String containing the entity's name
      */
-    const std::string& getName() const;
+    virtual const std::string& getName() const;
     
     /**
      * @brief Set the entity's name
      * @param name New name for the entity
      */
-    void setName(const std::string& name);
+    virtual void setName(const std::string& name);
     
     /**
      * @brief Load entity data from JSON
@@ -68,7 +75,7 @@ public:
     virtual std::unique_ptr<Entity> clone() const;
 
 private:
-    std::string id_;   ///< Unique identifier
+    util::Symbol id_;  ///< Unique identifier
     std::string name_; ///< Display name
 };
 
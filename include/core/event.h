@@ -70,7 +70,7 @@ public:
      * @brief Get the name of the event
      * @return Event name
      */
-    std::string getName() const { return name_; }
+    const std::string& getName() const override { return name_; }
     
     /**
      * @brief Get the description of the event
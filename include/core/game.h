@@ -4,25 +4,35 @@
 #ifndef DECKSTINY_CORE_GAME_H
 #define DECKSTINY_CORE_GAME_H
 
+#include "core/combat.h"
+#include "core/combat_journal.h"
+#include "core/encounter_index.h"
+#include "core/run_rng.h"
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include <functional>
-#include <random> // Required for std::mt19937
 #include <map> // Required for std::map
+#include <future>
+#include <cstdint>
+#include <optional>
 
 namespace deckstiny {
 
 // Forward declarations
 class Player;
-class Combat;
 class Card;
 class Enemy;
 class Relic;
 class GameMap;
 class UIInterface;
 class Event;
+struct LoadedContent;
+
+namespace util {
+enum class ContentKind : uint8_t;
+}
 
 /**
  * @struct CharacterData
@@ -64,7 +74,7 @@ enum class GameState {
  * Manages the overall game state, progression, and
  * interaction between various game systems.
  */
-class Game {
+class Game : public CombatHost {
 public:
     /**
      * @brief Default constructor
@@ -87,6 +97,14 @@ public:
      * @brief Run the game main loop
      */
     void run();
+
+    /**
+     * @brief Mark the game as running and show the main menu without blocking
+     *
+     * Used by run() and by drivers that feed input directly through
+     * processInput() instead of a UI loop.
+     */
+    void start();
     
     /**
      * @brief Shut down the game
@@ -175,7 +193,7 @@ public:
      * @param id Enemy ID to load
      * @return Shared pointer to the loaded enemy, nullptr if loading failed
      */
-    std::shared_ptr<Enemy> loadEnemy(const std::string& id);
+    std::shared_ptr<Enemy> loadEnemy(const std::string& id) override;
     
     /**
      * @brief Load all enemy templates
@@ -241,6 +259,18 @@ public:
      */
     int calculateScore() const;
 
+    /**
+     * @brief Fix the seed of the next run started from the main menu
+     * @param seed Run seed; runs without one get a random seed
+     */
+    void setSeed(uint64_t seed) { pendingSeed_ = seed; }
+
+    /**
+     * @brief Get the seed of the current run
+     * @return Seed every random stream of the run was split from
+     */
+    uint64_t getSeed() const { return rng_.getSeed(); }
+
     // Add getters for loaded data for testing and other purposes
     const std::unordered_map<std::string, std::shared_ptr<Card>>& getAllCards() const { return allCards_; }
     std::shared_ptr<Card> getCardData(const std::string& id) const;
@@ -248,6 +278,12 @@ public:
     const std::unordered_map<std::string, std::shared_ptr<Enemy>>& getAllEnemies() const { return allEnemies_; }
     std::shared_ptr<Enemy> getEnemyData(const std::string& id) const;
 
+    /**
+     * @brief Get the index used to pick enemies for map rooms
+     * @return Encounter index built from the loaded enemies
+     */
+    const EncounterIndex& getEncounterIndex() const { return encounterIndex_; }
+
     const std::unordered_map<std::string, std::shared_ptr<Relic>>& getAllRelics() const { return allRelics_; }
     std::shared_ptr<Relic> getRelicData(const std::string& id) const;
     
@@ -285,8 +321,9 @@ private:
     std::unordered_map<std::string, std::shared_ptr<Relic>> allRelics_;
     std::unordered_map<std::string, std::shared_ptr<Event>> allEvents_;
     std::map<std::string, CharacterData> allCharacters_; // Stores loaded character data
+    EncounterIndex encounterIndex_;                    ///< Enemy lookup for map rooms, rebuilt with allEnemies_
 
-    int failedLoads_ = 0; // Counter for failed data loads (used by multiple loaders)
+    int failedLoads_ = 0; // Counter for failed data loads (reset by each load, counted in file order)
     
     // Card selection state for two-step targeting
     bool awaitingEnemySelection_ = false;              ///< Whether we're waiting for enemy selection
@@ -303,6 +340,28 @@ private:
     bool handleCharacterSelectInput(const std::string& input);
     bool handleMapInput(const std::string& input);
     bool handleCombatInput(const std::string& input);
+    
+    /**
+     * @brief End the current combat if its last action finished it
+     *
+     * Combat only marks itself over; the game tears it down here, after the
+     * card or turn that ended it has fully returned.
+     */
+    void resolveFinishedCombat();
+
+    /**
+     * @brief Play a card in the current combat, remembering how to undo it
+     * @param cardIndex Hand index of the card
+     * @param targetIndex Enemy index for targeted cards, -1 for none
+     * @return True if the card was played
+     */
+    bool playCombatCard(int cardIndex, int targetIndex = -1);
+
+    /**
+     * @brief Undo the last card played this turn
+     * @return True if a card was taken back
+     */
+    bool undoLastCard();
     bool handleEventInput(const std::string& input);
     bool handleShopInput(const std::string& input);
     
@@ -321,6 +380,31 @@ private:
      * @return True if loading succeeded, false otherwise
      */
     bool loadGameData();
+
+    /**
+     * @brief Load all registries from a baked content pack
+     * @param packPath Path to the content pack file
+     * @return True if every record was loaded, false otherwise
+     */
+    bool loadGameDataFromPack(const std::string& packPath);
+
+    /**
+     * @brief Load registries from the JSON data directories, one loader task per file
+     * @param kinds Registries to load
+     * @return True if every file was loaded, false otherwise
+     */
+    bool loadContentDirectories(const std::vector<util::ContentKind>& kinds);
+
+    /**
+     * @brief Merge finished loader tasks into the registries in submission order
+     * @param pending Futures of the loader tasks
+     * @param kinds Registries being (re)loaded, cleared before merging
+     * @param setupMillis Time already spent before merging, for the timing report
+     * @return True if every task succeeded, false otherwise
+     */
+    bool mergeLoadedContent(std::vector<std::future<LoadedContent>>& pending,
+                            const std::vector<util::ContentKind>& kinds,
+                            double setupMillis);
     
     /**
      * @brief Load an event template
@@ -354,7 +438,11 @@ private:
     std::map<Relic*, int> shopRelicPrices_; // Prices for relics in the shop
     std::map<Card*, int> shopCardPrices_; // Prices for cards in the shop (NEW)
 
-    std::mt19937 rng_; // Random number generator
+    RunRng rng_; // Random streams of the current run
+    std::optional<uint64_t> pendingSeed_; // Seed requested for the next run
+
+    CombatJournal combatJournal_; // Changes made during the current player turn
+    std::vector<CombatJournal::Mark> undoMarks_; // Journal position before each card played this turn
 
     // Specific data loaders
     bool loadAllCharacters();
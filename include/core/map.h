@@ -4,12 +4,13 @@
 #ifndef DECKSTINY_CORE_MAP_H
 #define DECKSTINY_CORE_MAP_H
 
+#include "util/rng.h"
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
-#include <random>
 
 namespace deckstiny {
 
@@ -62,11 +63,25 @@ public:
     virtual ~GameMap() = default;
     
     /**
-     * @brief Generate a new map
+     * @brief Generate a new map from a random seed
      * @param act Current act number
      * @return True if generation succeeded, false otherwise
      */
     bool generate(int act);
+
+    /**
+     * @brief Generate a new map
+     * @param act Current act number
+     * @param seed Seed for the layout and room types
+     * @return True if generation succeeded, false otherwise
+     */
+    bool generate(int act, uint64_t seed);
+
+    /**
+     * @brief Get the seed of the current map
+     * @return Seed passed to generate()
+     */
+    uint64_t getSeed() const { return mapSeed_; }
     
     /**
      * @brief Check if player can move to a specific room
@@ -162,8 +177,8 @@ private:
     int currentRoomId_ = -1;                    ///< ID of the current room
     std::unordered_map<int, Room> rooms_;       ///< Map of rooms by ID
     bool bossDefeated_ = false;                 ///< Whether the boss has been defeated
-    unsigned mapSeed_;                          ///< Random seed for map generation
-    std::mt19937 rng_;                          ///< RNG for map generation
+    uint64_t mapSeed_ = 0;                      ///< Random seed for map generation
+    util::Rng rng_;                             ///< RNG for map generation
     int nextRoomId_ = 0;                        ///< Counter for unique room IDs, reset per generation
     
     /**
@@ -5,6 +5,10 @@
 #define DECKSTINY_CORE_PLAYER_H
 
 #include "core/character.h"
+#include "core/combat_state.h"
+#include "core/trigger_bus.h"
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <string> 
@@ -94,6 +98,25 @@ public:
      * @return Vector of card pointers in exhaust pile
      */
     const std::vector<std::shared_ptr<Card>>& getExhaustPile() const;
+
+    /**
+     * @brief Get a combat pile
+     * @param pile Pile to get
+     * @return Vector of card pointers in the pile
+     */
+    const std::vector<std::shared_ptr<Card>>& getPile(CardPile pile) const;
+
+    /**
+     * @brief Refill a combat pile from a card table
+     * @param pile Pile to refill
+     * @param cards Cards the indices refer to
+     * @param indices Card indices in pile order
+     * @param count Number of indices
+     *
+     * Cards are shared, not cloned, and the pile keeps its storage.
+     */
+    void restorePile(CardPile pile, const std::vector<std::shared_ptr<Card>>& cards,
+                     const uint8_t* indices, size_t count);
     
     /**
      * @brief Get the player's relics
@@ -176,8 +199,9 @@ public:
     
     /**
      * @brief End combat cleanup
+     * @param victorious Whether the player won; COMBAT_END relic effects only run on a win
      */
-    void endCombat();
+    void endCombat(bool victorious);
     
     /**
      * @brief Load player data from JSON
@@ -223,16 +247,42 @@ public:
      */
     void setCurrentCombat(Combat* combat);
 
+    /**
+     * @brief Set the generator used for draw pile shuffles
+     * @param rng Shuffle stream of the run, or nullptr for the per-thread default
+     */
+    void setShuffleRng(util::Rng* rng) { shuffleRng_ = rng; }
+
+    /**
+     * @brief Get the generator used for draw pile shuffles
+     * @return Shuffle stream of the run, or nullptr if the default is used
+     */
+    util::Rng* getShuffleRng() const { return shuffleRng_; }
+
     /**
      * @brief Get the current combat instance for the player.
      * @return Pointer to the current Combat object, or nullptr if not in combat.
      */
     Combat* getCurrentCombat() const;
 
+    /**
+     * @brief Get the bus relics and powers subscribe their hooks to
+     * @return Trigger bus of this player
+     */
+    TriggerBus& getTriggers() { return triggers_; }
+
+    /**
+     * @brief Fire a trigger on this player's bus
+     * @param trigger Trigger that happened
+     * @param context Arguments; player and combat are filled in when unset
+     */
+    void fireTrigger(Trigger trigger, TriggerContext& context);
+
 private:
     int gold_ = 0;                                    ///< Current gold amount
     int initialHandSize_ = 5;                         ///< Initial number of cards to draw each turn
     Combat* currentCombat_ = nullptr;                 ///< Pointer to the current combat instance
+    util::Rng* shuffleRng_ = nullptr;                 ///< Shuffle generator, not owned (nullptr = default)
     
     std::vector<std::shared_ptr<Card>> drawPile_;     ///< Cards in draw pile
     std::vector<std::shared_ptr<Card>> discardPile_;  ///< Cards in discard pile
@@ -240,6 +290,27 @@ private:
     std::vector<std::shared_ptr<Card>> exhaustPile_;  ///< Cards in exhaust pile
     
     std::vector<std::shared_ptr<Relic>> relics_;      ///< Player's relics
+    TriggerBus triggers_;                             ///< Hooks of the relics, by trigger
+
+    /**
+     * @brief Append a card to a pile, recording the change in the journal
+     * @param pile Destination pile
+     * @param card Card to append
+     */
+    void pushCard(std::vector<std::shared_ptr<Card>>& pile, const std::shared_ptr<Card>& card);
+
+    /**
+     * @brief Remove a card from a pile, recording the change in the journal
+     * @param pile Pile holding the card
+     * @param index Position of the card
+     */
+    void eraseCard(std::vector<std::shared_ptr<Card>>& pile, size_t index);
+
+    /**
+     * @brief Record a whole pile in the journal before reordering or replacing it
+     * @param pile Pile about to change
+     */
+    void journalPile(std::vector<std::shared_ptr<Card>>& pile);
 };
 
 } // namespace deckstiny 
@@ -5,7 +5,12 @@
 #define DECKSTINY_CORE_RELIC_H
 
 #include "core/entity.h"
+#include "core/trigger_bus.h"
+#include "util/symbol.h"
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace deckstiny {
 
@@ -27,12 +32,41 @@ enum class RelicRarity {
     EVENT
 };
 
+/**
+ * @enum RelicEffectOp
+ * @brief Operation of a compiled relic effect
+ *
+ * Targets are resolved when the relic is loaded, so each op knows exactly
+ * whom it affects.
+ */
+enum class RelicEffectOp : uint8_t {
+    HEAL,               ///< Player heals
+    DRAW,               ///< Player draws cards
+    BLOCK,              ///< Player gains block
+    ENERGY,             ///< Player gains energy
+    STATUS_SELF,        ///< Apply a status effect to the player
+    STATUS_ALL_ENEMIES  ///< Apply a status effect to every living enemy
+};
+
+/**
+ * @struct RelicEffect
+ * @brief Single instruction of a relic's compiled effect program
+ */
+struct RelicEffect {
+    Trigger trigger = Trigger::COMBAT_START;    ///< When the effect runs
+    RelicEffectOp op = RelicEffectOp::HEAL;     ///< Operation to perform
+    int value = 0;                              ///< Amount
+    util::Symbol status;                        ///< Interned status effect ID for status ops
+};
+
 /**
  * @class Relic
  * @brief Represents a relic in the game
  * 
  * Relics provide passive bonuses or special abilities
- * to the player throughout a run.
+ * to the player throughout a run. The "effects" of a relic's JSON are
+ * compiled into a program when it is loaded; each hook runs the effects of
+ * its trigger, and the relic subscribes only to triggers it has effects for.
  */
 class Relic : public Entity {
 public:
@@ -111,6 +145,12 @@ public:
      */
     void resetCounter();
     
+    /**
+     * @brief Get the compiled effect program
+     * @return Effects in data order
+     */
+    const std::vector<RelicEffect>& getEffects() const;
+    
     /**
      * @brief Called when the relic is obtained
      * @param player Player who obtained the relic
@@ -160,11 +200,33 @@ public:
     /**
      * @brief Called at the end of combat
      * @param player Player with the relic
-     * @param victorious Whether player won the combat
+     * @param victorious Whether player won the combat; COMBAT_END effects only run on a win
      * @param combat Current combat instance
      */
     virtual void onCombatEnd(Player* player, bool victorious, Combat* combat);
     
+    /**
+     * @brief Register the relic's hooks with a player's trigger bus
+     * @param bus Bus of the player holding the relic
+     *
+     * The default subscribes the matching hook for every trigger the relic
+     * has effects for; relics without effects subscribe to nothing.
+     */
+    virtual void subscribe(TriggerBus& bus);
+    
+    /**
+     * @brief Check whether the relic reacts to a trigger
+     * @param trigger Trigger to check
+     * @return True if subscribe() registers a hook for it
+     */
+    bool hasTrigger(Trigger trigger) const;
+    
+    /**
+     * @brief Make subscribe() register the hook for a trigger
+     * @param trigger Trigger to react to
+     */
+    void addTrigger(Trigger trigger);
+    
     /**
      * @brief Load relic data from JSON
      * @param json JSON object containing relic data
@@ -189,6 +251,29 @@ private:
     std::string flavorText_;               ///< Relic flavor text
     RelicRarity rarity_ = RelicRarity::COMMON; ///< Relic rarity
     int counter_ = 0;                      ///< Relic counter (for tracking purposes)
+    uint32_t triggers_ = 0;                ///< Bit per Trigger the relic reacts to
+    std::shared_ptr<const std::vector<RelicEffect>> effects_; ///< Compiled effects, shared by clones
+    
+    /**
+     * @brief Run the effects of one trigger
+     * @param trigger Trigger that happened
+     * @param player Player with the relic
+     * @param combat Current combat instance, if any
+     */
+    void runEffects(Trigger trigger, Player* player, Combat* combat) const;
+    
+    /**
+     * @brief Compile the "effects" array of the relic's JSON
+     * @param effectsJson Effects array
+     */
+    void compileEffects(const nlohmann::json& effectsJson);
+    
+    /**
+     * @brief Forward a fired trigger to the matching virtual hook
+     * @param owner The relic
+     * @param context Trigger arguments
+     */
+    static void handleTrigger(void* owner, TriggerContext& context);
 };
 
 } // namespace deckstiny 
@@ -0,0 +1,77 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_CORE_RUN_RNG_H
+#define DECKSTINY_CORE_RUN_RNG_H
+
+#include "util/rng.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace deckstiny {
+
+/**
+ * @enum RngStream
+ * @brief Independent random streams of a run
+ *
+ * Each system draws from its own stream, so e.g. an extra shuffle in combat
+ * does not change which map or shop the same seed produces.
+ */
+enum class RngStream : uint8_t {
+    MAP,      ///< Map generation and room contents (encounters, events)
+    SHUFFLE,  ///< Draw pile shuffles
+    AI,       ///< Enemy move selection
+    REWARDS,  ///< Gold, treasure and random card/relic rewards
+    SHOP,     ///< Shop stock and prices
+    COUNT
+};
+
+/**
+ * @class RunRng
+ * @brief Seeded random number service for a whole run
+ *
+ * One seed determines every random stream of the run. Streams are split from
+ * the seed by number and never from each other's output.
+ */
+class RunRng {
+public:
+    /**
+     * @brief Constructor
+     * @param seed Run seed
+     */
+    explicit RunRng(uint64_t seed = 0);
+
+    /**
+     * @brief Restart every stream from a new seed
+     * @param seed Run seed
+     */
+    void reseed(uint64_t seed);
+
+    /**
+     * @brief Get the run seed
+     * @return Seed the streams were split from
+     */
+    uint64_t getSeed() const { return seed_; }
+
+    /**
+     * @brief Get a stream
+     * @param stream Stream to get
+     * @return Generator of the stream
+     */
+    util::Rng& get(RngStream stream) { return streams_[static_cast<size_t>(stream)]; }
+
+    /**
+     * @brief Make a fresh seed for runs without a user-provided one
+     * @return Seed from std::random_device
+     */
+    static uint64_t randomSeed();
+
+private:
+    uint64_t seed_ = 0;                                                   ///< Run seed
+    std::array<util::Rng, static_cast<size_t>(RngStream::COUNT)> streams_; ///< Generators by stream
+};
+
+} // namespace deckstiny
+
+#endif // DECKSTINY_CORE_RUN_RNG_H
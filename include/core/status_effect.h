@@ -0,0 +1,104 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_CORE_STATUS_EFFECT_H
+#define DECKSTINY_CORE_STATUS_EFFECT_H
+
+#include "util/symbol.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace deckstiny {
+
+/**
+ * @enum StatusEffect
+ * @brief Built-in status effects, stored in fixed slots on every character
+ *
+ * Generated from DECKSTINY_STATUS_SYMBOLS, so the enum value of a built-in
+ * effect is its symbol handle minus one. Effects defined only in data files
+ * are not listed here and are stored by symbol instead.
+ */
+enum class StatusEffect : uint8_t {
+#define DECKSTINY_STATUS_ENUM(name, text) name,
+    DECKSTINY_STATUS_SYMBOLS(DECKSTINY_STATUS_ENUM)
+#undef DECKSTINY_STATUS_ENUM
+    COUNT
+};
+
+/// Number of built-in status effect slots
+constexpr size_t STATUS_EFFECT_COUNT = static_cast<size_t>(StatusEffect::COUNT);
+
+static_assert(util::symbols::VULNERABLE_ID == 1 &&
+              util::symbols::INTANGIBLE_ID == STATUS_EFFECT_COUNT,
+              "built-in status symbols must directly follow the empty symbol");
+
+/**
+ * @brief Get the symbol of a built-in status effect
+ * @param effect Built-in status effect
+ * @return Interned name of the effect
+ */
+constexpr util::Symbol statusEffectSymbol(StatusEffect effect) {
+    return util::Symbol(static_cast<uint32_t>(effect) + 1);
+}
+
+/**
+ * @brief Get the fixed slot of a status effect
+ * @param effect Interned name of the effect
+ * @return Slot index, or -1 if the effect is not built in
+ */
+constexpr int statusEffectSlot(util::Symbol effect) {
+    return (effect.isValid() && effect.getId() <= STATUS_EFFECT_COUNT) ? static_cast<int>(effect.getId()) - 1 : -1;
+}
+
+/**
+ * @class StatusEffectList
+ * @brief Ordered snapshot of a character's status effects for display
+ *
+ * Built-in effects come first in enum order, followed by custom effects in
+ * the order they were first applied.
+ */
+class StatusEffectList {
+public:
+    using Entry = std::pair<std::string, int>;
+    using const_iterator = std::vector<Entry>::const_iterator;
+
+    /**
+     * @brief Append an effect
+     * @param name Effect name
+     * @param stacks Stack count
+     */
+    void add(const std::string& name, int stacks);
+
+    /**
+     * @brief Get the stacks of an effect
+     * @param name Effect name
+     * @return Stack count
+     * @throws std::out_of_range if the effect is not in the list
+     */
+    int at(const std::string& name) const;
+
+    /**
+     * @brief Get the number of effects
+     * @return Effect count
+     */
+    size_t size() const { return entries_.size(); }
+
+    /**
+     * @brief Check whether the list is empty
+     * @return True if there are no effects
+     */
+    bool empty() const { return entries_.empty(); }
+
+    const_iterator begin() const { return entries_.begin(); }
+    const_iterator end() const { return entries_.end(); }
+
+private:
+    std::vector<Entry> entries_;  ///< Effects in display order
+};
+
+} // namespace deckstiny
+
+#endif // DECKSTINY_CORE_STATUS_EFFECT_H
@@ -0,0 +1,131 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_CORE_TRIGGER_BUS_H
+#define DECKSTINY_CORE_TRIGGER_BUS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace deckstiny {
+
+// Forward declarations
+class Player;
+class Combat;
+
+/**
+ * @enum Trigger
+ * @brief Points in combat where relics and powers can react
+ */
+enum class Trigger : uint8_t {
+    COMBAT_START,       ///< Player's combat setup is done
+    TURN_START,         ///< Player's turn starts
+    TURN_END,           ///< Player's turn ends
+    COMBAT_END,         ///< Combat is over
+    ON_DAMAGE_DEALT,    ///< Player is about to damage an enemy; amount may be changed
+    ON_DAMAGE_TAKEN,    ///< An enemy attack is about to hit the player; amount may be changed
+    COUNT               ///< Number of triggers
+};
+
+/**
+ * @brief Parse a trigger name as written in data files
+ * @param name Name such as "COMBAT_END"
+ * @param trigger Receives the trigger
+ * @return True if the name is known
+ */
+bool parseTrigger(std::string_view name, Trigger& trigger);
+
+/**
+ * @brief Get the data file name of a trigger
+ * @param trigger Trigger
+ * @return Name such as "COMBAT_END"
+ */
+const char* triggerName(Trigger trigger);
+
+/**
+ * @struct TriggerContext
+ * @brief Arguments passed to trigger handlers
+ */
+struct TriggerContext {
+    Trigger trigger = Trigger::COUNT;   ///< Trigger being fired, set by TriggerBus::fire
+    Player* player = nullptr;           ///< Player owning the bus
+    Combat* combat = nullptr;           ///< Current combat, if known
+    int amount = 0;                     ///< Damage of ON_DAMAGE_* triggers; handlers may change it
+    int targetIndex = -1;               ///< Enemy hit by ON_DAMAGE_DEALT
+    bool victorious = false;            ///< Outcome passed to COMBAT_END
+};
+
+/**
+ * @class TriggerBus
+ * @brief Per-trigger lists of subscribed handlers
+ *
+ * Relics and powers subscribe only to the triggers they react to, so firing
+ * a trigger nobody listens to is a single empty check, and firing one calls
+ * exactly the handlers subscribed to it, in subscription order. A handler is
+ * a plain function pointer plus the object it belongs to.
+ */
+class TriggerBus {
+public:
+    /// Handler function; owner is the pointer given to subscribe()
+    using HandlerFunction = void (*)(void* owner, TriggerContext& context);
+
+    /**
+     * @brief Add a handler for a trigger
+     * @param trigger Trigger to listen to
+     * @param owner Object passed back to the handler; must outlive the subscription
+     * @param function Handler
+     */
+    void subscribe(Trigger trigger, void* owner, HandlerFunction function);
+
+    /**
+     * @brief Remove every handler of an owner
+     * @param owner Object given to subscribe()
+     */
+    void unsubscribe(const void* owner);
+
+    /**
+     * @brief Call the handlers of a trigger
+     * @param trigger Trigger that happened
+     * @param context Arguments, updated in place by the handlers
+     */
+    void fire(Trigger trigger, TriggerContext& context) const {
+        context.trigger = trigger;
+        const std::vector<Handler>& handlers = handlers_[static_cast<size_t>(trigger)];
+        for (const Handler& handler : handlers) {
+            handler.function(handler.owner, context);
+        }
+    }
+
+    /**
+     * @brief Check whether anything listens to a trigger
+     * @param trigger Trigger
+     * @return True if at least one handler is subscribed
+     */
+    bool hasHandlers(Trigger trigger) const {
+        return !handlers_[static_cast<size_t>(trigger)].empty();
+    }
+
+    /**
+     * @brief Remove all handlers
+     */
+    void clear();
+
+private:
+    /**
+     * @struct Handler
+     * @brief One subscription
+     */
+    struct Handler {
+        HandlerFunction function;   ///< Function to call
+        void* owner;                ///< Its first argument
+    };
+
+    std::array<std::vector<Handler>, static_cast<size_t>(Trigger::COUNT)> handlers_;  ///< Handlers by trigger
+};
+
+} // namespace deckstiny
+
+#endif // DECKSTINY_CORE_TRIGGER_BUS_H
@@ -0,0 +1,206 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_SIM_BATCH_RUNNER_H
+#define DECKSTINY_SIM_BATCH_RUNNER_H
+
+#include "sim/bot_policy.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace deckstiny {
+
+// Forward declarations
+class Game;
+
+namespace sim {
+
+/**
+ * @struct FightSpec
+ * @brief One standalone fight to repeat: who fights, with what, against whom
+ */
+struct FightSpec {
+    std::string characterId;            ///< Character providing health, energy and hand size
+    std::vector<std::string> deck;      ///< Card IDs, or empty for the character's starting deck
+    std::vector<std::string> relics;    ///< Relic IDs, or empty for the character's starting relics
+    std::vector<std::string> enemies;   ///< Enemy IDs, in encounter order
+    int maxTurns = 100;                 ///< Turns before a fight is abandoned and counted as a loss
+};
+
+/**
+ * @struct FightOutcome
+ * @brief Result of a single fight
+ */
+struct FightOutcome {
+    bool victory = false;   ///< Whether every enemy died
+    int turns = 0;          ///< Turn the fight ended on
+    int hpLost = 0;         ///< Player health lost during the fight
+};
+
+/**
+ * @class FightStats
+ * @brief Mergeable accumulator of fight outcomes
+ *
+ * Holds only counts and exact histograms, so merging per-thread accumulators
+ * in any order gives the same totals as adding every fight to one.
+ */
+class FightStats {
+public:
+    /**
+     * @brief Record one fight
+     * @param outcome Fight result
+     */
+    void add(const FightOutcome& outcome);
+
+    /**
+     * @brief Add another accumulator's fights to this one
+     * @param other Accumulator to merge
+     */
+    void merge(const FightStats& other);
+
+    /**
+     * @brief Get the number of fights recorded
+     * @return Fight count
+     */
+    uint64_t getFights() const { return fights_; }
+
+    /**
+     * @brief Get the number of fights won
+     * @return Win count
+     */
+    uint64_t getWins() const { return wins_; }
+
+    /**
+     * @brief Get the share of fights won
+     * @return Win rate in [0, 1], 0 if no fights were recorded
+     */
+    double getWinRate() const;
+
+    /**
+     * @brief Get the average turn won fights ended on
+     * @return Mean turns to kill, 0 if no fight was won
+     */
+    double getMeanTurnsToKill() const;
+
+    /**
+     * @brief Get the average health lost per fight
+     * @return Mean HP lost over all fights
+     */
+    double getMeanHpLost() const;
+
+    /**
+     * @brief Get the turns-to-kill histogram of won fights
+     * @return Fight counts indexed by the turn the fight ended on
+     */
+    const std::vector<uint64_t>& getTurnsToKill() const { return turnsToKill_; }
+
+    /**
+     * @brief Get the HP-lost histogram of all fights
+     * @return Fight counts indexed by health lost
+     */
+    const std::vector<uint64_t>& getHpLost() const { return hpLost_; }
+
+private:
+    uint64_t fights_ = 0;               ///< Fights recorded
+    uint64_t wins_ = 0;                 ///< Fights won
+    uint64_t turnsToKillSum_ = 0;       ///< Sum of turns over won fights
+    uint64_t hpLostSum_ = 0;            ///< Sum of HP lost over all fights
+    std::vector<uint64_t> turnsToKill_; ///< Won fights by turn
+    std::vector<uint64_t> hpLost_;      ///< All fights by HP lost
+};
+
+/**
+ * @brief Check that a spec refers only to known content
+ * @param game Game holding the content templates
+ * @param spec Fight to check
+ * @return True if the character, cards, relics and enemies all exist
+ */
+bool validateFightSpec(const Game& game, const FightSpec& spec);
+
+/**
+ * @class BatchRunner
+ * @brief Plays many independent copies of one fight across all cores
+ *
+ * Each fight builds its own Player and Combat from the game's content
+ * templates and is driven by a bot policy, without a map, UI or run state.
+ * Fight i always uses the streams split from the batch seed by i, so the
+ * totals of a batch do not depend on the thread count or scheduling.
+ */
+class BatchRunner {
+public:
+    /**
+     * @brief Factory for the per-thread bot policies
+     *
+     * Called once per worker with the batch seed; the runner calls
+     * beginRun(fightIndex) before every fight.
+     */
+    using PolicyFactory = std::function<std::unique_ptr<BotPolicy>(uint64_t)>;
+
+    /**
+     * @brief Constructor
+     * @param game Initialized game whose content templates are used
+     * @param threadCount Number of worker threads (0 selects the hardware concurrency)
+     *
+     * Fights only read the game's templates; the game must not load content
+     * or play while a batch is running.
+     */
+    explicit BatchRunner(Game& game, size_t threadCount = 0);
+
+    /**
+     * @brief Set the factory for the bot policies
+     * @param factory Policy factory, or nullptr for GreedyPolicy
+     */
+    void setPolicyFactory(PolicyFactory factory);
+
+    /**
+     * @brief Check that a spec refers only to known content
+     * @param spec Fight to check
+     * @return True if the character, cards, relics and enemies all exist
+     */
+    bool validate(const FightSpec& spec) const;
+
+    /**
+     * @brief Play a batch of fights
+     * @param spec Fight to repeat
+     * @param fights Number of fights
+     * @param seed Batch seed
+     * @return Merged statistics of all fights
+     */
+    FightStats run(const FightSpec& spec, size_t fights, uint64_t seed);
+
+    /**
+     * @brief Play a single fight
+     * @param spec Fight to play
+     * @param policy Bot choosing the cards
+     * @param seed Seed of the fight's shuffle and enemy streams
+     * @return Result of the fight
+     */
+    FightOutcome runFight(const FightSpec& spec, BotPolicy& policy, uint64_t seed);
+
+    /**
+     * @brief Get the number of worker threads
+     * @return Worker count
+     */
+    size_t getThreadCount() const { return threadCount_; }
+
+    /**
+     * @brief Get the policies of the last batch
+     * @return One policy per worker, kept until the next batch so their statistics can be read
+     */
+    const std::vector<std::unique_ptr<BotPolicy>>& getPolicies() const { return policies_; }
+
+private:
+    Game& game_;                    ///< Source of content templates
+    size_t threadCount_;            ///< Worker threads per batch
+    PolicyFactory policyFactory_;   ///< Creates one policy per worker
+    std::vector<std::unique_ptr<BotPolicy>> policies_;  ///< Policies of the last batch
+};
+
+} // namespace sim
+} // namespace deckstiny
+
+#endif // DECKSTINY_SIM_BATCH_RUNNER_H
@@ -0,0 +1,151 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_SIM_BOT_POLICY_H
+#define DECKSTINY_SIM_BOT_POLICY_H
+
+#include "util/rng.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace deckstiny {
+
+// Forward declarations
+class Card;
+class Combat;
+class Event;
+class GameMap;
+class Player;
+
+namespace sim {
+
+/**
+ * @struct CombatChoice
+ * @brief Action chosen by a bot on its combat turn
+ */
+struct CombatChoice {
+    int cardIndex = -1;    ///< Hand index of the card to play, -1 to end the turn
+    int targetIndex = -1;  ///< Enemy index for targeted cards, -1 for none
+};
+
+/**
+ * @class BotPolicy
+ * @brief Decision maker used by the headless driver
+ *
+ * The driver asks the policy one question per game screen and translates the
+ * answer into regular game input, so a policy never touches the game directly.
+ */
+class BotPolicy {
+public:
+    /**
+     * @brief Virtual destructor
+     */
+    virtual ~BotPolicy() = default;
+
+    /**
+     * @brief Get the policy name for reports
+     * @return Policy name
+     */
+    virtual std::string getName() const = 0;
+
+    /**
+     * @brief Called before each run starts
+     * @param runIndex Zero-based index of the run
+     */
+    virtual void beginRun(int runIndex) { (void)runIndex; }
+
+    /**
+     * @brief Choose the character to play
+     * @param characterIds IDs of the selectable characters, in menu order
+     * @return Index into characterIds
+     */
+    virtual size_t chooseCharacter(const std::vector<std::string>& characterIds) = 0;
+
+    /**
+     * @brief Choose the next room on the map
+     * @param map Current map
+     * @param player Player character
+     * @param availableRooms IDs of the rooms that can be entered, in menu order
+     * @return Index into availableRooms
+     */
+    virtual size_t chooseRoom(const GameMap& map, const Player& player, const std::vector<int>& availableRooms) = 0;
+
+    /**
+     * @brief Choose the next combat action
+     * @param combat Current combat
+     * @param player Player character
+     * @return Card to play or end of turn
+     */
+    virtual CombatChoice chooseCombatAction(Combat& combat, Player& player) = 0;
+
+    /**
+     * @brief Choose an event option
+     * @param event Current event
+     * @param player Player character
+     * @return Index into the event's choices
+     */
+    virtual size_t chooseEventOption(const Event& event, const Player& player) = 0;
+
+    /**
+     * @brief Choose a card to buy in the shop
+     * @param cards Cards for sale
+     * @param prices Card prices
+     * @param gold Player gold
+     * @return Index into cards, or -1 to leave the shop
+     */
+    virtual int chooseShopPurchase(const std::vector<Card*>& cards, const std::map<Card*, int>& prices, int gold) = 0;
+
+    /**
+     * @brief Choose a card to upgrade
+     * @param cards Upgradable cards
+     * @return Index into cards
+     */
+    virtual size_t chooseCardToUpgrade(const std::vector<Card*>& cards) = 0;
+};
+
+/**
+ * @class GreedyPolicy
+ * @brief Simple baseline bot
+ *
+ * Plays the most expensive playable card into the weakest enemy, rests or
+ * heals when below half health, buys the cheapest affordable card and
+ * otherwise picks uniformly at random.
+ */
+class GreedyPolicy : public BotPolicy {
+public:
+    /**
+     * @brief Constructor
+     * @param seed Seed for the policy's random choices
+     * @param characterId Character to play, or empty for a random one
+     */
+    explicit GreedyPolicy(uint64_t seed = 0, const std::string& characterId = "");
+
+    std::string getName() const override { return "greedy"; }
+    void beginRun(int runIndex) override;
+    size_t chooseCharacter(const std::vector<std::string>& characterIds) override;
+    size_t chooseRoom(const GameMap& map, const Player& player, const std::vector<int>& availableRooms) override;
+    CombatChoice chooseCombatAction(Combat& combat, Player& player) override;
+    size_t chooseEventOption(const Event& event, const Player& player) override;
+    int chooseShopPurchase(const std::vector<Card*>& cards, const std::map<Card*, int>& prices, int gold) override;
+    size_t chooseCardToUpgrade(const std::vector<Card*>& cards) override;
+
+private:
+    /**
+     * @brief Pick a uniformly random index
+     * @param count Number of options (must be positive)
+     * @return Index in [0, count)
+     */
+    size_t pickIndex(size_t count);
+
+    util::Rng seedRng_;        ///< Generator each run's stream is split from
+    util::Rng rng_;            ///< Random number generator for open choices
+    std::string characterId_;  ///< Preferred character, empty for random
+};
+
+} // namespace sim
+} // namespace deckstiny
+
+#endif // DECKSTINY_SIM_BOT_POLICY_H
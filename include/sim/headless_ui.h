@@ -0,0 +1,145 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_SIM_HEADLESS_UI_H
+#define DECKSTINY_SIM_HEADLESS_UI_H
+
+#include "ui/ui_interface.h"
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace deckstiny {
+namespace sim {
+
+/**
+ * @class HeadlessUI
+ * @brief UI implementation that renders nothing and never blocks
+ *
+ * Every show call only records what the game asked to display, so a driver
+ * can read the current choices (rooms, event options, shop stock, cards
+ * offered for upgrade) and answer through Game::processInput. Prompts that
+ * the game issues synchronously via getInput are answered by a handler.
+ */
+class HeadlessUI : public UIInterface {
+public:
+    /**
+     * @brief Default constructor
+     */
+    HeadlessUI() = default;
+
+    /**
+     * @brief Virtual destructor
+     */
+    ~HeadlessUI() override = default;
+
+    bool initialize(Game* game) override;
+    void run() override {}
+    void shutdown() override {}
+    void setInputCallback(std::function<bool(const std::string&)> callback) override;
+
+    void showMainMenu() override {}
+    void showCharacterSelection(const std::vector<std::string>& availableClasses) override;
+    void showMap(int currentRoomId,
+                 const std::vector<int>& availableRooms,
+                 const std::unordered_map<int, Room>& allRooms) override;
+    void showCombat(const Combat*) override {}
+    void showPlayerStats(const Player*) override {}
+    void showEnemyStats(const Enemy*) override {}
+    void showEnemySelectionMenu(const Combat*, const std::string&) override {}
+    void showCard(const Card*, bool = true, bool = false) override {}
+    void showCards(const std::vector<Card*>& cards,
+                   const std::string& title = "",
+                   bool showIndices = true) override;
+    void showRelic(const Relic*) override {}
+    void showRelics(const std::vector<Relic*>&, const std::string& = "") override {}
+    void showMessage(const std::string&, bool = false) override {}
+
+    /**
+     * @brief Answer a synchronous prompt through the prompt handler
+     * @param prompt Prompt text
+     * @return Handler answer, or "cancel" if no handler is set
+     */
+    std::string getInput(const std::string& prompt) override;
+
+    void clearScreen() const override {}
+    void update() override {}
+    void showRewards(int gold,
+                     const std::vector<Card*>& cards,
+                     const std::vector<Relic*>& relics) override;
+    void showGameOver(bool victory, int score) override;
+    void showEvent(const Event* event, const Player* player) override;
+    void showEventResult(const std::string& resultText) override;
+    void showShop(const std::vector<Card*>& cardsForSale,
+                  const std::vector<Relic*>& relicsForSale,
+                  int playerGold) override;
+    void showShop(const std::vector<Card*>& cards,
+                  const std::vector<Relic*>& relics,
+                  const std::map<Relic*, int>& relicPrices,
+                  const std::map<Card*, int>& cardPrices,
+                  int playerGold) override;
+
+    /**
+     * @brief Set the handler that answers getInput prompts
+     * @param handler Function receiving the prompt and returning the answer
+     */
+    void setPromptHandler(std::function<std::string(const std::string&)> handler);
+
+    /**
+     * @brief Forget everything recorded for the previous run
+     */
+    void reset();
+
+    const std::vector<std::string>& getCharacterNames() const { return characterNames_; }
+    const std::vector<int>& getAvailableRooms() const { return availableRooms_; }
+    const std::vector<Card*>& getLastCards() const { return lastCards_; }
+    const Event* getCurrentEvent() const { return currentEvent_; }
+    const std::vector<Card*>& getShopCards() const { return shopCards_; }
+    const std::map<Card*, int>& getShopCardPrices() const { return shopCardPrices_; }
+    int getShopGold() const { return shopGold_; }
+
+    /**
+     * @brief Check whether the game over screen was shown since the last reset
+     * @return True if the run has ended
+     */
+    bool isGameOver() const { return gameOver_; }
+
+    /**
+     * @brief Get the score reported on the game over screen
+     * @return Final score
+     */
+    int getFinalScore() const { return finalScore_; }
+
+    /**
+     * @brief Get the number of combat rewards shown since the last reset
+     * @return Number of combats won
+     */
+    int getRewardCount() const { return rewardCount_; }
+
+    /**
+     * @brief Get the total gold shown on reward screens since the last reset
+     * @return Gold earned from combats
+     */
+    int getRewardGold() const { return rewardGold_; }
+
+private:
+    std::function<std::string(const std::string&)> promptHandler_;  ///< Answers getInput prompts
+    std::vector<std::string> characterNames_;                       ///< Last character selection
+    std::vector<int> availableRooms_;                               ///< Rooms offered on the last map screen
+    std::vector<Card*> lastCards_;                                  ///< Cards of the last card list (e.g. upgrade choice)
+    const Event* currentEvent_ = nullptr;                           ///< Event being shown, until its result
+    std::vector<Card*> shopCards_;                                  ///< Cards of the last shop screen
+    std::map<Card*, int> shopCardPrices_;                           ///< Prices of the last shop screen
+    int shopGold_ = 0;                                              ///< Player gold on the last shop screen
+    bool gameOver_ = false;                                         ///< Whether the game over screen was shown
+    int finalScore_ = 0;                                            ///< Score from the game over screen
+    int rewardCount_ = 0;                                           ///< Reward screens shown
+    int rewardGold_ = 0;                                            ///< Gold from reward screens
+};
+
+} // namespace sim
+} // namespace deckstiny
+
+#endif // DECKSTINY_SIM_HEADLESS_UI_H
@@ -0,0 +1,117 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_SIM_LANE_BATCH_RUNNER_H
+#define DECKSTINY_SIM_LANE_BATCH_RUNNER_H
+
+#include "sim/batch_runner.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace deckstiny {
+
+// Forward declarations
+class Game;
+
+namespace sim {
+
+/**
+ * @struct LaneFields
+ * @brief Combat fields of one fighter across a group of lanes
+ *
+ * A lane is one independent fight. Every field is a contiguous array indexed
+ * by lane, so the damage, block and poison kernels apply the same arithmetic
+ * to all lanes in one loop the compiler turns into SIMD instructions.
+ */
+struct LaneFields {
+    std::vector<int32_t> health;             ///< Current health
+    std::vector<int32_t> block;              ///< Current block
+    std::vector<int32_t> strength;           ///< Strength stacks
+    std::vector<int32_t> temporaryStrength;  ///< Strength lost again at the end of the turn
+    std::vector<int32_t> weak;               ///< Weak stacks
+    std::vector<int32_t> vulnerable;         ///< Vulnerable stacks
+    std::vector<int32_t> poison;             ///< Poison stacks
+
+    /**
+     * @brief Set the number of lanes
+     * @param lanes Lane count
+     */
+    void resize(size_t lanes);
+};
+
+/**
+ * @class LaneBatchRunner
+ * @brief Plays thousands of copies of one fight in lockstep
+ *
+ * An alternative to BatchRunner for large balance sweeps with the greedy
+ * bot. Fights are grouped into blocks of lanes; each step every lane of a
+ * block makes one decision, then the chosen cards and the enemy turns of
+ * all lanes are applied together by kernels over LaneFields. Card and move
+ * programs come from the compiled content templates, and only the status
+ * effects that change the outcome of a fight are kept. Relic effects are
+ * supported at combat start only.
+ *
+ * Fight i uses the same seed as in BatchRunner::run, and the outcome of
+ * every fight equals BatchRunner::runFight with GreedyPolicy.
+ */
+class LaneBatchRunner {
+public:
+    /// Lanes per block unless given otherwise
+    static constexpr size_t DEFAULT_LANES = 1024;
+
+    /**
+     * @brief Constructor
+     * @param game Initialized game providing content templates
+     * @param threadCount Worker threads, or 0 for one per core
+     * @param laneCount Fights advanced together in one block
+     */
+    explicit LaneBatchRunner(Game& game, size_t threadCount = 0, size_t laneCount = DEFAULT_LANES);
+
+    /**
+     * @brief Check that a spec can be played by the lane engine
+     * @param spec Fight to check
+     * @return True if the content exists, every card has an effect program, no enemy summons
+     *         and no relic acts after the fight has started
+     */
+    bool validate(const FightSpec& spec) const;
+
+    /**
+     * @brief Play a batch of fights on all worker threads
+     * @param spec Fight to repeat
+     * @param fights Number of fights
+     * @param seed Batch seed
+     * @return Merged statistics of all fights
+     */
+    FightStats run(const FightSpec& spec, size_t fights, uint64_t seed);
+
+    /**
+     * @brief Play one fight per seed on the calling thread
+     * @param spec Fight to repeat
+     * @param seeds Seed of each fight's shuffle and enemy streams
+     * @return Outcome of each fight, or an empty vector if the spec is invalid
+     */
+    std::vector<FightOutcome> runFights(const FightSpec& spec, const std::vector<uint64_t>& seeds);
+
+    /**
+     * @brief Get the number of worker threads
+     * @return Thread count
+     */
+    size_t getThreadCount() const { return threadCount_; }
+
+    /**
+     * @brief Get the number of lanes per block
+     * @return Lane count
+     */
+    size_t getLaneCount() const { return laneCount_; }
+
+private:
+    Game& game_;            ///< Source of content templates
+    size_t threadCount_;    ///< Worker threads per batch
+    size_t laneCount_;      ///< Fights per block
+};
+
+} // namespace sim
+} // namespace deckstiny
+
+#endif // DECKSTINY_SIM_LANE_BATCH_RUNNER_H
@@ -0,0 +1,90 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_SIM_MCTS_POLICY_H
+#define DECKSTINY_SIM_MCTS_POLICY_H
+
+#include "sim/bot_policy.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace deckstiny {
+namespace sim {
+
+/**
+ * @struct MctsOptions
+ * @brief Search budget and tuning of MctsPolicy
+ */
+struct MctsOptions {
+    size_t iterations = 2000;       ///< Playouts per thread and decision, 0 for no limit (needs a time budget)
+    double timeBudgetMs = 0.0;      ///< Wall time per decision in milliseconds, 0 for no limit
+    size_t threads = 1;             ///< Independent root-parallel trees (0 selects the hardware concurrency)
+    double exploration = 0.7;       ///< UCT exploration constant
+    int rolloutTurns = 20;          ///< Turns past the decision after which a playout is scored as unfinished
+};
+
+/**
+ * @struct MctsStats
+ * @brief Work done by MctsPolicy
+ */
+struct MctsStats {
+    uint64_t playouts = 0;      ///< Playouts over all threads
+    uint64_t decisions = 0;     ///< Decisions searched
+    double seconds = 0.0;       ///< Wall time spent searching
+};
+
+/**
+ * @class MctsPolicy
+ * @brief Combat bot that searches the fight with Monte Carlo tree search
+ *
+ * Each decision forks the combat once per thread and grows an independent UCT
+ * tree on every fork; root visit counts are summed and the most visited action
+ * is played. Draw order and enemy moves are chance events: every playout
+ * reseeds the fork's shuffle and enemy streams, and each action leads to one
+ * child per distinct visible outcome. Choices outside combat are GreedyPolicy's.
+ */
+class MctsPolicy : public GreedyPolicy {
+public:
+    /**
+     * @brief Constructor
+     * @param options Search budget and tuning
+     * @param seed Seed for the policy's random choices
+     * @param characterId Character to play, or empty for a random one
+     */
+    explicit MctsPolicy(const MctsOptions& options, uint64_t seed = 0, const std::string& characterId = "");
+
+    std::string getName() const override { return "mcts"; }
+    void beginRun(int runIndex) override;
+    CombatChoice chooseCombatAction(Combat& combat, Player& player) override;
+
+    /**
+     * @brief Get the search options
+     * @return Options
+     */
+    const MctsOptions& getOptions() const { return options_; }
+
+    /**
+     * @brief Get the work done by the last decision
+     * @return Statistics of the last search
+     */
+    const MctsStats& getLastStats() const { return lastStats_; }
+
+    /**
+     * @brief Get the work done since construction
+     * @return Accumulated statistics
+     */
+    const MctsStats& getTotalStats() const { return totalStats_; }
+
+private:
+    MctsOptions options_;       ///< Search budget and tuning
+    util::Rng searchSeedRng_;   ///< Generator each run's search stream is split from
+    util::Rng searchRng_;       ///< Seeds of the searches in the current run
+    MctsStats lastStats_;       ///< Work of the last decision
+    MctsStats totalStats_;      ///< Work of all decisions
+};
+
+} // namespace sim
+} // namespace deckstiny
+
+#endif // DECKSTINY_SIM_MCTS_POLICY_H
@@ -0,0 +1,118 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_SIM_SIM_DRIVER_H
+#define DECKSTINY_SIM_SIM_DRIVER_H
+
+#include "sim/bot_policy.h"
+#include "sim/headless_ui.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace deckstiny {
+
+// Forward declarations
+class Card;
+class Game;
+
+namespace sim {
+
+/**
+ * @struct SimOptions
+ * @brief Settings for headless runs
+ */
+struct SimOptions {
+    int maxActs = 1;        ///< A run is won once this many bosses are defeated
+    int maxSteps = 20000;   ///< Inputs per run before it is abandoned as stalled
+    uint64_t seed = 1;      ///< Base seed; each run's game seed is split from it by run index
+};
+
+/**
+ * @struct RunResult
+ * @brief Outcome of one headless run
+ */
+struct RunResult {
+    bool victory = false;       ///< Whether the run reached the act limit
+    bool stalled = false;       ///< Whether the run hit the step limit or got stuck
+    uint64_t seed = 0;          ///< Game seed of the run
+    std::string characterId;    ///< Character played
+    int act = 0;                ///< Act reached
+    int floor = 0;              ///< Floor of the last room entered
+    int combatsWon = 0;         ///< Combats won
+    int health = 0;             ///< Player health at the end
+    int gold = 0;               ///< Player gold at the end
+    int deckSize = 0;           ///< Cards in the deck at the end
+    int score = 0;              ///< Final score
+    int steps = 0;              ///< Inputs sent to the game
+};
+
+/**
+ * @class SimDriver
+ * @brief Drives complete runs through a Game without any rendering
+ *
+ * Owns one Game with a HeadlessUI. Content is loaded once in initialize();
+ * each run goes back to the main menu and answers every screen by asking the
+ * policy and feeding the answer to Game::processInput, exactly like a player
+ * typing into the text UI.
+ */
+class SimDriver {
+public:
+    /**
+     * @brief Constructor
+     * @param options Run settings
+     */
+    explicit SimDriver(const SimOptions& options = SimOptions());
+
+    /**
+     * @brief Destructor
+     */
+    ~SimDriver();
+
+    /**
+     * @brief Create the game and load its content
+     * @return True if the game initialized successfully
+     */
+    bool initialize();
+
+    /**
+     * @brief Play one full run
+     * @param policy Bot answering every decision
+     * @param runIndex Zero-based index of the run, passed to the policy
+     * @return Outcome of the run
+     *
+     * The same options, policy seed and run index always replay the same run.
+     */
+    RunResult runOnce(BotPolicy& policy, int runIndex = 0);
+
+    /**
+     * @brief Get the driven game
+     * @return Pointer to the game, nullptr before initialize()
+     */
+    Game* getGame() const { return game_.get(); }
+
+private:
+    /**
+     * @brief Translate the policy's decision for the current screen into input
+     * @param policy Bot answering the decision
+     * @param result Run being played, updated when the run ends
+     * @return Input for Game::processInput, or empty if the run is over
+     */
+    std::string nextInput(BotPolicy& policy, RunResult& result);
+
+    SimOptions options_;                ///< Run settings
+    std::unique_ptr<Game> game_;        ///< Game being driven
+    std::shared_ptr<HeadlessUI> ui_;    ///< Recording UI
+
+    std::vector<const Card*> rejectedCards_;  ///< Cards whose play failed this turn
+    int rejectedTurn_ = -1;                   ///< Combat turn rejectedCards_ belongs to
+    const Card* lastPlayedCard_ = nullptr;    ///< Card sent by the previous combat input
+    size_t lastHandSize_ = 0;                 ///< Hand size when that input was sent
+};
+
+} // namespace sim
+} // namespace deckstiny
+
+#endif // DECKSTINY_SIM_SIM_DRIVER_H
@@ -0,0 +1,135 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_UTIL_BENCH_COMPARE_H
+#define DECKSTINY_UTIL_BENCH_COMPARE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace deckstiny {
+namespace util {
+
+/**
+ * @struct BenchmarkSamples
+ * @brief Repetitions of one benchmark from a Google Benchmark JSON file
+ */
+struct BenchmarkSamples {
+    std::vector<double> times;          ///< Time per iteration of each repetition, in nanoseconds
+    std::vector<double> allocations;    ///< allocs/op of each repetition, empty if not reported
+};
+
+/**
+ * @class BenchmarkResults
+ * @brief Benchmark results read from the JSON written with --benchmark_out
+ *
+ * Only the per-repetition entries are read; aggregates such as _mean and
+ * _median are recomputed from them, and failed benchmarks are skipped.
+ */
+class BenchmarkResults {
+public:
+    /**
+     * @brief Read a results file
+     * @param path Google Benchmark JSON output
+     * @param cpuTime Read CPU time instead of wall-clock time
+     * @return True if the file was read and holds at least one benchmark
+     */
+    bool load(const std::string& path, bool cpuTime = false);
+
+    /**
+     * @brief Get the samples of every benchmark
+     * @return Samples by benchmark name
+     */
+    const std::map<std::string, BenchmarkSamples>& getBenchmarks() const { return benchmarks_; }
+
+    /**
+     * @brief Get the error of the last failed load
+     * @return Error message, empty if none
+     */
+    const std::string& getError() const { return error_; }
+
+private:
+    std::map<std::string, BenchmarkSamples> benchmarks_;   ///< Samples by benchmark name
+    std::string error_;                                     ///< Last error
+};
+
+/**
+ * @enum BenchmarkVerdict
+ * @brief Outcome of comparing one benchmark against its baseline
+ */
+enum class BenchmarkVerdict {
+    UNCHANGED,  ///< Within the threshold
+    FASTER,     ///< Faster by more than the threshold and the noise
+    SLOWER,     ///< Slower by more than the threshold and the noise: a regression
+    NOISY,      ///< Beyond the threshold, but within the noise of the measurements
+    ADDED,      ///< Only in the current results
+    REMOVED     ///< Only in the baseline
+};
+
+/**
+ * @brief Get the name of a verdict
+ * @param verdict Verdict
+ * @return Lowercase name, e.g. "slower"
+ */
+const char* benchmarkVerdictName(BenchmarkVerdict verdict);
+
+/**
+ * @struct BenchmarkCompareOptions
+ * @brief Limits a change has to exceed to count
+ */
+struct BenchmarkCompareOptions {
+    double threshold = 0.05;    ///< Smallest relative change of the median that counts
+    double noiseFactor = 3.0;   ///< Robust standard deviations of the difference a change must also exceed
+};
+
+/**
+ * @struct BenchmarkComparison
+ * @brief One benchmark in a baseline and in the current results
+ */
+struct BenchmarkComparison {
+    std::string name;                   ///< Benchmark name
+    double baselineMedian = 0.0;        ///< Median time of the baseline, in nanoseconds
+    double currentMedian = 0.0;         ///< Median time of the current results, in nanoseconds
+    double change = 0.0;                ///< currentMedian / baselineMedian - 1
+    double noise = 0.0;                 ///< Relative change the noise alone can explain
+    double baselineAllocations = -1.0;  ///< Median allocs/op of the baseline, -1 if not reported
+    double currentAllocations = -1.0;   ///< Median allocs/op of the current results, -1 if not reported
+    size_t repetitions = 0;             ///< Fewer repetitions of the two sides
+    BenchmarkVerdict verdict = BenchmarkVerdict::UNCHANGED;  ///< Outcome
+};
+
+/**
+ * @brief Get the median of some values
+ * @param values Values, need not be sorted
+ * @return Median, 0 if there are none
+ */
+double median(std::vector<double> values);
+
+/**
+ * @brief Get the median absolute deviation from the median
+ * @param values Values, need not be sorted
+ * @return MAD, 0 for fewer than two values
+ */
+double medianAbsoluteDeviation(const std::vector<double>& values);
+
+/**
+ * @brief Compare current results against a baseline benchmark by benchmark
+ *
+ * A median change counts when it exceeds both the threshold and the noise:
+ * noiseFactor times the robust standard deviation of the difference of the
+ * medians (1.4826 MAD of each side, combined), relative to the baseline.
+ * With a single repetition the MAD is 0 and only the threshold applies.
+ *
+ * @param baseline Baseline results
+ * @param current Current results
+ * @param options Threshold and noise factor
+ * @return Comparisons in name order, including added and removed benchmarks
+ */
+std::vector<BenchmarkComparison> compareBenchmarks(const BenchmarkResults& baseline, const BenchmarkResults& current,
+                                                   const BenchmarkCompareOptions& options);
+
+} // namespace util
+} // namespace deckstiny
+
+#endif // DECKSTINY_UTIL_BENCH_COMPARE_H
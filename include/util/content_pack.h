@@ -0,0 +1,207 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_UTIL_CONTENT_PACK_H
+#define DECKSTINY_UTIL_CONTENT_PACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace deckstiny {
+namespace util {
+
+/**
+ * @enum ContentKind
+ * @brief Registry a content pack record belongs to
+ */
+enum class ContentKind : uint8_t {
+    CHARACTER = 0,
+    CARD,
+    ENEMY,
+    RELIC,
+    EVENT
+};
+
+/**
+ * @brief Get the data subdirectory that holds content of the given kind
+ * @param kind Content kind
+ * @return Directory name relative to data/ (e.g. "cards")
+ */
+const char* contentKindDirectory(ContentKind kind);
+
+/**
+ * @class ContentPackWriter
+ * @brief Bakes JSON content documents into a binary content pack
+ *
+ * All object keys and string values are interned into a single string
+ * table, values are stored as a compact tagged tree that can be turned
+ * back into JSON objects without any text parsing.
+ */
+class ContentPackWriter {
+public:
+    /**
+     * @brief Add a content document to the pack
+     * @param kind Registry the document belongs to
+     * @param id Registry key of the document (file name stem)
+     * @param data Parsed JSON document
+     */
+    void addRecord(ContentKind kind, const std::string& id, const nlohmann::json& data);
+
+    /**
+     * @brief Get the number of records added so far
+     * @return Record count
+     */
+    size_t getRecordCount() const { return records_.size(); }
+
+    /**
+     * @brief Get the number of interned strings
+     * @return String table size
+     */
+    size_t getStringCount() const { return strings_.size(); }
+
+    /**
+     * @brief Write the pack to a file
+     * @param path Output file path
+     * @return True if the file was written, false otherwise
+     */
+    bool writeToFile(const std::string& path) const;
+
+private:
+    /**
+     * @struct Record
+     * @brief Record table entry
+     */
+    struct Record {
+        ContentKind kind;     ///< Registry of the record
+        uint32_t idIndex;     ///< String table index of the record ID
+        uint64_t offset;      ///< Offset of the encoded value in the value blob
+        uint64_t size;        ///< Size of the encoded value in bytes
+    };
+
+    std::vector<std::string> strings_;                     ///< Interned strings in index order
+    std::unordered_map<std::string, uint32_t> stringIndices_; ///< String to index lookup
+    std::vector<Record> records_;                          ///< Record table
+    std::vector<uint8_t> values_;                          ///< Encoded values of all records
+
+    /**
+     * @brief Intern a string into the string table
+     * @param str String to intern
+     * @return Index of the string in the table
+     */
+    uint32_t intern(const std::string& str);
+
+    /**
+     * @brief Encode a JSON value into the value blob
+     * @param value JSON value to encode
+     */
+    void encodeValue(const nlohmann::json& value);
+};
+
+/**
+ * @class ContentPack
+ * @brief Read-only, memory-mapped view of a baked content pack
+ */
+class ContentPack {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;                   ///< Supported pack format version
+    static constexpr const char* DEFAULT_FILE_NAME = "content.pack"; ///< Pack file name inside data/
+
+    /**
+     * @brief Default constructor
+     */
+    ContentPack() = default;
+
+    /**
+     * @brief Destructor, unmaps the pack if open
+     */
+    ~ContentPack();
+
+    ContentPack(const ContentPack&) = delete;
+    ContentPack& operator=(const ContentPack&) = delete;
+
+    /**
+     * @brief Map a pack file and validate its header
+     * @param path Path to the pack file
+     * @return True if the pack was opened, false otherwise
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Unmap the pack
+     */
+    void close();
+
+    /**
+     * @brief Check if a pack is open
+     * @return True if open, false otherwise
+     */
+    bool isOpen() const { return data_ != nullptr; }
+
+    /**
+     * @brief Get the number of records in the pack
+     * @return Record count
+     */
+    size_t getRecordCount() const { return recordCount_; }
+
+    /**
+     * @brief Get the registry of a record
+     * @param index Record index
+     * @return Content kind of the record
+     */
+    ContentKind getRecordKind(size_t index) const;
+
+    /**
+     * @brief Get the registry key of a record
+     * @param index Record index
+     * @return Record ID
+     */
+    std::string getRecordId(size_t index) const;
+
+    /**
+     * @brief Rebuild the JSON document stored in a record
+     * @param index Record index
+     * @param out JSON object to fill
+     * @return True if the record was decoded, false if it is malformed
+     */
+    bool decodeRecord(size_t index, nlohmann::json& out) const;
+
+private:
+    const uint8_t* data_ = nullptr;   ///< Start of the mapped file
+    size_t size_ = 0;                 ///< Size of the mapped file
+    bool mapped_ = false;             ///< Whether data_ was obtained with mmap
+    std::vector<uint8_t> buffer_;     ///< File contents when mmap is unavailable
+
+    uint32_t stringCount_ = 0;        ///< Number of interned strings
+    uint32_t recordCount_ = 0;        ///< Number of records
+    uint64_t stringOffsetsPos_ = 0;   ///< Position of the string offset array
+    uint64_t stringDataPos_ = 0;      ///< Position of the string characters
+    uint64_t recordTablePos_ = 0;     ///< Position of the record table
+    uint64_t valuesPos_ = 0;          ///< Position of the value blob
+
+    /**
+     * @brief Get an interned string by index
+     * @param index String table index
+     * @param out String to fill
+     * @return True if the index is valid, false otherwise
+     */
+    bool getString(uint32_t index, std::string& out) const;
+
+    /**
+     * @brief Decode a value starting at a position
+     * @param pos Position to read from, advanced past the value
+     * @param end End of the record's value range
+     * @param out JSON value to fill
+     * @param depth Current nesting depth
+     * @return True if decoded, false if the data is malformed
+     */
+    bool decodeValue(uint64_t& pos, uint64_t end, nlohmann::json& out, int depth) const;
+};
+
+} // namespace util
+} // namespace deckstiny
+
+#endif // DECKSTINY_UTIL_CONTENT_PACK_H
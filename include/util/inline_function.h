@@ -0,0 +1,160 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_UTIL_INLINE_FUNCTION_H
+#define DECKSTINY_UTIL_INLINE_FUNCTION_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace deckstiny {
+namespace util {
+
+/**
+ * @class InlineFunction
+ * @brief Copyable void() callable stored in a fixed inline buffer
+ *
+ * A replacement for std::function<void()> that never allocates: the callable
+ * is constructed inside the object, and one that does not fit in Capacity
+ * bytes is rejected at compile time instead of being moved to the heap.
+ *
+ * @tparam Capacity Size of the inline buffer in bytes
+ */
+template <size_t Capacity>
+class InlineFunction {
+public:
+    /**
+     * @brief Default constructor, an empty function
+     */
+    InlineFunction() = default;
+
+    /**
+     * @brief Constructor from a callable
+     * @param function Lambda or function object to store
+     */
+    template <typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, InlineFunction>::value>>
+    InlineFunction(F&& function) {
+        using Fn = std::decay_t<F>;
+        static_assert(sizeof(Fn) <= Capacity, "callable does not fit the inline buffer");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "callable is over-aligned");
+        static_assert(std::is_copy_constructible<Fn>::value, "callable must be copyable");
+        new (storage_) Fn(std::forward<F>(function));
+        ops_ = &OpsFor<Fn>::ops;
+    }
+
+    /**
+     * @brief Copy constructor
+     * @param other Function to copy
+     */
+    InlineFunction(const InlineFunction& other) : ops_(other.ops_) {
+        if (ops_) {
+            ops_->copy(storage_, other.storage_);
+        }
+    }
+
+    /**
+     * @brief Move constructor
+     * @param other Function to move from; left empty
+     */
+    InlineFunction(InlineFunction&& other) noexcept : ops_(other.ops_) {
+        if (ops_) {
+            ops_->move(storage_, other.storage_);
+            other.reset();
+        }
+    }
+
+    /**
+     * @brief Copy assignment
+     * @param other Function to copy
+     * @return Reference to this function
+     */
+    InlineFunction& operator=(const InlineFunction& other) {
+        if (this != &other) {
+            reset();
+            if (other.ops_) {
+                other.ops_->copy(storage_, other.storage_);
+                ops_ = other.ops_;
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Move assignment
+     * @param other Function to move from; left empty
+     * @return Reference to this function
+     */
+    InlineFunction& operator=(InlineFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.ops_) {
+                other.ops_->move(storage_, other.storage_);
+                ops_ = other.ops_;
+                other.reset();
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Destructor
+     */
+    ~InlineFunction() { reset(); }
+
+    /**
+     * @brief Call the stored callable; the function must not be empty
+     */
+    void operator()() { ops_->invoke(storage_); }
+
+    /**
+     * @brief Check whether a callable is stored
+     * @return True if not empty
+     */
+    explicit operator bool() const { return ops_ != nullptr; }
+
+    /**
+     * @brief Destroy the stored callable, leaving the function empty
+     */
+    void reset() {
+        if (ops_) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+private:
+    /**
+     * @struct Ops
+     * @brief Type-erased operations on the stored callable
+     */
+    struct Ops {
+        void (*invoke)(void* self);                         ///< Call it
+        void (*copy)(void* destination, const void* self);  ///< Copy-construct into another buffer
+        void (*move)(void* destination, void* self);        ///< Move-construct into another buffer
+        void (*destroy)(void* self);                        ///< Destroy it
+    };
+
+    /**
+     * @struct OpsFor
+     * @brief Operation table for one callable type
+     */
+    template <typename Fn>
+    struct OpsFor {
+        static void invoke(void* self) { (*static_cast<Fn*>(self))(); }
+        static void copy(void* destination, const void* self) { new (destination) Fn(*static_cast<const Fn*>(self)); }
+        static void move(void* destination, void* self) { new (destination) Fn(std::move(*static_cast<Fn*>(self))); }
+        static void destroy(void* self) { static_cast<Fn*>(self)->~Fn(); }
+
+        static constexpr Ops ops = {&invoke, &copy, &move, &destroy};
+    };
+
+    alignas(std::max_align_t) unsigned char storage_[Capacity];  ///< Inline storage of the callable
+    const Ops* ops_ = nullptr;                                      ///< Operations, or nullptr if empty
+};
+
+} // namespace util
+} // namespace deckstiny
+
+#endif // DECKSTINY_UTIL_INLINE_FUNCTION_H
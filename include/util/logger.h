@@ -4,12 +4,28 @@
 #ifndef DECKSTINY_UTIL_LOGGER_H
 #define DECKSTINY_UTIL_LOGGER_H
 
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <string>
-#include <fstream>
+#include <string_view>
 #include <iostream>
 #include <mutex>
-#include <map>
 #include <memory>
+#include <algorithm>
+#include <type_traits>
+
+/**
+ * @brief Lowest log level compiled in: 0 Debug, 1 Info, 2 Warning, 3 Error, 4 Fatal
+ *
+ * Log statements below it are removed by the compiler, arguments included.
+ * Set with the DECKSTINY_LOG_MIN_LEVEL CMake option.
+ */
+#ifndef DECKSTINY_LOG_MIN_LEVEL
+#define DECKSTINY_LOG_MIN_LEVEL 0
+#endif
 
 namespace deckstiny {
 namespace util {
@@ -22,8 +38,30 @@ enum class LogLevel {
     Fatal
 };
 
+/**
+ * @enum OverflowPolicy
+ * @brief What a thread does when the file queue is full
+ */
+enum class OverflowPolicy {
+    Drop,   ///< Discard Debug to Warning messages and count them; Error and Fatal still wait
+    Block   ///< Wait for the writer thread to make room
+};
+
+/**
+ * @class Logger
+ * @brief Process-wide logger with colored console output and per-category files
+ *
+ * Console lines are written synchronously. File records are pushed into a
+ * bounded lock-free queue and written by a background thread, which formats
+ * the timestamps and flushes the files once per batch, so logging threads
+ * never wait for the disk. Fatal messages and flush() wait until everything
+ * logged before them is on disk.
+ */
 class Logger {
 public:
+    /// Records the file queue holds before the overflow policy applies
+    static constexpr size_t QUEUE_CAPACITY = 8192;
+    
     /**
      * @brief Initialize the logger system
      */
@@ -41,7 +79,36 @@ public:
      * @param category Log category
      * @param message Message to log
      */
-    void log(LogLevel level, const std::string& category, const std::string& message);
+    void log(LogLevel level, const std::string& category, std::string message);
+    
+    /**
+     * @brief Wait until every message logged so far is written to its file
+     */
+    void flush();
+    
+    /**
+     * @brief Set what happens when the file queue is full
+     * @param policy Overflow policy, Drop by default
+     */
+    void setOverflowPolicy(OverflowPolicy policy);
+    
+    /**
+     * @brief Get the number of file messages discarded because the queue was full
+     * @return Dropped message count since startup
+     */
+    size_t getDroppedCount() const;
+    
+    /**
+     * @brief Check if a message of a level would be written anywhere
+     * @param level Log level
+     * @return True if some enabled output accepts the level
+     *
+     * Lock-free, so messages nobody reads cost one atomic load even when
+     * many threads log at once.
+     */
+    bool shouldLog(LogLevel level) const {
+        return static_cast<int>(level) >= threshold_.load(std::memory_order_relaxed);
+    }
     
     /**
      * @brief Set the minimum log level for console output
@@ -67,6 +134,21 @@ public:
      */
     void setFileEnabled(bool enabled);
     
+    /**
+     * @brief Enable or disable logging altogether
+     * @param enabled Whether messages are written to any output
+     *
+     * Disabled logging skips formatting and locking entirely, regardless of
+     * the console and file settings.
+     */
+    void setEnabled(bool enabled);
+    
+    /**
+     * @brief Check if logging is enabled
+     * @return True if messages are written to the enabled outputs
+     */
+    bool isEnabled() const;
+    
     /**
      * @brief Set the log directory
      * @param directory Directory to store log files
@@ -109,29 +191,29 @@ protected:
 private:
     friend class std::default_delete<Logger>;
     
+    // Queue and writer thread of file records, defined in logger.cpp
+    class FileWriter;
+    
     Logger();
     
     // Prevent copying
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
     
-    // Get log level string
-    std::string getLevelString(LogLevel level);
-    
     // Get log level color
     std::string getLevelColor(LogLevel level);
     
-    // Get timestamp
-    std::string getTimestamp();
+    // Format a timestamp taken from std::chrono::system_clock
+    static std::string formatTimestamp(int64_t microseconds);
     
-    // Open log file for category
-    void openLogFile(const std::string& category);
+    // Recompute the thresholds from the output settings; caller holds mutex_
+    void updateThreshold();
     
     // Instance
     static std::unique_ptr<Logger> instance_;
     
-    // Mutex for thread safety
-    std::mutex mutex_;
+    // Guards the settings and serializes console lines
+    mutable std::mutex mutex_;
     
     // Log settings
     LogLevel consoleLevel_ = LogLevel::Info;
@@ -140,19 +222,113 @@ private:
     bool fileEnabled_ = false;
     std::string logDirectory_ = "";
     bool testingMode_ = false;
+    std::atomic<bool> enabled_{true};
+    std::atomic<int> threshold_{static_cast<int>(LogLevel::Info)}; ///< Lowest level any output accepts
+    std::atomic<int> consoleThreshold_{static_cast<int>(LogLevel::Info)}; ///< Lowest level printed to the console
+    std::atomic<int> fileThreshold_{static_cast<int>(LogLevel::Fatal) + 1}; ///< Lowest level written to files
+    std::atomic<OverflowPolicy> overflowPolicy_{OverflowPolicy::Drop};
     
     // Log files
-    std::map<std::string, std::ofstream> logFiles_;
+    std::unique_ptr<FileWriter> writer_;
 };
 
+// Formatting of LOG_*F arguments
+inline void appendLogArgument(std::string& out, const std::string& value) { out += value; }
+inline void appendLogArgument(std::string& out, std::string_view value) { out.append(value.data(), value.size()); }
+inline void appendLogArgument(std::string& out, const char* value) { out += value ? value : "(null)"; }
+inline void appendLogArgument(std::string& out, char value) { out += value; }
+inline void appendLogArgument(std::string& out, bool value) { out += value ? "true" : "false"; }
+inline void appendLogArgument(std::string& out, std::nullptr_t) { out += "(null)"; }
+
+// Any other object pointer prints its address instead of converting to bool
+inline void appendLogArgument(std::string& out, const void* value) {
+    char buffer[2 + 2 * sizeof(uintptr_t)];
+    auto result = std::to_chars(buffer + 2, buffer + sizeof(buffer), reinterpret_cast<uintptr_t>(value), 16);
+    buffer[0] = '0';
+    buffer[1] = 'x';
+    out.append(buffer, result.ptr);
+}
+
+template <typename T>
+std::enable_if_t<std::is_integral<T>::value> appendLogArgument(std::string& out, T value) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+template <typename T>
+std::enable_if_t<std::is_floating_point<T>::value> appendLogArgument(std::string& out, T value) {
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%g", static_cast<double>(value));
+    out.append(buffer, static_cast<size_t>(std::max(length, 0)));
+}
+
+template <typename T>
+std::enable_if_t<std::is_enum<T>::value> appendLogArgument(std::string& out, T value) {
+    appendLogArgument(out, static_cast<std::underlying_type_t<T>>(value));
+}
+
+inline void formatLogInto(std::string& out, std::string_view format) {
+    out.append(format.data(), format.size());
+}
+
+template <typename First, typename... Rest>
+void formatLogInto(std::string& out, std::string_view format, const First& first, const Rest&... rest) {
+    size_t placeholder = format.find("{}");
+    if (placeholder == std::string_view::npos) {
+        formatLogInto(out, format);
+        return;
+    }
+    out.append(format.data(), placeholder);
+    appendLogArgument(out, first);
+    formatLogInto(out, format.substr(placeholder + 2), rest...);
+}
+
+/**
+ * @brief Build a log message from a format string
+ * @param format Text in which each "{}" is replaced by the next argument
+ * @param args Strings, numbers, booleans, enums or pointers (printed as addresses)
+ * @return Formatted message; surplus arguments are ignored
+ */
+template <typename... Args>
+std::string formatLog(std::string_view format, const Args&... args) {
+    std::string out;
+    out.reserve(format.size() + 8 * sizeof...(Args));
+    formatLogInto(out, format, args...);
+    return out;
+}
+
 } // namespace util
 
+/**
+ * @brief Log a message if its level is compiled in and enabled
+ *
+ * The message expression is only evaluated when the record will be written,
+ * so building it costs nothing for filtered levels.
+ */
+#define DECKSTINY_LOG(level, category, message)                                         \
+    do {                                                                                \
+        if (static_cast<int>(level) >= DECKSTINY_LOG_MIN_LEVEL) {                       \
+            ::deckstiny::util::Logger& deckstinyLogger = ::deckstiny::util::Logger::getInstance(); \
+            if (deckstinyLogger.shouldLog(level)) {                                     \
+                deckstinyLogger.log(level, category, message);                          \
+            }                                                                           \
+        }                                                                               \
+    } while (false)
+
 // Convenience macros
-#define LOG_DEBUG(category, message) ::deckstiny::util::Logger::getInstance().log(::deckstiny::util::LogLevel::Debug, category, message)
-#define LOG_INFO(category, message) ::deckstiny::util::Logger::getInstance().log(::deckstiny::util::LogLevel::Info, category, message)
-#define LOG_WARNING(category, message) ::deckstiny::util::Logger::getInstance().log(::deckstiny::util::LogLevel::Warning, category, message)
-#define LOG_ERROR(category, message) ::deckstiny::util::Logger::getInstance().log(::deckstiny::util::LogLevel::Error, category, message)
-#define LOG_FATAL(category, message) ::deckstiny::util::Logger::getInstance().log(::deckstiny::util::LogLevel::Fatal, category, message)
+#define LOG_DEBUG(category, message) DECKSTINY_LOG(::deckstiny::util::LogLevel::Debug, category, message)
+#define LOG_INFO(category, message) DECKSTINY_LOG(::deckstiny::util::LogLevel::Info, category, message)
+#define LOG_WARNING(category, message) DECKSTINY_LOG(::deckstiny::util::LogLevel::Warning, category, message)
+#define LOG_ERROR(category, message) DECKSTINY_LOG(::deckstiny::util::LogLevel::Error, category, message)
+#define LOG_FATAL(category, message) DECKSTINY_LOG(::deckstiny::util::LogLevel::Fatal, category, message)
+
+// Format-string macros: LOG_DEBUGF("card", "{} costs {}", name, cost)
+#define LOG_DEBUGF(category, ...) LOG_DEBUG(category, ::deckstiny::util::formatLog(__VA_ARGS__))
+#define LOG_INFOF(category, ...) LOG_INFO(category, ::deckstiny::util::formatLog(__VA_ARGS__))
+#define LOG_WARNINGF(category, ...) LOG_WARNING(category, ::deckstiny::util::formatLog(__VA_ARGS__))
+#define LOG_ERRORF(category, ...) LOG_ERROR(category, ::deckstiny::util::formatLog(__VA_ARGS__))
+#define LOG_FATALF(category, ...) LOG_FATAL(category, ::deckstiny::util::formatLog(__VA_ARGS__))
 
 } // namespace deckstiny
 
@@ -0,0 +1,368 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_UTIL_METRICS_H
+#define DECKSTINY_UTIL_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace deckstiny {
+namespace util {
+
+/// Label names and values of a metric, e.g. {{"kind", "cards"}}
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+/// Number of shards counters and histograms spread their updates over
+constexpr size_t METRIC_SHARD_COUNT = 8;
+
+/**
+ * @brief Get the shard of the calling thread
+ * @return Shard index, fixed for the lifetime of the thread
+ */
+size_t metricShard();
+
+/**
+ * @class Counter
+ * @brief Monotonic counter
+ *
+ * Threads add to their own cache line, so counting from many threads does
+ * not bounce one line between cores; value() sums the shards.
+ */
+class Counter {
+public:
+    /**
+     * @brief Add to the counter
+     * @param amount Amount to add
+     */
+    void add(uint64_t amount = 1) {
+        shards_[metricShard()].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the current total
+     * @return Sum over all threads
+     */
+    uint64_t value() const;
+
+private:
+    /**
+     * @struct Shard
+     * @brief Part of the counter updated by a subset of threads
+     */
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};  ///< Partial count
+    };
+
+    std::array<Shard, METRIC_SHARD_COUNT> shards_;  ///< Partial counts
+};
+
+/**
+ * @class Gauge
+ * @brief Value that can go up and down
+ */
+class Gauge {
+public:
+    /**
+     * @brief Set the value
+     * @param value New value
+     */
+    void set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+
+    /**
+     * @brief Add to the value
+     * @param amount Amount to add, may be negative
+     */
+    void add(int64_t amount) { value_.fetch_add(amount, std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the value
+     * @return Current value
+     */
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};  ///< Current value
+};
+
+/**
+ * @struct HistogramSnapshot
+ * @brief Totals of a histogram at one point in time
+ */
+struct HistogramSnapshot {
+    std::vector<uint64_t> buckets;  ///< Observations per bucket, not cumulative; the last is +Inf
+    uint64_t count = 0;             ///< Number of observations
+    uint64_t sumNanoseconds = 0;    ///< Sum of the observations
+};
+
+/**
+ * @class Histogram
+ * @brief Latency histogram with fixed buckets from 1 us to 4 s, four times apart
+ */
+class Histogram {
+public:
+    /// Upper bounds of the finite buckets, in nanoseconds
+    static constexpr std::array<uint64_t, 12> BOUNDS = {
+        1000, 4000, 16000, 64000, 256000, 1000000,
+        4000000, 16000000, 64000000, 256000000, 1000000000, 4000000000
+    };
+
+    /// Number of buckets, including +Inf
+    static constexpr size_t BUCKET_COUNT = BOUNDS.size() + 1;
+
+    /**
+     * @brief Record one observation
+     * @param nanoseconds Observed latency
+     */
+    void observe(uint64_t nanoseconds) {
+        size_t bucket = 0;
+        while (bucket < BOUNDS.size() && nanoseconds > BOUNDS[bucket]) {
+            ++bucket;
+        }
+        Shard& shard = shards_[metricShard()];
+        shard.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        shard.sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sum the shards
+     * @return Current totals
+     */
+    HistogramSnapshot snapshot() const;
+
+private:
+    /**
+     * @struct Shard
+     * @brief Part of the histogram updated by a subset of threads
+     */
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets{};  ///< Observations per bucket
+        std::atomic<uint64_t> sum{0};                               ///< Sum of the observations
+    };
+
+    std::array<Shard, METRIC_SHARD_COUNT> shards_;  ///< Partial histograms
+};
+
+/**
+ * @enum MetricsFormat
+ * @brief File format of a metrics snapshot
+ */
+enum class MetricsFormat {
+    Prometheus,     ///< Prometheus text exposition format
+    Json            ///< JSON document
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief Process-wide set of named metrics
+ *
+ * Metrics are created on first request and live until the process ends, so
+ * call sites look them up once and keep the reference, typically in a
+ * function-local static.
+ */
+class MetricsRegistry {
+public:
+    /**
+     * @brief Get the singleton instance
+     * @return Reference to the registry
+     */
+    static MetricsRegistry& getInstance();
+
+    /**
+     * @brief Get or create a counter
+     * @param name Metric name, e.g. "deckstiny_cards_played_total"
+     * @param help One-line description
+     * @param labels Labels distinguishing metrics of the same name
+     * @return Counter, valid for the lifetime of the program
+     */
+    Counter& counter(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+
+    /**
+     * @brief Get or create a gauge
+     * @param name Metric name
+     * @param help One-line description
+     * @param labels Labels distinguishing metrics of the same name
+     * @return Gauge, valid for the lifetime of the program
+     */
+    Gauge& gauge(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+
+    /**
+     * @brief Get or create a latency histogram
+     * @param name Metric name, e.g. "deckstiny_map_generate_seconds"
+     * @param help One-line description
+     * @param labels Labels distinguishing metrics of the same name
+     * @return Histogram, valid for the lifetime of the program
+     */
+    Histogram& histogram(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+
+    /**
+     * @brief Render all metrics
+     * @param format Output format
+     * @return Snapshot text
+     */
+    std::string snapshot(MetricsFormat format) const;
+
+    /**
+     * @brief Write a snapshot to a file, replacing it atomically
+     * @param path Destination file
+     * @param format Output format
+     * @return True if the file was written
+     */
+    bool writeSnapshot(const std::string& path, MetricsFormat format) const;
+
+    /**
+     * @brief Turn latency measurement on or off; MetricsExporter::start turns it on
+     *
+     * Reading the clock twice costs more than most of the timed calls, so
+     * histograms only fill while something exports them.
+     * @param enabled True to measure latencies
+     */
+    static void setTimingEnabled(bool enabled) { timingEnabled_.store(enabled, std::memory_order_relaxed); }
+
+    /**
+     * @brief Check whether latencies are measured
+     * @return True if ScopedLatency records
+     */
+    static bool isTimingEnabled() { return timingEnabled_.load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * @enum MetricType
+     * @brief Kind of a registered metric
+     */
+    enum class MetricType {
+        Counter,
+        Gauge,
+        Histogram
+    };
+
+    /**
+     * @struct Entry
+     * @brief One registered metric
+     */
+    struct Entry {
+        std::string name;                       ///< Metric name
+        std::string help;                       ///< Description
+        MetricLabels labels;                    ///< Labels
+        MetricType type;                        ///< Kind
+        std::unique_ptr<Counter> counter;       ///< Set for counters
+        std::unique_ptr<Gauge> gauge;           ///< Set for gauges
+        std::unique_ptr<Histogram> histogram;   ///< Set for histograms
+    };
+
+    MetricsRegistry() = default;
+
+    /**
+     * @brief Find or add the entry of a metric
+     * @return Entry of the right type, or nullptr if the name is taken by another type
+     */
+    Entry* findOrAdd(const std::string& name, const std::string& help, const MetricLabels& labels, MetricType type);
+
+    std::string toPrometheus() const;
+    std::string toJson() const;
+
+    static std::atomic<bool> timingEnabled_;        ///< Whether ScopedLatency reads the clock
+    mutable std::mutex mutex_;                      ///< Guards entries_
+    std::vector<std::unique_ptr<Entry>> entries_;   ///< Registered metrics, in registration order
+};
+
+/**
+ * @class ScopedLatency
+ * @brief Records the lifetime of a scope into a histogram
+ *
+ * Does nothing, not even read the clock, while timing is disabled.
+ */
+class ScopedLatency {
+public:
+    /**
+     * @brief Start timing
+     * @param histogram Histogram receiving the latency; must outlive the timer
+     */
+    explicit ScopedLatency(Histogram& histogram)
+        : histogram_(MetricsRegistry::isTimingEnabled() ? &histogram : nullptr) {
+        if (histogram_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedLatency() {
+        if (histogram_) {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            histogram_->observe(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    Histogram* histogram_;                              ///< Target histogram, nullptr while timing is off
+    std::chrono::steady_clock::time_point start_;       ///< Start of the scope
+};
+
+/**
+ * @class MetricsExporter
+ * @brief Background thread writing registry snapshots to a file at an interval
+ *
+ * Starting an exporter enables latency timing for the rest of the process.
+ */
+class MetricsExporter {
+public:
+    MetricsExporter() = default;
+
+    /**
+     * @brief Destructor, stops the exporter
+     */
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    /**
+     * @brief Start exporting; the format follows the extension (.json for JSON, Prometheus text otherwise)
+     * @param path Destination file
+     * @param interval Time between snapshots, at least 1 ms
+     * @return True if the first snapshot could be written
+     */
+    bool start(const std::string& path, std::chrono::milliseconds interval);
+
+    /**
+     * @brief Parse an export interval given in seconds, as on the tools' command lines
+     * @param text Positive number of seconds, at most 1e6 (about 11 days)
+     * @param interval Set to the interval on success
+     * @return False for garbage, non-positive or out of range values
+     */
+    static bool parseInterval(const char* text, std::chrono::milliseconds& interval);
+
+    /**
+     * @brief Write a last snapshot and stop the thread
+     */
+    void stop();
+
+private:
+    void run();
+
+    std::string path_;                          ///< Destination file
+    MetricsFormat format_ = MetricsFormat::Prometheus;  ///< Output format
+    std::chrono::milliseconds interval_{0};     ///< Time between snapshots
+    std::thread thread_;                        ///< Export thread
+    std::mutex mutex_;                          ///< Guards stopping_
+    std::condition_variable wakeup_;            ///< Signals stop()
+    bool stopping_ = false;                     ///< Set by stop()
+};
+
+} // namespace util
+} // namespace deckstiny
+
+#endif // DECKSTINY_UTIL_METRICS_H
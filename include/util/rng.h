@@ -0,0 +1,145 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_UTIL_RNG_H
+#define DECKSTINY_UTIL_RNG_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace deckstiny {
+namespace util {
+
+/**
+ * @class Rng
+ * @brief Small, fast pseudo-random generator (xoshiro256**)
+ *
+ * 32 bytes of state instead of mt19937's 5 KB, so seeding and copying are
+ * cheap. Satisfies UniformRandomBitGenerator, but game code should prefer the
+ * helpers below: unlike the std distributions their output is specified here,
+ * so a seed produces the same run on every standard library.
+ */
+class Rng {
+public:
+    using result_type = uint64_t;
+
+    /**
+     * @brief Constructor
+     * @param seed Seed value; every seed, including 0, gives a valid state
+     */
+    explicit Rng(uint64_t seed = 0);
+
+    /**
+     * @brief Reset the generator to the sequence of a seed
+     * @param seed Seed value
+     */
+    void seed(uint64_t seed);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    /**
+     * @brief Generate the next 64 random bits
+     * @return Random value
+     */
+    result_type operator()() {
+        const uint64_t result = rotl(state_[1] * 5, 7) * 9;
+        const uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+        return result;
+    }
+
+    /**
+     * @brief Generate an unbiased integer below a bound
+     * @param bound Exclusive upper bound (must be positive)
+     * @return Value in [0, bound)
+     */
+    uint64_t nextBelow(uint64_t bound);
+
+    /**
+     * @brief Generate an integer in a closed range
+     * @param lo Lower bound
+     * @param hi Upper bound (must be >= lo)
+     * @return Value in [lo, hi]
+     */
+    int uniformInt(int lo, int hi);
+
+    /**
+     * @brief Generate an index into a container
+     * @param count Number of elements (must be positive)
+     * @return Value in [0, count)
+     */
+    size_t index(size_t count) { return static_cast<size_t>(nextBelow(count)); }
+
+    /**
+     * @brief Generate a real number in [0, 1)
+     * @return Random value with 53 random bits
+     */
+    double uniformReal();
+
+    /**
+     * @brief Pick an index with probability proportional to its weight
+     * @param weights Non-negative weights
+     * @return Picked index, or 0 if all weights are zero
+     */
+    size_t weightedIndex(const std::vector<double>& weights);
+
+    /**
+     * @brief Shuffle a range (Fisher-Yates)
+     * @param first Start of the range
+     * @param last End of the range
+     */
+    template <typename RandomIt>
+    void shuffle(RandomIt first, RandomIt last) {
+        auto count = std::distance(first, last);
+        for (auto i = count - 1; i > 0; --i) {
+            using std::swap;
+            swap(first[i], first[static_cast<decltype(i)>(nextBelow(static_cast<uint64_t>(i) + 1))]);
+        }
+    }
+
+    /**
+     * @brief Derive an independent generator for a numbered stream
+     * @param streamId Stream number
+     * @return Generator whose sequence depends only on this state and streamId
+     *
+     * Does not advance this generator, so the streams split from a seed do
+     * not depend on how much any of them is used.
+     */
+    Rng split(uint64_t streamId) const;
+
+private:
+    static constexpr uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::array<uint64_t, 4> state_{};  ///< Generator state, never all zero
+};
+
+/**
+ * @brief Expand a seed into well-mixed 64-bit values (SplitMix64 step)
+ * @param state State advanced by each call
+ * @return Next mixed value
+ */
+uint64_t splitMix64(uint64_t& state);
+
+/**
+ * @brief Get a per-thread generator for code running outside a seeded run
+ * @return Generator seeded once per thread from std::random_device
+ */
+Rng& defaultRng();
+
+} // namespace util
+} // namespace deckstiny
+
+#endif // DECKSTINY_UTIL_RNG_H
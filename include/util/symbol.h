@@ -0,0 +1,212 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_UTIL_SYMBOL_H
+#define DECKSTINY_UTIL_SYMBOL_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace deckstiny {
+namespace util {
+
+/**
+ * @brief Built-in status effect names, in status slot order
+ *
+ * These occupy the handles right after the empty symbol, so a built-in status
+ * effect's slot is its handle minus one (see core/status_effect.h).
+ */
+#define DECKSTINY_STATUS_SYMBOLS(X)                 \
+    X(VULNERABLE, "vulnerable")                     \
+    X(WEAK, "weak")                                 \
+    X(STRENGTH, "strength")                         \
+    X(DEXTERITY, "dexterity")                       \
+    X(POISON, "poison")                             \
+    X(TEMPORARY_STRENGTH, "temporary_strength")     \
+    X(FRAIL, "frail")                               \
+    X(FIRST_ATTACK_BONUS, "first_attack_bonus")     \
+    X(RITUAL, "ritual")                             \
+    X(BURN, "burn")                                 \
+    X(SLOW, "slow")                                 \
+    X(BLEEDING, "bleeding")                         \
+    X(RAGE, "rage")                                 \
+    X(INTANGIBLE, "intangible")
+
+/**
+ * @brief Names interned before any content is loaded, in handle order
+ *
+ * Each entry gets a constant handle in the symbols namespace, so hot code can
+ * compare against e.g. symbols::WEAK without touching the table.
+ */
+#define DECKSTINY_PREDEFINED_SYMBOLS(X)             \
+    DECKSTINY_STATUS_SYMBOLS(X)                     \
+    X(INTENT_ATTACK, "attack")                      \
+    X(INTENT_ATTACK_DEFEND, "attack_defend")        \
+    X(INTENT_ATTACK_DEBUFF, "attack_debuff")        \
+    X(INTENT_DEFEND, "defend")                      \
+    X(INTENT_DEFEND_DEBUFF, "defend_debuff")        \
+    X(INTENT_BUFF, "buff")                          \
+    X(INTENT_DEBUFF, "debuff")                      \
+    X(INTENT_SUMMON, "summon")                      \
+    X(INTENT_UNKNOWN, "unknown")
+
+/**
+ * @class Symbol
+ * @brief 32-bit handle to a string interned in the SymbolTable
+ *
+ * Comparing and hashing symbols is an integer operation. Handle 0 is the
+ * empty string and doubles as "no symbol".
+ */
+class Symbol {
+public:
+    /**
+     * @brief Default constructor, the empty symbol
+     */
+    constexpr Symbol() = default;
+
+    /**
+     * @brief Constructor from a raw handle
+     * @param id Handle previously returned by the table
+     */
+    constexpr explicit Symbol(uint32_t id) : id_(id) {}
+
+    /**
+     * @brief Intern a string
+     * @param text String to intern
+     * @return Symbol for the string (existing one if already interned)
+     */
+    static Symbol intern(std::string_view text);
+
+    /**
+     * @brief Look up a string without interning it
+     * @param text String to look up
+     * @return Symbol for the string, or the empty symbol if it was never interned
+     */
+    static Symbol find(std::string_view text);
+
+    /**
+     * @brief Get the interned string
+     * @return Reference valid for the lifetime of the program
+     */
+    const std::string& str() const;
+
+    /**
+     * @brief Get the raw handle
+     * @return Handle value
+     */
+    constexpr uint32_t getId() const { return id_; }
+
+    /**
+     * @brief Check whether this is a non-empty symbol
+     * @return True if the handle is not 0
+     */
+    constexpr bool isValid() const { return id_ != 0; }
+
+    constexpr bool operator==(Symbol other) const { return id_ == other.id_; }
+    constexpr bool operator!=(Symbol other) const { return id_ != other.id_; }
+    constexpr bool operator<(Symbol other) const { return id_ < other.id_; }
+
+private:
+    uint32_t id_ = 0;  ///< Handle into the symbol table
+};
+
+namespace symbols {
+
+/// Handle indices of the predefined symbols
+enum PredefinedId : uint32_t {
+    EMPTY_ID = 0,
+#define DECKSTINY_SYMBOL_ID(name, text) name##_ID,
+    DECKSTINY_PREDEFINED_SYMBOLS(DECKSTINY_SYMBOL_ID)
+#undef DECKSTINY_SYMBOL_ID
+    PREDEFINED_COUNT
+};
+
+#define DECKSTINY_SYMBOL_CONSTANT(name, text) constexpr Symbol name{name##_ID};
+DECKSTINY_PREDEFINED_SYMBOLS(DECKSTINY_SYMBOL_CONSTANT)
+#undef DECKSTINY_SYMBOL_CONSTANT
+
+} // namespace symbols
+
+/**
+ * @class SymbolTable
+ * @brief Process-wide string interning table
+ *
+ * Interning takes a lock and is meant for load time. Names are stored in
+ * fixed-size chunks that never move, so resolving a handle back to its
+ * string does not lock.
+ */
+class SymbolTable {
+public:
+    /**
+     * @brief Get the singleton instance
+     * @return Reference to the symbol table
+     */
+    static SymbolTable& getInstance();
+
+    /**
+     * @brief Intern a string
+     * @param text String to intern
+     * @return Symbol for the string
+     */
+    Symbol intern(std::string_view text);
+
+    /**
+     * @brief Look up a string without interning it
+     * @param text String to look up
+     * @return Symbol for the string, or the empty symbol if not interned
+     */
+    Symbol find(std::string_view text) const;
+
+    /**
+     * @brief Get the string for a handle
+     * @param symbol Symbol to resolve
+     * @return Interned string (empty string for unknown handles)
+     */
+    const std::string& getName(Symbol symbol) const;
+
+    /**
+     * @brief Get the number of interned strings, including the empty one
+     * @return Symbol count
+     */
+    size_t size() const;
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+private:
+    static constexpr size_t CHUNK_BITS = 10;
+    static constexpr size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;
+    static constexpr size_t MAX_CHUNKS = 4096;
+
+    SymbolTable();
+
+    std::array<std::unique_ptr<std::string[]>, MAX_CHUNKS> chunks_;  ///< Interned names by handle
+    std::atomic<uint32_t> count_{0};                                  ///< Number of names published
+    std::unordered_map<std::string_view, uint32_t> ids_;              ///< Name to handle, views into chunks_
+    mutable std::shared_mutex mutex_;                                 ///< Protects ids_ and interning
+};
+
+} // namespace util
+} // namespace deckstiny
+
+namespace std {
+
+template <>
+struct hash<deckstiny::util::Symbol> {
+    size_t operator()(deckstiny::util::Symbol symbol) const noexcept {
+        return static_cast<size_t>(symbol.getId());
+    }
+};
+
+} // namespace std
+
+#endif // DECKSTINY_UTIL_SYMBOL_H
@@ -0,0 +1,85 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_UTIL_THREAD_POOL_H
+#define DECKSTINY_UTIL_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace deckstiny {
+namespace util {
+
+/**
+ * @class ThreadPool
+ * @brief Fixed-size pool of worker threads executing queued tasks
+ *
+ * Tasks are started in submission order; results are collected through
+ * the futures returned by submit(), so callers decide the order in which
+ * results are consumed.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Constructor
+     * @param threadCount Number of worker threads (0 selects the hardware concurrency)
+     */
+    explicit ThreadPool(size_t threadCount = 0);
+
+    /**
+     * @brief Destructor, finishes queued tasks and joins the workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queue a task for execution
+     * @param task Callable without arguments
+     * @return Future holding the task's result or exception
+     */
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(F&& task) {
+        using Result = std::invoke_result_t<F>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace_back([packaged]() { (*packaged)(); });
+        }
+        condition_.notify_one();
+        return future;
+    }
+
+    /**
+     * @brief Get the number of worker threads
+     * @return Worker count
+     */
+    size_t getThreadCount() const { return workers_.size(); }
+
+private:
+    std::vector<std::thread> workers_;            ///< Worker threads
+    std::deque<std::function<void()>> tasks_;     ///< Pending tasks
+    std::mutex mutex_;                            ///< Protects tasks_ and stopping_
+    std::condition_variable condition_;           ///< Signals new tasks or shutdown
+    bool stopping_ = false;                       ///< Whether the pool is shutting down
+
+    /**
+     * @brief Worker thread main loop
+     */
+    void workerLoop();
+};
+
+} // namespace util
+} // namespace deckstiny
+
+#endif // DECKSTINY_UTIL_THREAD_POOL_H
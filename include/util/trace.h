@@ -0,0 +1,200 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_UTIL_TRACE_H
+#define DECKSTINY_UTIL_TRACE_H
+
+#include "util/symbol.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace deckstiny {
+namespace util {
+
+/**
+ * @enum TraceEventType
+ * @brief Kind of a trace record, which decides what its fields mean
+ */
+enum class TraceEventType : uint16_t {
+    SYMBOL,             ///< Defines symbol subject; its text follows the record
+    CARD_PLAYED,        ///< subject card, object target enemy, a energy cost, b target index
+    DAMAGE_DEALT,       ///< subject character hit, a damage after Vulnerable, b health lost
+    STATUS_APPLIED,     ///< subject character, object status, a stacks added, b stacks now
+    INTENT_CHOSEN,      ///< subject enemy, object move, a move index, b intent value
+    STATE_CHANGED,      ///< subject previous game state, object new game state
+    COUNT               ///< Number of event types
+};
+
+/**
+ * @brief Get the name of a trace event type
+ * @param type Event type
+ * @return Name such as "CARD_PLAYED"
+ */
+const char* traceEventName(TraceEventType type);
+
+/**
+ * @struct TraceRecord
+ * @brief Fixed-layout trace record, written to the file as is
+ *
+ * Strings are symbol ids. The first record naming a symbol is preceded by a
+ * SYMBOL record defining it, whose text follows it padded to 8 bytes.
+ */
+struct TraceRecord {
+    uint64_t time = 0;      ///< Nanoseconds since the trace was opened
+    uint32_t thread = 0;    ///< Index of the recording thread
+    uint16_t type = 0;      ///< TraceEventType
+    uint16_t length = 0;    ///< Length of the text of a SYMBOL record, 0 otherwise
+    uint32_t subject = 0;   ///< Symbol id
+    uint32_t object = 0;    ///< Symbol id
+    int32_t a = 0;          ///< First value
+    int32_t b = 0;          ///< Second value
+};
+
+static_assert(sizeof(TraceRecord) == 32, "trace records are 32 bytes on disk");
+
+/**
+ * @struct TraceFileHeader
+ * @brief Header at the start of a trace file
+ */
+struct TraceFileHeader {
+    char magic[8] = {'D', 'K', 'S', 'T', 'R', 'A', 'C', 'E'};     ///< File signature
+    uint32_t version = 1;                                           ///< Format version
+    uint32_t recordSize = sizeof(TraceRecord);                      ///< Size of one record
+    uint32_t byteOrder = 0x01020304;                                ///< Reads back differently on a foreign byte order
+    uint32_t reserved = 0;                                          ///< Padding
+};
+
+/**
+ * @class Trace
+ * @brief Process-wide binary trace of typed game events
+ *
+ * Each thread appends records to its own buffer without locking and writes
+ * the whole buffer to the file when it fills up, so recording an event is a
+ * clock read and a 32-byte copy. While no trace is open, TRACE_RECORD costs a
+ * single flag check and does not evaluate its arguments.
+ */
+class Trace {
+public:
+    /// Records a thread buffers before writing them to the file
+    static constexpr size_t BUFFER_RECORDS = 4096;
+
+    /**
+     * @brief Start tracing to a file, closing any open trace
+     * @param path File to write
+     * @return True if the file could be created
+     */
+    static bool open(const std::string& path);
+
+    /**
+     * @brief Write every buffered record and close the file
+     *
+     * Threads other than the caller must not be recording any more; their
+     * buffers are written by this call.
+     */
+    static void close();
+
+    /**
+     * @brief Write the calling thread's buffered records to the file
+     */
+    static void flush();
+
+    /**
+     * @brief Check whether events of the calling thread are being recorded
+     * @return True if a trace is open and recording is not suspended on this thread
+     */
+    static bool isEnabled() { return enabled_.load(std::memory_order_relaxed) && suspended_ == 0; }
+
+    /**
+     * @brief Record an event; use TRACE_RECORD, which skips this when disabled
+     * @param type Event type
+     * @param subject First string of the event
+     * @param object Second string of the event
+     * @param a First value
+     * @param b Second value
+     */
+    static void record(TraceEventType type, Symbol subject, Symbol object, int32_t a, int32_t b);
+
+private:
+    friend class TraceSuspension;
+
+    static std::atomic<bool> enabled_;          ///< Whether a trace is open
+    static inline thread_local int suspended_ = 0;  ///< Live TraceSuspension scopes on this thread
+};
+
+/**
+ * @class TraceSuspension
+ * @brief Stops the calling thread from recording for the lifetime of the object
+ *
+ * Speculative work such as tree search playouts runs on forked combats whose
+ * events never happen in the game; suspending keeps them out of the trace.
+ * Scopes nest.
+ */
+class TraceSuspension {
+public:
+    TraceSuspension() { ++Trace::suspended_; }
+    ~TraceSuspension() { --Trace::suspended_; }
+
+    TraceSuspension(const TraceSuspension&) = delete;
+    TraceSuspension& operator=(const TraceSuspension&) = delete;
+};
+
+/**
+ * @class TraceReader
+ * @brief Reads the records of a trace file back, resolving its symbols
+ */
+class TraceReader {
+public:
+    /**
+     * @brief Open a trace file and check its header
+     * @param path File to read
+     * @return True if the file is a trace this build can read
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Read the next event record, taking in the symbols defined before it
+     * @param record Receives the record
+     * @return False at the end of the file, on a truncated record or on an out of range symbol id
+     */
+    bool next(TraceRecord& record);
+
+    /**
+     * @brief Get the text of a symbol defined so far
+     * @param id Symbol id from a record
+     * @return Text, empty for unknown ids
+     */
+    const std::string& symbol(uint32_t id) const;
+
+    /**
+     * @brief Get the error of the last failed call
+     * @return Error message, empty if none
+     */
+    const std::string& getError() const { return error_; }
+
+private:
+    std::ifstream in_;                  ///< Trace file
+    std::vector<std::string> symbols_;  ///< Symbol texts by id
+    uint64_t maxSymbolId_ = 0;          ///< Largest symbol id accepted from this file
+    std::string error_;                 ///< Last error
+};
+
+} // namespace util
+} // namespace deckstiny
+
+/**
+ * @brief Record a trace event if a trace is open; arguments are not evaluated otherwise
+ * @param type TraceEventType enumerator name, e.g. CARD_PLAYED
+ */
+#define TRACE_RECORD(type, subject, object, a, b) \
+    do { \
+        if (::deckstiny::util::Trace::isEnabled()) { \
+            ::deckstiny::util::Trace::record(::deckstiny::util::TraceEventType::type, (subject), (object), \
+                                             static_cast<int32_t>(a), static_cast<int32_t>(b)); \
+        } \
+    } while (false)
+
+#endif // DECKSTINY_UTIL_TRACE_H
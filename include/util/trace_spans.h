@@ -0,0 +1,124 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_UTIL_TRACE_SPANS_H
+#define DECKSTINY_UTIL_TRACE_SPANS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Whether TRACE_SCOPE records spans; 0 compiles them out
+ *
+ * Set with the DECKSTINY_TRACE_SPANS CMake option.
+ */
+#ifndef DECKSTINY_TRACE_SPANS
+#define DECKSTINY_TRACE_SPANS 0
+#endif
+
+namespace deckstiny {
+namespace util {
+
+/**
+ * @class SpanTrace
+ * @brief Process-wide capture of timed spans, written as Chrome trace_event JSON
+ *
+ * Each thread appends finished spans to its own buffer without locking.
+ * stop() gathers the buffers, including those of threads that have exited,
+ * into one JSON file that chrome://tracing and Perfetto open directly.
+ */
+class SpanTrace {
+public:
+    /// Spans a thread keeps per capture; later ones are dropped and counted
+    static constexpr size_t MAX_THREAD_SPANS = size_t(1) << 20;
+
+    /**
+     * @brief Start capturing spans, discarding any earlier capture
+     */
+    static void start();
+
+    /**
+     * @brief Stop capturing and write the captured spans
+     *
+     * Threads other than the caller must not be recording any more; their
+     * buffers are read by this call.
+     * @param path JSON file to write
+     * @return True if the file was written
+     */
+    static bool stop(const std::string& path);
+
+    /**
+     * @brief Check whether spans are being captured
+     * @return True between start() and stop()
+     */
+    static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the current time on the span clock
+     * @return Nanoseconds on a steady clock
+     */
+    static int64_t now();
+
+    /**
+     * @brief Record a finished span
+     * @param category Category; must be a string literal or otherwise outlive the capture
+     * @param name Span name; same lifetime requirement
+     * @param start Start time from now()
+     * @param end End time from now()
+     */
+    static void record(const char* category, const char* name, int64_t start, int64_t end);
+
+private:
+    static std::atomic<bool> enabled_;  ///< Whether a capture is running
+};
+
+/**
+ * @class ScopedSpan
+ * @brief Records the lifetime of a scope as a span; use TRACE_SCOPE
+ */
+class ScopedSpan {
+public:
+    /**
+     * @brief Start the span if a capture is running
+     * @param category Category literal
+     * @param name Name literal
+     */
+    ScopedSpan(const char* category, const char* name)
+        : category_(category), name_(name), start_(SpanTrace::isEnabled() ? SpanTrace::now() : -1) {}
+
+    ~ScopedSpan() {
+        if (start_ >= 0) {
+            SpanTrace::record(category_, name_, start_, SpanTrace::now());
+        }
+    }
+
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+private:
+    const char* category_;  ///< Category
+    const char* name_;      ///< Span name
+    int64_t start_;         ///< Start time, -1 if no capture was running
+};
+
+} // namespace util
+} // namespace deckstiny
+
+#define DECKSTINY_SPAN_CONCAT_INNER(a, b) a##b
+#define DECKSTINY_SPAN_CONCAT(a, b) DECKSTINY_SPAN_CONCAT_INNER(a, b)
+
+/**
+ * @brief Record the rest of the enclosing scope as a span, e.g. TRACE_SCOPE("combat", "enemy_turn")
+ *
+ * Expands to nothing unless DECKSTINY_TRACE_SPANS is set.
+ */
+#if DECKSTINY_TRACE_SPANS
+#define TRACE_SCOPE(category, name) \
+    ::deckstiny::util::ScopedSpan DECKSTINY_SPAN_CONCAT(traceScope, __LINE__)(category, name)
+#else
+#define TRACE_SCOPE(category, name) static_cast<void>(0)
+#endif
+
+#endif // DECKSTINY_UTIL_TRACE_SPANS_H
@@ -0,0 +1,62 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#ifndef DECKSTINY_UTIL_WORK_STEALING_H
+#define DECKSTINY_UTIL_WORK_STEALING_H
+
+#include <cstddef>
+#include <functional>
+
+namespace deckstiny {
+namespace util {
+
+/**
+ * @class WorkStealingScheduler
+ * @brief Splits an index range across threads, idle threads stealing from busy ones
+ *
+ * Every worker starts with an equal slice of the range and takes it in
+ * grain-sized chunks from the front. A worker whose slice runs out takes the
+ * back half of another worker's remaining slice, so uneven chunks (e.g. long
+ * and short fights) still keep every core busy until the end.
+ */
+class WorkStealingScheduler {
+public:
+    /**
+     * @brief Chunk callback
+     *
+     * Called as body(worker, begin, end) for disjoint chunks that together
+     * cover the range. Calls with the same worker index never overlap.
+     */
+    using Body = std::function<void(size_t, size_t, size_t)>;
+
+    /**
+     * @brief Constructor
+     * @param threadCount Number of workers (0 selects the hardware concurrency)
+     */
+    explicit WorkStealingScheduler(size_t threadCount = 0);
+
+    /**
+     * @brief Get the number of workers
+     * @return Worker count, including the calling thread
+     */
+    size_t getThreadCount() const { return threadCount_; }
+
+    /**
+     * @brief Process [0, count) and wait for it to finish
+     * @param count Number of indices
+     * @param grain Indices a worker takes from its own slice at a time
+     * @param body Chunk callback
+     *
+     * The calling thread works as worker 0. If the callback throws, the
+     * remaining chunks are skipped and the first exception is rethrown here.
+     */
+    void run(size_t count, size_t grain, const Body& body);
+
+private:
+    size_t threadCount_;  ///< Number of workers
+};
+
+} // namespace util
+} // namespace deckstiny
+
+#endif // DECKSTINY_UTIL_WORK_STEALING_H
@@ -5,52 +5,149 @@
 #include "core/player.h"
 #include "core/enemy.h"
 #include "core/combat.h"
-#include "core/game.h"
+#include "core/combat_state.h"
 #include "util/logger.h"
-#include "util/path_util.h"
+#include "util/trace_spans.h"
 
-#include <fstream>
+#include <algorithm>
+#include <cmath>
 #include <nlohmann/json.hpp>
-#include <sys/stat.h>
 
 namespace deckstiny {
 
+namespace {
+
+// Name a card gets when upgraded without explicit upgrade details
+std::string plusName(const std::string& name) {
+    return name.rfind('+') == std::string::npos ? name + "+" : name;
+}
+
+const std::shared_ptr<const CardDef>& emptyCardDef() {
+    static const std::shared_ptr<const CardDef> def = [] {
+        auto empty = std::make_shared<CardDef>();
+        empty->costUpgraded = empty->cost - 1;
+        empty->nameUpgraded = plusName(empty->name);
+        return empty;
+    }();
+    return def;
+}
+
+} // namespace
+
+Card::Card() : def_(emptyCardDef()) {
+}
+
 Card::Card(const std::string& id, const std::string& name, const std::string& description,
            CardType type, CardRarity rarity, CardTarget target, int cost, bool upgradable)
-    : Entity(id, name), description_(description), type_(type), rarity_(rarity), 
-      target_(target), cost_(cost), upgradable_(upgradable), upgraded_(false) {
+    : Entity(id, "") {
+    auto def = std::make_shared<CardDef>();
+    def->name = name;
+    def->nameUpgraded = plusName(name);
+    def->description = description;
+    def->descriptionUpgraded = description;
+    def->type = type;
+    def->rarity = rarity;
+    def->target = target;
+    def->cost = cost;
+    def->costUpgraded = cost > 0 ? cost - 1 : cost;
+    def->upgradable = upgradable;
+    def_ = std::move(def);
+}
+
+Card::Card(const std::string& id, std::shared_ptr<const CardDef> def)
+    : Entity(id, ""), def_(def ? std::move(def) : emptyCardDef()) {
+}
+
+const std::string& Card::getName() const {
+    return upgraded_ ? def_->nameUpgraded : def_->name;
+}
+
+void Card::setName(const std::string& name) {
+    CardDef& def = detachDef();
+    if (upgraded_) {
+        def.nameUpgraded = name;
+    } else {
+        def.name = name;
+        if (!def.hasUpgradeDetails) {
+            def.nameUpgraded = plusName(name);
+        }
+    }
+}
+
+const std::shared_ptr<const CardDef>& Card::getDef() const {
+    return def_;
+}
+
+CardDef& Card::detachDef() {
+    auto copy = std::make_shared<CardDef>(*def_);
+    CardDef& def = *copy;
+    def_ = std::move(copy);
+    return def;
 }
 
 const std::string& Card::getDescription() const {
-    return description_;
+    return upgraded_ ? def_->descriptionUpgraded : def_->description;
 }
 
 void Card::setDescription(const std::string& description) {
-    description_ = description;
+    CardDef& def = detachDef();
+    if (upgraded_) {
+        def.descriptionUpgraded = description;
+    } else {
+        def.description = description;
+        if (!def.hasUpgradeDetails) {
+            def.descriptionUpgraded = description;
+        }
+    }
 }
 
 CardType Card::getType() const {
-    return type_;
+    return def_->type;
 }
 
 CardRarity Card::getRarity() const {
-    return rarity_;
+    return def_->rarity;
 }
 
 CardTarget Card::getTarget() const {
-    return target_;
+    return def_->target;
 }
 
 int Card::getCost() const {
-    return cost_;
+    int cost = costOverride_ >= 0 ? costOverride_ : (upgraded_ ? def_->costUpgraded : def_->cost);
+    return combatCostModifier_ != 0 ? std::max(0, cost + combatCostModifier_) : cost;
 }
 
 void Card::setCost(int cost) {
-    cost_ = std::max(0, cost);
+    costOverride_ = std::max(0, cost);
+}
+
+int Card::getCombatCostModifier() const {
+    return combatCostModifier_;
+}
+
+void Card::setCombatCostModifier(int modifier) {
+    combatCostModifier_ = modifier;
+}
+
+void Card::resetCombatState() {
+    combatCostModifier_ = 0;
+}
+
+void Card::saveState(CardState& state) const {
+    state.costOverride = static_cast<int16_t>(costOverride_);
+    state.combatCostModifier = static_cast<int16_t>(combatCostModifier_);
+    state.upgraded = upgraded_ ? 1 : 0;
+}
+
+void Card::restoreState(const CardState& state) {
+    costOverride_ = state.costOverride;
+    combatCostModifier_ = state.combatCostModifier;
+    upgraded_ = state.upgraded != 0;
 }
 
 bool Card::isUpgradable() const {
-    return upgradable_;
+    return def_->upgradable;
 }
 
 bool Card::isUpgraded() const {
@@ -58,37 +155,18 @@ bool Card::isUpgraded() const {
 }
 
 bool Card::upgrade() {
-    if (!upgradable_ || upgraded_) {
+    if (!def_->upgradable || upgraded_) {
         return false;
     }
     
     upgraded_ = true;
-    
-    if (hasUpgradeDetails_) {
-        if (!nameUpgraded_.empty() && nameUpgraded_ != getName()) {
-            setName(nameUpgraded_);
-        }
-        if (!descriptionUpgraded_.empty()) {
-            description_ = descriptionUpgraded_;
-        }
-        if (costUpgraded_ != -1 && costUpgraded_ != cost_) {
-            cost_ = costUpgraded_;
-        }
-        if (damageUpgraded_ != -1) {
-            damage_ = damageUpgraded_;
-        }
-        if (blockUpgraded_ != -1) {
-            block_ = blockUpgraded_;
-        }
-        if (magicNumberUpgraded_ != -1) {
-            magicNumber_ = magicNumberUpgraded_;
-        }
-    } else {
-    if (cost_ > 0) {
-        cost_--;
-        }
-        if (getName().rfind('+') == std::string::npos) {
-             setName(getName() + "+");
+
+    // Name, description, cost and effect values switch to the definition's upgraded set
+    if (costOverride_ >= 0) {
+        if (def_->hasUpgradeDetails) {
+            costOverride_ = -1;
+        } else if (costOverride_ > 0) {
+            costOverride_--;
         }
     }
     
@@ -97,46 +175,45 @@ bool Card::upgrade() {
 
 bool Card::canPlay(Player* player, int targetIndex, Combat* combat) const {
     if (!player || !combat) {
-        LOG_DEBUG("card_canPlay", "Called with null player or combat. Card: " + getName());
+        LOG_DEBUGF("card_canPlay", "Called with null player or combat. Card: {}", getName());
         return false;
     }
     
     int currentEnergy = player->getEnergy();
-    LOG_DEBUG("card_canPlay", "Card: " + getName() + ", Player Energy: " + std::to_string(currentEnergy) + ", Card Cost: " + std::to_string(cost_));
+    int cost = getCost();
+    LOG_DEBUGF("card_canPlay", "Card: {}, Player Energy: {}, Card Cost: {}", getName(), currentEnergy, cost);
     
-    if (currentEnergy < cost_) {
-        LOG_DEBUG("card_canPlay", "Energy check FAILED for " + getName() + ". Player Energy: " + std::to_string(currentEnergy) + " < Card Cost: " + std::to_string(cost_));
+    if (currentEnergy < cost) {
+        LOG_DEBUGF("card_canPlay", "Energy check FAILED for {}. Player Energy: {} < Card Cost: {}", getName(), currentEnergy, cost);
         return false;
     }
-    LOG_DEBUG("card_canPlay", "Energy check PASSED for " + getName() + ". Player Energy: " + std::to_string(currentEnergy) + " >= Card Cost: " + std::to_string(cost_));
+    LOG_DEBUGF("card_canPlay", "Energy check PASSED for {}. Player Energy: {} >= Card Cost: {}", getName(), currentEnergy, cost);
     
-    switch (target_) {
+    switch (def_->target) {
         case CardTarget::NONE:
-            LOG_DEBUG("card_canPlay", "Target check PASSED for " + getName() + " (NONE target). Returning true.");
+            LOG_DEBUGF("card_canPlay", "Target check PASSED for {} (NONE target). Returning true.", getName());
             return true;
             
         case CardTarget::SELF:
-            LOG_DEBUG("card_canPlay", "Target check PASSED for " + getName() + " (SELF target, index: " + std::to_string(targetIndex) + "). Returning true.");
+            LOG_DEBUGF("card_canPlay", "Target check PASSED for {} (SELF target, index: {}). Returning true.", getName(), targetIndex);
             return true;
             
         case CardTarget::SINGLE_ENEMY: {
             bool targetValid = targetIndex >= 0 && targetIndex < static_cast<int>(combat->getEnemyCount()) &&
                    combat->getEnemy(targetIndex) && combat->getEnemy(targetIndex)->isAlive();
-            LOG_DEBUG("card_canPlay", "Target check (SINGLE_ENEMY) for " + getName() + ": targetIndex=" + std::to_string(targetIndex) +
-                                     ", enemyCount=" + std::to_string(combat->getEnemyCount()) +
-                                     ", getEnemy(idx) valid=" + (combat->getEnemy(targetIndex) ? "true" : "false") +
-                                     ", isAlive=" + (combat->getEnemy(targetIndex) && combat->getEnemy(targetIndex)->isAlive() ? "true" : "false") +
-                                     ", PlayerEnergy=" + std::to_string(player->getEnergy()) +
-                                     ". Result: " + (targetValid ? "PASSED" : "FAILED"));
+            LOG_DEBUGF("card_canPlay", "Target check (SINGLE_ENEMY) for {}: targetIndex={}, enemyCount={}, getEnemy(idx) valid={}, isAlive={}, PlayerEnergy={}. Result: {}",
+                       getName(), targetIndex, combat->getEnemyCount(), combat->getEnemy(targetIndex) != nullptr,
+                       combat->getEnemy(targetIndex) && combat->getEnemy(targetIndex)->isAlive(), player->getEnergy(),
+                       targetValid ? "PASSED" : "FAILED");
             return targetValid;
         }
             
         case CardTarget::ALL_ENEMIES:
-            LOG_DEBUG("card_canPlay", "Target check PASSED for " + getName() + " (ALL_ENEMIES target). Returning true.");
+            LOG_DEBUGF("card_canPlay", "Target check PASSED for {} (ALL_ENEMIES target). Returning true.", getName());
             return true;
             
         case CardTarget::SINGLE_ALLY:
-            LOG_DEBUG("card_canPlay", "Target check FAILED for " + getName() + " (SINGLE_ALLY target - Not Implemented). Returning false.");
+            LOG_DEBUGF("card_canPlay", "Target check FAILED for {} (SINGLE_ALLY target - Not Implemented). Returning false.", getName());
             return false;
             
         case CardTarget::ALL_ALLIES:
@@ -156,13 +233,14 @@ bool Card::play(Player* player, int targetIndex, Combat* combat) {
         return false;
     }
     
-    LOG_DEBUG("card_play", getName() + " canPlay() passed. Player energy before useEnergy: " + std::to_string(player->getEnergy()) + ", Card cost: " + std::to_string(cost_));
+    int cost = getCost();
+    LOG_DEBUG("card_play", getName() + " canPlay() passed. Player energy before useEnergy: " + std::to_string(player->getEnergy()) + ", Card cost: " + std::to_string(cost));
 
-    if (!player->useEnergy(cost_)) {
-        LOG_ERROR("card_play", getName() + " player->useEnergy(" + std::to_string(cost_) + ") FAILED. Player energy was: " + std::to_string(player->getEnergy()) + " (This should not happen if canPlay passed for positive cost cards).");
+    if (!player->useEnergy(cost)) {
+        LOG_ERROR("card_play", getName() + " player->useEnergy(" + std::to_string(cost) + ") FAILED. Player energy was: " + std::to_string(player->getEnergy()) + " (This should not happen if canPlay passed for positive cost cards).");
         return false;
     }
-    LOG_DEBUG("card_play", getName() + " player->useEnergy(" + std::to_string(cost_) + ") SUCCEEDED. Player energy after useEnergy: " + std::to_string(player->getEnergy()));
+    LOG_DEBUG("card_play", getName() + " player->useEnergy(" + std::to_string(cost) + ") SUCCEEDED. Player energy after useEnergy: " + std::to_string(player->getEnergy()));
     
     const auto& hand = player->getHand();
     int cardIndex = -1;
@@ -184,7 +262,7 @@ bool Card::play(Player* player, int targetIndex, Combat* combat) {
     LOG_DEBUG("card_play", "onPlay for " + getName() + " returned: " + (successOnPlay ? "true" : "false"));
     
     if (successOnPlay) {
-        if (type_ != CardType::POWER) {
+        if (def_->type != CardType::POWER) {
             std::vector<int> indices = {cardIndex};
             player->discardCards(indices);
             LOG_INFO("card", "Card " + getName() + " moved to discard pile");
@@ -204,63 +282,69 @@ bool Card::loadFromJson(const nlohmann::json& json) {
     }
     
     try {
+        auto def = std::make_shared<CardDef>(*def_);
+
+        if (json.contains("name")) {
+            def->name = json["name"].get<std::string>();
+        }
+
         if (json.contains("description")) {
-            description_ = json["description"].get<std::string>();
+            def->description = json["description"].get<std::string>();
         }
         
         if (json.contains("type")) {
             std::string typeStr = json["type"].get<std::string>();
             if (typeStr == "ATTACK") {
-                type_ = CardType::ATTACK;
+                def->type = CardType::ATTACK;
             } else if (typeStr == "SKILL") {
-                type_ = CardType::SKILL;
+                def->type = CardType::SKILL;
             } else if (typeStr == "POWER") {
-                type_ = CardType::POWER;
+                def->type = CardType::POWER;
             } else if (typeStr == "STATUS") {
-                type_ = CardType::STATUS;
+                def->type = CardType::STATUS;
             } else if (typeStr == "CURSE") {
-                type_ = CardType::CURSE;
+                def->type = CardType::CURSE;
             }
         }
         
         if (json.contains("rarity")) {
             std::string rarityStr = json["rarity"].get<std::string>();
             if (rarityStr == "COMMON") {
-                rarity_ = CardRarity::COMMON;
+                def->rarity = CardRarity::COMMON;
             } else if (rarityStr == "UNCOMMON") {
-                rarity_ = CardRarity::UNCOMMON;
+                def->rarity = CardRarity::UNCOMMON;
             } else if (rarityStr == "RARE") {
-                rarity_ = CardRarity::RARE;
+                def->rarity = CardRarity::RARE;
             } else if (rarityStr == "SPECIAL") {
-                rarity_ = CardRarity::SPECIAL;
+                def->rarity = CardRarity::SPECIAL;
             } else if (rarityStr == "BASIC") {
-                rarity_ = CardRarity::BASIC;
+                def->rarity = CardRarity::BASIC;
             }
         }
         
         if (json.contains("target")) {
             std::string targetStr = json["target"].get<std::string>();
             if (targetStr == "NONE") {
-                target_ = CardTarget::NONE;
+                def->target = CardTarget::NONE;
             } else if (targetStr == "SELF") {
-                target_ = CardTarget::SELF;
+                def->target = CardTarget::SELF;
             } else if (targetStr == "SINGLE_ENEMY") {
-                target_ = CardTarget::SINGLE_ENEMY;
+                def->target = CardTarget::SINGLE_ENEMY;
             } else if (targetStr == "ALL_ENEMIES") {
-                target_ = CardTarget::ALL_ENEMIES;
+                def->target = CardTarget::ALL_ENEMIES;
             } else if (targetStr == "SINGLE_ALLY") {
-                target_ = CardTarget::SINGLE_ALLY;
+                def->target = CardTarget::SINGLE_ALLY;
             } else if (targetStr == "ALL_ALLIES") {
-                target_ = CardTarget::ALL_ALLIES;
+                def->target = CardTarget::ALL_ALLIES;
             }
         }
         
         if (json.contains("cost")) {
-            cost_ = json["cost"].get<int>();
+            def->cost = json["cost"].get<int>();
         }
         
         if (json.contains("upgradable")) {
-            upgradable_ = json["upgradable"].get<bool>();
+            def->upgradable = json["upgradable"].get<bool>();
         }
         
         if (json.contains("upgraded")) {
@@ -268,37 +352,57 @@ bool Card::loadFromJson(const nlohmann::json& json) {
         }
         
         if (json.contains("damage")) {
-            damage_ = json["damage"].get<int>();
+            def->damage = json["damage"].get<int>();
         }
         if (json.contains("block")) {
-            block_ = json["block"].get<int>();
+            def->block = json["block"].get<int>();
         }
         if (json.contains("magic_number")) {
-            magicNumber_ = json["magic_number"].get<int>();
+            def->magicNumber = json["magic_number"].get<int>();
         }
 
         if (json.contains("class")) {
-            classRestriction_ = json["class"].get<std::string>();
-            std::transform(classRestriction_.begin(), classRestriction_.end(), 
-                         classRestriction_.begin(), ::toupper);
+            def->classRestriction = json["class"].get<std::string>();
+            std::transform(def->classRestriction.begin(), def->classRestriction.end(), 
+                         def->classRestriction.begin(), ::toupper);
             // Special case: "ALL" means available to all classes
-            if (classRestriction_ == "ALL") {
-                LOG_INFO("card", "Card " + getName() + " is available to all classes");
-            } else if (!classRestriction_.empty()) {
-                LOG_INFO("card", "Card " + getName() + " is restricted to class: " + classRestriction_);
+            if (def->classRestriction == "ALL") {
+                LOG_INFO("card", "Card " + def->name + " is available to all classes");
+            } else if (!def->classRestriction.empty()) {
+                LOG_INFO("card", "Card " + def->name + " is restricted to class: " + def->classRestriction);
             }
         }
         
         if (json.contains("upgrade_details") && json["upgrade_details"].is_object()) {
             const auto& upgradeJson = json["upgrade_details"];
-            hasUpgradeDetails_ = true;
-            nameUpgraded_ = upgradeJson.value("name", getName() + "+"); 
-            descriptionUpgraded_ = upgradeJson.value("description", description_);
-            costUpgraded_ = upgradeJson.value("cost", cost_);
-            damageUpgraded_ = upgradeJson.value("damage", damage_); 
-            blockUpgraded_ = upgradeJson.value("block", block_);
-            magicNumberUpgraded_ = upgradeJson.value("magic_number", magicNumber_);
+            def->hasUpgradeDetails = true;
+            def->nameUpgraded = upgradeJson.value("name", def->name + "+"); 
+            def->descriptionUpgraded = upgradeJson.value("description", def->description);
+            def->costUpgraded = upgradeJson.value("cost", def->cost);
+            def->damageUpgraded = upgradeJson.value("damage", def->damage); 
+            def->blockUpgraded = upgradeJson.value("block", def->block);
+            def->magicNumberUpgraded = upgradeJson.value("magic_number", def->magicNumber);
+            if (def->nameUpgraded.empty()) {
+                def->nameUpgraded = def->name;
+            }
+            if (def->descriptionUpgraded.empty()) {
+                def->descriptionUpgraded = def->description;
+            }
+        } else {
+            def->hasUpgradeDetails = false;
+            def->nameUpgraded = plusName(def->name);
+            def->descriptionUpgraded = def->description;
+            def->costUpgraded = def->cost > 0 ? def->cost - 1 : def->cost;
+        }
+
+        if (json.contains("effects") && json["effects"].is_array()) {
+            compileEffects(*def, json["effects"]);
+        } else {
+            LOG_WARNING("card", "No 'effects' array in JSON for card: " + getId());
         }
+
+        def_ = std::move(def);
+        costOverride_ = -1;
         
         return true;
     } catch (const std::exception& e) {
@@ -316,221 +420,225 @@ std::shared_ptr<Card> Card::cloneCard() const {
 }
 
 bool Card::onPlay(Player* player, int targetIndex, Combat* combat) {
-    std::string prefix = get_data_path_prefix();
+    TRACE_SCOPE("card", "on_play");
+    if (!def_->hasEffectProgram) {
+        LOG_DEBUG("card_onPlay", "No effect program for card: " + getId() + ", using fallback effect");
+        return fallbackCardEffect(player, targetIndex, combat);
+    }
 
-    try {
-        std::string jsonFilePath = prefix + "data/cards/" + getId() + ".json";
-        LOG_DEBUG("card_onPlay", "Attempting to open card JSON with get_data_path_prefix: " + jsonFilePath);
+    bool overallSuccess = true;
 
-        std::ifstream file(jsonFilePath);
-        if (!file.is_open()) {
-            LOG_ERROR("card_onPlay", "Failed to open card JSON: " + jsonFilePath);
-            return fallbackCardEffect(player, targetIndex, combat);
-        }
-        
-        nlohmann::json cardData;
-        file >> cardData;
-        
-        if (!cardData.contains("effects") || !cardData["effects"].is_array()) {
-            LOG_WARNING("card_onPlay", "No 'effects' array in JSON for card: " + getId());
-            return fallbackCardEffect(player, targetIndex, combat);
-        }
-        
-        bool overallSuccess = true;
-        
-        for (const auto& effectJson : cardData["effects"]) {
-            std::string effectType = effectJson.value("type", "");
-            std::string effectTargetType = effectJson.value("target", "");
-
-            int currentValue = 0;
-            if (effectType == "damage" || effectType == "block") {
-                currentValue = effectJson.value("value", 0);
-                if (this->upgraded_ && effectJson.contains("upgraded_value")) {
-                    currentValue = effectJson.value("upgraded_value", currentValue);
-                }
-            } else if (effectType == "apply_vulnerable" || effectType == "apply_weak" || effectType == "gain_strength") {
-                currentValue = effectJson.value("value", 0);
-                if (this->upgraded_) {
-                    if (effectJson.contains("upgraded_value")) {
-                        currentValue = effectJson.value("upgraded_value", currentValue);
-                    } else if (magicNumberUpgraded_ != -1) {
-                        currentValue = magicNumberUpgraded_;
-                    } 
-                } else if (effectJson.contains("value")){
-                     currentValue = effectJson.value("value", 0);
-                } else {
-                     currentValue = magicNumber_;
+    for (const auto& effect : getEffects()) {
+        bool effectSuccess = false;
+
+        switch (effect.op) {
+            case CardEffectOp::NONE:
+                continue;
+
+            case CardEffectOp::DAMAGE_TARGET: {
+                Enemy* enemy = combat->getEnemy(targetIndex);
+                if (enemy) {
+                    if (dealDamageToEnemy(player, combat, static_cast<size_t>(targetIndex), effect.value) &&
+                        combat->areAllEnemiesDefeated() && !combat->isCombatOver()) {
+                        combat->end(true);
+                    }
+                    effectSuccess = true;
                 }
-            } else if (effectType == "draw") {
-                currentValue = effectJson.value("value", 0);
-                if (this->upgraded_ && effectJson.contains("upgraded_value")) {
-                    currentValue = effectJson.value("upgraded_value", currentValue);
+                break;
+            }
+
+            case CardEffectOp::DAMAGE_ALL_ENEMIES: {
+                bool anyEnemyDefeated = false;
+                for (size_t i = 0; i < combat->getEnemyCount(); ++i) {
+                    Enemy* enemy = combat->getEnemy(i);
+                    if (enemy && enemy->isAlive()) {
+                        anyEnemyDefeated = dealDamageToEnemy(player, combat, i, effect.value) || anyEnemyDefeated;
+                    }
                 }
-            } else {
-                currentValue = effectJson.value("value", 0);
-                if (this->upgraded_ && effectJson.contains("upgraded_value")) {
-                    currentValue = effectJson.value("upgraded_value", currentValue);
+                if (anyEnemyDefeated && combat->areAllEnemiesDefeated() && !combat->isCombatOver()) {
+                    combat->end(true);
                 }
+                effectSuccess = true;
+                break;
             }
 
-            bool effectSuccess = false;
-            if (effectType == "damage") {
-                if (target_ == CardTarget::SINGLE_ENEMY) {
-                    Enemy* enemy = combat->getEnemy(targetIndex);
-                    if (enemy) {
-                        int finalDamage = currentValue;
-                        if (player && player->hasStatusEffect("weak")) {
-                            finalDamage = static_cast<int>(std::round(finalDamage * 0.75));
-                            LOG_DEBUG("card_onPlay", "Player is Weak, damage reduced to " + std::to_string(finalDamage));
-                        }
-                        enemy->takeDamage(finalDamage); 
-                        effectSuccess = true;
-                        if (!enemy->isAlive()) {
-                            for (size_t idx = 0; idx < combat->getEnemyCount(); ++idx) {
-                                if (combat->getEnemy(idx) == enemy) {
-                                    combat->handleEnemyDeath(idx);
-                                    break;
-                                }
-                            }
-                            if (combat->areAllEnemiesDefeated()) {
-                                if (!combat->isCombatOver()) {
-                                    combat->end(true);
-                                    if (auto game = combat->getGame()) game->endCombat(true);
-                                }
-                            }
-                        }
-                    }
-                } else if (target_ == CardTarget::ALL_ENEMIES) {
-                    bool anyEnemyDefeated = false;
-                    for (size_t i = 0; i < combat->getEnemyCount(); ++i) {
-                        Enemy* enemy = combat->getEnemy(i);
-                        if (enemy && enemy->isAlive()) {
-                            int finalDamage = currentValue;
-                            if (player && player->hasStatusEffect("weak")) {
-                                finalDamage = static_cast<int>(std::round(finalDamage * 0.75));
-                                LOG_DEBUG("card_onPlay", "Player is Weak (AOE), damage reduced to " + std::to_string(finalDamage) + " for enemy " + enemy->getName());
-                            }
-                            enemy->takeDamage(finalDamage);
-                            if (!enemy->isAlive()) {
-                                combat->handleEnemyDeath(i);
-                                anyEnemyDefeated = true;
-                            }
-                        }
-                    }
-                    if (anyEnemyDefeated && combat->areAllEnemiesDefeated()) {
-                        if (!combat->isCombatOver()) {
-                            combat->end(true);
-                            if (auto game = combat->getGame()) game->endCombat(true);
-                        }
-                    }
+            case CardEffectOp::BLOCK:
+                if (player) {
+                    player->addBlock(effect.value);
                     effectSuccess = true;
                 }
-            } else if (effectType == "block") {
+                break;
+
+            case CardEffectOp::DRAW:
                 if (player) {
-                    player->addBlock(currentValue);
+                    player->drawCards(effect.value);
                     effectSuccess = true;
                 }
-            } else if (effectType == "apply_vulnerable" || effectType == "apply_weak" || effectType == "gain_strength") {
-                std::string statusId = effectType.substr(std::string("apply_").length());
-                 if (effectType == "gain_strength") statusId = "strength";
+                break;
 
-                if (target_ == CardTarget::SINGLE_ENEMY && (statusId == "vulnerable" || statusId == "weak")) {
-                    Enemy* enemy = combat->getEnemy(targetIndex);
+            case CardEffectOp::STATUS_TARGET: {
+                Enemy* enemy = combat->getEnemy(targetIndex);
+                if (enemy && enemy->isAlive()) {
+                    enemy->addStatusEffect(effect.statusSymbol, effect.value);
+                } else {
+                    LOG_DEBUG("card_onPlay", "Target for status '" + effect.status + "' (" + getName() + ") is dead or missing. Effect considered vacuously successful.");
+                }
+                effectSuccess = true;
+                break;
+            }
+
+            case CardEffectOp::STATUS_ALL_ENEMIES:
+                for (size_t i = 0; i < combat->getEnemyCount(); ++i) {
+                    Enemy* enemy = combat->getEnemy(i);
                     if (enemy && enemy->isAlive()) {
-                        enemy->addStatusEffect(statusId, currentValue);
-                        effectSuccess = true; 
-                    } else if (enemy && !enemy->isAlive()) {
-                        LOG_DEBUG("card_onPlay", "Target for " + statusId + " (" + getName() + ") is dead. Effect considered vacuously successful.");
-                        effectSuccess = true; 
-                    } else if (!enemy) {
-                        LOG_DEBUG("card_onPlay", "Target enemy for " + statusId + " (" + getName() + ") does not exist (targetIndex=" + std::to_string(targetIndex) + "). Effect considered vacuously successful as combat might have ended.");
-                        effectSuccess = true; 
+                        enemy->addStatusEffect(effect.statusSymbol, effect.value);
                     }
-                } else if (target_ == CardTarget::SELF && statusId == "strength") {
-                     if(player) {
-                        player->addStatusEffect(statusId, currentValue);
-                        effectSuccess = true;
-                     }
                 }
-            } else if (effectType == "draw") {
+                effectSuccess = true;
+                break;
+
+            case CardEffectOp::STATUS_SELF:
                 if (player) {
-                    player->drawCards(currentValue);
+                    player->addStatusEffect(effect.statusSymbol, effect.value);
                     effectSuccess = true;
                 }
-            } else if (effectType == "status_effect") { 
-                std::string statusId = effectJson.value("effect", "");
-                std::string actualEffectTargetType = effectJson.value("target", "self"); 
-                
-                currentValue = effectJson.value("value", 0);
-                if (this->upgraded_ && effectJson.contains("upgraded_value")) {
-                    currentValue = effectJson.value("upgraded_value", currentValue);
-                }
+                break;
+
+            case CardEffectOp::UNSUPPORTED:
+                break;
+        }
+
+        if (!effectSuccess) {
+            LOG_WARNING("card_onPlay", "Effect type '" + effect.type + "' for card '" + getId() + "' failed or not handled.");
+            overallSuccess = false;
+        }
+    }
+
+    return overallSuccess;
+}
+
+bool Card::dealDamageToEnemy(Player* player, Combat* combat, size_t enemyIndex, int damage) {
+    Enemy* enemy = combat->getEnemy(enemyIndex);
+    if (!enemy) {
+        return false;
+    }
 
-                if (statusId.empty()) {
-                    LOG_WARNING("card_onPlay", "status_effect type missing 'effect' field in JSON for card '" + getId() + "'");
+    int finalDamage = damage;
+    if (player && player->hasStatusEffect(StatusEffect::WEAK)) {
+        finalDamage = static_cast<int>(std::round(finalDamage * 0.75));
+        LOG_DEBUG("card_onPlay", "Player is Weak, damage reduced to " + std::to_string(finalDamage) + " for enemy " + enemy->getName());
+    }
+    if (player && player->getTriggers().hasHandlers(Trigger::ON_DAMAGE_DEALT)) {
+        TriggerContext context;
+        context.combat = combat;
+        context.amount = finalDamage;
+        context.targetIndex = static_cast<int>(enemyIndex);
+        player->fireTrigger(Trigger::ON_DAMAGE_DEALT, context);
+        finalDamage = context.amount;
+    }
+    enemy->takeDamage(finalDamage);
+
+    if (!enemy->isAlive()) {
+        combat->handleEnemyDeath(enemyIndex);
+        return true;
+    }
+    return false;
+}
+
+void Card::compileEffects(CardDef& def, const nlohmann::json& effectsJson) const {
+    def.effects.clear();
+    def.effects.reserve(effectsJson.size());
+
+    for (const auto& effectJson : effectsJson) {
+        CardEffect effect;
+        effect.type = effectJson.value("type", "");
+        effect.value = effectJson.value("value", 0);
+        effect.upgradedValue = effectJson.value("upgraded_value", effect.value);
+
+        const std::string& effectType = effect.type;
+        if (effectType.empty()) {
+            effect.op = CardEffectOp::NONE;
+        } else if (effectType == "damage") {
+            if (def.target == CardTarget::SINGLE_ENEMY) {
+                effect.op = CardEffectOp::DAMAGE_TARGET;
+            } else if (def.target == CardTarget::ALL_ENEMIES) {
+                effect.op = CardEffectOp::DAMAGE_ALL_ENEMIES;
+            } else {
+                effect.op = CardEffectOp::UNSUPPORTED;
+            }
+        } else if (effectType == "block") {
+            effect.op = CardEffectOp::BLOCK;
+        } else if (effectType == "draw") {
+            effect.op = CardEffectOp::DRAW;
+        } else if (effectType == "apply_vulnerable" || effectType == "apply_weak" || effectType == "gain_strength") {
+            // Legacy shorthand effects fall back to the card's magic number
+            if (!effectJson.contains("value")) {
+                effect.value = def.magicNumber;
+            }
+            if (!effectJson.contains("upgraded_value")) {
+                effect.upgradedValue = def.magicNumberUpgraded != -1 ? def.magicNumberUpgraded : effectJson.value("value", 0);
+            }
+
+            if (effectType == "gain_strength") {
+                effect.status = "strength";
+                effect.op = def.target == CardTarget::SELF ? CardEffectOp::STATUS_SELF : CardEffectOp::UNSUPPORTED;
+            } else {
+                effect.status = effectType.substr(std::string("apply_").length());
+                effect.op = def.target == CardTarget::SINGLE_ENEMY ? CardEffectOp::STATUS_TARGET : CardEffectOp::UNSUPPORTED;
+            }
+        } else if (effectType == "status_effect") {
+            effect.status = effectJson.value("effect", "");
+            std::string effectTarget = effectJson.value("target", "self");
+
+            if (effect.status.empty()) {
+                LOG_WARNING("card", "status_effect type missing 'effect' field in JSON for card '" + getId() + "'");
+                effect.op = CardEffectOp::UNSUPPORTED;
+            } else if (effectTarget == "enemy" || effectTarget == "SINGLE_ENEMY") {
+                if (def.target == CardTarget::SINGLE_ENEMY) {
+                    effect.op = CardEffectOp::STATUS_TARGET;
+                } else if (def.target == CardTarget::ALL_ENEMIES) {
+                    effect.op = CardEffectOp::STATUS_ALL_ENEMIES;
                 } else {
-                    if (actualEffectTargetType == "enemy" || actualEffectTargetType == "SINGLE_ENEMY") {
-                        if (target_ == CardTarget::SINGLE_ENEMY) {
-                            Enemy* enemy = combat->getEnemy(targetIndex);
-                            if (enemy && enemy->isAlive()) {
-                                enemy->addStatusEffect(statusId, currentValue);
-                                effectSuccess = true;
-                            } else if (enemy && !enemy->isAlive()) {
-                                LOG_DEBUG("card_onPlay", "Target for generic status_effect '" + statusId + "' (" + getName() + ") is dead. Effect considered vacuously successful.");
-                                effectSuccess = true;
-                            } else if (!enemy) {
-                                LOG_DEBUG("card_onPlay", "Target enemy for generic status_effect '" + statusId + "' (" + getName() + ") does not exist. Effect considered vacuously successful as combat might have ended.");
-                                effectSuccess = true;
-                            }
-                        } else if (target_ == CardTarget::ALL_ENEMIES) {
-                             for (size_t i = 0; i < combat->getEnemyCount(); ++i) {
-                                Enemy* enemy = combat->getEnemy(i);
-                                if (enemy && enemy->isAlive()) {
-                                    enemy->addStatusEffect(statusId, currentValue);
-                                }
-                            }
-                            effectSuccess = true; 
-                        }
-                    } else if (actualEffectTargetType == "self" || actualEffectTargetType == "SELF") {
-                        if (player) {
-                            player->addStatusEffect(statusId, currentValue);
-                            effectSuccess = true;
-                        }
-                    } else if (actualEffectTargetType == "all_enemies" || actualEffectTargetType == "ALL_ENEMIES") {
-                    for (size_t i = 0; i < combat->getEnemyCount(); ++i) {
-                        Enemy* enemy = combat->getEnemy(i);
-                        if (enemy && enemy->isAlive()) {
-                                enemy->addStatusEffect(statusId, currentValue);
-                        }
-                    }
-                        effectSuccess = true; 
-                    }
+                    effect.op = CardEffectOp::UNSUPPORTED;
                 }
+            } else if (effectTarget == "self" || effectTarget == "SELF") {
+                effect.op = CardEffectOp::STATUS_SELF;
+            } else if (effectTarget == "all_enemies" || effectTarget == "ALL_ENEMIES") {
+                effect.op = CardEffectOp::STATUS_ALL_ENEMIES;
+            } else {
+                effect.op = CardEffectOp::UNSUPPORTED;
             }
-            
-            if (!effectSuccess && effectType != "") {
-                LOG_WARNING("card_onPlay", "Effect type '" + effectType + "' for card '" + getId() + "' failed or not handled.");
-                overallSuccess = false;
-            }
+        } else {
+            effect.op = CardEffectOp::UNSUPPORTED;
         }
-        
-        return overallSuccess;
-    } catch (const std::exception& e) {
-        LOG_ERROR("card_onPlay", "Error processing card effects for " + getId() + ": " + std::string(e.what()));
-        return fallbackCardEffect(player, targetIndex, combat);
+
+        if (effect.op == CardEffectOp::UNSUPPORTED) {
+            LOG_WARNING("card", "Effect type '" + effectType + "' for card '" + getId() + "' cannot be handled and will fail when played");
+        }
+
+        if (!effect.status.empty()) {
+            effect.statusSymbol = util::Symbol::intern(effect.status);
+        }
+        def.effects.push_back(std::move(effect));
+    }
+
+    def.upgradedEffects = def.effects;
+    for (auto& effect : def.upgradedEffects) {
+        effect.value = effect.upgradedValue;
     }
+    def.hasEffectProgram = true;
 }
 
 bool Card::fallbackCardEffect(Player* player, int targetIndex, Combat* combat) {
-    if (type_ == CardType::ATTACK) {
-        if (target_ == CardTarget::SINGLE_ENEMY) {
+    if (def_->type == CardType::ATTACK) {
+        if (def_->target == CardTarget::SINGLE_ENEMY) {
             Enemy* enemy = combat->getEnemy(targetIndex);
             if (enemy) {
                 int damage = upgraded_ ? 9 : 6;
                 enemy->takeDamage(damage);
                 return true;
             }
-        } else if (target_ == CardTarget::ALL_ENEMIES) {
+        } else if (def_->target == CardTarget::ALL_ENEMIES) {
             int damage = upgraded_ ? 9 : 6;
             for (size_t i = 0; i < combat->getEnemyCount(); ++i) {
                 Enemy* enemy = combat->getEnemy(i);
@@ -540,8 +648,8 @@ bool Card::fallbackCardEffect(Player* player, int targetIndex, Combat* combat) {
             }
             return true;
         }
-    } else if (type_ == CardType::SKILL) {
-        if (target_ == CardTarget::SELF) {
+    } else if (def_->type == CardType::SKILL) {
+        if (def_->target == CardTarget::SELF) {
             int block = upgraded_ ? 8 : 5;
             player->addBlock(block);
             return true;
@@ -552,22 +660,31 @@ bool Card::fallbackCardEffect(Player* player, int targetIndex, Combat* combat) {
 }
 
 bool Card::needsTarget() const {
-    return target_ == CardTarget::SINGLE_ENEMY;
+    return def_->target == CardTarget::SINGLE_ENEMY;
 }
 
 const std::string& Card::getClassRestriction() const {
-    return classRestriction_;
+    return def_->classRestriction;
 }
 
 void Card::setClassRestriction(const std::string& className) {
-    classRestriction_ = className;
+    detachDef().classRestriction = className;
+}
+
+const std::vector<CardEffect>& Card::getEffects() const {
+    return upgraded_ ? def_->upgradedEffects : def_->effects;
+}
+
+bool Card::hasEffectProgram() const {
+    return def_->hasEffectProgram;
 }
 
 bool Card::canUse(Player* player) const {
     if (!player) return false;
-    if (classRestriction_.empty()) return true;
-    if (classRestriction_ == "ALL") return true;
-    return player->getPlayerClassString() == classRestriction_;
+    const std::string& classRestriction = def_->classRestriction;
+    if (classRestriction.empty()) return true;
+    if (classRestriction == "ALL") return true;
+    return player->getPlayerClassString() == classRestriction;
 }
 
 } // namespace deckstiny 
\ No newline at end of file
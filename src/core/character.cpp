@@ -2,8 +2,11 @@
 // Laboratory Work 2
 
 #include "core/character.h"
+#include "core/combat_journal.h"
+#include "core/combat_state.h"
 #include "core/player.h"
 #include "util/logger.h"
+#include "util/trace.h"
 #include <algorithm>
 #include <string>
 
@@ -18,6 +21,7 @@ int Character::getHealth() const {
 }
 
 void Character::setHealth(int health) {
+    journalValue(currentHealth_);
     currentHealth_ = std::min(std::max(0, health), maxHealth_);
 }
 
@@ -28,6 +32,8 @@ int Character::getMaxHealth() const {
 void Character::setMaxHealth(int newMaxHealthValue) {
     int oldMaxHealth = maxHealth_;
     int oldCurrentHealth = currentHealth_;
+    journalValue(maxHealth_);
+    journalValue(currentHealth_);
     maxHealth_ = std::max(1, newMaxHealthValue);
     currentHealth_ = std::min(currentHealth_, maxHealth_);
     LOG_INFO("character_setmaxhealth", getName() + " setMaxHealth. Old MaxHP: " + std::to_string(oldMaxHealth) + " -> New MaxHP: " + std::to_string(maxHealth_) + ". Old HP: " + std::to_string(oldCurrentHealth) + " -> New HP (after cap): " + std::to_string(currentHealth_) + ". Requested New MaxHP: " + std::to_string(newMaxHealthValue));
@@ -43,7 +49,7 @@ int Character::takeDamage(int amount) {
     }
     
     int modifiedAmount = amount;
-    if (hasStatusEffect("vulnerable")) {
+    if (hasStatusEffect(StatusEffect::VULNERABLE)) {
         modifiedAmount = static_cast<int>(std::round(modifiedAmount * 1.5));
         LOG_DEBUG("combat", getName() + " is Vulnerable, incoming damage increased to " + std::to_string(modifiedAmount));
     }
@@ -54,6 +60,7 @@ int Character::takeDamage(int amount) {
     int remainingDamage = modifiedAmount;
     if (block_ > 0) {
         int blockUsed = std::min(block_, remainingDamage);
+        journalValue(block_);
         block_ -= blockUsed;
         remainingDamage -= blockUsed;
         
@@ -63,9 +70,13 @@ int Character::takeDamage(int amount) {
     
     if (remainingDamage > 0) {
         int oldHealth = currentHealth_;
+        journalValue(currentHealth_);
         currentHealth_ = std::max(0, currentHealth_ - remainingDamage);
         LOG_DEBUG("combat", entityType + " " + getName() + " took " + std::to_string(oldHealth - currentHealth_) + 
                  " health damage, health now " + std::to_string(currentHealth_));
+        TRACE_RECORD(DAMAGE_DEALT, getIdSymbol(), util::Symbol(), modifiedAmount, oldHealth - currentHealth_);
+    } else {
+        TRACE_RECORD(DAMAGE_DEALT, getIdSymbol(), util::Symbol(), modifiedAmount, 0);
     }
     
     return amount;
@@ -78,6 +89,7 @@ int Character::heal(int amount) {
     }
     
     int oldHealth = currentHealth_;
+    journalValue(currentHealth_);
     currentHealth_ = std::min(maxHealth_, currentHealth_ + amount);
     int healedAmount = currentHealth_ - oldHealth;
     LOG_INFO("character_heal", getName() + " healed for " + std::to_string(healedAmount) + ". Health: " + std::to_string(oldHealth) + " -> " + std::to_string(currentHealth_) + " (Max: " + std::to_string(maxHealth_) + "). Requested: " + std::to_string(amount));
@@ -87,6 +99,7 @@ int Character::heal(int amount) {
 void Character::addBlock(int amount) {
     if (amount > 0) {
         int oldBlock = block_;
+        journalValue(block_);
         block_ += amount;
         std::string entityType = (dynamic_cast<Player*>(this)) ? "Player" : "Enemy";
         LOG_DEBUG("combat", entityType + " " + getName() + " block increased from " + 
@@ -107,6 +120,7 @@ int Character::getEnergy() const {
 }
 
 void Character::setEnergy(int energy) {
+    journalValue(currentEnergy_);
     currentEnergy_ = std::max(0, energy);
 }
 
@@ -116,6 +130,7 @@ bool Character::useEnergy(int amount) {
     }
     
     if (currentEnergy_ >= amount) {
+        journalValue(currentEnergy_);
         currentEnergy_ -= amount;
         return true;
     }
@@ -124,6 +139,7 @@ bool Character::useEnergy(int amount) {
 }
 
 void Character::resetEnergy() {
+    journalValue(currentEnergy_);
     currentEnergy_ = baseEnergy_;
 }
 
@@ -133,53 +149,179 @@ void Character::resetBlock() {
         LOG_DEBUG("combat", entityType + " " + getName() + " block reset from " + 
                  std::to_string(block_) + " to 0");
     }
+    journalValue(block_);
     block_ = 0;
 }
 
 void Character::addStatusEffect(const std::string& effect, int stacks) {
+    addStatusEffect(util::Symbol::intern(effect), stacks);
+}
+
+void Character::addStatusEffect(util::Symbol effect, int stacks) {
     if (stacks == 0) {
         return;
     }
-    
-    auto it = statusEffects_.find(effect);
-    if (it == statusEffects_.end()) {
-        if (stacks > 0) {
-            statusEffects_[effect] = stacks;
+
+    int slot = statusEffectSlot(effect);
+    if (slot >= 0) {
+        addStatusEffect(static_cast<StatusEffect>(slot), stacks);
+        return;
+    }
+
+    size_t index = 0;
+    while (index < customStatusEffects_.size() && customStatusEffects_[index].first != effect) {
+        ++index;
+    }
+    if (index == customStatusEffects_.size()) {
+        if (stacks < 0) {
+            return;
         }
-    } else {
-        it->second += stacks;
-        if (it->second <= 0) {
-            statusEffects_.erase(it);
+        // Entries stay once added so the display order does not shift as stacks expire
+        if (journal_) {
+            journal_->recordStatusAdded(customStatusEffects_);
         }
+        customStatusEffects_.emplace_back(effect, 0);
     }
+    if (journal_) {
+        journal_->recordStatus(customStatusEffects_, index);
+    }
+    int& current = customStatusEffects_[index].second;
+    current = std::max(0, current + stacks);
+    TRACE_RECORD(STATUS_APPLIED, getIdSymbol(), effect, stacks, current);
+}
+
+void Character::addStatusEffect(StatusEffect effect, int stacks) {
+    if (stacks == 0) {
+        return;
+    }
+    int& current = statusStacks_[static_cast<size_t>(effect)];
+    journalValue(current);
+    current = std::max(0, current + stacks);
+    TRACE_RECORD(STATUS_APPLIED, getIdSymbol(), statusEffectSymbol(effect), stacks, current);
 }
 
 int Character::getStatusEffect(const std::string& effect) const {
-    auto it = statusEffects_.find(effect);
-    return (it != statusEffects_.end()) ? it->second : 0;
+    return getStatusEffect(util::Symbol::find(effect));
+}
+
+int Character::getStatusEffect(util::Symbol effect) const {
+    int slot = statusEffectSlot(effect);
+    if (slot >= 0) {
+        return statusStacks_[static_cast<size_t>(slot)];
+    }
+    for (const auto& [custom, stacks] : customStatusEffects_) {
+        if (custom == effect) {
+            return stacks;
+        }
+    }
+    return 0;
+}
+
+int Character::getStatusEffect(StatusEffect effect) const {
+    return statusStacks_[static_cast<size_t>(effect)];
 }
 
 bool Character::hasStatusEffect(const std::string& effect) const {
-    return statusEffects_.find(effect) != statusEffects_.end();
+    return getStatusEffect(effect) > 0;
+}
+
+bool Character::hasStatusEffect(util::Symbol effect) const {
+    return getStatusEffect(effect) > 0;
+}
+
+bool Character::hasStatusEffect(StatusEffect effect) const {
+    return statusStacks_[static_cast<size_t>(effect)] > 0;
+}
+
+StatusEffectList Character::getStatusEffects() const {
+    StatusEffectList effects;
+    for (size_t slot = 0; slot < STATUS_EFFECT_COUNT; ++slot) {
+        if (statusStacks_[slot] > 0) {
+            effects.add(statusEffectSymbol(static_cast<StatusEffect>(slot)).str(), statusStacks_[slot]);
+        }
+    }
+    for (const auto& [effect, stacks] : customStatusEffects_) {
+        if (stacks > 0) {
+            effects.add(effect.str(), stacks);
+        }
+    }
+    return effects;
 }
 
-const std::unordered_map<std::string, int>& Character::getStatusEffects() const {
-    return statusEffects_;
+bool Character::saveState(CharacterState& state) const {
+    if (customStatusEffects_.size() > MAX_CUSTOM_STATUS_EFFECTS) {
+        return false;
+    }
+    state.health = currentHealth_;
+    state.maxHealth = maxHealth_;
+    state.block = block_;
+    state.energy = currentEnergy_;
+    std::copy(statusStacks_.begin(), statusStacks_.end(), state.statusStacks.begin());
+    state.customCount = static_cast<uint8_t>(customStatusEffects_.size());
+    for (size_t i = 0; i < customStatusEffects_.size(); ++i) {
+        state.customSymbols[i] = customStatusEffects_[i].first.getId();
+        state.customStacks[i] = customStatusEffects_[i].second;
+    }
+    return true;
+}
+
+void Character::restoreState(const CharacterState& state) {
+    currentHealth_ = state.health;
+    maxHealth_ = state.maxHealth;
+    block_ = state.block;
+    currentEnergy_ = state.energy;
+    std::copy(state.statusStacks.begin(), state.statusStacks.end(), statusStacks_.begin());
+    // clear() keeps the capacity, so restoring does not allocate once effects were seen
+    customStatusEffects_.clear();
+    for (size_t i = 0; i < state.customCount; ++i) {
+        customStatusEffects_.emplace_back(util::Symbol(state.customSymbols[i]), state.customStacks[i]);
+    }
+}
+
+void Character::copyStatusEffects(const Character& other) {
+    statusStacks_ = other.statusStacks_;
+    customStatusEffects_ = other.customStatusEffects_;
+}
+
+void Character::journalValue(int& field) {
+    if (journal_) {
+        journal_->recordValue(field);
+    }
+}
+
+int* Character::findStatusStacks(util::Symbol effect, bool create) {
+    int slot = statusEffectSlot(effect);
+    if (slot >= 0) {
+        return &statusStacks_[static_cast<size_t>(slot)];
+    }
+
+    for (auto& [custom, stacks] : customStatusEffects_) {
+        if (custom == effect) {
+            return &stacks;
+        }
+    }
+    if (!create) {
+        return nullptr;
+    }
+
+    // Entries stay once added so the display order does not shift as stacks expire
+    customStatusEffects_.emplace_back(effect, 0);
+    return &customStatusEffects_.back().second;
 }
 
 void Character::startTurn() {
-    if (hasStatusEffect("poison")) {
-        int poison = getStatusEffect("poison");
+    if (hasStatusEffect(StatusEffect::POISON)) {
+        int poison = getStatusEffect(StatusEffect::POISON);
         takeDamage(poison);
-        addStatusEffect("poison", -1);
+        addStatusEffect(StatusEffect::POISON, -1);
     }
 }
 
 void Character::endTurn() {
-    if (hasStatusEffect("temporary_strength")) {
-        int tempStr = getStatusEffect("temporary_strength");
-        addStatusEffect("strength", -tempStr);
-        addStatusEffect("temporary_strength", -tempStr);
+    if (hasStatusEffect(StatusEffect::TEMPORARY_STRENGTH)) {
+        int tempStr = getStatusEffect(StatusEffect::TEMPORARY_STRENGTH);
+        addStatusEffect(StatusEffect::STRENGTH, -tempStr);
+        addStatusEffect(StatusEffect::TEMPORARY_STRENGTH, -tempStr);
     }
 }
 
@@ -205,7 +347,11 @@ bool Character::loadFromJson(const nlohmann::json& json) {
         
         if (json.contains("status_effects") && json["status_effects"].is_object()) {
             for (auto& [effect, stacks] : json["status_effects"].items()) {
-                statusEffects_[effect] = stacks.get<int>();
+                // Zero stacks only reset an effect that is already listed
+                int value = std::max(0, stacks.get<int>());
+                if (int* current = findStatusStacks(util::Symbol::intern(effect), value > 0)) {
+                    *current = value;
+                }
             }
         }
         
@@ -220,7 +366,7 @@ std::unique_ptr<Entity> Character::clone() const {
     character->currentHealth_ = currentHealth_;
     character->block_ = block_;
     character->currentEnergy_ = currentEnergy_;
-    character->statusEffects_ = statusEffects_;
+    character->copyStatusEffects(*this);
     return character;
 }
 
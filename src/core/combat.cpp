@@ -5,8 +5,14 @@
 #include "core/player.h"
 #include "core/enemy.h"
 #include "core/card.h"
-#include "core/game.h"
+#include "core/combat_journal.h"
+#include "core/combat_state.h"
+#include "core/relic.h"
 #include "util/logger.h"
+#include "util/metrics.h"
+#include "util/rng.h"
+#include "util/trace.h"
+#include "util/trace_spans.h"
 
 #include <algorithm>
 #include <iostream>
@@ -14,32 +20,71 @@
 namespace deckstiny {
 
 Combat::Combat() 
-    : player_(nullptr), game_(nullptr), turn_(0), playerTurn_(true), inCombat_(false) {
+    : player_(nullptr), host_(nullptr), turn_(0), playerTurn_(true), inCombat_(false) {
 }
 
 Combat::Combat(Player* player) 
-    : player_(player), game_(nullptr), turn_(0), playerTurn_(true), inCombat_(false) {
+    : player_(player), host_(nullptr), turn_(0), playerTurn_(true), inCombat_(false) {
+}
+
+Combat::~Combat() {
+    // The player outlives the combat; stop it recording into a journal nobody rolls back
+    setJournal(nullptr);
 }
 
 void Combat::setPlayer(Player* player) {
+    if (journal_ && player_) {
+        player_->setJournal(nullptr);
+    }
     player_ = player;
+    if (journal_ && player_) {
+        player_->setJournal(journal_);
+    }
 }
 
 Player* Combat::getPlayer() const {
     return player_;
 }
 
-void Combat::setGame(Game* game) {
-    game_ = game;
+void Combat::setHost(CombatHost* host) {
+    host_ = host;
 }
 
-Game* Combat::getGame() const {
-    return game_;
+CombatHost* Combat::getHost() const {
+    return host_;
+}
+
+void Combat::setRng(util::Rng* rng) {
+    rng_ = rng;
+}
+
+util::Rng& Combat::getRng() const {
+    return rng_ ? *rng_ : util::defaultRng();
+}
+
+void Combat::setJournal(CombatJournal* journal) {
+    journal_ = journal;
+    if (player_) {
+        player_->setJournal(journal);
+    }
+    for (auto& enemy : enemyTable_) {
+        enemy->setJournal(journal);
+    }
 }
 
 void Combat::addEnemy(std::shared_ptr<Enemy> enemy) {
     if (enemy) {
+        if (journal_) {
+            // Summons are rare; undo by dropping the enemy again
+            journal_->recordUndo([this]() {
+                enemies_.pop_back();
+                enemyTable_.back()->setJournal(nullptr);
+                enemyTable_.pop_back();
+            });
+            enemy->setJournal(journal_);
+        }
         enemies_.push_back(enemy);
+        enemyTable_.push_back(enemy);
     }
 }
 
@@ -84,11 +129,15 @@ bool Combat::isPlayerTurn() const {
 }
 
 void Combat::start() {
+    TRACE_SCOPE("combat", "start");
     if (!player_ || enemies_.empty()) {
         return;
     }
     
     LOG_INFO("combat", "Combat starting with " + std::to_string(enemies_.size()) + " enemies.");
+    journalValue(inCombat_);
+    journalValue(playerTurn_);
+    journalValue(turn_);
     inCombat_ = true;
     playerTurn_ = true; 
     turn_ = 1;
@@ -98,36 +147,36 @@ void Combat::start() {
         LOG_INFO("combat", "Calling player->beginCombat() for turn " + std::to_string(turn_));
     }
     
-    while (!delayedActions_.empty()) {
-        delayedActions_.pop();
+    if (!delayedActions_.empty()) {
+        journalDelayedActions();
     }
+    delayedActions_.clear();
     
     for (auto& enemy : enemies_) {
         enemy->chooseNextMove(this, player_);
     }
     
-    playerTurn_ = true;
-    
     LOG_INFO("combat", "Combat initialization complete. Player turn: " + 
              std::string(playerTurn_ ? "true" : "false"));
 }
 
 void Combat::beginPlayerTurn() {
+    TRACE_SCOPE("combat", "player_turn_start");
     if (!inCombat_ || !player_) {
         return;
     }
     
-    LOG_INFO("combat", "Beginning player turn " + std::to_string(turn_));
+    LOG_INFOF("combat", "Beginning player turn {}", turn_);
     
+    journalValue(playerTurn_);
     playerTurn_ = true;
     
     if (turn_ > 1) {
-        LOG_INFO("combat", "Calling player->startTurn() for turn " + std::to_string(turn_));
+        LOG_INFOF("combat", "Calling player->startTurn() for turn {}", turn_);
         player_->startTurn();
         
-        LOG_INFO("combat", "After startTurn - Hand size: " + std::to_string(player_->getHand().size()) + 
-                 ", Draw pile size: " + std::to_string(player_->getDrawPile().size()) + 
-                 ", Discard pile size: " + std::to_string(player_->getDiscardPile().size()));
+        LOG_INFOF("combat", "After startTurn - Hand size: {}, Draw pile size: {}, Discard pile size: {}",
+                  player_->getHand().size(), player_->getDrawPile().size(), player_->getDiscardPile().size());
     } else {
         LOG_INFO("combat", "Skipping player->startTurn() for first turn");
     }
@@ -136,6 +185,7 @@ void Combat::beginPlayerTurn() {
 }
 
 void Combat::endPlayerTurn() {
+    TRACE_SCOPE("combat", "player_turn_end");
     if (!inCombat_ || !player_) {
         return;
     }
@@ -143,16 +193,26 @@ void Combat::endPlayerTurn() {
     player_->endTurn();
     
     processEnemyTurns();
+    if (!inCombat_) {
+        return;
+    }
     
+    journalValue(turn_);
     turn_++;
     beginPlayerTurn();
 }
 
 void Combat::processEnemyTurns() {
+    TRACE_SCOPE("combat", "enemy_turns");
+    static util::Histogram& latency = util::MetricsRegistry::getInstance().histogram(
+        "deckstiny_combat_enemy_turns_seconds", "Time spent in Combat::processEnemyTurns");
+    util::ScopedLatency timer(latency);
+
     if (!inCombat_ || !player_) {
         return;
     }
     
+    journalValue(playerTurn_);
     playerTurn_ = false;
     
     for (auto& enemy : enemies_) {
@@ -164,15 +224,9 @@ void Combat::processEnemyTurns() {
             enemy->endTurn();
             
             if (isPlayerDefeated()) {
+                // The owner (Game::handleCombatInput) ends the combat; doing it here would destroy this object mid-call
                 LOG_INFO("combat", "Player was defeated by enemy: " + enemy->getName());
                 end(false);
-                
-                if (game_) {
-                    LOG_INFO("combat", "Game pointer available, calling game->endCombat(false)");
-                    game_->endCombat(false);
-                } else {
-                    LOG_ERROR("combat", "Player defeated but game pointer not available!");
-                }
                 return;
             }
         }
@@ -197,6 +251,12 @@ void Combat::processEnemyTurns() {
 }
 
 bool Combat::playCard(int cardIndex, int targetIndex) {
+    static util::Histogram& latency = util::MetricsRegistry::getInstance().histogram(
+        "deckstiny_combat_play_card_seconds", "Time spent in Combat::playCard");
+    static util::Counter& played = util::MetricsRegistry::getInstance().counter(
+        "deckstiny_cards_played_total", "Cards played successfully");
+    util::ScopedLatency timer(latency);
+
     if (!inCombat_ || !player_ || !playerTurn_) {
         LOG_ERROR("combat", "Cannot play card: combat not active, player is null, or not player's turn");
         return false;
@@ -217,7 +277,13 @@ bool Combat::playCard(int cardIndex, int targetIndex) {
         return false;
     }
     
+    TRACE_RECORD(CARD_PLAYED, card->getIdSymbol(),
+                 getEnemy(targetIndex) ? getEnemy(targetIndex)->getIdSymbol() : util::Symbol(),
+                 card->getCost(), targetIndex);
     bool success = card->play(player_, targetIndex, this);
+    if (success) {
+        played.add();
+    }
     LOG_DEBUG("combat", "Card played: " + card->getName() + ", success: " + (success ? "true" : "false"));
     
     LOG_DEBUG("combat", "After playing card - Hand size: " + std::to_string(player_->getHand().size()) + 
@@ -234,42 +300,28 @@ bool Combat::playCard(int cardIndex, int targetIndex) {
     return success;
 }
 
-void Combat::addDelayedAction(std::function<void()> action, int delay, int priority, const std::string& source) {
+void Combat::addDelayedAction(DelayedCallback action, int delay, int priority, util::Symbol source) {
     if (!action) {
         return;
     }
     
-    CombatAction delayedAction;
-    delayedAction.action = action;
-    delayedAction.delay = delay;
-    delayedAction.priority = priority;
-    delayedAction.source = source;
-    
-    delayedActions_.push(delayedAction);
+    journalDelayedActions();
+    delayedActions_.schedule(std::move(action), delay, priority, source);
 }
 
-void Combat::processDelayedActions() {
-    while (!delayedActions_.empty() && delayedActions_.top().delay <= 0) {
-        CombatAction action = delayedActions_.top();
-        delayedActions_.pop();
-        
-        if (action.action) {
-            action.action();
-        }
-    }
-    
-    std::vector<CombatAction> remainingActions;
-    while (!delayedActions_.empty()) {
-        CombatAction action = delayedActions_.top();
-        delayedActions_.pop();
-        
-        action.delay--;
-        remainingActions.push_back(action);
+void Combat::addDelayedAction(DelayedCallback action, int delay, int priority, std::string_view source) {
+    if (!action) {
+        return;
     }
-    
-    for (const auto& action : remainingActions) {
-        delayedActions_.push(action);
+    addDelayedAction(std::move(action), delay, priority, util::Symbol::intern(source));
+}
+
+void Combat::processDelayedActions() {
+    if (delayedActions_.empty()) {
+        return;
     }
+    journalDelayedActions();
+    delayedActions_.advance();
 }
 
 void Combat::handleEnemyDeath(size_t index) {
@@ -288,13 +340,186 @@ void Combat::end(bool victorious) {
         return;
     }
     
+    journalValue(inCombat_);
     inCombat_ = false;
     
     LOG_INFO("combat", "Combat ended with " + std::string(victorious ? "victory" : "defeat"));
-    
-    if (!victorious && isPlayerDefeated() && game_) {
-        LOG_INFO("combat", "Player defeated, ensuring game transition to game over");
+}
+
+bool Combat::snapshot(CombatState& state) {
+    if (!player_ || !delayedActions_.empty() || enemies_.size() > MAX_COMBAT_ENEMIES) {
+        return false;
+    }
+    if (!player_->saveState(state.player)) {
+        return false;
+    }
+    state.gold = player_->getGold();
+
+    size_t pileOffset = 0;
+    for (size_t pile = 0; pile < static_cast<size_t>(CardPile::COUNT); ++pile) {
+        const auto& cards = player_->getPile(static_cast<CardPile>(pile));
+        if (pileOffset + cards.size() > MAX_COMBAT_CARDS) {
+            return false;
+        }
+        for (const auto& card : cards) {
+            int slot = card->getCombatSlot();
+            if (slot < 0 || static_cast<size_t>(slot) >= cardTable_.size() || cardTable_[slot] != card) {
+                if (cardTable_.size() >= MAX_COMBAT_CARDS) {
+                    return false;
+                }
+                slot = static_cast<int>(cardTable_.size());
+                card->setCombatSlot(slot);
+                cardTable_.push_back(card);
+            }
+            state.pileCards[pileOffset++] = static_cast<uint8_t>(slot);
+        }
+        state.pileSizes[pile] = static_cast<uint16_t>(cards.size());
+    }
+    state.cardCount = static_cast<uint16_t>(cardTable_.size());
+    for (size_t i = 0; i < cardTable_.size(); ++i) {
+        cardTable_[i]->saveState(state.cards[i]);
+    }
+
+    const auto& relics = player_->getRelics();
+    if (relics.size() > MAX_COMBAT_RELICS) {
+        return false;
+    }
+    state.relicCount = static_cast<uint8_t>(relics.size());
+    for (size_t i = 0; i < relics.size(); ++i) {
+        state.relicCounters[i] = relics[i]->getCounter();
+    }
+
+    state.enemyCount = static_cast<uint8_t>(enemies_.size());
+    for (size_t i = 0; i < enemies_.size(); ++i) {
+        EnemyState& enemyState = state.enemies[i];
+        auto slot = std::find(enemyTable_.begin(), enemyTable_.end(), enemies_[i]);
+        if (slot == enemyTable_.end() || slot - enemyTable_.begin() > UINT8_MAX ||
+            !enemies_[i]->saveState(enemyState.character)) {
+            return false;
+        }
+        enemyState.slot = static_cast<uint8_t>(slot - enemyTable_.begin());
+        enemyState.currentMove = static_cast<int16_t>(enemies_[i]->getCurrentMoveIndex());
+    }
+
+    state.turn = turn_;
+    state.playerTurn = playerTurn_ ? 1 : 0;
+    state.inCombat = inCombat_ ? 1 : 0;
+
+    state.hasAiRng = rng_ ? 1 : 0;
+    if (rng_) {
+        state.aiRng = *rng_;
+    }
+    util::Rng* shuffleRng = player_->getShuffleRng();
+    state.hasShuffleRng = shuffleRng ? 1 : 0;
+    if (shuffleRng) {
+        state.shuffleRng = *shuffleRng;
+    }
+    return true;
+}
+
+bool Combat::restore(const CombatState& state) {
+    if (!player_ || state.cardCount > cardTable_.size() ||
+        state.relicCount != player_->getRelics().size()) {
+        LOG_ERROR("combat", "Cannot restore a combat state taken from a different combat");
+        return false;
+    }
+    for (size_t i = 0; i < state.enemyCount; ++i) {
+        if (state.enemies[i].slot >= enemyTable_.size()) {
+            LOG_ERROR("combat", "Cannot restore a combat state taken from a different combat");
+            return false;
+        }
+    }
+
+    player_->restoreState(state.player);
+    player_->addGold(state.gold - player_->getGold());
+
+    size_t pileOffset = 0;
+    for (size_t pile = 0; pile < static_cast<size_t>(CardPile::COUNT); ++pile) {
+        player_->restorePile(static_cast<CardPile>(pile), cardTable_, &state.pileCards[pileOffset], state.pileSizes[pile]);
+        pileOffset += state.pileSizes[pile];
+    }
+    for (size_t i = 0; i < state.cardCount; ++i) {
+        cardTable_[i]->restoreState(state.cards[i]);
+    }
+
+    const auto& relics = player_->getRelics();
+    for (size_t i = 0; i < relics.size(); ++i) {
+        relics[i]->setCounter(state.relicCounters[i]);
+    }
+
+    enemies_.resize(state.enemyCount);
+    for (size_t i = 0; i < state.enemyCount; ++i) {
+        const EnemyState& enemyState = state.enemies[i];
+        enemies_[i] = enemyTable_[enemyState.slot];
+        enemies_[i]->restoreState(enemyState.character);
+        enemies_[i]->setCurrentMoveIndex(enemyState.currentMove);
+    }
+
+    turn_ = state.turn;
+    playerTurn_ = state.playerTurn != 0;
+    inCombat_ = state.inCombat != 0;
+
+    if (state.hasAiRng && rng_) {
+        *rng_ = state.aiRng;
+    }
+    util::Rng* shuffleRng = player_->getShuffleRng();
+    if (state.hasShuffleRng && shuffleRng) {
+        *shuffleRng = state.shuffleRng;
+    }
+
+    delayedActions_.clear();
+    if (journal_) {
+        journal_->clear();
+    }
+    return true;
+}
+
+void Combat::journalValue(int& field) {
+    if (journal_) {
+        journal_->recordValue(field);
+    }
+}
+
+void Combat::journalValue(bool& field) {
+    if (journal_) {
+        journal_->recordValue(field);
+    }
+}
+
+void Combat::journalDelayedActions() {
+    // The queue holds arbitrary functions and is rarely used, so its pending
+    // actions are saved whole; a batch being run is not part of the copy
+    if (journal_) {
+        journal_->recordUndo([this, saved = delayedActions_]() {
+            delayedActions_ = saved;
+        });
+    }
+}
+
+std::unique_ptr<Combat> Combat::fork(Player& player) {
+    CombatState state;
+    if (!snapshot(state)) {
+        return nullptr;
+    }
+
+    auto copy = std::make_unique<Combat>(&player);
+    copy->host_ = host_;
+    copy->cardTable_.reserve(cardTable_.size());
+    for (size_t i = 0; i < cardTable_.size(); ++i) {
+        auto card = cardTable_[i]->cloneCard();
+        card->setCombatSlot(static_cast<int>(i));
+        copy->cardTable_.push_back(card);
+    }
+    copy->enemyTable_.reserve(enemyTable_.size());
+    for (const auto& enemy : enemyTable_) {
+        copy->enemyTable_.push_back(enemy->cloneEnemy());
+    }
+
+    player.setCurrentCombat(copy.get());
+    if (!copy->restore(state)) {
+        return nullptr;
     }
+    return copy;
 }
 
-} // namespace deckstiny 
\ No newline at end of file
+} // namespace deckstiny
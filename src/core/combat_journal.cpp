@@ -0,0 +1,116 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "core/combat_journal.h"
+#include "core/card.h"
+
+namespace deckstiny {
+
+CombatJournal::Mark CombatJournal::mark() const {
+    Mark mark;
+    mark.entries = entries_.size();
+    mark.cards = cards_.size();
+    mark.rngs = rngs_.size();
+    mark.callbacks = callbacks_.size();
+    mark.generation = generation_;
+    return mark;
+}
+
+bool CombatJournal::rollback(const Mark& mark) {
+    if (mark.generation != generation_) {
+        return false;
+    }
+    while (entries_.size() > mark.entries) {
+        const Entry& entry = entries_.back();
+        switch (entry.op) {
+            case Op::INT:
+                *static_cast<int*>(entry.target) = static_cast<int>(entry.value);
+                break;
+            case Op::BOOL:
+                *static_cast<bool*>(entry.target) = entry.value != 0;
+                break;
+            case Op::RNG:
+                *static_cast<util::Rng*>(entry.target) = rngs_[entry.index];
+                break;
+            case Op::CARD_PUSH:
+                static_cast<CardList*>(entry.target)->pop_back();
+                break;
+            case Op::CARD_ERASE: {
+                auto* pile = static_cast<CardList*>(entry.target);
+                pile->insert(pile->begin() + entry.value, cards_[entry.index]);
+                break;
+            }
+            case Op::CARD_PILE: {
+                auto first = cards_.begin() + static_cast<std::ptrdiff_t>(entry.index);
+                static_cast<CardList*>(entry.target)->assign(first, first + entry.value);
+                break;
+            }
+            case Op::STATUS:
+                (*static_cast<CustomStatusList*>(entry.target))[entry.index].second = static_cast<int>(entry.value);
+                break;
+            case Op::STATUS_ADDED:
+                static_cast<CustomStatusList*>(entry.target)->pop_back();
+                break;
+            case Op::CALLBACK:
+                callbacks_[entry.index]();
+                break;
+        }
+        entries_.pop_back();
+    }
+
+    // resize() and clear() keep the capacity, so later marks reuse the buffers
+    cards_.resize(mark.cards);
+    rngs_.resize(mark.rngs);
+    callbacks_.resize(mark.callbacks);
+    return true;
+}
+
+void CombatJournal::clear() {
+    entries_.clear();
+    cards_.clear();
+    rngs_.clear();
+    callbacks_.clear();
+    ++generation_;
+}
+
+void CombatJournal::recordValue(int& field) {
+    entries_.push_back(Entry{Op::INT, &field, field, 0});
+}
+
+void CombatJournal::recordValue(bool& field) {
+    entries_.push_back(Entry{Op::BOOL, &field, field ? 1 : 0, 0});
+}
+
+void CombatJournal::recordRng(util::Rng& rng) {
+    entries_.push_back(Entry{Op::RNG, &rng, 0, rngs_.size()});
+    rngs_.push_back(rng);
+}
+
+void CombatJournal::recordPush(CardList& pile) {
+    entries_.push_back(Entry{Op::CARD_PUSH, &pile, 0, 0});
+}
+
+void CombatJournal::recordErase(CardList& pile, size_t index) {
+    entries_.push_back(Entry{Op::CARD_ERASE, &pile, static_cast<int64_t>(index), cards_.size()});
+    cards_.push_back(pile[index]);
+}
+
+void CombatJournal::recordPile(CardList& pile) {
+    entries_.push_back(Entry{Op::CARD_PILE, &pile, static_cast<int64_t>(pile.size()), cards_.size()});
+    cards_.insert(cards_.end(), pile.begin(), pile.end());
+}
+
+void CombatJournal::recordStatus(CustomStatusList& effects, size_t index) {
+    entries_.push_back(Entry{Op::STATUS, &effects, effects[index].second, index});
+}
+
+void CombatJournal::recordStatusAdded(CustomStatusList& effects) {
+    entries_.push_back(Entry{Op::STATUS_ADDED, &effects, 0, 0});
+}
+
+void CombatJournal::recordUndo(std::function<void()> undo) {
+    entries_.push_back(Entry{Op::CALLBACK, nullptr, 0, callbacks_.size()});
+    callbacks_.push_back(std::move(undo));
+}
+
+} // namespace deckstiny
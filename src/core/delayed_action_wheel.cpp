@@ -0,0 +1,85 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "core/delayed_action_wheel.h"
+
+#include <utility>
+
+namespace deckstiny {
+
+DelayedActionWheel::DelayedActionWheel(const DelayedActionWheel& other)
+    : slots_(other.slots_), tick_(other.tick_), size_(other.size_) {}
+
+DelayedActionWheel& DelayedActionWheel::operator=(const DelayedActionWheel& other) {
+    if (this != &other) {
+        slots_ = other.slots_;
+        tick_ = other.tick_;
+        size_ = other.size_;
+    }
+    return *this;
+}
+
+void DelayedActionWheel::schedule(DelayedCallback action, int delay, int priority, util::Symbol source) {
+    CombatAction scheduled;
+    scheduled.action = std::move(action);
+    scheduled.priority = priority;
+    scheduled.dueTick = tick_ + static_cast<uint32_t>(delay > 0 ? delay : 0);
+    scheduled.source = source;
+
+    slots_[scheduled.dueTick & (SLOT_COUNT - 1)].push_back(std::move(scheduled));
+    ++size_;
+}
+
+void DelayedActionWheel::advance() {
+    std::vector<CombatAction>& slot = slots_[tick_ & (SLOT_COUNT - 1)];
+
+    while (!slot.empty()) {
+        // Move the due actions out, so actions they schedule land in the slot
+        // again instead of invalidating the batch
+        running_.clear();
+        size_t kept = 0;
+        for (size_t i = 0; i < slot.size(); ++i) {
+            if (slot[i].dueTick == tick_) {
+                running_.push_back(std::move(slot[i]));
+            } else {
+                if (kept != i) {
+                    slot[kept] = std::move(slot[i]);
+                }
+                ++kept;
+            }
+        }
+        slot.resize(kept);
+        if (running_.empty()) {
+            break;
+        }
+        size_ -= running_.size();
+
+        // Insertion sort keeps equal priorities in scheduling order; batches
+        // are a handful of actions
+        for (size_t i = 1; i < running_.size(); ++i) {
+            CombatAction action = std::move(running_[i]);
+            size_t j = i;
+            while (j > 0 && running_[j - 1].priority < action.priority) {
+                running_[j] = std::move(running_[j - 1]);
+                --j;
+            }
+            running_[j] = std::move(action);
+        }
+
+        for (CombatAction& action : running_) {
+            action.action();
+        }
+    }
+
+    running_.clear();
+    ++tick_;
+}
+
+void DelayedActionWheel::clear() {
+    for (auto& slot : slots_) {
+        slot.clear();
+    }
+    size_ = 0;
+}
+
+} // namespace deckstiny
@@ -0,0 +1,156 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "core/encounter_index.h"
+#include "core/enemy.h"
+#include "util/logger.h"
+
+#include <algorithm>
+
+namespace deckstiny {
+
+void EncounterIndex::build(const std::unordered_map<std::string, std::shared_ptr<Enemy>>& enemies) {
+    clear();
+
+    struct Entry {
+        std::string id;
+        int64_t minFloor;
+        int64_t maxFloor;
+        int weight;
+    };
+    std::array<std::vector<Entry>, 3> entries;
+
+    for (const auto& [id, enemy] : enemies) {
+        if (!enemy) {
+            continue;
+        }
+        Entry entry{id, enemy->getMinFloor(), enemy->getMaxFloor(), enemy->getEncounterWeight()};
+        // An enemy flagged both elite and boss is eligible for both kinds of room
+        if (enemy->isElite()) {
+            entries[static_cast<size_t>(EncounterTier::ELITE)].push_back(entry);
+        }
+        if (enemy->isBoss()) {
+            entries[static_cast<size_t>(EncounterTier::BOSS)].push_back(entry);
+        }
+        if (!enemy->isElite() && !enemy->isBoss()) {
+            entries[static_cast<size_t>(EncounterTier::NORMAL)].push_back(entry);
+        }
+    }
+
+    for (size_t t = 0; t < tiers_.size(); ++t) {
+        auto& list = entries[t];
+        auto& tier = tiers_[t];
+
+        // Sorted so picks do not depend on the registry's hash order
+        std::sort(list.begin(), list.end(), [](const Entry& a, const Entry& b) { return a.id < b.id; });
+
+        int64_t total = 0;
+        for (const auto& entry : list) {
+            tier.ids.push_back(entry.id);
+            total += std::max(entry.weight, 0);
+            tier.cumulative.push_back(total);
+            if (entry.minFloor <= entry.maxFloor) {
+                tier.breakpoints.push_back(entry.minFloor);
+                tier.breakpoints.push_back(entry.maxFloor + 1);
+            }
+        }
+        std::sort(tier.breakpoints.begin(), tier.breakpoints.end());
+        tier.breakpoints.erase(std::unique(tier.breakpoints.begin(), tier.breakpoints.end()), tier.breakpoints.end());
+
+        // Membership cannot change inside a segment because every range end is a breakpoint
+        tier.segments.resize(tier.breakpoints.size());
+        for (size_t s = 0; s < tier.breakpoints.size(); ++s) {
+            int64_t start = tier.breakpoints[s];
+            Segment& segment = tier.segments[s];
+            int64_t total = 0;
+            for (size_t i = 0; i < list.size(); ++i) {
+                if (list[i].weight > 0 && list[i].minFloor <= start && start <= list[i].maxFloor) {
+                    total += list[i].weight;
+                    segment.members.push_back(static_cast<uint32_t>(i));
+                    segment.cumulative.push_back(total);
+                }
+            }
+        }
+    }
+
+    LOG_DEBUG("encounters", "Encounter index built: " + std::to_string(getCount(EncounterTier::NORMAL)) + " normal, " +
+              std::to_string(getCount(EncounterTier::ELITE)) + " elite, " +
+              std::to_string(getCount(EncounterTier::BOSS)) + " boss");
+}
+
+void EncounterIndex::clear() {
+    for (auto& tier : tiers_) {
+        tier.ids.clear();
+        tier.cumulative.clear();
+        tier.breakpoints.clear();
+        tier.segments.clear();
+    }
+}
+
+const EncounterIndex::Segment* EncounterIndex::findSegment(const TierIndex& tier, int floor) {
+    auto it = std::upper_bound(tier.breakpoints.begin(), tier.breakpoints.end(), static_cast<int64_t>(floor));
+    if (it == tier.breakpoints.begin()) {
+        return nullptr;
+    }
+    const Segment& segment = tier.segments[static_cast<size_t>(it - tier.breakpoints.begin()) - 1];
+    return segment.members.empty() ? nullptr : &segment;
+}
+
+std::string EncounterIndex::pick(EncounterTier tier, int floor, util::Rng& rng) const {
+    const TierIndex& index = tiers_[static_cast<size_t>(tier)];
+    const Segment* segment = findSegment(index, floor);
+    if (!segment) {
+        return "";
+    }
+
+    int64_t roll = static_cast<int64_t>(rng.nextBelow(static_cast<uint64_t>(segment->cumulative.back())));
+    size_t slot = static_cast<size_t>(
+        std::upper_bound(segment->cumulative.begin(), segment->cumulative.end(), roll) - segment->cumulative.begin());
+    return index.ids[segment->members[slot]];
+}
+
+std::string EncounterIndex::pickAny(EncounterTier tier, util::Rng& rng, const std::string& exclude) const {
+    const TierIndex& index = tiers_[static_cast<size_t>(tier)];
+    const std::vector<int64_t>& cumulative = index.cumulative;
+    // Zero-weight enemies are never picked, the same as in pick()
+    if (cumulative.empty() || cumulative.back() == 0) {
+        return "";
+    }
+
+    // Take the excluded enemy's weight out of the roll unless nothing else is left
+    int64_t excludedStart = 0;
+    int64_t excludedWeight = 0;
+    auto excluded = std::lower_bound(index.ids.begin(), index.ids.end(), exclude);
+    if (!exclude.empty() && excluded != index.ids.end() && *excluded == exclude) {
+        size_t slot = static_cast<size_t>(excluded - index.ids.begin());
+        excludedStart = slot > 0 ? cumulative[slot - 1] : 0;
+        excludedWeight = cumulative[slot] - excludedStart;
+        if (excludedWeight == cumulative.back()) {
+            excludedWeight = 0;
+        }
+    }
+
+    int64_t roll = static_cast<int64_t>(rng.nextBelow(static_cast<uint64_t>(cumulative.back() - excludedWeight)));
+    if (roll >= excludedStart) {
+        roll += excludedWeight;
+    }
+    size_t slot = static_cast<size_t>(std::upper_bound(cumulative.begin(), cumulative.end(), roll) - cumulative.begin());
+    return index.ids[slot];
+}
+
+std::vector<std::string> EncounterIndex::getCandidates(EncounterTier tier, int floor) const {
+    const TierIndex& index = tiers_[static_cast<size_t>(tier)];
+    std::vector<std::string> result;
+    if (const Segment* segment = findSegment(index, floor)) {
+        for (uint32_t member : segment->members) {
+            result.push_back(index.ids[member]);
+        }
+    }
+    return result;
+}
+
+size_t EncounterIndex::getCount(EncounterTier tier) const {
+    return tiers_[static_cast<size_t>(tier)].ids.size();
+}
+
+} // namespace deckstiny
@@ -4,26 +4,107 @@
 #include "core/enemy.h"
 #include "core/player.h"
 #include "core/combat.h"
-#include "core/game.h"
+#include "core/combat_journal.h"
 #include "util/logger.h"
+#include "util/rng.h"
+#include "util/trace.h"
+#include "util/trace_spans.h"
 
-#include <random>
-#include <chrono>
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
 namespace deckstiny {
 
+namespace {
+
+std::string describeIntent(const Intent& intent) {
+    std::stringstream ss;
+    if (intent.kind == IntentKind::ATTACK) {
+        ss << "Attack: " << intent.value;
+    } else if (intent.kind == IntentKind::ATTACK_DEFEND) {
+        ss << "Attack: " << intent.value << ", Defend: " << intent.secondaryValue;
+    } else if (intent.kind == IntentKind::DEFEND) {
+        ss << "Defend: " << intent.value;
+    } else if (intent.kind == IntentKind::BUFF) {
+        ss << "Buff";
+        if (!intent.effect.empty()) {
+            ss << " (" << intent.effect << " +" << intent.value << ")";
+        }
+    } else if (intent.kind == IntentKind::DEBUFF) {
+        ss << "Debuff";
+        if (!intent.effect.empty()) {
+            ss << " (" << intent.effect << " +" << intent.value << ")";
+        }
+    } else if (intent.kind == IntentKind::ATTACK_DEBUFF) {
+        ss << "Attack: " << intent.value;
+        if (!intent.effect.empty()) {
+            ss << ", Debuff (" << intent.effect;
+            if (intent.secondaryValue > 0) {
+                ss << " " << intent.secondaryValue;
+            }
+            ss << ")";
+        } else {
+            ss << ", Debuff";
+        }
+    } else if (intent.kind == IntentKind::DEFEND_DEBUFF) {
+        ss << "Defend: " << intent.value;
+        if (!intent.effect.empty()) {
+            ss << ", Debuff (" << intent.effect;
+            if (intent.secondaryValue > 0) {
+                ss << " " << intent.secondaryValue;
+            }
+            ss << ")";
+        } else {
+            ss << ", Debuff";
+        }
+    } else if (intent.kind == IntentKind::SUMMON) {
+        ss << "Summon";
+         if (intent.value > 0) {
+            ss << " (" << intent.value << ")";
+        }
+    } else {
+        ss << intent.type;
+        if (intent.value > 0) {
+            ss << " (" << intent.value << ")";
+        }
+    }
+    return ss.str();
+}
+
+} // namespace
+
 Enemy::Enemy(const std::string& id, const std::string& name, int maxHealth)
     : Character(id, name, maxHealth, 0), elite_(false), boss_(false), minGold_(10), maxGold_(20) {
 }
 
 const Intent& Enemy::getIntent() const {
-    return currentIntent_;
+    return getCurrentMove().intent;
 }
 
 void Enemy::setIntent(const Intent& intent) {
-    currentIntent_ = intent;
+    if (CombatJournal* journal = getJournal()) {
+        journal->recordUndo([this, move = customMove_, index = currentMove_]() {
+            customMove_ = move;
+            currentMove_ = index;
+        });
+    }
+    customMove_ = compileMove("", intent);
+    currentMove_ = -1;
+}
+
+void Enemy::setCurrentMoveIndex(int index) {
+    if (CombatJournal* journal = getJournal()) {
+        journal->recordValue(currentMove_);
+    }
+    currentMove_ = index;
+}
+
+const EnemyMove& Enemy::getCurrentMove() const {
+    if (currentMove_ >= 0 && moveTable_ && static_cast<size_t>(currentMove_) < moveTable_->size()) {
+        return (*moveTable_)[static_cast<size_t>(currentMove_)];
+    }
+    return customMove_;
 }
 
 bool Enemy::isElite() const {
@@ -50,28 +131,51 @@ int Enemy::getMaxGold() const {
     return maxGold_;
 }
 
+int Enemy::getMinFloor() const {
+    return minFloor_;
+}
+
+int Enemy::getMaxFloor() const {
+    return maxFloor_;
+}
+
+void Enemy::setFloorRange(int minFloor, int maxFloor) {
+    minFloor_ = minFloor;
+    maxFloor_ = maxFloor;
+}
+
+int Enemy::getEncounterWeight() const {
+    return encounterWeight_;
+}
+
+void Enemy::setEncounterWeight(int weight) {
+    encounterWeight_ = std::max(0, weight);
+}
+
 void Enemy::setGoldReward(int min, int max) {
     minGold_ = min;
     maxGold_ = max;
 }
 
 int Enemy::rollGoldReward() const {
+    return rollGoldReward(util::defaultRng());
+}
+
+int Enemy::rollGoldReward(util::Rng& rng) const {
     if (!isAlive()) {
-        unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-        std::mt19937 gen(seed);
-        std::uniform_int_distribution<> dist(minGold_, maxGold_);
-        return dist(gen);
+        return rng.uniformInt(std::min(minGold_, maxGold_), std::max(minGold_, maxGold_));
     }
     return 0;
 }
 
 void Enemy::chooseNextMove(Combat* combat, Player* player) {
-    if (moves_.empty()) {
+    if (moves_.empty() || !moveTable_) {
         LOG_ERROR("combat", "Enemy " + getName() + " has no moves available");
 
-        currentIntent_.type = "unknown";
-        currentIntent_.value = 0;
-        currentIntent_.target = "player";
+        Intent unknown;
+        unknown.type = "unknown";
+        unknown.target = "player";
+        setIntent(unknown);
         return;
     }
     
@@ -79,115 +183,95 @@ void Enemy::chooseNextMove(Combat* combat, Player* player) {
     
     int playerHealth = player ? player->getHealth() : 0;
     
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    std::mt19937 gen(seed);
-    std::uniform_int_distribution<> dist(0, moves_.size() - 1);
-    int moveIndex = dist(gen);
+    util::Rng& rng = combat ? combat->getRng() : util::defaultRng();
+    if (CombatJournal* journal = getJournal()) {
+        journal->recordRng(rng);
+    }
+    int moveIndex = static_cast<int>(rng.index(moves_.size()));
     
-    (void)combat;
     (void)playerHealth;
-    std::string moveId = moves_[moveIndex];
+    setCurrentMoveIndex(moveIndex);
+    const EnemyMove& move = getCurrentMove();
+    TRACE_RECORD(INTENT_CHOSEN, getIdSymbol(), move.idSymbol, moveIndex, move.intent.value);
     
-    LOG_DEBUG("combat", "Selected move: " + moveId + " for enemy " + getName());
+    LOG_DEBUG("combat", "Selected move: " + move.id + " for enemy " + getName());
     
-    auto it = moveIntents_.find(moveId);
-    if (it != moveIntents_.end()) {
-        currentIntent_ = it->second;
-        LOG_DEBUG("combat", "Set intent to type=" + currentIntent_.type + 
-                 ", value=" + std::to_string(currentIntent_.value) + 
-                 ", target=" + currentIntent_.target + 
-                 (currentIntent_.effect.empty() ? "" : ", effect=" + currentIntent_.effect));
+    if (move.intent.kind != IntentKind::UNKNOWN) {
+        LOG_DEBUG("combat", "Set intent to type=" + move.intent.type + 
+                 ", value=" + std::to_string(move.intent.value) + 
+                 ", target=" + move.intent.target + 
+                 (move.intent.effect.empty() ? "" : ", effect=" + move.intent.effect));
     } else {
-        LOG_ERROR("combat", "No intent found for move " + moveId + " on enemy " + getName());
-        currentIntent_.type = "unknown";
-        currentIntent_.value = 0;
-        currentIntent_.target = "player";
+        LOG_ERROR("combat", "No intent found for move " + move.id + " on enemy " + getName());
     }
 }
 
 void Enemy::takeTurn(Combat* combat, Player* player) {
+    TRACE_SCOPE("combat", "enemy_turn");
     if (!isAlive() || !player) {
         return;
     }
     
-    (void)combat;
-    
-    if (currentIntent_.type == "attack") {
-        int finalDamage = currentIntent_.value;
-        if (hasStatusEffect("weak")) {
-            finalDamage = static_cast<int>(std::round(finalDamage * 0.75));
-            LOG_DEBUG("combat", getName() + " is Weak, attack damage reduced to " + std::to_string(finalDamage));
-        }
-        player->takeDamage(finalDamage);
-    } else if (currentIntent_.type == "attack_defend") {
-        int finalDamage = currentIntent_.value;
-        if (hasStatusEffect("weak")) {
-            finalDamage = static_cast<int>(std::round(finalDamage * 0.75));
-            LOG_DEBUG("combat", getName() + " is Weak, attack_defend damage reduced to " + std::to_string(finalDamage));
-        }
-        player->takeDamage(finalDamage);
-        addBlock(currentIntent_.secondaryValue);
-    } else if (currentIntent_.type == "buff") {
-        if (!currentIntent_.effect.empty()) {
-            addStatusEffect(currentIntent_.effect, currentIntent_.value);
-        }
-        
-        if (currentIntent_.secondaryValue > 0) {
-            addBlock(currentIntent_.secondaryValue);
-        }
-    } else if (currentIntent_.type == "defend") {
-        addBlock(currentIntent_.value);
-    } else if (currentIntent_.type == "debuff") {
-        if (!currentIntent_.effect.empty()) {
-            player->addStatusEffect(currentIntent_.effect, currentIntent_.value);
-        }
-    } else if (currentIntent_.type == "summon") {
-        LOG_DEBUG("combat", getName() + " is summoning. Intent value: " + std::to_string(currentIntent_.value));
-        std::string summonType = "";
-        int numToSummon = currentIntent_.value;
-
-        if (currentIntent_.associatedEffectsJson.is_array()) {
-            for (const auto& effectJson : currentIntent_.associatedEffectsJson) {
-                if (effectJson.is_object() && effectJson.value("type", "") == "summon") {
-                    summonType = effectJson.value("summon_type", "");
-                    break; 
+    const EnemyMove& move = getCurrentMove();
+    if (move.intent.kind == IntentKind::UNKNOWN) {
+        LOG_WARNING("combat", "Unknown intent type '" + move.intent.type + "' for enemy " + getName());
+        return;
+    }
+
+    for (const MoveEffect& effect : move.program) {
+        switch (effect.op) {
+            case MoveOp::ATTACK: {
+                int finalDamage = effect.value;
+                if (hasStatusEffect(StatusEffect::WEAK)) {
+                    finalDamage = static_cast<int>(std::round(finalDamage * 0.75));
+                    LOG_DEBUG("combat", getName() + " is Weak, " + move.intent.type + " damage reduced to " + std::to_string(finalDamage));
+                }
+                if (player->getTriggers().hasHandlers(Trigger::ON_DAMAGE_TAKEN)) {
+                    TriggerContext context;
+                    context.combat = combat;
+                    context.amount = finalDamage;
+                    player->fireTrigger(Trigger::ON_DAMAGE_TAKEN, context);
+                    finalDamage = context.amount;
                 }
+                player->takeDamage(finalDamage);
+                break;
             }
-        }
 
-        if (!summonType.empty() && numToSummon > 0 && combat && combat->getGame()) {
-            LOG_INFO("combat", getName() + " attempts to summon " + std::to_string(numToSummon) + " of type '" + summonType + "'");
-            for (int i = 0; i < numToSummon; ++i) {
-                std::shared_ptr<Enemy> summonedEnemy = combat->getGame()->loadEnemy(summonType);
-                if (summonedEnemy) {
-                    combat->addEnemy(summonedEnemy);
-                    LOG_INFO("combat", "Successfully summoned a " + summonType + ". Total enemies: " + std::to_string(combat->getEnemyCount()));
+            case MoveOp::BLOCK:
+                addBlock(effect.value);
+                break;
+
+            case MoveOp::STATUS_SELF:
+                addStatusEffect(effect.symbol, effect.value);
+                break;
+
+            case MoveOp::STATUS_PLAYER:
+                player->addStatusEffect(effect.symbol, effect.value);
+                LOG_DEBUG("combat", getName() + " applied debuff '" + effect.symbol.str() + "' for " + std::to_string(effect.value) + " turns to player.");
+                break;
+
+            case MoveOp::SUMMON: {
+                const std::string& summonType = effect.symbol.str();
+                int numToSummon = effect.value;
+                LOG_DEBUG("combat", getName() + " is summoning. Intent value: " + std::to_string(numToSummon));
+
+                if (!summonType.empty() && numToSummon > 0 && combat && combat->getHost()) {
+                    LOG_INFO("combat", getName() + " attempts to summon " + std::to_string(numToSummon) + " of type '" + summonType + "'");
+                    for (int i = 0; i < numToSummon; ++i) {
+                        std::shared_ptr<Enemy> summonedEnemy = combat->getHost()->loadEnemy(summonType);
+                        if (summonedEnemy) {
+                            combat->addEnemy(summonedEnemy);
+                            LOG_INFO("combat", "Successfully summoned a " + summonType + ". Total enemies: " + std::to_string(combat->getEnemyCount()));
+                        } else {
+                            LOG_ERROR("combat", "Failed to load enemy type '" + summonType + "' for summoning.");
+                        }
+                    }
                 } else {
-                    LOG_ERROR("combat", "Failed to load enemy type '" + summonType + "' for summoning.");
+                    LOG_WARNING("combat", getName() + " summon failed. SummonType: '" + summonType + "', NumToSummon: " + std::to_string(numToSummon) + ", Combat valid: " + (combat ? "true":"false") + ", Host valid: " + (combat && combat->getHost() ? "true":"false"));
                 }
+                break;
             }
-        } else {
-            LOG_WARNING("combat", getName() + " summon failed. SummonType: '" + summonType + "', NumToSummon: " + std::to_string(numToSummon) + ", Combat valid: " + (combat ? "true":"false") + ", Game valid: " + (combat && combat->getGame() ? "true":"false"));
-        }
-    } else if (currentIntent_.type == "attack_debuff") {
-        int finalDamage = currentIntent_.value;
-        if (hasStatusEffect("weak")) {
-            finalDamage = static_cast<int>(std::round(finalDamage * 0.75));
-            LOG_DEBUG("combat", getName() + " is Weak, attack_debuff damage reduced to " + std::to_string(finalDamage));
-        }
-        if (player) player->takeDamage(finalDamage);
-        if (player && !currentIntent_.effect.empty() && currentIntent_.secondaryValue > 0) {
-            player->addStatusEffect(currentIntent_.effect, currentIntent_.secondaryValue);
-            LOG_DEBUG("combat", getName() + " applied debuff '" + currentIntent_.effect + "' for " + std::to_string(currentIntent_.secondaryValue) + " turns to player.");
         }
-    } else if (currentIntent_.type == "defend_debuff") {
-        addBlock(currentIntent_.value);
-        if (player && !currentIntent_.effect.empty() && currentIntent_.secondaryValue > 0) {
-            player->addStatusEffect(currentIntent_.effect, currentIntent_.secondaryValue);
-            LOG_DEBUG("combat", getName() + " applied debuff '" + currentIntent_.effect + "' for " + std::to_string(currentIntent_.secondaryValue) + " turns to player while defending.");
-        }
-    } else {
-        LOG_WARNING("combat", "Unknown intent type '" + currentIntent_.type + "' for enemy " + getName());
     }
 }
 
@@ -195,10 +279,104 @@ const std::vector<std::string>& Enemy::getPossibleMoves() const {
     return moves_;
 }
 
+const EnemyMove* Enemy::getMove(size_t index) const {
+    if (moveTable_ && index < moveTable_->size()) {
+        return &(*moveTable_)[index];
+    }
+    return nullptr;
+}
+
 void Enemy::addPossibleMove(const std::string& moveId) {
     if (std::find(moves_.begin(), moves_.end(), moveId) == moves_.end()) {
         moves_.push_back(moveId);
+
+        // The table may be shared with clones, so copy it before appending
+        auto table = moveTable_ ? std::make_shared<std::vector<EnemyMove>>(*moveTable_)
+                                : std::make_shared<std::vector<EnemyMove>>();
+        Intent unknown;
+        unknown.type = "unknown";
+        unknown.target = "player";
+        table->push_back(compileMove(moveId, unknown));
+        moveTable_ = std::move(table);
+    }
+}
+
+EnemyMove Enemy::compileMove(const std::string& id, const Intent& intent, util::Symbol summonId) {
+    EnemyMove move;
+    move.id = id;
+    move.idSymbol = util::Symbol::intern(id);
+    move.intent = intent;
+    move.intent.effectSymbol = intent.effect.empty() ? util::Symbol() : util::Symbol::intern(intent.effect);
+
+    static const std::pair<const char*, IntentKind> kinds[] = {
+        {"attack", IntentKind::ATTACK},
+        {"attack_defend", IntentKind::ATTACK_DEFEND},
+        {"attack_debuff", IntentKind::ATTACK_DEBUFF},
+        {"defend", IntentKind::DEFEND},
+        {"defend_debuff", IntentKind::DEFEND_DEBUFF},
+        {"buff", IntentKind::BUFF},
+        {"debuff", IntentKind::DEBUFF},
+        {"summon", IntentKind::SUMMON}
+    };
+    move.intent.kind = IntentKind::UNKNOWN;
+    for (const auto& [name, kind] : kinds) {
+        if (intent.type == name) {
+            move.intent.kind = kind;
+            break;
+        }
+    }
+
+    const Intent& compiled = move.intent;
+    bool hasEffect = compiled.effectSymbol.isValid();
+    auto emit = [&move](MoveOp op, int value, util::Symbol symbol = util::Symbol()) {
+        move.program.push_back({op, value, symbol});
+    };
+
+    switch (compiled.kind) {
+        case IntentKind::ATTACK:
+            emit(MoveOp::ATTACK, compiled.value);
+            break;
+        case IntentKind::ATTACK_DEFEND:
+            emit(MoveOp::ATTACK, compiled.value);
+            emit(MoveOp::BLOCK, compiled.secondaryValue);
+            break;
+        case IntentKind::ATTACK_DEBUFF:
+            emit(MoveOp::ATTACK, compiled.value);
+            if (hasEffect && compiled.secondaryValue > 0) {
+                emit(MoveOp::STATUS_PLAYER, compiled.secondaryValue, compiled.effectSymbol);
+            }
+            break;
+        case IntentKind::DEFEND:
+            emit(MoveOp::BLOCK, compiled.value);
+            break;
+        case IntentKind::DEFEND_DEBUFF:
+            emit(MoveOp::BLOCK, compiled.value);
+            if (hasEffect && compiled.secondaryValue > 0) {
+                emit(MoveOp::STATUS_PLAYER, compiled.secondaryValue, compiled.effectSymbol);
+            }
+            break;
+        case IntentKind::BUFF:
+            if (hasEffect) {
+                emit(MoveOp::STATUS_SELF, compiled.value, compiled.effectSymbol);
+            }
+            if (compiled.secondaryValue > 0) {
+                emit(MoveOp::BLOCK, compiled.secondaryValue);
+            }
+            break;
+        case IntentKind::DEBUFF:
+            if (hasEffect) {
+                emit(MoveOp::STATUS_PLAYER, compiled.value, compiled.effectSymbol);
+            }
+            break;
+        case IntentKind::SUMMON:
+            emit(MoveOp::SUMMON, compiled.value, summonId);
+            break;
+        case IntentKind::UNKNOWN:
+            break;
     }
+
+    move.description = describeIntent(compiled);
+    return move;
 }
 
 void Enemy::startTurn() {
@@ -232,12 +410,25 @@ bool Enemy::loadFromJson(const nlohmann::json& json) {
         if (json.contains("max_gold")) {
             maxGold_ = json["max_gold"].get<int>();
         }
+
+        if (json.contains("min_floor")) {
+            minFloor_ = json["min_floor"].get<int>();
+        }
+
+        if (json.contains("max_floor")) {
+            maxFloor_ = json["max_floor"].get<int>();
+        }
+
+        if (json.contains("encounter_weight")) {
+            setEncounterWeight(json["encounter_weight"].get<int>());
+        }
         
         LOG_INFO("enemy", "Created enemy: " + getName() + " with " + std::to_string(getHealth()) + "/" + 
                 std::to_string(getMaxHealth()) + " HP");
         
-        moveIntents_.clear();
         moves_.clear();
+        moveTable_.reset();
+        currentMove_ = -1;
         
         if (!json.contains("moves") || !json["moves"].is_array() || json["moves"].empty()) {
             LOG_ERROR("enemy", "Enemy " + getId() + " has no moves defined in JSON");
@@ -245,6 +436,9 @@ bool Enemy::loadFromJson(const nlohmann::json& json) {
         }
         
         LOG_DEBUG("enemy", "Loading " + std::to_string(json["moves"].size()) + " moves for enemy " + getId());
+
+        auto table = std::make_shared<std::vector<EnemyMove>>();
+        table->reserve(json["moves"].size());
             
         for (const auto& move : json["moves"]) {
             if (!move.contains("id")) {
@@ -253,7 +447,6 @@ bool Enemy::loadFromJson(const nlohmann::json& json) {
             }
                 
             std::string moveId = move["id"].get<std::string>();
-            addPossibleMove(moveId);
             LOG_DEBUG("enemy", "Added move: " + moveId + " for enemy " + getId());
                 
             if (!move.contains("intent")) {
@@ -285,21 +478,43 @@ bool Enemy::loadFromJson(const nlohmann::json& json) {
             if (intentData.contains("effect")) {
                 intent.effect = intentData["effect"].get<std::string>();
             }
-                
+
+            // Summons name the enemy to create in the move's effects array
+            util::Symbol summonId;
             if (move.contains("effects") && move["effects"].is_array()) {
-                intent.associatedEffectsJson = move["effects"];
+                for (const auto& effectJson : move["effects"]) {
+                    if (effectJson.is_object() && effectJson.value("type", "") == "summon") {
+                        std::string summonType = effectJson.value("summon_type", "");
+                        if (!summonType.empty()) {
+                            summonId = util::Symbol::intern(summonType);
+                        }
+                        break;
+                    }
+                }
+            }
+
+            EnemyMove compiled = compileMove(moveId, intent, summonId);
+            if (compiled.intent.kind == IntentKind::UNKNOWN) {
+                LOG_WARNING("enemy", "Move " + moveId + " of enemy " + getId() + " has unknown intent type '" + intent.type + "'");
+            }
+
+            auto existing = std::find(moves_.begin(), moves_.end(), moveId);
+            if (existing != moves_.end()) {
+                (*table)[static_cast<size_t>(existing - moves_.begin())] = std::move(compiled);
+            } else {
+                moves_.push_back(moveId);
+                table->push_back(std::move(compiled));
             }
-            
-            moveIntents_[moveId] = intent;
             LOG_DEBUG("enemy", "Added intent for move " + moveId + ": type=" + intent.type + 
                       ", value=" + std::to_string(intent.value) + 
                       ", target=" + intent.target + 
                       (intent.secondaryValue > 0 ? ", secondary_value=" + std::to_string(intent.secondaryValue) : "") + 
                       (intent.effect.empty() ? "" : ", effect=" + intent.effect));
         }
+
+        moveTable_ = std::move(table);
         
-        LOG_INFO("enemy", "Enemy " + getId() + " loaded " + std::to_string(moves_.size()) + 
-                 " moves and " + std::to_string(moveIntents_.size()) + " intents");
+        LOG_INFO("enemy", "Enemy " + getId() + " loaded " + std::to_string(moves_.size()) + " moves");
         
         return true;
     } catch (const std::exception& e) {
@@ -313,19 +528,16 @@ std::unique_ptr<Entity> Enemy::clone() const {
     enemy->setElite(elite_);
     enemy->setBoss(boss_);
     enemy->setGoldReward(minGold_, maxGold_);
+    enemy->setFloorRange(minFloor_, maxFloor_);
+    enemy->setEncounterWeight(encounterWeight_);
     
-    for (const auto& move : moves_) {
-        enemy->addPossibleMove(move);
-    }
-    
-    enemy->moveIntents_ = moveIntents_;
+    enemy->moves_ = moves_;
+    enemy->moveTable_ = moveTable_;
     
     enemy->setHealth(getHealth());
     enemy->addBlock(getBlock());
     
-    for (const auto& effect : getStatusEffects()) {
-        enemy->addStatusEffect(effect.first, effect.second);
-    }
+    enemy->copyStatusEffects(*this);
     
     return enemy;
 }
@@ -335,75 +547,22 @@ std::shared_ptr<Enemy> Enemy::cloneEnemy() const {
     enemy->setElite(elite_);
     enemy->setBoss(boss_);
     enemy->setGoldReward(minGold_, maxGold_);
+    enemy->setFloorRange(minFloor_, maxFloor_);
+    enemy->setEncounterWeight(encounterWeight_);
     
-    for (const auto& move : moves_) {
-        enemy->addPossibleMove(move);
-    }
-    
-    enemy->moveIntents_ = moveIntents_;
+    enemy->moves_ = moves_;
+    enemy->moveTable_ = moveTable_;
     
     enemy->setHealth(getHealth());
     enemy->addBlock(getBlock());
     
-    for (const auto& effect : getStatusEffects()) {
-        enemy->addStatusEffect(effect.first, effect.second);
-    }
+    enemy->copyStatusEffects(*this);
     
     return enemy;
 }
 
-std::string Enemy::getIntentDescription() const {
-    std::stringstream ss;
-    if (currentIntent_.type == "attack") {
-        ss << "Attack: " << currentIntent_.value;
-    } else if (currentIntent_.type == "attack_defend") {
-        ss << "Attack: " << currentIntent_.value << ", Defend: " << currentIntent_.secondaryValue;
-    } else if (currentIntent_.type == "defend") {
-        ss << "Defend: " << currentIntent_.value;
-    } else if (currentIntent_.type == "buff") {
-        ss << "Buff";
-        if (!currentIntent_.effect.empty()) {
-            ss << " (" << currentIntent_.effect << " +" << currentIntent_.value << ")";
-        }
-    } else if (currentIntent_.type == "debuff") {
-        ss << "Debuff";
-        if (!currentIntent_.effect.empty()) {
-            ss << " (" << currentIntent_.effect << " +" << currentIntent_.value << ")";
-        }
-    } else if (currentIntent_.type == "attack_debuff") {
-        ss << "Attack: " << currentIntent_.value;
-        if (!currentIntent_.effect.empty()) {
-            ss << ", Debuff (" << currentIntent_.effect;
-            if (currentIntent_.secondaryValue > 0) {
-                ss << " " << currentIntent_.secondaryValue;
-            }
-            ss << ")";
-        } else {
-            ss << ", Debuff";
-        }
-    } else if (currentIntent_.type == "defend_debuff") {
-        ss << "Defend: " << currentIntent_.value;
-        if (!currentIntent_.effect.empty()) {
-            ss << ", Debuff (" << currentIntent_.effect;
-            if (currentIntent_.secondaryValue > 0) {
-                ss << " " << currentIntent_.secondaryValue;
-            }
-            ss << ")";
-        } else {
-            ss << ", Debuff";
-        }
-    } else if (currentIntent_.type == "summon") {
-        ss << "Summon";
-         if (currentIntent_.value > 0) {
-            ss << " (" << currentIntent_.value << ")";
-        }
-    } else {
-        ss << currentIntent_.type;
-        if (currentIntent_.value > 0) {
-            ss << " (" << currentIntent_.value << ")";
-        }
-    }
-    return ss.str();
+const std::string& Enemy::getIntentDescription() const {
+    return getCurrentMove().description;
 }
 
 } // namespace deckstiny 
\ No newline at end of file
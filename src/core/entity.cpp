@@ -6,10 +6,14 @@
 namespace deckstiny {
 
 Entity::Entity(const std::string& id, const std::string& name)
-    : id_(id), name_(name) {
+    : id_(util::Symbol::intern(id)), name_(name) {
 }
 
 const std::string& Entity::getId() const {
+    return id_.str();
+}
+
+util::Symbol Entity::getIdSymbol() const {
     return id_;
 }
 
@@ -24,7 +28,7 @@ void Entity::setName(const std::string& name) {
 bool Entity::loadFromJson(const nlohmann::json& json) {
     try {
         if (json.contains("id")) {
-            id_ = json["id"].get<std::string>();
+            id_ = util::Symbol::intern(json["id"].get<std::string>());
         }
         
         if (json.contains("name")) {
@@ -38,7 +42,7 @@ bool Entity::loadFromJson(const nlohmann::json& json) {
 }
 
 std::unique_ptr<Entity> Entity::clone() const {
-    return std::make_unique<Entity>(id_, name_);
+    return std::make_unique<Entity>(id_.str(), name_);
 }
 
 } // namespace deckstiny 
\ No newline at end of file
@@ -11,15 +11,20 @@
 #include "core/event.h"
 #include "ui/ui_interface.h"
 #include "util/logger.h"
+#include "util/metrics.h"
 #include "util/path_util.h"
+#include "util/content_pack.h"
+#include "util/thread_pool.h"
+#include "util/trace.h"
+#include "util/trace_spans.h"
 
 #include <iostream>
 #include <fstream>
 #include <sstream>
-#include <random>
 #include <chrono>
 #include <algorithm>
 #include <filesystem>
+#include <future>
 #include <nlohmann/json.hpp>
 #include <thread>
 
@@ -28,6 +33,161 @@ using json = nlohmann::json;
 
 namespace deckstiny {
 
+namespace {
+
+// Fill CharacterData from a character JSON document
+bool parseCharacterData(const json& charJson, const std::string& fallbackId, CharacterData& data) {
+    try {
+        data.id = charJson.value("id", fallbackId);
+        data.name = charJson.at("name").get<std::string>();
+        data.max_health = charJson.at("max_health").get<int>();
+        data.base_energy = charJson.at("base_energy").get<int>();
+        data.initial_hand_size = charJson.at("initial_hand_size").get<int>();
+        data.description = charJson.value("description", "");
+
+        if (charJson.contains("starting_deck") && charJson["starting_deck"].is_array()) {
+            for (const auto& deck_item : charJson["starting_deck"]) {
+                data.starting_deck.push_back(deck_item.get<std::string>());
+            }
+        }
+        if (charJson.contains("starting_relics") && charJson["starting_relics"].is_array()) {
+            for (const auto& relic_item : charJson["starting_relics"]) {
+                data.starting_relics.push_back(relic_item.get<std::string>());
+            }
+        }
+        return true;
+    } catch (const json::exception& e) {
+        LOG_ERROR("game", "Invalid character data for '" + fallbackId + "': " + e.what());
+        return false;
+    }
+}
+
+// Build a registry template from an already parsed JSON document
+template <typename T>
+std::shared_ptr<T> buildFromJson(const json& document) {
+    auto entity = std::make_shared<T>();
+    if (!entity->loadFromJson(document)) {
+        return nullptr;
+    }
+    return entity;
+}
+
+} // namespace
+
+/**
+ * @struct LoadedContent
+ * @brief Result of loading one content document on a loader thread
+ */
+struct LoadedContent {
+    util::ContentKind kind = util::ContentKind::CARD; ///< Registry the content belongs to
+    std::string id;                                   ///< Registry key (file name stem or pack record ID)
+    std::string source;                               ///< Origin of the content, for diagnostics
+    bool loaded = false;                              ///< Whether the template was built
+    std::string error;                                ///< Failure reason when not loaded
+    double millis = 0.0;                              ///< Time spent reading, parsing and building
+    CharacterData character;                          ///< Loaded character (CHARACTER)
+    std::shared_ptr<Card> card;                       ///< Loaded card template (CARD)
+    std::shared_ptr<Enemy> enemy;                     ///< Loaded enemy template (ENEMY)
+    std::shared_ptr<Relic> relic;                     ///< Loaded relic template (RELIC)
+    std::shared_ptr<Event> event;                     ///< Loaded event template (EVENT)
+};
+
+namespace {
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Build the template described by a document into the matching LoadedContent slot
+void buildContent(LoadedContent& content, const json& document) {
+    switch (content.kind) {
+        case util::ContentKind::CHARACTER:
+            content.loaded = parseCharacterData(document, content.id, content.character);
+            break;
+        case util::ContentKind::CARD:
+            content.card = buildFromJson<Card>(document);
+            content.loaded = content.card != nullptr;
+            break;
+        case util::ContentKind::ENEMY:
+            content.enemy = buildFromJson<Enemy>(document);
+            content.loaded = content.enemy != nullptr;
+            break;
+        case util::ContentKind::RELIC:
+            content.relic = buildFromJson<Relic>(document);
+            content.loaded = content.relic != nullptr;
+            break;
+        case util::ContentKind::EVENT:
+            content.event = buildFromJson<Event>(document);
+            content.loaded = content.event != nullptr;
+            break;
+    }
+    if (!content.loaded && content.error.empty()) {
+        content.error = "Failed to load data from JSON";
+    }
+}
+
+// Read, parse and build a single content file (runs on a loader thread)
+LoadedContent loadContentFile(util::ContentKind kind, const fs::path& path) {
+    auto start = std::chrono::steady_clock::now();
+
+    LoadedContent content;
+    content.kind = kind;
+    content.id = path.stem().string();
+    content.source = path.string();
+    LOG_DEBUG("game", "Attempting to load " + std::string(util::contentKindDirectory(kind)) + " '" + content.id + "' from: " + content.source);
+
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        content.error = "Could not open file";
+    } else {
+        try {
+            json document;
+            file >> document;
+            buildContent(content, document);
+        } catch (const json::exception& e) {
+            content.error = "JSON parsing error: " + std::string(e.what());
+        }
+    }
+
+    content.millis = millisecondsSince(start);
+    return content;
+}
+
+// Decode and build a single content pack record (runs on a loader thread)
+LoadedContent loadContentRecord(const util::ContentPack& pack, size_t index) {
+    auto start = std::chrono::steady_clock::now();
+
+    LoadedContent content;
+    content.kind = pack.getRecordKind(index);
+    content.id = pack.getRecordId(index);
+    content.source = "content pack record " + std::to_string(index);
+
+    json document;
+    if (pack.decodeRecord(index, document)) {
+        buildContent(content, document);
+    } else {
+        content.error = "Malformed record";
+    }
+
+    content.millis = millisecondsSince(start);
+    return content;
+}
+
+// JSON files of a content directory in a stable (sorted) order
+std::vector<fs::path> listContentFiles(const fs::path& directory) {
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(directory)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".json") {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+} // namespace
+
+
 std::string GameStateToString(GameState state) {
     switch (state) {
         case GameState::MAIN_MENU: return "MAIN_MENU";
@@ -54,6 +214,10 @@ Game::~Game() {
 
 void Game::initializeLogging() {
     util::Logger::init();
+    if (!util::Logger::getInstance().isEnabled()) {
+        // Logging was switched off by the embedding program (e.g. the headless simulator)
+        return;
+    }
 
     const char* appDirEnv = std::getenv("APPDIR");
     if (appDirEnv) {
@@ -130,6 +294,7 @@ void Game::prepareUserSpecificData() {
 }
 
 bool Game::initialize(std::shared_ptr<UIInterface> uiInterface) {
+    TRACE_SCOPE("game", "initialize");
     initializeLogging();
     prepareUserSpecificData();
 
@@ -140,8 +305,6 @@ bool Game::initialize(std::shared_ptr<UIInterface> uiInterface) {
     ui_ = uiInterface;
     LOG_INFO("game", "Game::initialize called. UIInterface assigned. Relying on external logger configuration.");
 
-    srand(time(0));
-    
     if (!ui_->initialize(this)) {
         LOG_ERROR("system", "Failed to initialize UI");
         return false;
@@ -158,8 +321,7 @@ bool Game::initialize(std::shared_ptr<UIInterface> uiInterface) {
     initializeInputHandlers();
     LOG_DEBUG("system", "Input handlers initialized");
     
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    rng_.seed(seed);
+    rng_.reseed(RunRng::randomSeed());
 
     if (!loadGameData()) {
         LOG_ERROR("game", "Failed to load essential game data during Game::initialize.");
@@ -172,9 +334,7 @@ bool Game::initialize(std::shared_ptr<UIInterface> uiInterface) {
 
 void Game::run() {
     LOG_INFO("game", "Starting game loop");
-    running_ = true;
-    
-    setState(GameState::MAIN_MENU);
+    start();
     
     LOG_INFO("game", "Game loop started");
     
@@ -185,6 +345,11 @@ void Game::run() {
     LOG_INFO("game", "Game loop ended");
 }
 
+void Game::start() {
+    running_ = true;
+    setState(GameState::MAIN_MENU);
+}
+
 void Game::shutdown() {
     LOG_INFO("game", "Shutting down game");
     running_ = false;
@@ -192,12 +357,25 @@ void Game::shutdown() {
 }
 
 void Game::setState(GameState newState) {
+    static util::Histogram& latency = util::MetricsRegistry::getInstance().histogram(
+        "deckstiny_game_set_state_seconds", "Time spent in Game::setState, including screen setup");
+    static util::Counter& transitions = util::MetricsRegistry::getInstance().counter(
+        "deckstiny_game_state_changes_total", "Calls to Game::setState");
+    static util::Gauge& currentState = util::MetricsRegistry::getInstance().gauge(
+        "deckstiny_game_state", "GameState value last set by Game::setState");
+    util::ScopedLatency timer(latency);
+    transitions.add();
+    currentState.set(static_cast<int64_t>(newState));
+
     LOG_DEBUG("game", "Attempting to change state from " + GameStateToString(state_) +
              " to " + GameStateToString(newState));
 
     GameState previousState = state_;
     LOG_DEBUG("game_trace", "Game::setState called. Previous: " + GameStateToString(previousState) + ", New: " + GameStateToString(newState));
     state_ = newState;
+    TRACE_RECORD(STATE_CHANGED, util::Symbol::intern(GameStateToString(previousState)),
+                 util::Symbol::intern(GameStateToString(newState)),
+                 static_cast<int>(previousState), static_cast<int>(newState));
 
     LOG_DEBUG("game", "newState value before switch: " + GameStateToString(newState) + ", current state_ after assignment: " + GameStateToString(state_));
 
@@ -277,7 +455,10 @@ void Game::setState(GameState newState) {
                     break;
                 }
                 if (!allEvents_.empty()) {
-                   startEvent(allEvents_.begin()->first);
+                   // The smallest id, so the fallback event does not depend on hash order
+                   auto first = std::min_element(allEvents_.begin(), allEvents_.end(),
+                       [](const auto& a, const auto& b) { return a.first < b.first; });
+                   startEvent(first->first);
             } else {
                     LOG_ERROR("game", "No events loaded to start (logic error).");
                     setState(GameState::MAP);
@@ -399,7 +580,9 @@ bool Game::startCombat(const std::vector<std::string>& enemies) {
     
     currentCombat_ = std::make_unique<Combat>(player_.get());
     
-    currentCombat_->setGame(this);
+    currentCombat_->setHost(this);
+    currentCombat_->setRng(&rng_.get(RngStream::AI));
+    player_->setShuffleRng(&rng_.get(RngStream::SHUFFLE));
     
     for (const auto& enemyId : enemies) {
         auto enemy = loadEnemy(enemyId);
@@ -408,8 +591,15 @@ bool Game::startCombat(const std::vector<std::string>& enemies) {
         }
     }
     
+    // Relic COMBAT_START effects can target the enemies, so bind the combat first
+    player_->setCurrentCombat(currentCombat_.get());
     player_->beginCombat();
     currentCombat_->start();
+
+    // Only the player's own turn can be taken back, so the journal starts after setup
+    combatJournal_.clear();
+    undoMarks_.clear();
+    currentCombat_->setJournal(&combatJournal_);
     
     setState(GameState::COMBAT);
     
@@ -425,10 +615,13 @@ void Game::endCombat(bool victorious) {
     LOG_INFO("game", "Ending combat. Victory: " + std::string(victorious ? "true" : "false"));
     
     transitioningFromCombat_ = true;
+    currentCombat_->setJournal(nullptr);
+    combatJournal_.clear();
+    undoMarks_.clear();
     
     try {
         try {
-            player_->endCombat();
+            player_->endCombat(victorious);
         } catch (const std::exception& e) {
             LOG_ERROR("game", "Exception in player->endCombat: " + std::string(e.what()));
         }
@@ -447,7 +640,7 @@ void Game::endCombat(bool victorious) {
                 for (const auto& enemy : currentCombat_->getEnemies()) {
                     if (enemy) {
                         try {
-                            goldReward += enemy->rollGoldReward();
+                            goldReward += enemy->rollGoldReward(rng_.get(RngStream::REWARDS));
                         } catch (const std::exception& e) {
                             LOG_ERROR("game", "Exception rolling gold reward: " + std::string(e.what()));
                         }
@@ -532,7 +725,7 @@ GameMap* Game::getMap() const {
 
 bool Game::generateMap(int act) {
     map_ = std::make_unique<GameMap>();
-    return map_->generate(act);
+    return map_->generate(act, rng_.get(RngStream::MAP)());
 }
 
 std::shared_ptr<Card> Game::loadCard(const std::string& id) {
@@ -545,48 +738,8 @@ std::shared_ptr<Card> Game::loadCard(const std::string& id) {
 }
 
 bool Game::loadAllCards() {
-    failedLoads_ = 0;
-    try {
-        std::string data_prefix = get_data_path_prefix();
-        std::string cards_dir_path = data_prefix + "data/cards";
-        LOG_DEBUG("game", "Loading all cards from directory: " + cards_dir_path);
-        if (!fs::exists(cards_dir_path) || !fs::is_directory(cards_dir_path)) {
-            LOG_ERROR("game", "Cards directory not found or is not a directory: " + cards_dir_path);
-            return false;
-        }
-        for (const auto& entry : fs::directory_iterator(cards_dir_path)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".json") {
-                std::string id_from_filename = entry.path().stem().string();
-                LOG_DEBUG("game", "Attempting to load card '" + id_from_filename + "' from: " + entry.path().string());
-                std::ifstream file(entry.path());
-        if (!file.is_open()) {
-                    LOG_ERROR("game", "Could not open card file: " + entry.path().string());
-                    failedLoads_++;
-                    continue;
-        }
-                json cardJson;
-                file >> cardJson;
-                file.close();
-        
-        auto card = std::make_shared<Card>();
-                if (!card->loadFromJson(cardJson)) {
-                    LOG_ERROR("game", "Failed to load card data from JSON for file: " + entry.path().string());
-                    failedLoads_++;
-                    continue;
-        }
-
-                allCards_[id_from_filename] = card;
-    }
-}
-        LOG_INFO("game", "Loaded " + std::to_string(allCards_.size()) + " cards. " + std::to_string(failedLoads_) + " failed.");
-        return failedLoads_ == 0;
-    } catch (const fs::filesystem_error& e) {
-        LOG_ERROR("game", "Filesystem error while loading cards: " + std::string(e.what()));
-        return false;
-    } catch (const json::exception& e) {
-        LOG_ERROR("game", "JSON parsing error while loading cards: " + std::string(e.what()));
-        return false;
-    }
+    TRACE_SCOPE("content", "load_all_cards");
+    return loadContentDirectories({util::ContentKind::CARD});
 }
 
 std::shared_ptr<Enemy> Game::loadEnemy(const std::string& id) {
@@ -599,49 +752,8 @@ std::shared_ptr<Enemy> Game::loadEnemy(const std::string& id) {
         }
         
 bool Game::loadAllEnemies() {
-    failedLoads_ = 0;
-    try {
-        std::string data_prefix = get_data_path_prefix();
-        std::string enemies_dir_path = data_prefix + "data/enemies";
-        LOG_DEBUG("game", "Loading all enemies from directory: " + enemies_dir_path);
-
-        if (!fs::exists(enemies_dir_path) || !fs::is_directory(enemies_dir_path)) {
-            LOG_ERROR("game", "Enemies directory not found or is not a directory: " + enemies_dir_path);
-            return false;
-    }
-
-        for (const auto& entry : fs::directory_iterator(enemies_dir_path)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".json") {
-                std::string id_from_filename = entry.path().stem().string();
-                LOG_DEBUG("game", "Attempting to load enemy '" + id_from_filename + "' from: " + entry.path().string());
-                std::ifstream file(entry.path());
-                if (!file.is_open()) {
-                    LOG_ERROR("game", "Error: Could not open enemy file: " + entry.path().string());
-                    failedLoads_++;
-                    continue;
-                }
-                json enemyJson;
-                file >> enemyJson;
-                file.close();
-
-                auto enemy = std::make_shared<Enemy>();
-                if (!enemy->loadFromJson(enemyJson)) {
-                    LOG_ERROR("game", "Failed to load enemy data from JSON for file: " + entry.path().string());
-                    failedLoads_++;
-                    continue;
-                }
-                allEnemies_[id_from_filename] = enemy;
-                }
-            }
-        LOG_INFO("game", "Loaded " + std::to_string(allEnemies_.size()) + " enemies. " + std::to_string(failedLoads_) + " failed.");
-        return failedLoads_ == 0;
-    } catch (const fs::filesystem_error& e) {
-        LOG_ERROR("game", "Filesystem error while loading enemies: " + std::string(e.what()));
-        return false;
-    } catch (const json::exception& e) {
-        LOG_ERROR("game", "JSON parsing error while loading enemies: " + std::string(e.what()));
-        return false;
-    }
+    TRACE_SCOPE("content", "load_all_enemies");
+    return loadContentDirectories({util::ContentKind::ENEMY});
 }
 
 std::shared_ptr<Relic> Game::loadRelic(const std::string& id) {
@@ -654,47 +766,8 @@ std::shared_ptr<Relic> Game::loadRelic(const std::string& id) {
 }
 
 bool Game::loadAllRelics() {
-    failedLoads_ = 0;
-    try {
-        std::string data_prefix = get_data_path_prefix();
-        std::string relics_dir_path = data_prefix + "data/relics";
-        LOG_DEBUG("game", "Loading all relics from directory: " + relics_dir_path);
-        if (!fs::exists(relics_dir_path) || !fs::is_directory(relics_dir_path)) {
-            LOG_ERROR("game", "Relics directory not found or is not a directory: " + relics_dir_path);
-            return false;
-        }
-        for (const auto& entry : fs::directory_iterator(relics_dir_path)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".json") {
-                std::string id_from_filename = entry.path().stem().string();
-                LOG_DEBUG("game", "Attempting to load relic '" + id_from_filename + "' from: " + entry.path().string());
-                std::ifstream file(entry.path());
-                if (!file.is_open()) {
-                    LOG_ERROR("game", "Could not open relic file: " + entry.path().string());
-                    failedLoads_++;
-                    continue;
-                }
-                json relicJson;
-                file >> relicJson;
-                file.close();
-
-                auto relic = std::make_shared<Relic>();
-                if (!relic->loadFromJson(relicJson)) {
-                    LOG_ERROR("game", "Failed to load relic data from JSON for file: " + entry.path().string());
-                    failedLoads_++;
-                    continue;
-                }
-                allRelics_[id_from_filename] = relic;
-                }
-            }
-        LOG_INFO("game", "Loaded " + std::to_string(allRelics_.size()) + " relics. " + std::to_string(failedLoads_) + " failed.");
-        return failedLoads_ == 0;
-    } catch (const fs::filesystem_error& e) {
-        LOG_ERROR("game", "Filesystem error while loading relics: " + std::string(e.what()));
-        return false;
-    } catch (const json::exception& e) {
-        LOG_ERROR("game", "JSON parsing error while loading relics: " + std::string(e.what()));
-        return false;
-    }
+    TRACE_SCOPE("content", "load_all_relics");
+    return loadContentDirectories({util::ContentKind::RELIC});
 }
 
 UIInterface* Game::getUI() const {
@@ -702,6 +775,13 @@ UIInterface* Game::getUI() const {
 }
 
 bool Game::processInput(const std::string& input) {
+    static util::Histogram& latency = util::MetricsRegistry::getInstance().histogram(
+        "deckstiny_game_input_seconds", "Time spent in Game::processInput");
+    static util::Counter& inputs = util::MetricsRegistry::getInstance().counter(
+        "deckstiny_game_inputs_total", "Inputs passed to Game::processInput");
+    util::ScopedLatency timer(latency);
+    inputs.add();
+
     if (!running_ && state_ != GameState::MAIN_MENU && state_ != GameState::CHARACTER_SELECT) {
         LOG_WARNING("game", "Input processed while game not actively running (state: " + std::to_string(static_cast<int>(state_)) + ")");
         if (state_ != GameState::MAIN_MENU && state_ != GameState::CHARACTER_SELECT) {
@@ -781,6 +861,10 @@ void Game::initializeInputHandlers() {
                 std::string selectedCharacterId = availableCharacterIds[choice - 1];
                 LOG_DEBUG("game", "Selected character ID: " + selectedCharacterId);
 
+                rng_.reseed(pendingSeed_ ? *pendingSeed_ : RunRng::randomSeed());
+                pendingSeed_.reset();
+                LOG_INFO("game", "Starting run with seed " + std::to_string(rng_.getSeed()));
+
                 if (createPlayer(selectedCharacterId, "")) {
                     LOG_DEBUG("game", "Player '" + selectedCharacterId + "' created, generating map");
                         if (generateMap(1)) {
@@ -1027,289 +1111,66 @@ bool Game::handleMapInput(const std::string& input) {
                     if (room) {
                         switch (room->type) {
                             case RoomType::MONSTER: {
-                                std::vector<std::string> availableEnemies;
                                 int floorRange = map_->getEnemyFloorRange();
-
                                 LOG_INFO("game", "Selecting enemy for monster room at floor range: " + std::to_string(floorRange));
-                                std::string enemies_path_str = get_data_path_prefix() + "data/enemies";
-                                LOG_DEBUG("game", "Looking for enemies in: " + enemies_path_str);
-
-                                if (fs::exists(enemies_path_str) && fs::is_directory(enemies_path_str)) {
-                                    try {
-                                        for (const auto& entry : fs::directory_iterator(enemies_path_str)) {
-                                            if (entry.is_regular_file() && entry.path().extension() == ".json") {
-                                                try {
-                                                    std::string id = entry.path().stem().string();
-                                                    json enemyData;
-                                                    std::ifstream file(entry.path());
-                                                    if (file.is_open()) {
-                                                        file >> enemyData;
-                                                        
-                                                        bool isAppropriate = true;
-                                                        
-                                                        if ((enemyData.contains("is_elite") && enemyData["is_elite"].get<bool>()) || 
-                                                            (enemyData.contains("is_boss") && enemyData["is_boss"].get<bool>())) {
-                                                            isAppropriate = false;
-                                                        }
-                                                        
-                                                        if (enemyData.contains("min_floor") && 
-                                                            floorRange < enemyData["min_floor"].get<int>()) {
-                                                            isAppropriate = false;
-                                                        }
-                                                        
-                                                        if (enemyData.contains("max_floor") && 
-                                                            floorRange > enemyData["max_floor"].get<int>()) {
-                                                            isAppropriate = false;
-                                                        }
-                                                        
-                                                        if (isAppropriate) {
-                                                            availableEnemies.push_back(id);
-                                                            LOG_DEBUG("game", "Added enemy " + id + " to available list for floor range " + 
-                                                                      std::to_string(floorRange));
-                                                        }
-                                                    }
-                                                } catch (const std::exception& e) {
-                                                    LOG_ERROR("game", "Error loading enemies for encounter: " + std::string(e.what()));
-                                                }
-                                            }
-                                        }
-                                    } catch (const std::exception& e) {
-                                        LOG_ERROR("game", "Error accessing enemy directory: " + std::string(e.what()));
-                                    }
-                                }
-                                
-                                if (availableEnemies.empty()) {
+
+                                std::string enemyId = encounterIndex_.pick(EncounterTier::NORMAL, floorRange, rng_.get(RngStream::MAP));
+                                if (enemyId.empty()) {
                                     LOG_WARNING("game", "No appropriate enemies found for floor range " + std::to_string(floorRange) + 
                                                 ", falling back to all non-elite enemies");
-                                    
-                                    try {
-                                        for (const auto& entry : fs::directory_iterator("data/enemies")) {
-                                            if (entry.is_regular_file() && entry.path().extension() == ".json") {
-                                                try {
-                                                    std::string id = entry.path().stem().string();
-                                                    json enemyData;
-                                                    std::ifstream file(entry.path());
-                                                    if (file.is_open()) {
-                                                        file >> enemyData;
-                                                        if ((!enemyData.contains("is_elite") || !enemyData["is_elite"].get<bool>()) && 
-                                                            (!enemyData.contains("is_boss") || !enemyData["is_boss"].get<bool>())) {
-                                                            availableEnemies.push_back(id);
-                                                        }
-                                                    }
-                                                } catch (const std::exception& e) {
-                                                    LOG_ERROR("game", "Error loading enemy file: " + std::string(e.what()));
-                                                }
-                                            }
-                                        }
-                                    } catch (const std::exception& e) {
-                                        LOG_ERROR("game", "Error accessing enemy directory: " + std::string(e.what()));
-                                    }
+                                    enemyId = encounterIndex_.pickAny(EncounterTier::NORMAL, rng_.get(RngStream::MAP));
                                 }
-                                
-                                if (availableEnemies.empty()) {
+
+                                if (enemyId.empty()) {
                                     ui_->showMessage("Error: No enemies found for this floor.", true);
                                     ui_->showMap(roomId, map_->getAvailableRooms(), map_->getAllRooms());
                                     return true;
                                 }
-                                
-                                unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-                                std::mt19937 gen(seed);
-                                std::uniform_int_distribution<> dist(0, availableEnemies.size() - 1);
-                                int enemyIndex = dist(gen);
-                                
-                                LOG_INFO("game", "Selected enemy: " + availableEnemies[enemyIndex] + " for floor range " + 
-                                          std::to_string(floorRange));
-                                
-                                startCombat({availableEnemies[enemyIndex]});
+
+                                LOG_INFO("game", "Selected enemy: " + enemyId + " for floor range " + std::to_string(floorRange));
+                                startCombat({enemyId});
                                 break;
                             }
                             case RoomType::ELITE: {
-                                std::vector<std::string> availableElites;
                                 int floorRange = map_->getEnemyFloorRange();
-                                
                                 LOG_INFO("game", "Selecting elite enemy for elite room at floor range: " + std::to_string(floorRange));
-                                std::string elite_enemies_path_str = get_data_path_prefix() + "data/enemies";
-                                LOG_DEBUG("game", "Looking for elite enemies in: " + elite_enemies_path_str);
-                                
-                                try {
-                                    for (const auto& entry : fs::directory_iterator(elite_enemies_path_str)) {
-                                        if (entry.is_regular_file() && entry.path().extension() == ".json") {
-                                            try {
-                                                std::string id = entry.path().stem().string();
-                                                json enemyData;
-                                                std::ifstream file(entry.path());
-                                                if (file.is_open()) {
-                                                    file >> enemyData;
-                                                    
-                                                    bool isAppropriate = true;
-                                                    
-                                                    if (!enemyData.contains("is_elite") || !enemyData["is_elite"].get<bool>()) {
-                                                        isAppropriate = false;
-                                                    }
-                                                    
-                                                    if (enemyData.contains("min_floor") && 
-                                                        floorRange < enemyData["min_floor"].get<int>()) {
-                                                        isAppropriate = false;
-                                                    }
-                                                    
-                                                    if (enemyData.contains("max_floor") && 
-                                                        floorRange > enemyData["max_floor"].get<int>()) {
-                                                        isAppropriate = false;
-                                                    }
-                                                    
-                                                    if (isAppropriate) {
-                                                        availableElites.push_back(id);
-                                                        LOG_DEBUG("game", "Added elite enemy " + id + " to available list for floor range " + 
-                                                                std::to_string(floorRange));
-                                                    }
-                                                }
-                                            } catch (const std::exception& e) {
-                                                LOG_ERROR("game", "Error loading elite enemy file: " + std::string(e.what()));
-                                            }
-                                        }
-                                    }
-                                } catch (const std::exception& e) {
-                                    LOG_ERROR("game", "Error accessing elite enemy directory: " + std::string(e.what()));
-                                }
-                                
-                                if (availableElites.empty()) {
+
+                                std::string eliteId = encounterIndex_.pick(EncounterTier::ELITE, floorRange, rng_.get(RngStream::MAP));
+                                if (eliteId.empty()) {
                                     LOG_WARNING("game", "No appropriate elite enemies found for floor range " + std::to_string(floorRange) + 
                                                 ", falling back to all elite enemies");
-                                    
-                                    try {
-                                        for (const auto& entry : fs::directory_iterator(elite_enemies_path_str)) {
-                                            if (entry.is_regular_file() && entry.path().extension() == ".json") {
-                                                try {
-                                                    std::string id = entry.path().stem().string();
-                                                    json enemyData;
-                                                    std::ifstream file(entry.path());
-                                                    if (file.is_open()) {
-                                                        file >> enemyData;
-                                                        if (enemyData.contains("is_elite") && enemyData["is_elite"].get<bool>()) {
-                                                            availableElites.push_back(id);
-                                                        }
-                                                    }
-                                                } catch (const std::exception& e) {
-                                                    LOG_ERROR("game", "Error loading elite enemy file: " + std::string(e.what()));
-                                                }
-                                            }
-                                        }
-                                    } catch (const std::exception& e) {
-                                        LOG_ERROR("game", "Error in fallback elite loading: " + std::string(e.what()));
-                                    }
+                                    eliteId = encounterIndex_.pickAny(EncounterTier::ELITE, rng_.get(RngStream::MAP));
                                 }
-                                
-                                if (availableElites.empty()) {
+
+                                if (eliteId.empty()) {
                                     LOG_WARNING("game", "No elite enemies found, falling back to multiple basic enemies");
-                                    
-                                    std::vector<std::string> basicEnemies;
-                                    try {
-                                        for (const auto& entry : fs::directory_iterator(elite_enemies_path_str)) {
-                                            if (entry.is_regular_file() && entry.path().extension() == ".json") {
-                                                try {
-                                                    std::string id = entry.path().stem().string();
-                                                    json enemyData;
-                                                    std::ifstream file(entry.path());
-                                                    if (file.is_open()) {
-                                                        file >> enemyData;
-                                                        if ((!enemyData.contains("is_elite") || 
-                                                             !enemyData["is_elite"].get<bool>()) && 
-                                                            (!enemyData.contains("is_boss") || 
-                                                             !enemyData["is_boss"].get<bool>())) {
-                                                            basicEnemies.push_back(id);
-                                                        }
-                                                    }
-                                                } catch (const std::exception& e) {
-                                                    LOG_ERROR("game", "Error loading basic enemy file: " + std::string(e.what()));
-                                                }
-                                            }
-                                        }
-                                    } catch (const std::exception& e) {
-                                                LOG_ERROR("game", "Error in fallback basic enemy loading: " + std::string(e.what()));
-                                            }
-                                    
-                                    if (basicEnemies.empty()) {
+
+                                    std::string firstId = encounterIndex_.pickAny(EncounterTier::NORMAL, rng_.get(RngStream::MAP));
+                                    if (firstId.empty()) {
                                         ui_->showMessage("Error: No enemies found for elite encounter.", true);
                                         ui_->showMap(roomId, map_->getAvailableRooms(), map_->getAllRooms());
                                         return true;
                                     }
-                                    
-                                    try {
-                                        unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-                                        std::mt19937 gen(seed);
-                                        std::vector<std::string> encounter;
-                                        
-                                        std::uniform_int_distribution<> dist(0, basicEnemies.size() - 1);
-                                        int firstEnemyIndex = dist(gen);
-                                        encounter.push_back(basicEnemies[firstEnemyIndex]);
-                                        
-                                        if (basicEnemies.size() > 1) {
-                                            std::vector<std::string> remainingEnemies = basicEnemies;
-                                            remainingEnemies.erase(remainingEnemies.begin() + firstEnemyIndex);
-                                            std::uniform_int_distribution<> dist2(0, remainingEnemies.size() - 1);
-                                            encounter.push_back(remainingEnemies[dist2(gen)]);
-                                        } else {
-                                            encounter.push_back(basicEnemies[0]);
-                                        }
-                                        
-                                        startCombat(encounter);
-                                    } catch (const std::exception& e) {
-                                        LOG_ERROR("game", "Error creating elite encounter: " + std::string(e.what()));
-                                        ui_->showMessage("Error: Failed to create encounter.", true);
-                                        ui_->showMap(roomId, map_->getAvailableRooms(), map_->getAllRooms());
-                                        return true;
-                                    }
+
+                                    // A second, different basic enemy when there is more than one
+                                    std::string secondId = encounterIndex_.pickAny(EncounterTier::NORMAL, rng_.get(RngStream::MAP), firstId);
+                                    startCombat({firstId, secondId});
                                 } else {
-                                    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-                                    std::mt19937 gen(seed);
-                                    std::uniform_int_distribution<> dist(0, availableElites.size() - 1);
-                                    int enemyIndex = dist(gen);
-                                    
-                                    LOG_INFO("game", "Selected elite enemy: " + availableElites[enemyIndex] + " for floor range " + 
+                                    LOG_INFO("game", "Selected elite enemy: " + eliteId + " for floor range " + 
                                              std::to_string(floorRange));
-                                    
-                                    startCombat({availableElites[enemyIndex]});
+                                    startCombat({eliteId});
                                 }
                                 break;
                             }
                             case RoomType::BOSS: {
-                                std::vector<std::string> bossEnemies;
-                                std::string boss_enemies_path_str = get_data_path_prefix() + "data/enemies";
-                                LOG_DEBUG("game", "Looking for boss enemies in: " + boss_enemies_path_str);
-                                try {
-                                    for (const auto& entry : fs::directory_iterator(boss_enemies_path_str)) {
-                                        if (entry.is_regular_file() && entry.path().extension() == ".json") {
-                                            try {
-                                                std::string id = entry.path().stem().string();
-                                                json enemyData;
-                                                std::ifstream file(entry.path());
-                                                if (file.is_open()) {
-                                                    file >> enemyData;
-                                                    if (enemyData.contains("is_boss") && 
-                                                        enemyData["is_boss"].get<bool>()) {
-                                                        bossEnemies.push_back(id);
-                                                    }
-                                                }
-                                            } catch (const std::exception& e) {
-                                                LOG_ERROR("game", "Error loading boss enemy file: " + std::string(e.what()));
-                                            }
-                                        }
-                                    }
-                                } catch (const std::exception& e) {
-                                    LOG_ERROR("game", "Error loading boss enemies for encounter: " + std::string(e.what()));
-                                }
-                                
-                                if (bossEnemies.empty()) {
+                                std::string bossId = encounterIndex_.pickAny(EncounterTier::BOSS, rng_.get(RngStream::MAP));
+                                if (bossId.empty()) {
                                     ui_->showMessage("Error: No boss enemies found.", true);
                                     ui_->showMap(roomId, map_->getAvailableRooms(), map_->getAllRooms());
                                     return true;
                                 }
-                                
-                                unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-                                std::mt19937 gen(seed);
-                                std::uniform_int_distribution<> dist(0, bossEnemies.size() - 1);
-                                int enemyIndex = dist(gen);
-                                startCombat({bossEnemies[enemyIndex]});
+
+                                startCombat({bossId});
                                 break;
                             }
                             case RoomType::EVENT: {
@@ -1323,11 +1184,10 @@ bool Game::handleMapInput(const std::string& input) {
                                 for (const auto& [id, event] : allEvents_) {
                                     eventIds.push_back(id);
                                 }
+                                // Sorted so the pick does not depend on the registry's hash order
+                                std::sort(eventIds.begin(), eventIds.end());
                                 
-                                unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-                                std::mt19937 gen(seed);
-                                std::uniform_int_distribution<> dist(0, eventIds.size() - 1);
-                                int eventIndex = dist(gen);
+                                size_t eventIndex = rng_.get(RngStream::MAP).index(eventIds.size());
                                 
                                 startEvent(eventIds[eventIndex]);
                                 break;
@@ -1339,7 +1199,7 @@ bool Game::handleMapInput(const std::string& input) {
                             case RoomType::TREASURE: {
                                 LOG_INFO("game", "Player entered TREASURE room #" + std::to_string(room->id));
                                 if (player_) {
-                                    int goldAmount = 50 + (rand() % 51);
+                                    int goldAmount = rng_.get(RngStream::REWARDS).uniformInt(50, 100);
                                     player_->addGold(goldAmount);
                                     ui_->showMessage("You found a treasure chest containing " + std::to_string(goldAmount) + " gold!", true);
 
@@ -1348,7 +1208,8 @@ bool Game::handleMapInput(const std::string& input) {
                                         for(const auto& pair : allRelics_) {
                                             relicIds.push_back(pair.first);
                                         }
-                                        std::string randomRelicId = relicIds[rand() % relicIds.size()]; 
+                                        std::sort(relicIds.begin(), relicIds.end());
+                                        std::string randomRelicId = relicIds[rng_.get(RngStream::REWARDS).index(relicIds.size())]; 
                                         auto relic = loadRelic(randomRelicId);
                                         if (relic) {
                                             player_->addRelic(relic);
@@ -1447,10 +1308,11 @@ bool Game::handleCombatInput(const std::string& input) {
             if (selectedCardIndex_ >= 0 && selectedCardIndex_ < static_cast<int>(hand.size())) {
                 const std::string& cardName = hand[selectedCardIndex_]->getName();
                 
-                if (currentCombat_->playCard(selectedCardIndex_, targetIndex)) {
+                if (playCombatCard(selectedCardIndex_, targetIndex)) {
                     awaitingEnemySelection_ = false;
                     selectedCardIndex_ = -1;
                     ui_->showCombat(currentCombat_.get());
+                    resolveFinishedCombat();
                 } else {
                     ui_->showMessage("Cannot target that enemy with " + cardName + ". Try a different target or card.", true);
                     ui_->showEnemySelectionMenu(currentCombat_.get(), cardName);
@@ -1477,6 +1339,18 @@ bool Game::handleCombatInput(const std::string& input) {
     
     if (input == "end" || input == "e") {
         currentCombat_->endPlayerTurn();
+        combatJournal_.clear();
+        undoMarks_.clear();
+        if (currentCombat_->isPlayerDefeated()) {
+            LOG_INFO("game", "Player defeated during enemy turn, transitioning");
+            endCombat(false);
+            return true;
+        }
+        ui_->showCombat(currentCombat_.get());
+    } else if (input == "undo" || input == "u") {
+        if (!undoLastCard()) {
+            ui_->showMessage("No card played this turn to undo.", true);
+        }
         ui_->showCombat(currentCombat_.get());
     } else if (input == "help" || input == "h") {
         ui_->showMessage(
@@ -1487,6 +1361,7 @@ bool Game::handleCombatInput(const std::string& input) {
             "  <number> <num>  - Play the card directly on a specific enemy\n"
             "                     (e.g., '1 2' to play the first card on the second enemy)\n"
             "  end or e        - End your turn\n"
+            "  undo or u       - Take back the last card played this turn\n"
             "  help or h       - Show this help message\n"
             "  cancel or c     - Cancel enemy selection\n\n"
             "Tips:\n"
@@ -1514,7 +1389,7 @@ bool Game::handleCombatInput(const std::string& input) {
             if (spacePos != std::string::npos) {
                 int targetIndex = std::stoi(input.substr(spacePos + 1)) - 1;
                 
-                if (currentCombat_->playCard(cardIndex, targetIndex)) {
+                if (playCombatCard(cardIndex, targetIndex)) {
                     ui_->showCombat(currentCombat_.get());
                 } else {
                     ui_->showMessage("Cannot play that card on that target. Check energy cost or valid targets.", true);
@@ -1525,7 +1400,7 @@ bool Game::handleCombatInput(const std::string& input) {
                 
                 if (card && card->needsTarget()) {
                     if (currentCombat_->getEnemyCount() == 1 && currentCombat_->getEnemy(0) && currentCombat_->getEnemy(0)->isAlive()) {
-                        if (currentCombat_->playCard(cardIndex, 0)) {
+                        if (playCombatCard(cardIndex, 0)) {
                             ui_->showCombat(currentCombat_.get());
                         } else {
                             ui_->showMessage("Cannot play " + card->getName() + " on the enemy. Check energy cost.", true);
@@ -1537,7 +1412,7 @@ bool Game::handleCombatInput(const std::string& input) {
                         ui_->showEnemySelectionMenu(currentCombat_.get(), card->getName());
                     }
                 } else {
-                    if (currentCombat_->playCard(cardIndex)) {
+                    if (playCombatCard(cardIndex)) {
                         ui_->showCombat(currentCombat_.get());
                     } else {
                         ui_->showMessage("Cannot play " + card->getName() + ". Check energy cost.", true);
@@ -1551,6 +1426,38 @@ bool Game::handleCombatInput(const std::string& input) {
         }
     }
     
+    resolveFinishedCombat();
+    return true;
+}
+
+void Game::resolveFinishedCombat() {
+    if (currentCombat_ && !transitioningFromCombat_ && currentCombat_->isCombatOver()) {
+        LOG_INFO("game", "Combat finished by the last action. Player defeated: " +
+            std::string(currentCombat_->isPlayerDefeated() ? "true" : "false"));
+        endCombat(!currentCombat_->isPlayerDefeated());
+    }
+}
+
+bool Game::playCombatCard(int cardIndex, int targetIndex) {
+    CombatJournal::Mark mark = combatJournal_.mark();
+    if (!currentCombat_->playCard(cardIndex, targetIndex)) {
+        return false;
+    }
+    undoMarks_.push_back(mark);
+    return true;
+}
+
+bool Game::undoLastCard() {
+    if (!currentCombat_ || undoMarks_.empty()) {
+        return false;
+    }
+    if (!combatJournal_.rollback(undoMarks_.back())) {
+        // The combat was restored from a snapshot, which clears its journal
+        undoMarks_.clear();
+        return false;
+    }
+    undoMarks_.pop_back();
+    LOG_INFO("game", "Took back the last card played");
     return true;
 }
 
@@ -1572,48 +1479,8 @@ std::shared_ptr<Event> Game::loadEvent(const std::string& id) {
 }
 
 bool Game::loadAllEvents() {
-    failedLoads_ = 0;
-    try {
-        std::string data_prefix = get_data_path_prefix();
-        std::string events_dir_path = data_prefix + "data/events";
-        LOG_DEBUG("game", "Loading all events from directory: " + events_dir_path);
-        if (!fs::exists(events_dir_path) || !fs::is_directory(events_dir_path)) {
-            LOG_ERROR("game", "Events directory not found or is not a directory: " + events_dir_path);
-            return false;
-        }
-        
-        for (const auto& entry : fs::directory_iterator(events_dir_path)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".json") {
-                std::string id_from_filename = entry.path().stem().string();
-                LOG_DEBUG("game", "Attempting to load event '" + id_from_filename + "' from: " + entry.path().string());
-                std::ifstream file(entry.path());
-                if (!file.is_open()) {
-                    LOG_ERROR("game", "Could not open event file: " + entry.path().string());
-                    failedLoads_++;
-                    continue;
-                }
-                json eventJson;
-                file >> eventJson;
-                file.close();
-
-                auto event = std::make_shared<Event>();
-                if (!event->loadFromJson(eventJson)) {
-                    LOG_ERROR("game", "Failed to load event data from JSON for file: " + entry.path().string());
-                    failedLoads_++;
-                    continue;
-                }
-                allEvents_[id_from_filename] = event;
-            }
-        }
-        LOG_INFO("game", "Loaded " + std::to_string(allEvents_.size()) + " events. " + std::to_string(failedLoads_) + " failed.");
-        return failedLoads_ == 0;
-    } catch (const fs::filesystem_error& e) {
-        LOG_ERROR("game", "Filesystem error while loading events: " + std::string(e.what()));
-        return false;
-    } catch (const json::exception& e) {
-        LOG_ERROR("game", "JSON parsing error while loading events: " + std::string(e.what()));
-        return false;
-    }
+    TRACE_SCOPE("content", "load_all_events");
+    return loadContentDirectories({util::ContentKind::EVENT});
 }
 
 bool Game::startEvent(const std::string& eventId) {
@@ -1808,33 +1675,163 @@ bool Game::loadGameData() {
     std::string data_prefix = get_data_path_prefix();
     LOG_INFO("game", "Data path prefix: " + data_prefix);
 
-    if (!loadAllCharacters()) {
-        LOG_ERROR("game", "Failed to load characters.");
-        return false;
+    std::string packPath = data_prefix + "data/" + util::ContentPack::DEFAULT_FILE_NAME;
+    if (fs::exists(packPath)) {
+        if (loadGameDataFromPack(packPath)) {
+            LOG_INFO("game", "Game data loading complete (content pack).");
+            return true;
+        }
+        LOG_WARNING("game", "Content pack " + packPath + " could not be loaded, falling back to JSON data directories.");
     }
 
-    if (!loadAllCards()) {
-        LOG_ERROR("game", "Failed to load cards.");
+    if (!loadContentDirectories({util::ContentKind::CHARACTER,
+                                 util::ContentKind::CARD,
+                                 util::ContentKind::ENEMY,
+                                 util::ContentKind::RELIC,
+                                 util::ContentKind::EVENT})) {
+        LOG_ERROR("game", "Failed to load game data.");
         return false;
     }
     
-    if (!loadAllEnemies()) {
-        LOG_ERROR("game", "Failed to load enemies.");
+    LOG_INFO("game", "Game data loading complete.");
+    return true;
+}
+
+bool Game::loadGameDataFromPack(const std::string& packPath) {
+    TRACE_SCOPE("content", "load_pack");
+    static util::Histogram& latency = util::MetricsRegistry::getInstance().histogram(
+        "deckstiny_content_load_seconds", "Time spent loading content", {{"source", "pack"}});
+    util::ScopedLatency timer(latency);
+    auto start = std::chrono::steady_clock::now();
+
+    util::ContentPack pack;
+    if (!pack.open(packPath)) {
         return false;
     }
-    
-    if (!loadAllRelics()) {
-        LOG_ERROR("game", "Failed to load relics.");
-        return false;
+
+    std::vector<std::future<LoadedContent>> pending;
+    pending.reserve(pack.getRecordCount());
+    util::ThreadPool pool;
+    for (size_t i = 0; i < pack.getRecordCount(); ++i) {
+        pending.push_back(pool.submit([&pack, i]() { return loadContentRecord(pack, i); }));
     }
-    
-    if (!loadAllEvents()) {
-        LOG_ERROR("game", "Failed to load events.");
+
+    return mergeLoadedContent(pending,
+                              {util::ContentKind::CHARACTER,
+                               util::ContentKind::CARD,
+                               util::ContentKind::ENEMY,
+                               util::ContentKind::RELIC,
+                               util::ContentKind::EVENT},
+                              millisecondsSince(start));
+}
+
+bool Game::loadContentDirectories(const std::vector<util::ContentKind>& kinds) {
+    TRACE_SCOPE("content", "load_directories");
+    static util::Histogram& latency = util::MetricsRegistry::getInstance().histogram(
+        "deckstiny_content_load_seconds", "Time spent loading content", {{"source", "json"}});
+    util::ScopedLatency timer(latency);
+    auto start = std::chrono::steady_clock::now();
+    std::string data_prefix = get_data_path_prefix();
+
+    // List every directory up front so a missing directory fails before any work is queued
+    std::vector<std::pair<util::ContentKind, fs::path>> files;
+    try {
+        for (util::ContentKind kind : kinds) {
+            fs::path directory = data_prefix + "data/" + util::contentKindDirectory(kind);
+            LOG_DEBUG("game", "Loading all " + std::string(util::contentKindDirectory(kind)) + " from directory: " + directory.string());
+            if (!fs::exists(directory) || !fs::is_directory(directory)) {
+                LOG_ERROR("game", "Content directory not found or is not a directory: " + directory.string());
+                return false;
+            }
+            for (const auto& path : listContentFiles(directory)) {
+                files.emplace_back(kind, path);
+            }
+        }
+    } catch (const fs::filesystem_error& e) {
+        LOG_ERROR("game", "Filesystem error while listing content: " + std::string(e.what()));
         return false;
     }
-    
-    LOG_INFO("game", "Game data loading complete.");
-    return true;
+
+    std::vector<std::future<LoadedContent>> pending;
+    pending.reserve(files.size());
+    util::ThreadPool pool;
+    for (const auto& file : files) {
+        pending.push_back(pool.submit([file]() { return loadContentFile(file.first, file.second); }));
+    }
+
+    return mergeLoadedContent(pending, kinds, millisecondsSince(start));
+}
+
+bool Game::mergeLoadedContent(std::vector<std::future<LoadedContent>>& pending,
+                              const std::vector<util::ContentKind>& kinds,
+                              double setupMillis) {
+    auto start = std::chrono::steady_clock::now();
+
+    struct RegistryStats {
+        int loaded = 0;
+        int failed = 0;
+        double millis = 0.0;
+    };
+    std::map<util::ContentKind, RegistryStats> stats;
+
+    for (util::ContentKind kind : kinds) {
+        stats[kind] = RegistryStats();
+        switch (kind) {
+            case util::ContentKind::CHARACTER: allCharacters_.clear(); break;
+            case util::ContentKind::CARD: allCards_.clear(); break;
+            case util::ContentKind::ENEMY: allEnemies_.clear(); break;
+            case util::ContentKind::RELIC: allRelics_.clear(); break;
+            case util::ContentKind::EVENT: allEvents_.clear(); break;
+        }
+    }
+
+    // Results are consumed in submission order, so the outcome does not depend on thread timing
+    failedLoads_ = 0;
+    for (auto& future : pending) {
+        LoadedContent content = future.get();
+        RegistryStats& registry = stats[content.kind];
+        registry.millis += content.millis;
+
+        if (!content.loaded) {
+            LOG_ERROR("game", "Failed to load " + std::string(util::contentKindDirectory(content.kind)) + " '" + content.id +
+                      "' from " + content.source + ": " + content.error);
+            registry.failed++;
+            failedLoads_++;
+            continue;
+        }
+
+        registry.loaded++;
+        switch (content.kind) {
+            case util::ContentKind::CHARACTER:
+                LOG_INFO("game", "Successfully loaded character: " + content.character.name + " (ID: " + content.character.id + ")");
+                allCharacters_[content.character.id] = std::move(content.character);
+                break;
+            case util::ContentKind::CARD:
+                allCards_[content.id] = std::move(content.card);
+                break;
+            case util::ContentKind::ENEMY:
+                allEnemies_[content.id] = std::move(content.enemy);
+                break;
+            case util::ContentKind::RELIC:
+                allRelics_[content.id] = std::move(content.relic);
+                break;
+            case util::ContentKind::EVENT:
+                allEvents_[content.id] = std::move(content.event);
+                break;
+        }
+    }
+
+    if (stats.count(util::ContentKind::ENEMY)) {
+        encounterIndex_.build(allEnemies_);
+    }
+
+    for (const auto& [kind, registry] : stats) {
+        LOG_INFO("game", "Loaded " + std::to_string(registry.loaded) + " " + util::contentKindDirectory(kind) + ". " +
+                 std::to_string(registry.failed) + " failed. (" + std::to_string(registry.millis) + " ms load time)");
+    }
+    LOG_INFO("game", "Content loading took " + std::to_string(setupMillis + millisecondsSince(start)) + " ms wall time.");
+
+    return failedLoads_ == 0;
 }
 
 bool Game::addCardToDeck(const std::string& cardId) {
@@ -2146,7 +2143,7 @@ CardRarity stringToCardRarity(const std::string& rarity_str) {
 }
 
 std::shared_ptr<Card> Game::getRandomCardFromMasterList(const std::string& rarity_filter_str) {
-    std::vector<std::shared_ptr<Card>> eligibleCards;
+    std::vector<std::string> eligibleCardIds;
     bool any_rarity = (rarity_filter_str == "ANY" || rarity_filter_str.empty());
     CardRarity target_rarity = CardRarity::COMMON;
     if (!any_rarity) {
@@ -2156,38 +2153,39 @@ std::shared_ptr<Card> Game::getRandomCardFromMasterList(const std::string& rarit
     for (const auto& pair : allCards_) {
         if (pair.second) { 
             if (any_rarity || pair.second->getRarity() == target_rarity) {
-                eligibleCards.push_back(pair.second->cloneCard());
+                eligibleCardIds.push_back(pair.first);
             }
         }
     }
-    if (eligibleCards.empty()) {
+    if (eligibleCardIds.empty()) {
         LOG_WARNING("game", "No eligible cards found for rarity_filter: " + rarity_filter_str + " in getRandomCardFromMasterList. Trying ANY rarity.");
         if (!any_rarity) {
             for (const auto& pair : allCards_) {
-                if (pair.second) eligibleCards.push_back(pair.second->cloneCard());
+                if (pair.second) eligibleCardIds.push_back(pair.first);
             }
         }
-        if (eligibleCards.empty()) return nullptr; 
+        if (eligibleCardIds.empty()) return nullptr; 
     }
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    std::mt19937 gen(seed);
-    return eligibleCards[gen() % eligibleCards.size()];
+    // Sorted so the pick does not depend on the registry's hash order
+    std::sort(eligibleCardIds.begin(), eligibleCardIds.end());
+    const std::string& cardId = eligibleCardIds[rng_.get(RngStream::REWARDS).index(eligibleCardIds.size())];
+    return allCards_.at(cardId)->cloneCard();
 }
 
 std::shared_ptr<Relic> Game::getRandomRelicFromMasterList() {
-    std::vector<std::shared_ptr<Relic>> eligibleRelics;
+    std::vector<std::string> eligibleRelicIds;
     for (const auto& pair : allRelics_) {
         if (pair.second) { 
-            eligibleRelics.push_back(pair.second->cloneRelic());
+            eligibleRelicIds.push_back(pair.first);
         }
     }
-    if (eligibleRelics.empty()) {
+    if (eligibleRelicIds.empty()) {
         LOG_WARNING("game", "No relics found in getRandomRelicFromMasterList");
         return nullptr;
     }
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    std::mt19937 gen(seed);
-    return eligibleRelics[gen() % eligibleRelics.size()];
+    std::sort(eligibleRelicIds.begin(), eligibleRelicIds.end());
+    const std::string& relicId = eligibleRelicIds[rng_.get(RngStream::REWARDS).index(eligibleRelicIds.size())];
+    return allRelics_.at(relicId)->cloneRelic();
 }
 
 void Game::startShop() {
@@ -2231,7 +2229,9 @@ void Game::startShop() {
         }
     }
     LOG_DEBUG("game_shop", "Number of cards available after filtering: " + std::to_string(availableCardIds.size()));
-    std::shuffle(availableCardIds.begin(), availableCardIds.end(), rng_); 
+    // Sorted before shuffling so the offer does not depend on the registry's hash order
+    std::sort(availableCardIds.begin(), availableCardIds.end());
+    rng_.get(RngStream::SHOP).shuffle(availableCardIds.begin(), availableCardIds.end());
 
     for (int i = 0; i < numCardsToOffer && i < static_cast<int>(availableCardIds.size()); ++i) {
         std::shared_ptr<Card> templateCard = allCards_[availableCardIds[i]];
@@ -2240,10 +2240,11 @@ void Game::startShop() {
 
             int price = 50;
 
-            if      (shopCardInstance->getRarity() == CardRarity::COMMON) price = 20 + (rng_() % 9);    // 20-29
-            else if (shopCardInstance->getRarity() == CardRarity::BASIC) price = 25 + (rng_() % 11);    // 25-35
-            else if (shopCardInstance->getRarity() == CardRarity::UNCOMMON) price = 45 + (rng_() % 21); // 45-65
-            else if (shopCardInstance->getRarity() == CardRarity::RARE) price = 70 + (rng_() % 31);     // 70-100
+            util::Rng& shopRng = rng_.get(RngStream::SHOP);
+            if      (shopCardInstance->getRarity() == CardRarity::COMMON) price = shopRng.uniformInt(20, 28);
+            else if (shopCardInstance->getRarity() == CardRarity::BASIC) price = shopRng.uniformInt(25, 35);
+            else if (shopCardInstance->getRarity() == CardRarity::UNCOMMON) price = shopRng.uniformInt(45, 65);
+            else if (shopCardInstance->getRarity() == CardRarity::RARE) price = shopRng.uniformInt(70, 100);
             
             shopCardPrices_[shopCardInstance] = price;
 
@@ -2271,7 +2272,8 @@ void Game::startShop() {
             availableRelicIds.push_back(pair.first);
         }
     }
-    std::shuffle(availableRelicIds.begin(), availableRelicIds.end(), rng_);
+    std::sort(availableRelicIds.begin(), availableRelicIds.end());
+    rng_.get(RngStream::SHOP).shuffle(availableRelicIds.begin(), availableRelicIds.end());
 
     for (int i = 0; i < numRelicsToOffer && i < static_cast<int>(availableRelicIds.size()); ++i) {
         std::shared_ptr<Relic> templateRelic = allRelics_[availableRelicIds[i]];
@@ -2295,76 +2297,8 @@ void Game::startShop() {
 }
 
 bool Game::loadAllCharacters() {
-    allCharacters_.clear();
-    failedLoads_ = 0;
-    std::string data_prefix = get_data_path_prefix();
-    std::string characters_dir_path_str = data_prefix + "data/characters";
-    fs::path characters_dir_path(characters_dir_path_str);
-
-    LOG_DEBUG("game", "Loading all characters from directory: " + characters_dir_path.string());
-
-    if (!fs::exists(characters_dir_path) || !fs::is_directory(characters_dir_path)) {
-        LOG_ERROR("game", "Characters directory not found or is not a directory: " + characters_dir_path.string());
-        return false;
-    }
-
-    try {
-        for (const auto& entry : fs::directory_iterator(characters_dir_path)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".json") {
-                std::string char_id_from_filename = entry.path().stem().string();
-                LOG_DEBUG("game", "Attempting to load character '" + char_id_from_filename + "' from: " + entry.path().string());
-                
-                std::ifstream file(entry.path());
-                if (!file.is_open()) {
-                    LOG_ERROR("game", "Could not open character file: " + entry.path().string());
-                    failedLoads_++;
-                    continue;
-                }
-                
-                json charJson;
-                try {
-                    file >> charJson;
-                } catch (const json::parse_error& e) {
-                    LOG_ERROR("game", "JSON parse error in file " + entry.path().string() + ": " + e.what());
-                    failedLoads_++;
-                    file.close();
-                    continue;
-                }
-                file.close();
-
-                CharacterData data;
-                try {
-                    data.id = charJson.value("id", char_id_from_filename);
-                    data.name = charJson.at("name").get<std::string>();
-                    data.max_health = charJson.at("max_health").get<int>();
-                    data.base_energy = charJson.at("base_energy").get<int>();
-                    data.initial_hand_size = charJson.at("initial_hand_size").get<int>();
-                    data.description = charJson.value("description", "");
-
-                    if (charJson.contains("starting_deck") && charJson["starting_deck"].is_array()) {
-                        for (const auto& deck_item : charJson["starting_deck"]) {
-                            data.starting_deck.push_back(deck_item.get<std::string>());
-                        }
-                    }
-                    if (charJson.contains("starting_relics") && charJson["starting_relics"].is_array()) {
-                        for (const auto& relic_item : charJson["starting_relics"]) {
-                            data.starting_relics.push_back(relic_item.get<std::string>());
-                        }
-                    }
-                    allCharacters_[data.id] = data;
-                    LOG_INFO("game", "Successfully loaded character: " + data.name + " (ID: " + data.id + ")");
-                } catch (const json::exception& e) {
-                    LOG_ERROR("game", "Error processing JSON data for character file " + entry.path().string() + ": " + e.what());
-                    failedLoads_++;
-                }
-            }
-        }
-        LOG_INFO("game", "Loaded " + std::to_string(allCharacters_.size()) + " characters. " + std::to_string(failedLoads_) + " failed to load.");
-        return failedLoads_ == 0;
-    } catch (const fs::filesystem_error& e) {
-        LOG_ERROR("game", "Filesystem error while loading characters: " + std::string(e.what()));
-        return false;
-    }
+    TRACE_SCOPE("content", "load_all_characters");
+    return loadContentDirectories({util::ContentKind::CHARACTER});
 }
 
 } // namespace deckstiny 
\ No newline at end of file
@@ -2,13 +2,13 @@
 // Laboratory Work 2
 
 #include "core/map.h"
-#include <random>
 #include <algorithm>
-#include <chrono>
 #include <cmath>
 #include <iostream>
 #include <queue>
 #include "util/logger.h"
+#include "util/metrics.h"
+#include "util/trace_spans.h"
 
 namespace deckstiny {
 
@@ -23,19 +23,24 @@ const int STS_ELITE_MIN_FLOOR_Y = 5; // Elites can start appearing from floor 5
 const size_t STS_MAX_INCOMING_CONNECTIONS_PER_NODE = 3; // Max incoming connections a typical node can receive
 
 GameMap::GameMap() : act_(1), currentRoomId_(-1), bossDefeated_(false), nextRoomId_(0) {
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    rng_.seed(seed);
-    mapSeed_ = seed;
 }
 
 bool GameMap::generate(int act) {
+    return generate(act, util::defaultRng()());
+}
+
+bool GameMap::generate(int act, uint64_t seed) {
+    TRACE_SCOPE("map", "generate");
+    static util::Histogram& latency = util::MetricsRegistry::getInstance().histogram(
+        "deckstiny_map_generate_seconds", "Time spent in GameMap::generate");
+    util::ScopedLatency timer(latency);
+
     rooms_.clear();
     currentRoomId_ = -1;
     bossDefeated_ = false;
     act_ = act;
     nextRoomId_ = 0; 
     
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
     rng_.seed(seed);
     mapSeed_ = seed;
     
@@ -56,11 +61,10 @@ bool GameMap::generate(int act) {
     std::vector<Room*> nodes_on_higher_floor_to_connect_from; 
 
     // 2a. Create Pre-Boss Rest Site(s) on STS_PRE_BOSS_REST_FLOOR_Y (e.g., floor 14)
-    std::uniform_int_distribution<> pre_boss_rest_count_dist(2, 3); 
-    int num_pre_boss_rests = pre_boss_rest_count_dist(rng_);
+    int num_pre_boss_rests = rng_.uniformInt(2, 3);
     std::vector<int> available_pre_boss_columns;
     for(int i=0; i<STS_NUM_COLUMNS; ++i) available_pre_boss_columns.push_back(i);
-    std::shuffle(available_pre_boss_columns.begin(), available_pre_boss_columns.end(), rng_); 
+    rng_.shuffle(available_pre_boss_columns.begin(), available_pre_boss_columns.end()); 
 
     LOG_INFO("map", "Creating " + std::to_string(num_pre_boss_rests) + " rest sites on pre-boss floor y=" + std::to_string(STS_PRE_BOSS_REST_FLOOR_Y));
     for (int i = 0; i < num_pre_boss_rests && i < (int)available_pre_boss_columns.size(); ++i) {
@@ -87,8 +91,7 @@ bool GameMap::generate(int act) {
         std::unordered_set<Room*> all_nodes_on_higher_floor_that_got_a_link;
 
         for (Room* room_on_higher_floor : nodes_on_higher_floor_to_connect_from) {
-            std::uniform_int_distribution<> num_incoming_paths_dist(1, 2); 
-            int num_paths_to_create_for_this_room_above = num_incoming_paths_dist(rng_);
+            int num_paths_to_create_for_this_room_above = rng_.uniformInt(1, 2);
             if (nodes_on_higher_floor_to_connect_from.size() == 1 && y > 0) num_paths_to_create_for_this_room_above = std::max(1, num_paths_to_create_for_this_room_above);
             
             LOG_DEBUG("map_detail", "  TargetRoom on y+1: #" + std::to_string(room_on_higher_floor->id) + 
@@ -100,7 +103,7 @@ bool GameMap::generate(int act) {
                 possible_cols.push_back(room_on_higher_floor->x); 
                 if (room_on_higher_floor->x > 0) possible_cols.push_back(room_on_higher_floor->x - 1);
                 if (room_on_higher_floor->x < STS_NUM_COLUMNS - 1) possible_cols.push_back(room_on_higher_floor->x + 1);
-                std::shuffle(possible_cols.begin(), possible_cols.end(), rng_);
+                rng_.shuffle(possible_cols.begin(), possible_cols.end());
 
                 int chosen_x_for_new_room_on_floor_y = -1;
                 Room* existing_room_on_floor_y_to_reuse = nullptr;
@@ -241,7 +244,7 @@ bool GameMap::generate(int act) {
                     }
                 }
             }
-            std::shuffle(potential_targets_on_floor_y_plus_1.begin(), potential_targets_on_floor_y_plus_1.end(), rng_);
+            rng_.shuffle(potential_targets_on_floor_y_plus_1.begin(), potential_targets_on_floor_y_plus_1.end());
 
             size_t added_count = 0;
             for (Room* target_node : potential_targets_on_floor_y_plus_1) {
@@ -270,7 +273,7 @@ bool GameMap::generate(int act) {
     }
 
     if (!good_starting_rooms.empty()) {
-        std::shuffle(good_starting_rooms.begin(), good_starting_rooms.end(), rng_);
+        rng_.shuffle(good_starting_rooms.begin(), good_starting_rooms.end());
         currentRoomId_ = good_starting_rooms[0]->id;
         LOG_INFO("map", "Selected start room #" + std::to_string(currentRoomId_) + " at (x:" + std::to_string(rooms_[currentRoomId_].x) + ", y:0) with " + std::to_string(rooms_[currentRoomId_].nextRooms.size()) + " exits.");
     } else {
@@ -308,7 +311,7 @@ bool GameMap::generate(int act) {
                     }
                 }
             }
-            std::shuffle(potential_targets_on_floor1.begin(), potential_targets_on_floor1.end(), rng_);
+            rng_.shuffle(potential_targets_on_floor1.begin(), potential_targets_on_floor1.end());
 
             size_t added_count = 0;
             for (Room* target_room_on_floor1 : potential_targets_on_floor1) {
@@ -408,8 +411,8 @@ bool GameMap::generate(int act) {
             }
         }
     }
-    std::shuffle(candidate_treasure_rooms_ids.begin(), candidate_treasure_rooms_ids.end(), rng_);
-    int treasures_to_place = 1 + (rng_() % 2);
+    rng_.shuffle(candidate_treasure_rooms_ids.begin(), candidate_treasure_rooms_ids.end());
+    int treasures_to_place = 1 + static_cast<int>(rng_.index(2));
     LOG_DEBUG("map", "Attempting to place " + std::to_string(treasures_to_place) + " mid-act treasures on floor " + std::to_string(STS_MID_ACT_TREASURE_FLOOR_Y));
     
     int treasures_placed = 0;
@@ -493,8 +496,7 @@ void GameMap::setRoomType(int roomId, int y, int x, int numPathsFromNode) {
     if (is_sole_child_of_start_monster) {
         std::vector<RoomType> restricted_types = {RoomType::MONSTER, RoomType::EVENT};
         std::vector<double> restricted_weights = {0.7, 0.3};
-        std::discrete_distribution<> dist(restricted_weights.begin(), restricted_weights.end());
-        room.type = restricted_types[dist(rng_)];
+        room.type = restricted_types[rng_.weightedIndex(restricted_weights)];
         LOG_DEBUG("map_detail", "Room #" + std::to_string(roomId) + " (y:1) is sole child of start MONSTER. Forced to " + getRoomTypeString(room.type));
         return;
     }
@@ -562,8 +564,7 @@ void GameMap::setRoomType(int roomId, int y, int x, int numPathsFromNode) {
         return;
     }
 
-    std::discrete_distribution<> dist(weights.begin(), weights.end());
-    room.type = possible_types[dist(rng_)];
+    room.type = possible_types[rng_.weightedIndex(weights)];
 
     if (y == (STS_PRE_BOSS_REST_FLOOR_Y - 1) && room.type == RoomType::REST) {
         LOG_DEBUG("map_detail", "Room #" + std::to_string(roomId) + " on floor y=" + std::to_string(y) + " (pre-pre-boss) became REST, changing to MONSTER.");
@@ -5,11 +5,11 @@
 #include "core/card.h"
 #include "core/relic.h"
 #include "core/combat.h"
+#include "core/combat_journal.h"
 #include "util/logger.h"
+#include "util/rng.h"
 
 #include <algorithm>
-#include <random>
-#include <chrono>
 #include <iostream>
 
 namespace deckstiny {
@@ -25,6 +25,9 @@ int Player::getGold() const {
 
 void Player::addGold(int amount) {
     if (amount > 0) {
+        if (CombatJournal* journal = getJournal()) {
+            journal->recordValue(gold_);
+        }
         gold_ += amount;
     }
 }
@@ -35,6 +38,9 @@ bool Player::spendGold(int amount) {
     }
     
     if (gold_ >= amount) {
+        if (CombatJournal* journal = getJournal()) {
+            journal->recordValue(gold_);
+        }
         gold_ -= amount;
         return true;
     }
@@ -58,6 +64,31 @@ const std::vector<std::shared_ptr<Card>>& Player::getExhaustPile() const {
     return exhaustPile_;
 }
 
+const std::vector<std::shared_ptr<Card>>& Player::getPile(CardPile pile) const {
+    switch (pile) {
+        case CardPile::HAND:    return hand_;
+        case CardPile::DISCARD: return discardPile_;
+        case CardPile::EXHAUST: return exhaustPile_;
+        default:                return drawPile_;
+    }
+}
+
+void Player::restorePile(CardPile pile, const std::vector<std::shared_ptr<Card>>& cards,
+                         const uint8_t* indices, size_t count) {
+    std::vector<std::shared_ptr<Card>>* target = &drawPile_;
+    switch (pile) {
+        case CardPile::HAND:    target = &hand_; break;
+        case CardPile::DISCARD: target = &discardPile_; break;
+        case CardPile::EXHAUST: target = &exhaustPile_; break;
+        default:                break;
+    }
+    journalPile(*target);
+    target->resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        (*target)[i] = cards[indices[i]];
+    }
+}
+
 const std::vector<std::shared_ptr<Relic>>& Player::getRelics() const {
     return relics_;
 }
@@ -76,31 +107,31 @@ void Player::addCard(std::shared_ptr<Card> card, const std::string& destination)
     
     if (destination == "draw") {
         LOG_DEBUG("player", "Adding card " + card->getName() + " to draw pile");
-        drawPile_.push_back(card);
+        pushCard(drawPile_, card);
     } else if (destination == "discard") {
         LOG_DEBUG("player", "Adding card " + card->getName() + " to discard pile");
         auto it = std::find(hand_.begin(), hand_.end(), card);
         if (it != hand_.end()) {
             LOG_DEBUG("player", "Removing card " + card->getName() + " from hand first");
-            hand_.erase(it);
+            eraseCard(hand_, static_cast<size_t>(it - hand_.begin()));
         }
-        discardPile_.push_back(card);
+        pushCard(discardPile_, card);
         LOG_DEBUG("player", "Hand size now: " + std::to_string(hand_.size()) + ", discard pile size: " + std::to_string(discardPile_.size()));
     } else if (destination == "hand") {
         LOG_DEBUG("player", "Adding card " + card->getName() + " to hand");
-        hand_.push_back(card);
+        pushCard(hand_, card);
         LOG_DEBUG("player", "Hand size now: " + std::to_string(hand_.size()));
     } else if (destination == "exhaust") {
         LOG_DEBUG("player", "Adding card " + card->getName() + " to exhaust pile");
         auto it = std::find(hand_.begin(), hand_.end(), card);
         if (it != hand_.end()) {
             LOG_DEBUG("player", "Removing card " + card->getName() + " from hand first");
-            hand_.erase(it);
+            eraseCard(hand_, static_cast<size_t>(it - hand_.begin()));
         }
-        exhaustPile_.push_back(card);
+        pushCard(exhaustPile_, card);
     } else {
         LOG_DEBUG("player", "Unknown destination '" + destination + "', defaulting to draw pile");
-        drawPile_.push_back(card);
+        pushCard(drawPile_, card);
     }
 }
 
@@ -108,29 +139,29 @@ void Player::addRelic(std::shared_ptr<Relic> relic) {
     if (relic) {
         relics_.push_back(relic);
         relic->onObtain(this);
+        relic->subscribe(triggers_);
     }
 }
 
 int Player::drawCards(int count) {
-    LOG_INFO("player", "Attempting to draw " + std::to_string(count) + " cards. Draw pile size: " + 
-             std::to_string(drawPile_.size()) + ", Discard pile size: " + std::to_string(discardPile_.size()) +
-             ", Hand size: " + std::to_string(hand_.size()));
+    LOG_INFOF("player", "Attempting to draw {} cards. Draw pile size: {}, Discard pile size: {}, Hand size: {}",
+              count, drawPile_.size(), discardPile_.size(), hand_.size());
     
     int drawn = 0;
     int targetCount = count;
     
     int maxPossibleDraws = initialHandSize_ - static_cast<int>(hand_.size());
     if (maxPossibleDraws <= 0) {
-        LOG_INFO("player", "Hand is already full (" + std::to_string(hand_.size()) + " cards), cannot draw more");
+        LOG_INFOF("player", "Hand is already full ({} cards), cannot draw more", hand_.size());
         return 0;
     }
     
     targetCount = std::min(targetCount, maxPossibleDraws);
-    LOG_INFO("player", "Limited draw to " + std::to_string(targetCount) + " cards to respect hand size limit");
+    LOG_INFOF("player", "Limited draw to {} cards to respect hand size limit", targetCount);
     
     if ((int)(drawPile_.size() + discardPile_.size()) < targetCount) {
-        LOG_WARNING("player", "Not enough cards in deck to draw " + std::to_string(targetCount) + 
-                   " cards. Total available: " + std::to_string(drawPile_.size() + discardPile_.size()));
+        LOG_WARNINGF("player", "Not enough cards in deck to draw {} cards. Total available: {}",
+                     targetCount, drawPile_.size() + discardPile_.size());
     }
     
     while (drawn < targetCount) {
@@ -143,28 +174,25 @@ int Player::drawCards(int count) {
             }
             
             shuffleDiscardIntoDraw();
-            LOG_INFO("player", "Shuffled discard into draw. New draw pile size: " + std::to_string(drawPile_.size()));
+            LOG_INFOF("player", "Shuffled discard into draw. New draw pile size: {}", drawPile_.size());
         }
         
         if (!drawPile_.empty()) {
-            std::string cardName = drawPile_.back()->getName();
-            hand_.push_back(drawPile_.back());
-            drawPile_.pop_back();
+            const Card* card = drawPile_.back().get();
+            pushCard(hand_, drawPile_.back());
+            eraseCard(drawPile_, drawPile_.size() - 1);
             drawn++;
-            LOG_INFO("player", "Drew card: " + cardName + ". Cards drawn so far: " + std::to_string(drawn) + 
-                     " of " + std::to_string(targetCount) + 
-                     ". Hand size: " + std::to_string(hand_.size()));
+            LOG_INFOF("player", "Drew card: {}. Cards drawn so far: {} of {}. Hand size: {}",
+                      card->getName(), drawn, targetCount, hand_.size());
         }
     }
     
-    LOG_INFO("player", "Drew " + std::to_string(drawn) + " cards. Hand size now: " + std::to_string(hand_.size()) +
-             ", Draw pile size: " + std::to_string(drawPile_.size()) + 
-             ", Discard pile size: " + std::to_string(discardPile_.size()) +
-             ", Total deck size: " + std::to_string(drawPile_.size() + discardPile_.size() + hand_.size() + exhaustPile_.size()));
+    LOG_INFOF("player", "Drew {} cards. Hand size now: {}, Draw pile size: {}, Discard pile size: {}, Total deck size: {}",
+              drawn, hand_.size(), drawPile_.size(), discardPile_.size(),
+              drawPile_.size() + discardPile_.size() + hand_.size() + exhaustPile_.size());
 
     if (drawn < targetCount) {
-        LOG_WARNING("player", "Drew fewer cards (" + std::to_string(drawn) + ") than requested (" + 
-                   std::to_string(targetCount) + ")");
+        LOG_WARNINGF("player", "Drew fewer cards ({}) than requested ({})", drawn, targetCount);
     }
     
     return drawn;
@@ -202,9 +230,9 @@ int Player::discardCards(const std::vector<int>& indices) {
             LOG_INFO("player", "Discarding card: " + cardName + " at index " + std::to_string(index));
             
             auto card = hand_[index];
-            discardPile_.push_back(card);
+            pushCard(discardPile_, card);
             
-            hand_.erase(hand_.begin() + index);
+            eraseCard(hand_, static_cast<size_t>(index));
             discarded++;
             
             LOG_INFO("player", "Card discarded. Hand size now: " + std::to_string(hand_.size()) + 
@@ -239,6 +267,7 @@ bool Player::discardHand() {
     } catch (const std::exception& e) {
         LOG_ERROR("player", "Exception while discarding hand: " + std::string(e.what()));
 
+        journalPile(hand_);
         hand_.clear();
         LOG_INFO("player", "Hand cleared after error. Hand size now: " + std::to_string(hand_.size()));
         return false;
@@ -257,14 +286,14 @@ bool Player::discardCard(int index) {
         auto card = hand_[index];
         if (!card) {
             LOG_ERROR("player", "Null card at index " + std::to_string(index));
-            hand_.erase(hand_.begin() + index);
+            eraseCard(hand_, static_cast<size_t>(index));
             return false;
         }
         
         LOG_INFO("player", "Discarding card: " + card->getName() + " at index " + std::to_string(index));
         
-        hand_.erase(hand_.begin() + index);
-        discardPile_.push_back(card);
+        eraseCard(hand_, static_cast<size_t>(index));
+        pushCard(discardPile_, card);
         
         LOG_INFO("player", "Card discarded. Hand size now: " + std::to_string(hand_.size()) + ", Discard pile size: " + std::to_string(discardPile_.size()));
         
@@ -272,7 +301,7 @@ bool Player::discardCard(int index) {
     } catch (const std::exception& e) {
         LOG_ERROR("player", "Exception while discarding card: " + std::string(e.what()));
         if (index >= 0 && index < static_cast<int>(hand_.size())) {
-            hand_.erase(hand_.begin() + index);
+            eraseCard(hand_, static_cast<size_t>(index));
         }
         return false;
     }
@@ -283,13 +312,15 @@ bool Player::exhaustCard(int index) {
         return false;
     }
     
-    exhaustPile_.push_back(hand_[index]);
-    hand_.erase(hand_.begin() + index);
+    pushCard(exhaustPile_, hand_[index]);
+    eraseCard(hand_, static_cast<size_t>(index));
     
     return true;
 }
 
 void Player::shuffleDiscardIntoDraw() {
+    journalPile(drawPile_);
+    journalPile(discardPile_);
     drawPile_.insert(drawPile_.end(), discardPile_.begin(), discardPile_.end());
     discardPile_.clear();
     
@@ -297,8 +328,12 @@ void Player::shuffleDiscardIntoDraw() {
 }
 
 void Player::shuffleDrawPile() {
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    std::shuffle(drawPile_.begin(), drawPile_.end(), std::default_random_engine(seed));
+    util::Rng& rng = shuffleRng_ ? *shuffleRng_ : util::defaultRng();
+    journalPile(drawPile_);
+    if (CombatJournal* journal = getJournal()) {
+        journal->recordRng(rng);
+    }
+    rng.shuffle(drawPile_.begin(), drawPile_.end());
     LOG_INFO("player", "Draw pile shuffled.");
 }
 
@@ -309,6 +344,9 @@ void Player::beginCombat(bool shuffleDeck) {
     
     if (shuffleDeck) {
         LOG_INFO("player", "Shuffling main deck into draw pile for new combat.");
+        for (auto* pile : {&drawPile_, &hand_, &discardPile_, &exhaustPile_}) {
+            journalPile(*pile);
+        }
         for (auto& card : hand_) { drawPile_.push_back(card); }
         hand_.clear();
         for (auto& card : discardPile_) { drawPile_.push_back(card); }
@@ -324,8 +362,9 @@ void Player::beginCombat(bool shuffleDeck) {
     LOG_INFO("player", "Drawing initial hand of " + std::to_string(initialHandSize_) + " cards.");
     drawCards(initialHandSize_);
     
-    for (auto& relic : relics_) {
-        relic->onCombatStart(this, nullptr);
+    if (triggers_.hasHandlers(Trigger::COMBAT_START)) {
+        TriggerContext context;
+        fireTrigger(Trigger::COMBAT_START, context);
     }
     LOG_INFO("player", "Combat setup complete for " + getName() + ". Energy: " + std::to_string(getEnergy()) + ", Hand size: " + std::to_string(hand_.size()));
 }
@@ -341,8 +380,9 @@ void Player::startTurn() {
     LOG_INFO("player", "Drawing cards up to hand size limit of " + std::to_string(initialHandSize_) + " cards.");
     drawCards(initialHandSize_); 
     
-    for (auto& relic : relics_) {
-        relic->onTurnStart(this, currentCombat_);
+    if (triggers_.hasHandlers(Trigger::TURN_START)) {
+        TriggerContext context;
+        fireTrigger(Trigger::TURN_START, context);
     }
 
     Character::startTurn();
@@ -352,19 +392,29 @@ void Player::startTurn() {
 
 void Player::endTurn() {
     LOG_INFO("player", "Player " + getName() + " ending turn.");
-    for (auto& relic : relics_) {
-        relic->onTurnEnd(this, nullptr);
+    if (triggers_.hasHandlers(Trigger::TURN_END)) {
+        TriggerContext context;
+        fireTrigger(Trigger::TURN_END, context);
     }
     Character::endTurn();
 }
 
-void Player::endCombat() {
+void Player::endCombat(bool victorious) {
     LOG_INFO("player", "Player " + getName() + " ending combat.");
-    for (auto& relic : relics_) {
-        relic->onCombatEnd(this, true, nullptr);
+    if (triggers_.hasHandlers(Trigger::COMBAT_END)) {
+        TriggerContext context;
+        context.victorious = victorious;
+        fireTrigger(Trigger::COMBAT_END, context);
     }
     resetBlock();
     setEnergy(0);
+    for (auto* pile : {&drawPile_, &discardPile_, &hand_, &exhaustPile_}) {
+        for (auto& card : *pile) {
+            if (card) {
+                card->resetCombatState();
+            }
+        }
+    }
     LOG_INFO("player", "Player " + getName() + " combat ended. Energy set to 0.");
 }
 
@@ -393,14 +443,13 @@ bool Player::loadFromJson(const nlohmann::json& json) {
 std::unique_ptr<Entity> Player::clone() const {
     auto player = std::make_unique<Player>(getId(), getName(), getMaxHealth(), getBaseEnergy(), initialHandSize_);
     player->gold_ = gold_;
+    player->shuffleRng_ = shuffleRng_;
     
     player->setHealth(getHealth());
     player->addBlock(getBlock());
     player->setEnergy(getEnergy());
     
-    for (const auto& effect : getStatusEffects()) {
-        player->addStatusEffect(effect.first, effect.second);
-    }
+    player->copyStatusEffects(*this);
     
     for (const auto& card : drawPile_) {
         player->addCard(card->cloneCard(), "draw");
@@ -436,24 +485,24 @@ void Player::increaseMaxHealth(int amount) {
 void Player::addCardToDeck(std::shared_ptr<Card> card) {
     if (card) {
         LOG_DEBUG("player", "Adding card " + card->getName() + " directly to draw pile (deck).");
-        drawPile_.push_back(card);
+        pushCard(drawPile_, card);
     }
 }
 
 bool Player::removeCardFromDeck(const std::string& cardId, bool removeAllInstances) {
     bool removed = false;
     auto removeFromPile = [&](std::vector<std::shared_ptr<Card>>& pile, const std::string& pileName) {
-        auto it = pile.begin();
-        while (it != pile.end()) {
-            if ((*it) && (*it)->getId() == cardId) {
+        size_t index = 0;
+        while (index < pile.size()) {
+            if (pile[index] && pile[index]->getId() == cardId) {
                 LOG_DEBUG("player", "Removing card '" + cardId + "' from " + pileName);
-                it = pile.erase(it);
+                eraseCard(pile, index);
                 removed = true;
                 if (!removeAllInstances) {
                     return; 
                 }
             } else {
-                ++it;
+                ++index;
             }
         }
     };
@@ -480,8 +529,38 @@ void Player::setCurrentCombat(Combat* combat) {
     currentCombat_ = combat;
 }
 
+void Player::fireTrigger(Trigger trigger, TriggerContext& context) {
+    if (!context.player) {
+        context.player = this;
+    }
+    if (!context.combat) {
+        context.combat = currentCombat_;
+    }
+    triggers_.fire(trigger, context);
+}
+
 Combat* Player::getCurrentCombat() const {
     return currentCombat_;
 }
 
+void Player::pushCard(std::vector<std::shared_ptr<Card>>& pile, const std::shared_ptr<Card>& card) {
+    if (CombatJournal* journal = getJournal()) {
+        journal->recordPush(pile);
+    }
+    pile.push_back(card);
+}
+
+void Player::eraseCard(std::vector<std::shared_ptr<Card>>& pile, size_t index) {
+    if (CombatJournal* journal = getJournal()) {
+        journal->recordErase(pile, index);
+    }
+    pile.erase(pile.begin() + static_cast<std::ptrdiff_t>(index));
+}
+
+void Player::journalPile(std::vector<std::shared_ptr<Card>>& pile) {
+    if (CombatJournal* journal = getJournal()) {
+        journal->recordPile(pile);
+    }
+}
+
 } // namespace deckstiny 
\ No newline at end of file
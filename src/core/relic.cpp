@@ -4,6 +4,8 @@
 #include "core/relic.h"
 #include "core/player.h"
 #include "core/combat.h"
+#include "core/enemy.h"
+#include "util/logger.h"
 
 #include <iostream>
 
@@ -57,38 +59,164 @@ void Relic::onObtain(Player* player) {
 }
 
 void Relic::onCombatStart(Player* player, Combat* combat) {
-    (void)player;
-    (void)combat;
+    runEffects(Trigger::COMBAT_START, player, combat);
 }
 
 void Relic::onTurnStart(Player* player, Combat* combat) {
-    (void)player;
-    (void)combat;
+    runEffects(Trigger::TURN_START, player, combat);
 }
 
 void Relic::onTurnEnd(Player* player, Combat* combat) {
-    (void)player;
-    (void)combat;
+    runEffects(Trigger::TURN_END, player, combat);
 }
 
 int Relic::onTakeDamage(Player* player, int damage, Combat* combat) {
-    (void)player;
-    (void)combat;
+    runEffects(Trigger::ON_DAMAGE_TAKEN, player, combat);
     return damage;
 }
 
 int Relic::onDealDamage(Player* player, int damage, int targetIndex, Combat* combat) {
-    (void)player;
     (void)targetIndex;
-    (void)combat;
+    runEffects(Trigger::ON_DAMAGE_DEALT, player, combat);
     return damage;
 }
 
 void Relic::onCombatEnd(Player* player, bool victorious, Combat* combat) {
-    (void)combat;
-    
-    if (getId() == "burning_blood" && victorious && player) {
-        player->heal(6);
+    if (victorious) {
+        runEffects(Trigger::COMBAT_END, player, combat);
+    }
+}
+
+const std::vector<RelicEffect>& Relic::getEffects() const {
+    static const std::vector<RelicEffect> empty;
+    return effects_ ? *effects_ : empty;
+}
+
+void Relic::runEffects(Trigger trigger, Player* player, Combat* combat) const {
+    if (!player || !effects_ || !hasTrigger(trigger)) {
+        return;
+    }
+    for (const RelicEffect& effect : *effects_) {
+        if (effect.trigger != trigger) {
+            continue;
+        }
+        switch (effect.op) {
+            case RelicEffectOp::HEAL:
+                player->heal(effect.value);
+                break;
+            case RelicEffectOp::DRAW:
+                player->drawCards(effect.value);
+                break;
+            case RelicEffectOp::BLOCK:
+                player->addBlock(effect.value);
+                break;
+            case RelicEffectOp::ENERGY:
+                player->setEnergy(player->getEnergy() + effect.value);
+                break;
+            case RelicEffectOp::STATUS_SELF:
+                player->addStatusEffect(effect.status, effect.value);
+                break;
+            case RelicEffectOp::STATUS_ALL_ENEMIES:
+                if (combat) {
+                    for (size_t i = 0; i < combat->getEnemyCount(); ++i) {
+                        Enemy* enemy = combat->getEnemy(i);
+                        if (enemy && enemy->isAlive()) {
+                            enemy->addStatusEffect(effect.status, effect.value);
+                        }
+                    }
+                }
+                break;
+        }
+    }
+}
+
+void Relic::compileEffects(const nlohmann::json& effectsJson) {
+    auto effects = std::make_shared<std::vector<RelicEffect>>();
+    triggers_ = 0;
+
+    for (const auto& effectJson : effectsJson) {
+        std::string triggerStr = effectJson.value("trigger", "");
+        std::string type = effectJson.value("type", "");
+        std::string target = effectJson.value("target", "player");
+
+        RelicEffect effect;
+        if (!parseTrigger(triggerStr, effect.trigger)) {
+            LOG_WARNING("relic", "Unknown trigger '" + triggerStr + "' in relic " + getId());
+            continue;
+        }
+        effect.value = effectJson.value("value", 0);
+
+        bool onPlayer = target == "player" || target == "self" || target == "SELF";
+        bool onEnemies = target == "all_enemies" || target == "ALL_ENEMIES";
+        bool supported = true;
+        if (type == "heal" && onPlayer) {
+            effect.op = RelicEffectOp::HEAL;
+        } else if (type == "draw" && onPlayer) {
+            effect.op = RelicEffectOp::DRAW;
+        } else if (type == "block" && onPlayer) {
+            effect.op = RelicEffectOp::BLOCK;
+        } else if (type == "energy" && onPlayer) {
+            effect.op = RelicEffectOp::ENERGY;
+        } else if (type == "status_effect" && (onPlayer || onEnemies)) {
+            std::string status = effectJson.value("effect", "");
+            supported = !status.empty();
+            effect.op = onPlayer ? RelicEffectOp::STATUS_SELF : RelicEffectOp::STATUS_ALL_ENEMIES;
+            effect.status = util::Symbol::intern(status);
+        } else {
+            supported = false;
+        }
+
+        if (!supported) {
+            LOG_WARNING("relic", "Unsupported effect '" + type + "' on '" + target + "' in relic " + getId());
+            continue;
+        }
+        effects->push_back(effect);
+        addTrigger(effect.trigger);
+    }
+    effects_ = std::move(effects);
+}
+
+void Relic::subscribe(TriggerBus& bus) {
+    for (size_t i = 0; i < static_cast<size_t>(Trigger::COUNT); ++i) {
+        if (triggers_ & (1u << i)) {
+            bus.subscribe(static_cast<Trigger>(i), this, &Relic::handleTrigger);
+        }
+    }
+}
+
+bool Relic::hasTrigger(Trigger trigger) const {
+    return (triggers_ & (1u << static_cast<unsigned>(trigger))) != 0;
+}
+
+void Relic::addTrigger(Trigger trigger) {
+    if (trigger < Trigger::COUNT) {
+        triggers_ |= 1u << static_cast<unsigned>(trigger);
+    }
+}
+
+void Relic::handleTrigger(void* owner, TriggerContext& context) {
+    Relic* relic = static_cast<Relic*>(owner);
+    switch (context.trigger) {
+        case Trigger::COMBAT_START:
+            relic->onCombatStart(context.player, context.combat);
+            break;
+        case Trigger::TURN_START:
+            relic->onTurnStart(context.player, context.combat);
+            break;
+        case Trigger::TURN_END:
+            relic->onTurnEnd(context.player, context.combat);
+            break;
+        case Trigger::COMBAT_END:
+            relic->onCombatEnd(context.player, context.victorious, context.combat);
+            break;
+        case Trigger::ON_DAMAGE_DEALT:
+            context.amount = relic->onDealDamage(context.player, context.amount, context.targetIndex, context.combat);
+            break;
+        case Trigger::ON_DAMAGE_TAKEN:
+            context.amount = relic->onTakeDamage(context.player, context.amount, context.combat);
+            break;
+        case Trigger::COUNT:
+            break;
     }
 }
 
@@ -129,6 +257,10 @@ bool Relic::loadFromJson(const nlohmann::json& json) {
             counter_ = json["counter"].get<int>();
         }
         
+        if (json.contains("effects") && json["effects"].is_array()) {
+            compileEffects(json["effects"]);
+        }
+        
         return true;
     } catch (const std::exception& e) {
         return false;
@@ -138,11 +270,16 @@ bool Relic::loadFromJson(const nlohmann::json& json) {
 std::unique_ptr<Entity> Relic::clone() const {
     auto relic = std::make_unique<Relic>(getId(), getName(), description_, rarity_, flavorText_);
     relic->counter_ = counter_;
+    relic->triggers_ = triggers_;
+    relic->effects_ = effects_;
     return relic;
 }
 
 std::shared_ptr<Relic> Relic::cloneRelic() const {
-    return std::make_shared<Relic>(getId(), getName(), description_, rarity_, flavorText_);
+    auto relic = std::make_shared<Relic>(getId(), getName(), description_, rarity_, flavorText_);
+    relic->triggers_ = triggers_;
+    relic->effects_ = effects_;
+    return relic;
 }
 
 } // namespace deckstiny 
\ No newline at end of file
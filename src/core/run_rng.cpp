@@ -0,0 +1,27 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "core/run_rng.h"
+
+#include <random>
+
+namespace deckstiny {
+
+RunRng::RunRng(uint64_t seed) {
+    reseed(seed);
+}
+
+void RunRng::reseed(uint64_t seed) {
+    seed_ = seed;
+    util::Rng root(seed);
+    for (size_t i = 0; i < streams_.size(); ++i) {
+        streams_[i] = root.split(i);
+    }
+}
+
+uint64_t RunRng::randomSeed() {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) ^ device();
+}
+
+} // namespace deckstiny
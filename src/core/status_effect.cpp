@@ -0,0 +1,23 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "core/status_effect.h"
+
+#include <stdexcept>
+
+namespace deckstiny {
+
+void StatusEffectList::add(const std::string& name, int stacks) {
+    entries_.emplace_back(name, stacks);
+}
+
+int StatusEffectList::at(const std::string& name) const {
+    for (const auto& entry : entries_) {
+        if (entry.first == name) {
+            return entry.second;
+        }
+    }
+    throw std::out_of_range("Status effect not present: " + name);
+}
+
+} // namespace deckstiny
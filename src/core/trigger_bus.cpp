@@ -0,0 +1,63 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "core/trigger_bus.h"
+
+#include <algorithm>
+
+namespace deckstiny {
+
+namespace {
+
+/// Data file names, in Trigger order
+constexpr const char* TRIGGER_NAMES[] = {
+    "COMBAT_START",
+    "TURN_START",
+    "TURN_END",
+    "COMBAT_END",
+    "ON_DAMAGE_DEALT",
+    "ON_DAMAGE_TAKEN"
+};
+
+static_assert(sizeof(TRIGGER_NAMES) / sizeof(TRIGGER_NAMES[0]) == static_cast<size_t>(Trigger::COUNT),
+              "every trigger needs a name");
+
+} // namespace
+
+bool parseTrigger(std::string_view name, Trigger& trigger) {
+    for (size_t i = 0; i < static_cast<size_t>(Trigger::COUNT); ++i) {
+        if (name == TRIGGER_NAMES[i]) {
+            trigger = static_cast<Trigger>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* triggerName(Trigger trigger) {
+    size_t index = static_cast<size_t>(trigger);
+    return index < static_cast<size_t>(Trigger::COUNT) ? TRIGGER_NAMES[index] : "UNKNOWN";
+}
+
+void TriggerBus::subscribe(Trigger trigger, void* owner, HandlerFunction function) {
+    if (trigger >= Trigger::COUNT || !function) {
+        return;
+    }
+    handlers_[static_cast<size_t>(trigger)].push_back(Handler{function, owner});
+}
+
+void TriggerBus::unsubscribe(const void* owner) {
+    for (auto& handlers : handlers_) {
+        handlers.erase(std::remove_if(handlers.begin(), handlers.end(),
+                                      [owner](const Handler& handler) { return handler.owner == owner; }),
+                       handlers.end());
+    }
+}
+
+void TriggerBus::clear() {
+    for (auto& handlers : handlers_) {
+        handlers.clear();
+    }
+}
+
+} // namespace deckstiny
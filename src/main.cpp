@@ -6,6 +6,9 @@
 #include "ui/text_ui.h"
 #include "ui/ui_interface.h"
 #include "util/logger.h"
+#include "util/metrics.h"
+#include "util/trace_spans.h"
+#include <chrono>
 #include <thread>
 #include <iostream>
 #include <string>
@@ -26,7 +29,22 @@ int main(int argc, char* argv[]) {
     } else {
         ui = std::make_shared<GraphicalUI>();
     }
+
+    // --metrics FILE writes a metrics snapshot every 10 seconds while the game runs
+    util::MetricsExporter metrics;
+    auto metricsArg = std::find(args.begin(), args.end(), "--metrics");
+    if (metricsArg != args.end() && metricsArg + 1 != args.end() &&
+        !metrics.start(*(metricsArg + 1), std::chrono::seconds(10))) {
+        std::cerr << "Failed to write metrics file " << *(metricsArg + 1) << std::endl;
+    }
     
+    // --spans FILE captures TRACE_SCOPE spans from startup to exit as Chrome trace JSON
+    auto spansArg = std::find(args.begin(), args.end(), "--spans");
+    bool captureSpans = spansArg != args.end() && spansArg + 1 != args.end();
+    if (captureSpans) {
+        util::SpanTrace::start();
+    }
+
     // Initialize game
     if (!game->initialize(ui)) {
         std::cerr << "Failed to initialize game" << std::endl;
@@ -41,6 +59,9 @@ int main(int argc, char* argv[]) {
     if (gameThread.joinable()) {
         gameThread.join();
     }
+    if (captureSpans) {
+        util::SpanTrace::stop(*(spansArg + 1));
+    }
     
     return 0;
 } 
\ No newline at end of file
@@ -0,0 +1,218 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "sim/batch_runner.h"
+#include "core/card.h"
+#include "core/combat.h"
+#include "core/enemy.h"
+#include "core/game.h"
+#include "core/player.h"
+#include "core/relic.h"
+#include "core/run_rng.h"
+#include "util/logger.h"
+#include "util/rng.h"
+#include "util/work_stealing.h"
+
+#include <algorithm>
+
+namespace deckstiny {
+namespace sim {
+
+namespace {
+
+// Fights a worker claims at a time; small enough to balance, large enough to skip most locking
+constexpr size_t FIGHT_GRAIN = 64;
+
+void addToBucket(std::vector<uint64_t>& histogram, int value) {
+    size_t bucket = static_cast<size_t>(std::max(value, 0));
+    if (histogram.size() <= bucket) {
+        histogram.resize(bucket + 1, 0);
+    }
+    histogram[bucket]++;
+}
+
+void mergeHistogram(std::vector<uint64_t>& into, const std::vector<uint64_t>& from) {
+    if (into.size() < from.size()) {
+        into.resize(from.size(), 0);
+    }
+    for (size_t i = 0; i < from.size(); ++i) {
+        into[i] += from[i];
+    }
+}
+
+} // namespace
+
+void FightStats::add(const FightOutcome& outcome) {
+    fights_++;
+    hpLostSum_ += static_cast<uint64_t>(std::max(outcome.hpLost, 0));
+    addToBucket(hpLost_, outcome.hpLost);
+    if (outcome.victory) {
+        wins_++;
+        turnsToKillSum_ += static_cast<uint64_t>(std::max(outcome.turns, 0));
+        addToBucket(turnsToKill_, outcome.turns);
+    }
+}
+
+void FightStats::merge(const FightStats& other) {
+    fights_ += other.fights_;
+    wins_ += other.wins_;
+    turnsToKillSum_ += other.turnsToKillSum_;
+    hpLostSum_ += other.hpLostSum_;
+    mergeHistogram(turnsToKill_, other.turnsToKill_);
+    mergeHistogram(hpLost_, other.hpLost_);
+}
+
+double FightStats::getWinRate() const {
+    return fights_ > 0 ? static_cast<double>(wins_) / static_cast<double>(fights_) : 0.0;
+}
+
+double FightStats::getMeanTurnsToKill() const {
+    return wins_ > 0 ? static_cast<double>(turnsToKillSum_) / static_cast<double>(wins_) : 0.0;
+}
+
+double FightStats::getMeanHpLost() const {
+    return fights_ > 0 ? static_cast<double>(hpLostSum_) / static_cast<double>(fights_) : 0.0;
+}
+
+bool validateFightSpec(const Game& game, const FightSpec& spec) {
+    const auto& characters = game.getAllCharacterData();
+    if (characters.find(spec.characterId) == characters.end()) {
+        LOG_ERROR("batch", "Unknown character '" + spec.characterId + "'");
+        return false;
+    }
+    if (spec.enemies.empty()) {
+        LOG_ERROR("batch", "Fight has no enemies");
+        return false;
+    }
+    for (const auto& id : spec.deck) {
+        if (!game.getCardData(id)) {
+            LOG_ERROR("batch", "Unknown card '" + id + "'");
+            return false;
+        }
+    }
+    for (const auto& id : spec.relics) {
+        if (!game.getRelicData(id)) {
+            LOG_ERROR("batch", "Unknown relic '" + id + "'");
+            return false;
+        }
+    }
+    for (const auto& id : spec.enemies) {
+        if (!game.getEnemyData(id)) {
+            LOG_ERROR("batch", "Unknown enemy '" + id + "'");
+            return false;
+        }
+    }
+    return true;
+}
+
+BatchRunner::BatchRunner(Game& game, size_t threadCount)
+    : game_(game), threadCount_(util::WorkStealingScheduler(threadCount).getThreadCount()) {
+}
+
+void BatchRunner::setPolicyFactory(PolicyFactory factory) {
+    policyFactory_ = std::move(factory);
+}
+
+bool BatchRunner::validate(const FightSpec& spec) const {
+    return validateFightSpec(game_, spec);
+}
+
+FightStats BatchRunner::run(const FightSpec& spec, size_t fights, uint64_t seed) {
+    FightStats total;
+    if (fights == 0 || !validate(spec)) {
+        return total;
+    }
+
+    util::WorkStealingScheduler scheduler(threadCount_);
+    std::vector<FightStats> perWorker(scheduler.getThreadCount());
+    policies_.clear();
+    policies_.resize(scheduler.getThreadCount());
+    for (auto& policy : policies_) {
+        policy = policyFactory_ ? policyFactory_(seed) : std::make_unique<GreedyPolicy>(seed, spec.characterId);
+    }
+
+    const util::Rng root(seed);
+    scheduler.run(fights, FIGHT_GRAIN, [&](size_t worker, size_t begin, size_t end) {
+        BotPolicy& policy = *policies_[worker];
+        for (size_t i = begin; i < end; ++i) {
+            policy.beginRun(static_cast<int>(i));
+            perWorker[worker].add(runFight(spec, policy, root.split(i)()));
+        }
+    });
+
+    for (const auto& stats : perWorker) {
+        total.merge(stats);
+    }
+    return total;
+}
+
+FightOutcome BatchRunner::runFight(const FightSpec& spec, BotPolicy& policy, uint64_t seed) {
+    FightOutcome outcome;
+    const auto& characters = game_.getAllCharacterData();
+    auto characterIt = characters.find(spec.characterId);
+    if (characterIt == characters.end()) {
+        return outcome;
+    }
+    const CharacterData& character = characterIt->second;
+
+    RunRng rng(seed);
+    Player player(character.id, character.name, character.max_health, character.base_energy,
+                  character.initial_hand_size);
+    player.setShuffleRng(&rng.get(RngStream::SHUFFLE));
+    for (const auto& id : spec.deck.empty() ? character.starting_deck : spec.deck) {
+        if (auto card = game_.loadCard(id)) {
+            player.addCard(card);
+        }
+    }
+    for (const auto& id : spec.relics.empty() ? character.starting_relics : spec.relics) {
+        if (auto relic = game_.loadRelic(id)) {
+            player.addRelic(relic);
+        }
+    }
+
+    Combat combat(&player);
+    combat.setHost(&game_);
+    combat.setRng(&rng.get(RngStream::AI));
+    for (const auto& id : spec.enemies) {
+        combat.addEnemy(game_.loadEnemy(id));
+    }
+
+    int startHealth = player.getHealth();
+    player.setCurrentCombat(&combat);
+    player.beginCombat();
+    combat.start();
+
+    // A card whose effects fail stays in hand; end the turn instead of retrying it forever
+    std::vector<const Card*> rejected;
+    int rejectedTurn = combat.getTurn();
+    while (!combat.isCombatOver() && combat.getTurn() <= spec.maxTurns) {
+        if (combat.getTurn() != rejectedTurn) {
+            rejected.clear();
+            rejectedTurn = combat.getTurn();
+        }
+
+        CombatChoice choice = policy.chooseCombatAction(combat, player);
+        const auto& hand = player.getHand();
+        if (choice.cardIndex < 0 || choice.cardIndex >= static_cast<int>(hand.size())) {
+            combat.endPlayerTurn();
+            continue;
+        }
+        const Card* card = hand[choice.cardIndex].get();
+        if (std::find(rejected.begin(), rejected.end(), card) != rejected.end()) {
+            combat.endPlayerTurn();
+            continue;
+        }
+        if (!combat.playCard(choice.cardIndex, choice.targetIndex)) {
+            rejected.push_back(card);
+        }
+    }
+
+    outcome.victory = combat.areAllEnemiesDefeated() && !combat.isPlayerDefeated();
+    outcome.turns = combat.getTurn();
+    outcome.hpLost = startHealth - player.getHealth();
+    player.setCurrentCombat(nullptr);
+    return outcome;
+}
+
+} // namespace sim
+} // namespace deckstiny
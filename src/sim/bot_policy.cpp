@@ -0,0 +1,139 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "sim/bot_policy.h"
+#include "core/card.h"
+#include "core/combat.h"
+#include "core/enemy.h"
+#include "core/event.h"
+#include "core/map.h"
+#include "core/player.h"
+
+#include <algorithm>
+
+namespace deckstiny {
+namespace sim {
+
+namespace {
+
+bool isBelowHalfHealth(const Player& player) {
+    return player.getHealth() * 2 < player.getMaxHealth();
+}
+
+bool choiceHeals(const EventChoice& choice) {
+    return std::any_of(choice.effects.begin(), choice.effects.end(), [](const EventEffect& effect) {
+        return (effect.type == "GAIN_HEALTH" || effect.type == "HP") && effect.value > 0;
+    });
+}
+
+} // namespace
+
+GreedyPolicy::GreedyPolicy(uint64_t seed, const std::string& characterId)
+    : seedRng_(seed), rng_(seed), characterId_(characterId) {
+}
+
+void GreedyPolicy::beginRun(int runIndex) {
+    // Choices of a run depend only on the seed and its index, not on earlier runs
+    rng_ = seedRng_.split(static_cast<uint64_t>(runIndex));
+}
+
+size_t GreedyPolicy::pickIndex(size_t count) {
+    return rng_.index(count);
+}
+
+size_t GreedyPolicy::chooseCharacter(const std::vector<std::string>& characterIds) {
+    auto it = std::find(characterIds.begin(), characterIds.end(), characterId_);
+    if (it != characterIds.end()) {
+        return static_cast<size_t>(it - characterIds.begin());
+    }
+    return pickIndex(characterIds.size());
+}
+
+size_t GreedyPolicy::chooseRoom(const GameMap& map, const Player& player, const std::vector<int>& availableRooms) {
+    if (isBelowHalfHealth(player)) {
+        for (size_t i = 0; i < availableRooms.size(); ++i) {
+            const Room* room = map.getRoom(availableRooms[i]);
+            if (room && room->type == RoomType::REST) {
+                return i;
+            }
+        }
+    }
+    return pickIndex(availableRooms.size());
+}
+
+CombatChoice GreedyPolicy::chooseCombatAction(Combat& combat, Player& player) {
+    // Weakest living enemy is the target for every targeted card this action
+    int target = -1;
+    for (size_t i = 0; i < combat.getEnemyCount(); ++i) {
+        Enemy* enemy = combat.getEnemy(i);
+        if (enemy && enemy->isAlive() && (target < 0 || enemy->getHealth() < combat.getEnemy(target)->getHealth())) {
+            target = static_cast<int>(i);
+        }
+    }
+
+    CombatChoice best;
+    int bestCost = -1;
+    const auto& hand = player.getHand();
+    for (size_t i = 0; i < hand.size(); ++i) {
+        Card* card = hand[i].get();
+        if (!card) {
+            continue;
+        }
+        int cardTarget = card->needsTarget() ? target : -1;
+        if (card->needsTarget() && target < 0) {
+            continue;
+        }
+        int cost = card->getCost();
+        if (cost > bestCost && card->canPlay(&player, cardTarget, &combat)) {
+            best.cardIndex = static_cast<int>(i);
+            best.targetIndex = cardTarget;
+            bestCost = cost;
+        }
+    }
+    return best;
+}
+
+size_t GreedyPolicy::chooseEventOption(const Event& event, const Player& player) {
+    const auto& choices = event.getAllChoices();
+    std::vector<size_t> affordable;
+    for (size_t i = 0; i < choices.size(); ++i) {
+        if (choices[i].goldCost <= player.getGold() && choices[i].healthCost < player.getHealth()) {
+            if (isBelowHalfHealth(player) && choiceHeals(choices[i])) {
+                return i;
+            }
+            affordable.push_back(i);
+        }
+    }
+    if (affordable.empty()) {
+        return pickIndex(choices.size());
+    }
+    return affordable[pickIndex(affordable.size())];
+}
+
+int GreedyPolicy::chooseShopPurchase(const std::vector<Card*>& cards, const std::map<Card*, int>& prices, int gold) {
+    int cheapest = -1;
+    int cheapestPrice = 0;
+    for (size_t i = 0; i < cards.size(); ++i) {
+        auto it = prices.find(cards[i]);
+        if (it == prices.end() || it->second > gold) {
+            continue;
+        }
+        if (cheapest < 0 || it->second < cheapestPrice) {
+            cheapest = static_cast<int>(i);
+            cheapestPrice = it->second;
+        }
+    }
+    return cheapest;
+}
+
+size_t GreedyPolicy::chooseCardToUpgrade(const std::vector<Card*>& cards) {
+    for (size_t i = 0; i < cards.size(); ++i) {
+        if (cards[i] && cards[i]->getType() == CardType::ATTACK) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+} // namespace sim
+} // namespace deckstiny
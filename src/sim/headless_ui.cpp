@@ -0,0 +1,88 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "sim/headless_ui.h"
+#include "core/map.h"
+
+namespace deckstiny {
+namespace sim {
+
+bool HeadlessUI::initialize(Game*) {
+    return true;
+}
+
+void HeadlessUI::setInputCallback(std::function<bool(const std::string&)>) {
+    // Input is pushed by the driver through Game::processInput
+}
+
+void HeadlessUI::showCharacterSelection(const std::vector<std::string>& availableClasses) {
+    characterNames_ = availableClasses;
+}
+
+void HeadlessUI::showMap(int, const std::vector<int>& availableRooms, const std::unordered_map<int, Room>&) {
+    availableRooms_ = availableRooms;
+}
+
+void HeadlessUI::showCards(const std::vector<Card*>& cards, const std::string&, bool) {
+    lastCards_ = cards;
+}
+
+std::string HeadlessUI::getInput(const std::string& prompt) {
+    return promptHandler_ ? promptHandler_(prompt) : "cancel";
+}
+
+void HeadlessUI::showRewards(int gold, const std::vector<Card*>&, const std::vector<Relic*>&) {
+    rewardCount_++;
+    rewardGold_ += gold;
+}
+
+void HeadlessUI::showGameOver(bool, int score) {
+    gameOver_ = true;
+    finalScore_ = score;
+}
+
+void HeadlessUI::showEvent(const Event* event, const Player*) {
+    currentEvent_ = event;
+}
+
+void HeadlessUI::showEventResult(const std::string&) {
+    // The game releases the event right after reporting its result
+    currentEvent_ = nullptr;
+}
+
+void HeadlessUI::showShop(const std::vector<Card*>& cardsForSale, const std::vector<Relic*>&, int playerGold) {
+    shopCards_ = cardsForSale;
+    shopCardPrices_.clear();
+    shopGold_ = playerGold;
+}
+
+void HeadlessUI::showShop(const std::vector<Card*>& cards,
+                          const std::vector<Relic*>&,
+                          const std::map<Relic*, int>&,
+                          const std::map<Card*, int>& cardPrices,
+                          int playerGold) {
+    shopCards_ = cards;
+    shopCardPrices_ = cardPrices;
+    shopGold_ = playerGold;
+}
+
+void HeadlessUI::setPromptHandler(std::function<std::string(const std::string&)> handler) {
+    promptHandler_ = std::move(handler);
+}
+
+void HeadlessUI::reset() {
+    characterNames_.clear();
+    availableRooms_.clear();
+    lastCards_.clear();
+    currentEvent_ = nullptr;
+    shopCards_.clear();
+    shopCardPrices_.clear();
+    shopGold_ = 0;
+    gameOver_ = false;
+    finalScore_ = 0;
+    rewardCount_ = 0;
+    rewardGold_ = 0;
+}
+
+} // namespace sim
+} // namespace deckstiny
@@ -0,0 +1,841 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "sim/lane_batch_runner.h"
+#include "core/card.h"
+#include "core/enemy.h"
+#include "core/game.h"
+#include "core/player.h"
+#include "core/relic.h"
+#include "core/run_rng.h"
+#include "core/status_effect.h"
+#include "util/logger.h"
+#include "util/rng.h"
+#include "util/work_stealing.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+namespace deckstiny {
+namespace sim {
+
+namespace {
+
+/**
+ * @enum LaneStatus
+ * @brief Status effect kept per lane
+ *
+ * Only these change how a fight plays out (strength is kept for completeness);
+ * every other effect is dropped when the programs are translated.
+ */
+enum class LaneStatus : uint8_t {
+    NONE,
+    STRENGTH,
+    TEMPORARY_STRENGTH,
+    WEAK,
+    VULNERABLE,
+    POISON,
+    COUNT
+};
+
+/// Card effect translated for the lanes
+struct LaneCardOp {
+    CardEffectOp op = CardEffectOp::NONE;
+    int32_t value = 0;
+    LaneStatus status = LaneStatus::NONE;
+};
+
+/// Card instance of the deck, by its position in the deck
+struct LaneCard {
+    int32_t cost = 0;
+    CardTarget target = CardTarget::NONE;
+    bool exhausts = false;              ///< POWER cards leave the fight once played
+    std::vector<LaneCardOp> program;
+};
+
+/// Enemy move effect translated for the lanes
+struct LaneMoveOp {
+    MoveOp op = MoveOp::ATTACK;
+    int32_t value = 0;
+    LaneStatus status = LaneStatus::NONE;
+};
+
+/// Relic effect run when the fight starts, translated for the lanes
+struct LaneRelicOp {
+    RelicEffectOp op = RelicEffectOp::HEAL;
+    int32_t value = 0;
+    LaneStatus status = LaneStatus::NONE;
+};
+
+/// Enemy of the encounter, by its position in the spec
+struct LaneEnemy {
+    int32_t health = 0;
+    int32_t block = 0;
+    int32_t statuses[static_cast<size_t>(LaneStatus::COUNT)] = {};  ///< Starting stacks by LaneStatus
+    std::vector<std::vector<LaneMoveOp>> moves;     ///< Programs by move index
+};
+
+/// Everything a block of lanes needs to know about the fight
+struct LaneContent {
+    int32_t maxHealth = 0;
+    int32_t baseEnergy = 0;
+    int32_t handSize = 0;
+    int maxTurns = 0;
+    std::vector<LaneCard> cards;
+    size_t maxCardOps = 0;
+    std::vector<LaneEnemy> enemies;
+    size_t maxMoveOps = 0;
+    std::vector<LaneRelicOp> startProgram;  ///< COMBAT_START effects of the relics, in firing order
+};
+
+LaneStatus laneStatus(util::Symbol symbol) {
+    int slot = statusEffectSlot(symbol);
+    if (slot < 0) {
+        return LaneStatus::NONE;
+    }
+    switch (static_cast<StatusEffect>(slot)) {
+        case StatusEffect::STRENGTH:           return LaneStatus::STRENGTH;
+        case StatusEffect::TEMPORARY_STRENGTH: return LaneStatus::TEMPORARY_STRENGTH;
+        case StatusEffect::WEAK:               return LaneStatus::WEAK;
+        case StatusEffect::VULNERABLE:         return LaneStatus::VULNERABLE;
+        case StatusEffect::POISON:             return LaneStatus::POISON;
+        default:                               return LaneStatus::NONE;
+    }
+}
+
+std::vector<int32_t>* statusField(LaneFields& fields, LaneStatus status) {
+    switch (status) {
+        case LaneStatus::STRENGTH:           return &fields.strength;
+        case LaneStatus::TEMPORARY_STRENGTH: return &fields.temporaryStrength;
+        case LaneStatus::WEAK:               return &fields.weak;
+        case LaneStatus::VULNERABLE:         return &fields.vulnerable;
+        case LaneStatus::POISON:             return &fields.poison;
+        default:                             return nullptr;
+    }
+}
+
+/// Relic triggers fired during a fight; lanes only run COMBAT_START effects
+bool relicActsInFight(const Relic& relic) {
+    return relic.hasTrigger(Trigger::TURN_START) || relic.hasTrigger(Trigger::TURN_END) ||
+           relic.hasTrigger(Trigger::ON_DAMAGE_DEALT) || relic.hasTrigger(Trigger::ON_DAMAGE_TAKEN);
+}
+
+bool enemySummons(const Enemy& enemy) {
+    for (size_t i = 0; i < enemy.getPossibleMoves().size(); ++i) {
+        const EnemyMove* move = enemy.getMove(i);
+        if (move && std::any_of(move->program.begin(), move->program.end(),
+                                [](const MoveEffect& effect) { return effect.op == MoveOp::SUMMON; })) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool compileContent(Game& game, const FightSpec& spec, LaneContent& content) {
+    const CharacterData& character = game.getAllCharacterData().at(spec.characterId);
+    content.maxHealth = character.max_health;
+    content.baseEnergy = character.base_energy;
+    content.handSize = character.initial_hand_size;
+    content.maxTurns = spec.maxTurns;
+
+    // Build the deck the way BatchRunner::runFight does, so class restrictions drop the same cards
+    Player player(character.id, character.name, character.max_health, character.base_energy,
+                  character.initial_hand_size);
+    for (const auto& id : spec.deck.empty() ? character.starting_deck : spec.deck) {
+        if (auto card = game.loadCard(id)) {
+            player.addCard(card);
+        }
+    }
+    const auto& deck = player.getDrawPile();
+    if (deck.size() > std::numeric_limits<uint16_t>::max()) {
+        LOG_ERROR("lanes", "Deck of " + std::to_string(deck.size()) + " cards is too large");
+        return false;
+    }
+
+    for (const auto& card : deck) {
+        LaneCard laneCard;
+        laneCard.cost = card->getCost();
+        laneCard.target = card->getTarget();
+        laneCard.exhausts = card->getType() == CardType::POWER;
+        for (const CardEffect& effect : card->getEffects()) {
+            laneCard.program.push_back({effect.op, effect.value, laneStatus(effect.statusSymbol)});
+        }
+        content.maxCardOps = std::max(content.maxCardOps, laneCard.program.size());
+        content.cards.push_back(std::move(laneCard));
+    }
+
+    // COMBAT_END effects run after the outcome is taken, like in BatchRunner::runFight
+    for (const auto& id : spec.relics.empty() ? character.starting_relics : spec.relics) {
+        if (auto relic = game.getRelicData(id)) {
+            for (const RelicEffect& effect : relic->getEffects()) {
+                if (effect.trigger == Trigger::COMBAT_START) {
+                    content.startProgram.push_back({effect.op, effect.value, laneStatus(effect.status)});
+                }
+            }
+        }
+    }
+
+    for (const auto& id : spec.enemies) {
+        std::shared_ptr<Enemy> source = game.getEnemyData(id);
+        LaneEnemy enemy;
+        enemy.health = source->getHealth();
+        enemy.block = source->getBlock();
+        enemy.statuses[static_cast<size_t>(LaneStatus::STRENGTH)] = source->getStatusEffect(StatusEffect::STRENGTH);
+        enemy.statuses[static_cast<size_t>(LaneStatus::TEMPORARY_STRENGTH)] =
+            source->getStatusEffect(StatusEffect::TEMPORARY_STRENGTH);
+        enemy.statuses[static_cast<size_t>(LaneStatus::WEAK)] = source->getStatusEffect(StatusEffect::WEAK);
+        enemy.statuses[static_cast<size_t>(LaneStatus::VULNERABLE)] = source->getStatusEffect(StatusEffect::VULNERABLE);
+        enemy.statuses[static_cast<size_t>(LaneStatus::POISON)] = source->getStatusEffect(StatusEffect::POISON);
+        for (size_t i = 0; i < source->getPossibleMoves().size(); ++i) {
+            std::vector<LaneMoveOp> program;
+            if (const EnemyMove* move = source->getMove(i)) {
+                for (const MoveEffect& effect : move->program) {
+                    program.push_back({effect.op, effect.value, laneStatus(effect.symbol)});
+                }
+            }
+            content.maxMoveOps = std::max(content.maxMoveOps, program.size());
+            enemy.moves.push_back(std::move(program));
+        }
+        content.enemies.push_back(std::move(enemy));
+    }
+    return true;
+}
+
+// Character::takeDamage for one lane, after the attacker's weak was applied
+inline void takeDamage(int32_t amount, int32_t vulnerable, int32_t& health, int32_t& block) {
+    amount = std::max(amount, 0);
+    amount = vulnerable > 0 ? (3 * amount + 1) >> 1 : amount;   // round(amount * 1.5)
+    int32_t absorbed = std::min(block, amount);
+    block -= absorbed;
+    health = std::max(0, health - (amount - absorbed));
+}
+
+/**
+ * @brief Deal damage in every lane; lanes with zero damage are unchanged
+ * @param amount Damage before modifiers by lane
+ * @param attackerWeak Weak stacks of the attacker by lane
+ * @param target Fighter taking the damage
+ * @param count Lanes in use
+ */
+void applyDamage(const int32_t* amount, const int32_t* attackerWeak, LaneFields& target, size_t count) {
+    int32_t* health = target.health.data();
+    int32_t* block = target.block.data();
+    const int32_t* vulnerable = target.vulnerable.data();
+    for (size_t i = 0; i < count; ++i) {
+        int32_t damage = attackerWeak[i] > 0 ? (3 * amount[i] + 2) >> 2 : amount[i];   // round(damage * 0.75)
+        takeDamage(damage, vulnerable[i], health[i], block[i]);
+    }
+}
+
+/**
+ * @brief Add block in every lane
+ * @param amount Block gained by lane, zero or negative for none
+ * @param block Block of the fighter
+ * @param count Lanes in use
+ */
+void applyBlock(const int32_t* amount, int32_t* block, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        block[i] += std::max(amount[i], 0);
+    }
+}
+
+/**
+ * @brief Start-of-turn poison: damage equal to the stacks, then lose one stack
+ * @param mask Nonzero for lanes whose fighter starts a turn
+ * @param fighter Fighter whose turn starts
+ * @param count Lanes in use
+ */
+void tickPoison(const int32_t* mask, LaneFields& fighter, size_t count) {
+    int32_t* health = fighter.health.data();
+    int32_t* block = fighter.block.data();
+    int32_t* poison = fighter.poison.data();
+    const int32_t* vulnerable = fighter.vulnerable.data();
+    for (size_t i = 0; i < count; ++i) {
+        int32_t damage = mask[i] != 0 ? poison[i] : 0;
+        takeDamage(damage, vulnerable[i], health[i], block[i]);
+        poison[i] -= damage > 0 ? 1 : 0;
+    }
+}
+
+/**
+ * @brief End-of-turn loss of temporary strength
+ * @param mask Nonzero for lanes whose fighter ends a turn
+ * @param fighter Fighter whose turn ends
+ * @param count Lanes in use
+ */
+void expireTemporaryStrength(const int32_t* mask, LaneFields& fighter, size_t count) {
+    int32_t* strength = fighter.strength.data();
+    int32_t* temporary = fighter.temporaryStrength.data();
+    for (size_t i = 0; i < count; ++i) {
+        int32_t lost = mask[i] != 0 ? temporary[i] : 0;
+        strength[i] = std::max(0, strength[i] - lost);
+        temporary[i] -= lost;
+    }
+}
+
+/**
+ * @class LaneBatch
+ * @brief State of one block of lanes, owned by one worker
+ *
+ * Per-fighter numbers live in LaneFields; piles, generators and the greedy
+ * choice are per lane because they differ in length and control flow.
+ */
+class LaneBatch {
+public:
+    LaneBatch(const LaneContent& content, size_t lanes)
+        : content_(content), lanes_(lanes), deckSize_(content.cards.size()),
+          enemies_(content.enemies.size()) {
+        player_.resize(lanes);
+        for (auto& enemy : enemies_) {
+            enemy.resize(lanes);
+        }
+        energy_.resize(lanes);
+        turn_.resize(lanes);
+        active_.resize(lanes);
+        moves_.resize(content.enemies.size() * lanes);
+        draw_.resize(deckSize_ * lanes);
+        hand_.resize(deckSize_ * lanes);
+        discard_.resize(deckSize_ * lanes);
+        rejected_.resize(deckSize_ * lanes);
+        drawCount_.resize(lanes);
+        handCount_.resize(lanes);
+        discardCount_.resize(lanes);
+        rejectedCount_.resize(lanes);
+        shuffleRng_.resize(lanes);
+        aiRng_.resize(lanes);
+        playing_.resize(lanes);
+        target_.resize(lanes);
+        success_.resize(lanes);
+        ending_.resize(lanes);
+        acting_.resize(lanes);
+        damage_.resize(content.enemies.size() * lanes);
+        amount_.resize(lanes);
+    }
+
+    /**
+     * @brief Play one fight per lane to the end
+     * @param seeds Seed by lane
+     * @param count Lanes to use, at most the lane count
+     * @param outcomes Filled with the outcome by lane
+     */
+    void run(const uint64_t* seeds, size_t count, FightOutcome* outcomes) {
+        count_ = count;
+        for (size_t lane = 0; lane < count_; ++lane) {
+            reset(lane, seeds[lane]);
+        }
+
+        size_t remaining = count_;
+        while (remaining > 0) {
+            bool anyPlaying = false;
+            bool anyEnding = false;
+            for (size_t lane = 0; lane < count_; ++lane) {
+                playing_[lane] = -1;
+                ending_[lane] = 0;
+                if (!active_[lane]) {
+                    continue;
+                }
+                if (isOver(lane)) {
+                    finish(lane, outcomes[lane]);
+                    --remaining;
+                } else if (chooseCard(lane)) {
+                    anyPlaying = true;
+                } else {
+                    ending_[lane] = 1;
+                    anyEnding = true;
+                }
+            }
+            if (anyPlaying) {
+                playCards();
+            }
+            if (anyEnding) {
+                endTurns();
+            }
+        }
+    }
+
+private:
+    const LaneContent& content_;
+    size_t lanes_;
+    size_t count_ = 0;
+    size_t deckSize_;
+
+    LaneFields player_;
+    std::vector<LaneFields> enemies_;            ///< By enemy position
+    std::vector<int32_t> energy_;
+    std::vector<int32_t> turn_;
+    std::vector<uint8_t> active_;
+    std::vector<int32_t> moves_;                 ///< Current move, [enemy * lanes + lane]
+
+    // Piles hold deck positions, lane by lane with room for the whole deck
+    std::vector<uint16_t> draw_;
+    std::vector<uint16_t> hand_;
+    std::vector<uint16_t> discard_;
+    std::vector<uint16_t> rejected_;             ///< Cards whose effects failed this turn
+    std::vector<uint16_t> drawCount_;
+    std::vector<uint16_t> handCount_;
+    std::vector<uint16_t> discardCount_;
+    std::vector<uint16_t> rejectedCount_;
+
+    std::vector<util::Rng> shuffleRng_;
+    std::vector<util::Rng> aiRng_;
+
+    // Scratch of the current step
+    std::vector<int32_t> playing_;               ///< Hand index of the card played, -1 if none
+    std::vector<int32_t> target_;
+    std::vector<uint8_t> success_;
+    std::vector<int32_t> ending_;                ///< Nonzero for lanes ending their turn
+    std::vector<int32_t> acting_;                ///< Nonzero for lanes where the current enemy acts
+    std::vector<int32_t> damage_;                ///< Damage operands, [enemy * lanes + lane]
+    std::vector<int32_t> amount_;                ///< Block or damage operand by lane
+
+    size_t at(size_t enemy, size_t lane) const {
+        return enemy * lanes_ + lane;
+    }
+
+    bool isEnemyAlive(size_t enemy, size_t lane) const {
+        return enemies_[enemy].health[lane] > 0;
+    }
+
+    bool areAllEnemiesDefeated(size_t lane) const {
+        for (size_t e = 0; e < enemies_.size(); ++e) {
+            if (isEnemyAlive(e, lane)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isOver(size_t lane) const {
+        return areAllEnemiesDefeated(lane) || player_.health[lane] <= 0 || turn_[lane] > content_.maxTurns;
+    }
+
+    void finish(size_t lane, FightOutcome& outcome) {
+        active_[lane] = 0;
+        outcome.victory = areAllEnemiesDefeated(lane) && player_.health[lane] > 0;
+        outcome.turns = turn_[lane];
+        outcome.hpLost = content_.maxHealth - player_.health[lane];
+    }
+
+    void addStatus(LaneFields& fighter, LaneStatus status, size_t lane, int32_t stacks) {
+        if (std::vector<int32_t>* field = statusField(fighter, status)) {
+            (*field)[lane] = std::max(0, (*field)[lane] + stacks);
+        }
+    }
+
+    void chooseMove(size_t enemy, size_t lane) {
+        size_t moveCount = content_.enemies[enemy].moves.size();
+        moves_[at(enemy, lane)] = moveCount > 0 ? static_cast<int32_t>(aiRng_[lane].index(moveCount)) : -1;
+    }
+
+    // Player::beginCombat followed by Combat::start
+    void reset(size_t lane, uint64_t seed) {
+        RunRng rng(seed);
+        shuffleRng_[lane] = rng.get(RngStream::SHUFFLE);
+        aiRng_[lane] = rng.get(RngStream::AI);
+
+        player_.health[lane] = content_.maxHealth;
+        player_.block[lane] = 0;
+        player_.strength[lane] = 0;
+        player_.temporaryStrength[lane] = 0;
+        player_.weak[lane] = 0;
+        player_.vulnerable[lane] = 0;
+        player_.poison[lane] = 0;
+        energy_[lane] = content_.baseEnergy;
+
+        uint16_t* draw = &draw_[lane * deckSize_];
+        for (size_t i = 0; i < deckSize_; ++i) {
+            draw[i] = static_cast<uint16_t>(i);
+        }
+        drawCount_[lane] = static_cast<uint16_t>(deckSize_);
+        handCount_[lane] = 0;
+        discardCount_[lane] = 0;
+        rejectedCount_[lane] = 0;
+        shuffleRng_[lane].shuffle(draw, draw + deckSize_);
+        drawCards(lane, content_.handSize);
+        runStartProgram(lane);
+
+        for (size_t e = 0; e < enemies_.size(); ++e) {
+            const LaneEnemy& source = content_.enemies[e];
+            LaneFields& enemy = enemies_[e];
+            enemy.health[lane] = source.health;
+            enemy.block[lane] = source.block;
+            enemy.strength[lane] = source.statuses[static_cast<size_t>(LaneStatus::STRENGTH)];
+            enemy.temporaryStrength[lane] = source.statuses[static_cast<size_t>(LaneStatus::TEMPORARY_STRENGTH)];
+            enemy.weak[lane] = source.statuses[static_cast<size_t>(LaneStatus::WEAK)];
+            enemy.vulnerable[lane] = source.statuses[static_cast<size_t>(LaneStatus::VULNERABLE)];
+            enemy.poison[lane] = source.statuses[static_cast<size_t>(LaneStatus::POISON)];
+            for (const LaneRelicOp& effect : content_.startProgram) {
+                if (effect.op == RelicEffectOp::STATUS_ALL_ENEMIES) {
+                    addStatus(enemy, effect.status, lane, effect.value);
+                }
+            }
+            chooseMove(e, lane);
+        }
+        turn_[lane] = 1;
+        active_[lane] = 1;
+    }
+
+    // Relic::runEffects for COMBAT_START on the player; enemy statuses are added with the enemies
+    void runStartProgram(size_t lane) {
+        for (const LaneRelicOp& effect : content_.startProgram) {
+            switch (effect.op) {
+                case RelicEffectOp::HEAL:
+                    if (effect.value > 0) {
+                        player_.health[lane] = std::min(content_.maxHealth, player_.health[lane] + effect.value);
+                    }
+                    break;
+                case RelicEffectOp::DRAW:
+                    drawCards(lane, effect.value);
+                    break;
+                case RelicEffectOp::BLOCK:
+                    player_.block[lane] += std::max(effect.value, 0);
+                    break;
+                case RelicEffectOp::ENERGY:
+                    energy_[lane] = std::max(0, energy_[lane] + effect.value);
+                    break;
+                case RelicEffectOp::STATUS_SELF:
+                    addStatus(player_, effect.status, lane, effect.value);
+                    break;
+                case RelicEffectOp::STATUS_ALL_ENEMIES:
+                    break;
+            }
+        }
+    }
+
+    // Player::drawCards
+    void drawCards(size_t lane, int count) {
+        int room = content_.handSize - static_cast<int>(handCount_[lane]);
+        int target = std::min(count, room);
+        uint16_t* draw = &draw_[lane * deckSize_];
+        uint16_t* hand = &hand_[lane * deckSize_];
+        uint16_t* discard = &discard_[lane * deckSize_];
+        for (int drawn = 0; drawn < target; ++drawn) {
+            if (drawCount_[lane] == 0) {
+                if (discardCount_[lane] == 0) {
+                    break;
+                }
+                std::copy(discard, discard + discardCount_[lane], draw);
+                drawCount_[lane] = discardCount_[lane];
+                discardCount_[lane] = 0;
+                shuffleRng_[lane].shuffle(draw, draw + drawCount_[lane]);
+            }
+            hand[handCount_[lane]++] = draw[--drawCount_[lane]];
+        }
+    }
+
+    void removeFromHand(size_t lane, size_t index) {
+        uint16_t* hand = &hand_[lane * deckSize_];
+        std::copy(hand + index + 1, hand + handCount_[lane], hand + index);
+        --handCount_[lane];
+    }
+
+    // GreedyPolicy::chooseCombatAction plus the rejected-card rule of BatchRunner::runFight
+    bool chooseCard(size_t lane) {
+        int target = -1;
+        for (size_t e = 0; e < enemies_.size(); ++e) {
+            if (isEnemyAlive(e, lane) &&
+                (target < 0 || enemies_[e].health[lane] < enemies_[static_cast<size_t>(target)].health[lane])) {
+                target = static_cast<int>(e);
+            }
+        }
+
+        int best = -1;
+        int bestTarget = -1;
+        int32_t bestCost = -1;
+        const uint16_t* hand = &hand_[lane * deckSize_];
+        for (size_t i = 0; i < handCount_[lane]; ++i) {
+            const LaneCard& card = content_.cards[hand[i]];
+            bool needsTarget = card.target == CardTarget::SINGLE_ENEMY;
+            if (needsTarget && target < 0) {
+                continue;
+            }
+            bool targetValid = card.target == CardTarget::NONE || card.target == CardTarget::SELF ||
+                               card.target == CardTarget::ALL_ENEMIES || needsTarget;
+            if (card.cost > bestCost && energy_[lane] >= card.cost && targetValid) {
+                best = static_cast<int>(i);
+                bestTarget = needsTarget ? target : -1;
+                bestCost = card.cost;
+            }
+        }
+        if (best < 0) {
+            return false;
+        }
+
+        const uint16_t* rejected = &rejected_[lane * deckSize_];
+        if (std::find(rejected, rejected + rejectedCount_[lane], hand[best]) != rejected + rejectedCount_[lane]) {
+            return false;
+        }
+        playing_[lane] = best;
+        target_[lane] = bestTarget;
+        return true;
+    }
+
+    // Card::play for every lane playing a card, one program instruction at a time
+    void playCards() {
+        for (size_t lane = 0; lane < count_; ++lane) {
+            if (playing_[lane] >= 0) {
+                const LaneCard& card = content_.cards[hand_[lane * deckSize_ + playing_[lane]]];
+                energy_[lane] -= std::max(card.cost, 0);
+                success_[lane] = 1;
+            }
+        }
+
+        for (size_t op = 0; op < content_.maxCardOps; ++op) {
+            std::fill(damage_.begin(), damage_.end(), 0);
+            std::fill(amount_.begin(), amount_.end(), 0);
+            for (size_t lane = 0; lane < count_; ++lane) {
+                if (playing_[lane] < 0) {
+                    continue;
+                }
+                const LaneCard& card = content_.cards[hand_[lane * deckSize_ + playing_[lane]]];
+                if (op >= card.program.size()) {
+                    continue;
+                }
+                const LaneCardOp& effect = card.program[op];
+                int target = target_[lane];
+                switch (effect.op) {
+                    case CardEffectOp::NONE:
+                        break;
+                    case CardEffectOp::DAMAGE_TARGET:
+                        if (target >= 0) {
+                            damage_[at(static_cast<size_t>(target), lane)] = effect.value;
+                        } else {
+                            success_[lane] = 0;
+                        }
+                        break;
+                    case CardEffectOp::DAMAGE_ALL_ENEMIES:
+                        for (size_t e = 0; e < enemies_.size(); ++e) {
+                            if (isEnemyAlive(e, lane)) {
+                                damage_[at(e, lane)] = effect.value;
+                            }
+                        }
+                        break;
+                    case CardEffectOp::BLOCK:
+                        amount_[lane] = effect.value;
+                        break;
+                    case CardEffectOp::DRAW:
+                        drawCards(lane, effect.value);
+                        break;
+                    case CardEffectOp::STATUS_TARGET:
+                        if (target >= 0 && isEnemyAlive(static_cast<size_t>(target), lane)) {
+                            addStatus(enemies_[static_cast<size_t>(target)], effect.status, lane, effect.value);
+                        }
+                        break;
+                    case CardEffectOp::STATUS_ALL_ENEMIES:
+                        for (size_t e = 0; e < enemies_.size(); ++e) {
+                            if (isEnemyAlive(e, lane)) {
+                                addStatus(enemies_[e], effect.status, lane, effect.value);
+                            }
+                        }
+                        break;
+                    case CardEffectOp::STATUS_SELF:
+                        addStatus(player_, effect.status, lane, effect.value);
+                        break;
+                    case CardEffectOp::UNSUPPORTED:
+                        success_[lane] = 0;
+                        break;
+                }
+            }
+
+            for (size_t e = 0; e < enemies_.size(); ++e) {
+                applyDamage(&damage_[at(e, 0)], player_.weak.data(), enemies_[e], count_);
+            }
+            applyBlock(amount_.data(), player_.block.data(), count_);
+        }
+
+        for (size_t lane = 0; lane < count_; ++lane) {
+            if (playing_[lane] < 0) {
+                continue;
+            }
+            size_t index = static_cast<size_t>(playing_[lane]);
+            uint16_t card = hand_[lane * deckSize_ + index];
+            if (!success_[lane]) {
+                // The card stays in hand; choosing it again this turn ends the turn
+                rejected_[lane * deckSize_ + rejectedCount_[lane]++] = card;
+            } else {
+                removeFromHand(lane, index);
+                if (!content_.cards[card].exhausts) {
+                    discard_[lane * deckSize_ + discardCount_[lane]++] = card;
+                }
+            }
+        }
+    }
+
+    // Combat::endPlayerTurn for every lane in ending_
+    void endTurns() {
+        expireTemporaryStrength(ending_.data(), player_, count_);
+
+        for (size_t e = 0; e < enemies_.size(); ++e) {
+            LaneFields& enemy = enemies_[e];
+            const LaneEnemy& source = content_.enemies[e];
+            for (size_t lane = 0; lane < count_; ++lane) {
+                acting_[lane] = ending_[lane] != 0 && enemy.health[lane] > 0 ? 1 : 0;
+            }
+            tickPoison(acting_.data(), enemy, count_);
+
+            for (size_t op = 0; op < content_.maxMoveOps; ++op) {
+                std::fill(damage_.begin(), damage_.begin() + static_cast<std::ptrdiff_t>(count_), 0);
+                std::fill(amount_.begin(), amount_.end(), 0);
+                for (size_t lane = 0; lane < count_; ++lane) {
+                    int32_t move = moves_[at(e, lane)];
+                    if (!acting_[lane] || enemy.health[lane] <= 0 || move < 0) {
+                        continue;
+                    }
+                    const auto& program = source.moves[static_cast<size_t>(move)];
+                    if (op >= program.size()) {
+                        continue;
+                    }
+                    const LaneMoveOp& effect = program[op];
+                    switch (effect.op) {
+                        case MoveOp::ATTACK:
+                            damage_[lane] = effect.value;
+                            break;
+                        case MoveOp::BLOCK:
+                            amount_[lane] = effect.value;
+                            break;
+                        case MoveOp::STATUS_SELF:
+                            addStatus(enemy, effect.status, lane, effect.value);
+                            break;
+                        case MoveOp::STATUS_PLAYER:
+                            addStatus(player_, effect.status, lane, effect.value);
+                            break;
+                        case MoveOp::SUMMON:
+                            // Rejected by validate()
+                            break;
+                    }
+                }
+                applyDamage(damage_.data(), enemy.weak.data(), player_, count_);
+                applyBlock(amount_.data(), enemy.block.data(), count_);
+            }
+            expireTemporaryStrength(acting_.data(), enemy, count_);
+
+            // A defeated player ends the fight before the remaining enemies act
+            for (size_t lane = 0; lane < count_; ++lane) {
+                if (ending_[lane] && player_.health[lane] <= 0) {
+                    ending_[lane] = 0;
+                }
+            }
+        }
+
+        for (size_t lane = 0; lane < count_; ++lane) {
+            if (!ending_[lane]) {
+                continue;
+            }
+            player_.block[lane] = 0;
+            for (size_t e = 0; e < enemies_.size(); ++e) {
+                if (isEnemyAlive(e, lane)) {
+                    chooseMove(e, lane);
+                }
+            }
+            if (areAllEnemiesDefeated(lane)) {
+                ending_[lane] = 0;
+                continue;
+            }
+
+            // Player::startTurn up to the poison tick
+            turn_[lane]++;
+            energy_[lane] = content_.baseEnergy;
+            drawCards(lane, content_.handSize);
+            rejectedCount_[lane] = 0;
+        }
+        tickPoison(ending_.data(), player_, count_);
+    }
+};
+
+} // namespace
+
+void LaneFields::resize(size_t lanes) {
+    for (auto* field : {&health, &block, &strength, &temporaryStrength, &weak, &vulnerable, &poison}) {
+        field->assign(lanes, 0);
+    }
+}
+
+LaneBatchRunner::LaneBatchRunner(Game& game, size_t threadCount, size_t laneCount)
+    : game_(game), threadCount_(util::WorkStealingScheduler(threadCount).getThreadCount()),
+      laneCount_(std::max<size_t>(laneCount, 1)) {
+}
+
+bool LaneBatchRunner::validate(const FightSpec& spec) const {
+    if (!validateFightSpec(game_, spec)) {
+        return false;
+    }
+    const CharacterData& character = game_.getAllCharacterData().at(spec.characterId);
+    for (const auto& id : spec.deck.empty() ? character.starting_deck : spec.deck) {
+        auto card = game_.getCardData(id);
+        if (card && !card->hasEffectProgram()) {
+            LOG_ERROR("lanes", "Card '" + id + "' has no effect program");
+            return false;
+        }
+    }
+    for (const auto& id : spec.relics.empty() ? character.starting_relics : spec.relics) {
+        auto relic = game_.getRelicData(id);
+        if (relic && relicActsInFight(*relic)) {
+            LOG_ERROR("lanes", "Relic '" + id + "' acts during the fight, which lanes cannot do");
+            return false;
+        }
+    }
+    for (const auto& id : spec.enemies) {
+        if (enemySummons(*game_.getEnemyData(id))) {
+            LOG_ERROR("lanes", "Enemy '" + id + "' summons, which lanes cannot do");
+            return false;
+        }
+    }
+    return true;
+}
+
+FightStats LaneBatchRunner::run(const FightSpec& spec, size_t fights, uint64_t seed) {
+    FightStats total;
+    LaneContent content;
+    if (fights == 0 || !validate(spec) || !compileContent(game_, spec, content)) {
+        return total;
+    }
+
+    util::WorkStealingScheduler scheduler(threadCount_);
+    std::vector<FightStats> perWorker(scheduler.getThreadCount());
+    std::vector<std::unique_ptr<LaneBatch>> batches(scheduler.getThreadCount());
+    const util::Rng root(seed);
+    size_t blocks = (fights + laneCount_ - 1) / laneCount_;
+    scheduler.run(blocks, 1, [&](size_t worker, size_t begin, size_t end) {
+        if (!batches[worker]) {
+            batches[worker] = std::make_unique<LaneBatch>(content, laneCount_);
+        }
+        std::vector<uint64_t> seeds(laneCount_);
+        std::vector<FightOutcome> outcomes(laneCount_);
+        for (size_t block = begin; block < end; ++block) {
+            size_t first = block * laneCount_;
+            size_t count = std::min(laneCount_, fights - first);
+            for (size_t i = 0; i < count; ++i) {
+                seeds[i] = root.split(first + i)();
+            }
+            batches[worker]->run(seeds.data(), count, outcomes.data());
+            for (size_t i = 0; i < count; ++i) {
+                perWorker[worker].add(outcomes[i]);
+            }
+        }
+    });
+
+    for (const auto& stats : perWorker) {
+        total.merge(stats);
+    }
+    return total;
+}
+
+std::vector<FightOutcome> LaneBatchRunner::runFights(const FightSpec& spec, const std::vector<uint64_t>& seeds) {
+    std::vector<FightOutcome> outcomes;
+    LaneContent content;
+    if (seeds.empty() || !validate(spec) || !compileContent(game_, spec, content)) {
+        return outcomes;
+    }
+
+    outcomes.resize(seeds.size());
+    LaneBatch batch(content, std::min(laneCount_, seeds.size()));
+    for (size_t first = 0; first < seeds.size(); first += laneCount_) {
+        size_t count = std::min(laneCount_, seeds.size() - first);
+        batch.run(seeds.data() + first, count, outcomes.data() + first);
+    }
+    return outcomes;
+}
+
+} // namespace sim
+} // namespace deckstiny
@@ -0,0 +1,460 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "sim/mcts_policy.h"
+#include "core/card.h"
+#include "core/combat.h"
+#include "core/combat_state.h"
+#include "core/enemy.h"
+#include "core/player.h"
+#include "util/logger.h"
+#include "util/trace.h"
+#include "util/work_stealing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace deckstiny {
+namespace sim {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @struct Edge
+ * @brief Action out of a decision node, followed by a chance node
+ */
+struct Edge {
+    CombatChoice action;                                ///< Card and target, or end of turn
+    uint64_t visits = 0;                                ///< Playouts through this action
+    double value = 0.0;                                 ///< Sum of playout values
+    bool pruned = false;                                ///< Whether playing the action failed
+    std::unordered_map<uint64_t, uint32_t> outcomes;    ///< Visible outcome hash to child node
+};
+
+/**
+ * @struct Node
+ * @brief Decision node: a player-turn state seen in at least one playout
+ */
+struct Node {
+    std::vector<Edge> edges;    ///< Distinct legal actions, filled on first visit
+    uint64_t visits = 0;        ///< Playouts through this node
+    bool expanded = false;      ///< Whether edges were enumerated
+};
+
+uint64_t mix(uint64_t hash, uint64_t value) {
+    uint64_t state = hash ^ value;
+    return util::splitMix64(state);
+}
+
+uint64_t hashCharacter(uint64_t hash, const CharacterState& character) {
+    hash = mix(hash, static_cast<uint32_t>(character.health));
+    hash = mix(hash, static_cast<uint32_t>(character.block));
+    hash = mix(hash, static_cast<uint32_t>(character.energy));
+    for (int32_t stacks : character.statusStacks) {
+        hash = mix(hash, static_cast<uint32_t>(stacks));
+    }
+    for (uint8_t i = 0; i < character.customCount; ++i) {
+        hash = mix(hash, (static_cast<uint64_t>(character.customSymbols[i]) << 32) |
+                         static_cast<uint32_t>(character.customStacks[i]));
+    }
+    return hash;
+}
+
+/**
+ * @brief Hash what the player can see of a state
+ *
+ * The draw pile order is hidden and left out, so states that differ only in
+ * the order of future draws share a node.
+ */
+uint64_t hashVisible(const CombatState& state) {
+    uint64_t hash = mix(0, static_cast<uint32_t>(state.turn));
+    hash = hashCharacter(hash, state.player);
+
+    size_t handOffset = state.pileSizes[static_cast<size_t>(CardPile::DRAW)];
+    for (size_t i = 0; i < state.pileSizes[static_cast<size_t>(CardPile::HAND)]; ++i) {
+        uint8_t slot = state.pileCards[handOffset + i];
+        const CardState& card = state.cards[slot];
+        hash = mix(hash, (static_cast<uint64_t>(slot) << 32) | (static_cast<uint64_t>(card.upgraded) << 24) |
+                         (static_cast<uint64_t>(static_cast<uint16_t>(card.combatCostModifier)) << 8));
+    }
+    for (uint16_t size : state.pileSizes) {
+        hash = mix(hash, size);
+    }
+    for (uint8_t i = 0; i < state.enemyCount; ++i) {
+        const EnemyState& enemy = state.enemies[i];
+        hash = hashCharacter(hash, enemy.character);
+        hash = mix(hash, (static_cast<uint64_t>(enemy.slot) << 16) | static_cast<uint16_t>(enemy.currentMove));
+    }
+    return hash;
+}
+
+/**
+ * @class Searcher
+ * @brief One root-parallel tree with its own copy of the combat
+ */
+class Searcher {
+public:
+    /**
+     * @brief Fork the combat for this tree
+     * @param combat Combat being decided
+     * @param player Player in that combat
+     * @param root Snapshot of the combat
+     * @param rng Generator of this tree's playouts
+     * @return True if the combat could be forked
+     */
+    bool initialize(Combat& combat, const Player& player, const CombatState& root, const util::Rng& rng) {
+        playerEntity_ = player.clone();
+        player_ = static_cast<Player*>(playerEntity_.get());
+        player_->setShuffleRng(&shuffleRng_);
+        combat_ = combat.fork(*player_);
+        if (!combat_) {
+            return false;
+        }
+        combat_->setRng(&aiRng_);
+        root_ = root;
+        rng_ = rng;
+        nodes_.emplace_back();
+        return true;
+    }
+
+    /**
+     * @brief Run playouts until the budget is spent
+     * @param options Budget and tuning
+     * @param deadline Time to stop at, used if the options set a time budget
+     */
+    void search(const MctsOptions& options, Clock::time_point deadline) {
+        exploration_ = options.exploration;
+        lastTurn_ = root_.turn + options.rolloutTurns;
+        for (size_t i = 0; options.iterations == 0 || i < options.iterations; ++i) {
+            if (options.timeBudgetMs > 0.0 && Clock::now() >= deadline) {
+                break;
+            }
+            if (playout()) {
+                playouts_++;
+            }
+        }
+    }
+
+    /**
+     * @brief Get the actions at the root
+     * @return Root edges
+     */
+    const std::vector<Edge>& getRootEdges() const { return nodes_.front().edges; }
+
+    /**
+     * @brief Get the number of completed playouts
+     * @return Playout count
+     */
+    uint64_t getPlayouts() const { return playouts_; }
+
+private:
+    bool isRunning() const {
+        return !combat_->isCombatOver() && combat_->getTurn() <= lastTurn_;
+    }
+
+    void expand(uint32_t nodeIndex) {
+        std::vector<Edge> edges;
+        std::vector<std::tuple<std::string, bool, int, int>> seen;
+        const auto& hand = player_->getHand();
+        for (size_t i = 0; i < hand.size(); ++i) {
+            Card* card = hand[i].get();
+            if (!card) {
+                continue;
+            }
+            for (size_t target = 0; target < (card->needsTarget() ? combat_->getEnemyCount() : 1); ++target) {
+                int targetIndex = card->needsTarget() ? static_cast<int>(target) : -1;
+                if (targetIndex >= 0 && !combat_->getEnemy(target)->isAlive()) {
+                    continue;
+                }
+                // Copies of the same card are the same action
+                auto key = std::make_tuple(card->getId(), card->isUpgraded(), card->getCost(), targetIndex);
+                if (std::find(seen.begin(), seen.end(), key) != seen.end() ||
+                    !card->canPlay(player_, targetIndex, combat_.get())) {
+                    continue;
+                }
+                seen.push_back(key);
+                edges.emplace_back();
+                edges.back().action.cardIndex = static_cast<int>(i);
+                edges.back().action.targetIndex = targetIndex;
+            }
+        }
+        edges.emplace_back();
+
+        Node& node = nodes_[nodeIndex];
+        node.edges = std::move(edges);
+        node.expanded = true;
+    }
+
+    size_t select(uint32_t nodeIndex) {
+        const Node& node = nodes_[nodeIndex];
+        std::vector<size_t> untried;
+        for (size_t i = 0; i < node.edges.size(); ++i) {
+            if (!node.edges[i].pruned && node.edges[i].visits == 0) {
+                untried.push_back(i);
+            }
+        }
+        if (!untried.empty()) {
+            return untried[rng_.index(untried.size())];
+        }
+
+        size_t best = node.edges.size() - 1;
+        double bestScore = -1.0;
+        double logVisits = std::log(static_cast<double>(std::max<uint64_t>(node.visits, 1)));
+        for (size_t i = 0; i < node.edges.size(); ++i) {
+            const Edge& edge = node.edges[i];
+            if (edge.pruned) {
+                continue;
+            }
+            double visits = static_cast<double>(edge.visits);
+            double score = edge.value / visits + exploration_ * std::sqrt(logVisits / visits);
+            if (score > bestScore) {
+                best = i;
+                bestScore = score;
+            }
+        }
+        return best;
+    }
+
+    bool apply(const CombatChoice& action) {
+        if (action.cardIndex < 0) {
+            combat_->endPlayerTurn();
+            return true;
+        }
+        if (action.cardIndex >= static_cast<int>(player_->getHand().size())) {
+            return false;
+        }
+        return combat_->playCard(action.cardIndex, action.targetIndex);
+    }
+
+    uint64_t observe() {
+        return combat_->snapshot(scratch_) ? hashVisible(scratch_) : 0;
+    }
+
+    bool playout() {
+        combat_->restore(root_);
+        // Every playout samples its own draw order and enemy moves
+        aiRng_ = rng_.split(rng_());
+        shuffleRng_ = rng_.split(rng_());
+
+        path_.clear();
+        uint32_t nodeIndex = 0;
+        while (isRunning()) {
+            if (!nodes_[nodeIndex].expanded) {
+                expand(nodeIndex);
+            }
+            size_t edgeIndex = select(nodeIndex);
+            CombatChoice action = nodes_[nodeIndex].edges[edgeIndex].action;
+            if (!apply(action)) {
+                // A card whose effects fail is never worth choosing; try again without it
+                nodes_[nodeIndex].edges[edgeIndex].pruned = true;
+                return false;
+            }
+            path_.emplace_back(nodeIndex, edgeIndex);
+            if (nodes_[nodeIndex].edges[edgeIndex].visits == 0) {
+                break;
+            }
+
+            uint64_t outcome = observe();
+            auto& outcomes = nodes_[nodeIndex].edges[edgeIndex].outcomes;
+            auto it = outcomes.find(outcome);
+            if (it == outcomes.end()) {
+                uint32_t child = static_cast<uint32_t>(nodes_.size());
+                outcomes.emplace(outcome, child);
+                nodes_.emplace_back();
+                break;
+            }
+            nodeIndex = it->second;
+        }
+
+        double value = rollout();
+        for (const auto& step : path_) {
+            Node& node = nodes_[step.first];
+            Edge& edge = node.edges[step.second];
+            node.visits++;
+            edge.visits++;
+            edge.value += value;
+        }
+        return true;
+    }
+
+    double rollout() {
+        // Uniformly random legal cards until nothing is playable, then end the turn
+        std::vector<CombatChoice> playable;
+        std::vector<const Card*> rejected;
+        int rejectedTurn = combat_->getTurn();
+        while (isRunning()) {
+            if (combat_->getTurn() != rejectedTurn) {
+                rejected.clear();
+                rejectedTurn = combat_->getTurn();
+            }
+
+            playable.clear();
+            const auto& hand = player_->getHand();
+            for (size_t i = 0; i < hand.size(); ++i) {
+                Card* card = hand[i].get();
+                if (!card || std::find(rejected.begin(), rejected.end(), card) != rejected.end()) {
+                    continue;
+                }
+                int target = card->needsTarget() ? randomLivingEnemy() : -1;
+                if ((!card->needsTarget() || target >= 0) && card->canPlay(player_, target, combat_.get())) {
+                    playable.push_back(CombatChoice{static_cast<int>(i), target});
+                }
+            }
+            if (playable.empty()) {
+                combat_->endPlayerTurn();
+                continue;
+            }
+
+            const CombatChoice& choice = playable[rng_.index(playable.size())];
+            const Card* card = hand[choice.cardIndex].get();
+            if (!combat_->playCard(choice.cardIndex, choice.targetIndex)) {
+                rejected.push_back(card);
+            }
+        }
+        return evaluate();
+    }
+
+    int randomLivingEnemy() {
+        int chosen = -1;
+        size_t living = 0;
+        for (size_t i = 0; i < combat_->getEnemyCount(); ++i) {
+            Enemy* enemy = combat_->getEnemy(i);
+            if (enemy && enemy->isAlive() && rng_.index(++living) == 0) {
+                chosen = static_cast<int>(i);
+            }
+        }
+        return chosen;
+    }
+
+    double evaluate() const {
+        if (combat_->areAllEnemiesDefeated() && !combat_->isPlayerDefeated()) {
+            return 0.5 + 0.5 * static_cast<double>(player_->getHealth()) /
+                         static_cast<double>(std::max(player_->getMaxHealth(), 1));
+        }
+        // Lost or unfinished fights score by the share of enemy health removed
+        int health = 0;
+        int maxHealth = 0;
+        for (size_t i = 0; i < combat_->getEnemyCount(); ++i) {
+            Enemy* enemy = combat_->getEnemy(i);
+            health += std::max(enemy->getHealth(), 0);
+            maxHealth += enemy->getMaxHealth();
+        }
+        return maxHealth > 0 ? 0.25 * (1.0 - static_cast<double>(health) / maxHealth) : 0.0;
+    }
+
+    std::unique_ptr<Entity> playerEntity_;          ///< Owns the player copy
+    Player* player_ = nullptr;                      ///< Player copy
+    std::unique_ptr<Combat> combat_;                ///< Combat copy, playouts run here
+    util::Rng aiRng_;                               ///< Enemy stream of the copy
+    util::Rng shuffleRng_;                          ///< Shuffle stream of the copy
+    util::Rng rng_;                                 ///< Tree policy, rollouts and chance seeds
+    CombatState root_;                              ///< State every playout starts from
+    CombatState scratch_;                           ///< Snapshot buffer for outcome hashing
+    std::vector<Node> nodes_;                       ///< Tree, root first
+    std::vector<std::pair<uint32_t, size_t>> path_; ///< Node and edge of each step of a playout
+    double exploration_ = 0.0;                      ///< UCT exploration constant
+    int lastTurn_ = 0;                              ///< Last turn a playout may reach
+    uint64_t playouts_ = 0;                         ///< Completed playouts
+};
+
+} // namespace
+
+MctsPolicy::MctsPolicy(const MctsOptions& options, uint64_t seed, const std::string& characterId)
+    : GreedyPolicy(seed, characterId), options_(options), searchSeedRng_(seed), searchRng_(seed) {
+    if (options_.iterations == 0 && options_.timeBudgetMs <= 0.0) {
+        options_.iterations = MctsOptions().iterations;
+    }
+    options_.threads = util::WorkStealingScheduler(options_.threads).getThreadCount();
+}
+
+void MctsPolicy::beginRun(int runIndex) {
+    GreedyPolicy::beginRun(runIndex);
+    searchRng_ = searchSeedRng_.split(static_cast<uint64_t>(runIndex));
+}
+
+CombatChoice MctsPolicy::chooseCombatAction(Combat& combat, Player& player) {
+    lastStats_ = MctsStats();
+    CombatChoice fallback = GreedyPolicy::chooseCombatAction(combat, player);
+    if (fallback.cardIndex < 0) {
+        // Nothing is playable, so ending the turn is the only choice
+        return fallback;
+    }
+
+    // Forks and playouts are speculative, so only the chosen action reaches the trace
+    util::TraceSuspension noTrace;
+    auto start = Clock::now();
+    CombatState root;
+    if (!combat.snapshot(root)) {
+        LOG_DEBUG("mcts", "Combat cannot be snapshotted, using the greedy choice");
+        return fallback;
+    }
+
+    // Forks are made here: snapshotting reads and registers cards of the shared combat
+    const util::Rng decisionRng(searchRng_());
+    std::vector<std::unique_ptr<Searcher>> searchers;
+    for (size_t i = 0; i < options_.threads; ++i) {
+        searchers.push_back(std::make_unique<Searcher>());
+        if (!searchers.back()->initialize(combat, player, root, decisionRng.split(i))) {
+            LOG_DEBUG("mcts", "Combat cannot be forked, using the greedy choice");
+            return fallback;
+        }
+    }
+
+    auto deadline = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(options_.timeBudgetMs));
+    util::WorkStealingScheduler scheduler(options_.threads);
+    scheduler.run(searchers.size(), 1, [&](size_t, size_t begin, size_t end) {
+        util::TraceSuspension workerNoTrace;
+        for (size_t i = begin; i < end; ++i) {
+            searchers[i]->search(options_, deadline);
+        }
+    });
+
+    // Root parallelism: sum each action's visits over the independent trees
+    std::map<std::pair<int, int>, std::pair<uint64_t, double>> totals;
+    for (const auto& searcher : searchers) {
+        lastStats_.playouts += searcher->getPlayouts();
+        for (const Edge& edge : searcher->getRootEdges()) {
+            if (!edge.pruned && edge.visits > 0) {
+                auto& total = totals[{edge.action.cardIndex, edge.action.targetIndex}];
+                total.first += edge.visits;
+                total.second += edge.value;
+            }
+        }
+    }
+
+    CombatChoice best = fallback;
+    uint64_t bestVisits = 0;
+    double bestValue = 0.0;
+    for (const auto& entry : totals) {
+        uint64_t visits = entry.second.first;
+        double value = entry.second.second / static_cast<double>(visits);
+        if (visits > bestVisits || (visits == bestVisits && value > bestValue)) {
+            best.cardIndex = entry.first.first;
+            best.targetIndex = entry.first.second;
+            bestVisits = visits;
+            bestValue = value;
+        }
+    }
+
+    lastStats_.decisions = 1;
+    lastStats_.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    totalStats_.playouts += lastStats_.playouts;
+    totalStats_.decisions += lastStats_.decisions;
+    totalStats_.seconds += lastStats_.seconds;
+    LOG_DEBUG("mcts", "Chose card " + std::to_string(best.cardIndex) + " target " + std::to_string(best.targetIndex) +
+              " after " + std::to_string(lastStats_.playouts) + " playouts");
+    return best;
+}
+
+} // namespace sim
+} // namespace deckstiny
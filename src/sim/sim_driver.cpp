@@ -0,0 +1,197 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "sim/sim_driver.h"
+#include "core/combat.h"
+#include "core/event.h"
+#include "core/game.h"
+#include "core/map.h"
+#include "core/player.h"
+#include "util/logger.h"
+#include "util/rng.h"
+
+#include <algorithm>
+
+namespace deckstiny {
+namespace sim {
+
+SimDriver::SimDriver(const SimOptions& options)
+    : options_(options) {
+}
+
+SimDriver::~SimDriver() = default;
+
+bool SimDriver::initialize() {
+    ui_ = std::make_shared<HeadlessUI>();
+    game_ = std::make_unique<Game>();
+    if (!game_->initialize(ui_)) {
+        LOG_ERROR("sim", "Failed to initialize game for headless runs");
+        game_.reset();
+        return false;
+    }
+    game_->start();
+    return true;
+}
+
+RunResult SimDriver::runOnce(BotPolicy& policy, int runIndex) {
+    RunResult result;
+    if (!game_) {
+        result.stalled = true;
+        return result;
+    }
+
+    ui_->reset();
+    rejectedCards_.clear();
+    rejectedTurn_ = -1;
+    lastPlayedCard_ = nullptr;
+    policy.beginRun(runIndex);
+    result.seed = util::Rng(options_.seed).split(static_cast<uint64_t>(runIndex))();
+    game_->setSeed(result.seed);
+    ui_->setPromptHandler([this, &policy](const std::string&) {
+        const auto& cards = ui_->getLastCards();
+        if (cards.empty()) {
+            return std::string("cancel");
+        }
+        size_t choice = policy.chooseCardToUpgrade(cards);
+        return choice < cards.size() ? std::to_string(choice + 1) : std::string("cancel");
+    });
+
+    // Main menu -> new game -> character selection, in the menu's own order
+    game_->setState(GameState::MAIN_MENU);
+    game_->processInput("1");
+    result.steps++;
+
+    std::vector<std::string> characterIds;
+    for (const auto& [id, data] : game_->getAllCharacterData()) {
+        characterIds.push_back(id);
+    }
+    if (!characterIds.empty()) {
+        size_t choice = std::min(policy.chooseCharacter(characterIds), characterIds.size() - 1);
+        result.characterId = characterIds[choice];
+        game_->processInput(std::to_string(choice + 1));
+        result.steps++;
+    }
+
+    if (game_->getState() != GameState::MAP) {
+        LOG_ERROR("sim", "Run " + std::to_string(runIndex) + " could not start a new game");
+        result.stalled = true;
+    } else {
+        while (result.steps < options_.maxSteps) {
+            std::string input = nextInput(policy, result);
+            if (input.empty()) {
+                break;
+            }
+            game_->processInput(input);
+            result.steps++;
+        }
+        if (result.steps >= options_.maxSteps && !result.victory && !ui_->isGameOver()) {
+            LOG_WARNING("sim", "Run " + std::to_string(runIndex) + " abandoned after " + std::to_string(result.steps) + " inputs");
+            result.stalled = true;
+        }
+    }
+
+    if (const GameMap* map = game_->getMap()) {
+        result.act = map->getAct();
+        if (const Room* room = map->getCurrentRoom()) {
+            result.floor = room->y;
+        }
+    }
+    if (const Player* player = game_->getPlayer()) {
+        result.health = player->getHealth();
+        result.gold = player->getGold();
+        result.deckSize = static_cast<int>(player->getDrawPile().size() + player->getDiscardPile().size() +
+                                           player->getHand().size());
+    }
+    result.combatsWon = ui_->getRewardCount();
+    result.score = game_->calculateScore();
+
+    ui_->setPromptHandler(nullptr);
+    return result;
+}
+
+std::string SimDriver::nextInput(BotPolicy& policy, RunResult& result) {
+    Player* player = game_->getPlayer();
+
+    switch (game_->getState()) {
+        case GameState::MAP: {
+            GameMap* map = game_->getMap();
+            if (!map || !player) {
+                result.stalled = true;
+                return "";
+            }
+            if (map->getAct() > options_.maxActs) {
+                result.victory = true;
+                return "";
+            }
+            std::vector<int> rooms = map->getAvailableRooms();
+            if (rooms.empty()) {
+                LOG_WARNING("sim", "No rooms available on floor " + std::to_string(map->getCurrentRoom() ? map->getCurrentRoom()->y : -1));
+                result.stalled = true;
+                return "";
+            }
+            size_t choice = std::min(policy.chooseRoom(*map, *player, rooms), rooms.size() - 1);
+            return std::to_string(choice + 1);
+        }
+        case GameState::COMBAT: {
+            Combat* combat = game_->getCurrentCombat();
+            if (!combat || !player || combat->isCombatOver()) {
+                // The game resolves a finished combat on the next input it receives
+                return "end";
+            }
+            CombatChoice choice = policy.chooseCombatAction(*combat, *player);
+            const auto& hand = player->getHand();
+            if (choice.cardIndex < 0 || choice.cardIndex >= static_cast<int>(hand.size())) {
+                return "end";
+            }
+
+            // A card whose effects fail stays in hand; end the turn instead of retrying it forever
+            if (combat->getTurn() != rejectedTurn_) {
+                rejectedCards_.clear();
+                rejectedTurn_ = combat->getTurn();
+            }
+            const Card* card = hand[choice.cardIndex].get();
+            if (card == lastPlayedCard_ && hand.size() == lastHandSize_) {
+                rejectedCards_.push_back(card);
+            }
+            if (std::find(rejectedCards_.begin(), rejectedCards_.end(), card) != rejectedCards_.end()) {
+                lastPlayedCard_ = nullptr;
+                return "end";
+            }
+            lastPlayedCard_ = card;
+            lastHandSize_ = hand.size();
+
+            std::string input = std::to_string(choice.cardIndex + 1);
+            if (choice.targetIndex >= 0) {
+                input += " " + std::to_string(choice.targetIndex + 1);
+            }
+            return input;
+        }
+        case GameState::EVENT: {
+            const Event* event = ui_->getCurrentEvent();
+            if (!event || !player || event->getAllChoices().empty()) {
+                // Any input makes the game leave an event it cannot show
+                return "1";
+            }
+            size_t choice = std::min(policy.chooseEventOption(*event, *player), event->getAllChoices().size() - 1);
+            return std::to_string(choice + 1);
+        }
+        case GameState::SHOP: {
+            int choice = policy.chooseShopPurchase(ui_->getShopCards(), ui_->getShopCardPrices(), ui_->getShopGold());
+            if (choice < 0 || choice >= static_cast<int>(ui_->getShopCards().size())) {
+                return "leave";
+            }
+            return "c" + std::to_string(choice + 1);
+        }
+        case GameState::REWARD:
+            return "continue";
+        case GameState::GAME_OVER:
+            return "";
+        default:
+            LOG_WARNING("sim", "Headless run stopped in unexpected state " + std::to_string(static_cast<int>(game_->getState())));
+            result.stalled = true;
+            return "";
+    }
+}
+
+} // namespace sim
+} // namespace deckstiny
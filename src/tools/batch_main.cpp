@@ -0,0 +1,167 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "sim/batch_runner.h"
+#include "sim/lane_batch_runner.h"
+#include "sim/sim_driver.h"
+#include "util/logger.h"
+#include "util/metrics.h"
+#include "util/trace.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace deckstiny;
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " --enemies ID[,ID...] [--character ID] [--deck ID[,ID...]]"
+              << " [--relics ID[,ID...]] [--fights N] [--threads N] [--seed S] [--max-turns N] [--lanes N] [--log] [--trace FILE]"
+              << " [--metrics FILE] [--metrics-interval SECONDS]"
+              << std::endl;
+}
+
+std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+void printHistogram(const std::string& title, const std::vector<uint64_t>& histogram, uint64_t total) {
+    std::cout << title << ":\n";
+    for (size_t value = 0; value < histogram.size(); ++value) {
+        if (histogram[value] == 0) {
+            continue;
+        }
+        double share = total > 0 ? 100.0 * static_cast<double>(histogram[value]) / static_cast<double>(total) : 0.0;
+        std::cout << "  " << std::setw(4) << value << "  " << std::setw(10) << histogram[value] << "  "
+                  << std::fixed << std::setprecision(2) << std::setw(6) << share << "%  "
+                  << std::string(static_cast<size_t>(share / 2.0), '#') << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    sim::FightSpec spec;
+    spec.characterId = "ironclad";
+    size_t fights = 10000;
+    size_t threads = 0;
+    size_t lanes = 0;
+    uint64_t seed = 1;
+    bool logging = false;
+    std::string tracePath;
+    std::string metricsPath;
+    std::chrono::milliseconds metricsInterval(10000);
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        try {
+            if (arg == "--character" && hasValue) {
+                spec.characterId = argv[++i];
+            } else if (arg == "--enemies" && hasValue) {
+                spec.enemies = splitList(argv[++i]);
+            } else if (arg == "--deck" && hasValue) {
+                spec.deck = splitList(argv[++i]);
+            } else if (arg == "--relics" && hasValue) {
+                spec.relics = splitList(argv[++i]);
+            } else if (arg == "--fights" && hasValue) {
+                fights = std::stoull(argv[++i]);
+            } else if (arg == "--threads" && hasValue) {
+                threads = std::stoull(argv[++i]);
+            } else if (arg == "--seed" && hasValue) {
+                seed = std::stoull(argv[++i]);
+            } else if (arg == "--max-turns" && hasValue) {
+                spec.maxTurns = std::stoi(argv[++i]);
+            } else if (arg == "--lanes" && hasValue) {
+                lanes = std::stoull(argv[++i]);
+            } else if (arg == "--log") {
+                logging = true;
+            } else if (arg == "--trace" && hasValue) {
+                tracePath = argv[++i];
+            } else if (arg == "--metrics" && hasValue) {
+                metricsPath = argv[++i];
+            } else if (arg == "--metrics-interval" && hasValue) {
+                if (!util::MetricsExporter::parseInterval(argv[++i], metricsInterval)) {
+                    printUsage(argv[0]);
+                    return 2;
+                }
+            } else {
+                printUsage(argv[0]);
+                return 2;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << std::endl;
+            return 2;
+        }
+    }
+    if (spec.enemies.empty()) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    // Logging is off unless asked for; content errors below are reported on stderr instead
+    util::Logger::getInstance().setEnabled(logging);
+
+    sim::SimDriver driver;
+    if (!driver.initialize()) {
+        std::cerr << "Failed to initialize game" << std::endl;
+        return 1;
+    }
+
+    sim::BatchRunner runner(*driver.getGame(), threads);
+    sim::LaneBatchRunner laneRunner(*driver.getGame(), threads, lanes);
+    if (lanes > 0 ? !laneRunner.validate(spec) : !runner.validate(spec)) {
+        std::cerr << "Fight refers to unknown content or content the lane engine cannot play"
+                  << " (run with --log for details)" << std::endl;
+        return 1;
+    }
+
+    // The lane engine does not go through Combat, so only scalar fights are traced
+    if (!tracePath.empty()) {
+        if (lanes > 0) {
+            std::cerr << "--trace records nothing with --lanes" << std::endl;
+        }
+        if (!util::Trace::open(tracePath)) {
+            std::cerr << "Failed to open trace file " << tracePath << std::endl;
+            return 1;
+        }
+    }
+
+    util::MetricsExporter metrics;
+    if (!metricsPath.empty() && !metrics.start(metricsPath, metricsInterval)) {
+        std::cerr << "Failed to write metrics file " << metricsPath << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    sim::FightStats stats = lanes > 0 ? laneRunner.run(spec, fights, seed) : runner.run(spec, fights, seed);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    util::Trace::close();
+
+    std::cout << stats.getFights() << " fights on " << runner.getThreadCount() << " threads";
+    if (lanes > 0) {
+        std::cout << " (" << laneRunner.getLaneCount() << " lanes per block)";
+    }
+    std::cout << " in " << seconds << " s, " << (seconds > 0.0 ? stats.getFights() / seconds : 0.0) << " fights/s\n";
+    std::cout << std::fixed << std::setprecision(2)
+              << "win rate " << 100.0 * stats.getWinRate() << "% (" << stats.getWins() << " wins), "
+              << "mean turns to kill " << stats.getMeanTurnsToKill() << ", "
+              << "mean HP lost " << stats.getMeanHpLost() << "\n";
+    printHistogram("Turns to kill (won fights)", stats.getTurnsToKill(), stats.getWins());
+    printHistogram("HP lost (all fights)", stats.getHpLost(), stats.getFights());
+    return 0;
+}
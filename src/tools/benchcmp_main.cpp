@@ -0,0 +1,236 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "util/bench_compare.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using namespace deckstiny;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/// Exit status when a benchmark regressed
+constexpr int EXIT_REGRESSION = 1;
+/// Exit status for bad arguments and unreadable files
+constexpr int EXIT_ERROR = 2;
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " save NAME RESULTS.json [--dir DIR]\n"
+              << "       " << program << " compare BASELINE RESULTS.json [--dir DIR] [--threshold PERCENT]"
+              << " [--noise FACTOR] [--cpu] [--filter TEXT]\n"
+              << "       " << program << " list [--dir DIR]\n"
+              << "BASELINE is a saved baseline name or a results file" << std::endl;
+}
+
+/// Baseline names become file names, so keep them to a safe set of characters
+bool isValidName(const std::string& name) {
+    if (name.empty() || name[0] == '.') {
+        return false;
+    }
+    for (char c : name) {
+        bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                       c == '_' || c == '-' || c == '.';
+        if (!allowed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Parse a finite, non-negative number; false for garbage such as "5%x" or "abc"
+bool parseNonNegative(const char* text, double& value) {
+    char* end = nullptr;
+    double parsed = std::strtod(text, &end);
+    if (end == text || *end != '\0' || !std::isfinite(parsed) || parsed < 0.0) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+fs::path baselinePath(const std::string& directory, const std::string& name) {
+    return fs::path(directory) / (name + ".json");
+}
+
+/// Time with a unit that keeps three to four significant digits
+std::string formatTime(double nanoseconds) {
+    static const char* UNITS[] = {"ns", "us", "ms", "s"};
+    size_t unit = 0;
+    while (unit + 1 < sizeof(UNITS) / sizeof(UNITS[0]) && nanoseconds >= 10000.0) {
+        nanoseconds /= 1000.0;
+        ++unit;
+    }
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.1f %s", nanoseconds, UNITS[unit]);
+    return text;
+}
+
+std::string formatAllocations(double before, double after) {
+    if (before < 0.0 && after < 0.0) {
+        return "";
+    }
+    char text[64];
+    std::snprintf(text, sizeof(text), "allocs %g -> %g", before < 0.0 ? 0.0 : before, after < 0.0 ? 0.0 : after);
+    return text;
+}
+
+int saveBaseline(const std::string& directory, const std::string& name, const std::string& resultsPath) {
+    if (!isValidName(name)) {
+        std::cerr << "Invalid baseline name '" << name << "': use letters, digits, '_', '-' and '.'" << std::endl;
+        return EXIT_ERROR;
+    }
+    util::BenchmarkResults results;
+    if (!results.load(resultsPath)) {
+        std::cerr << results.getError() << std::endl;
+        return EXIT_ERROR;
+    }
+
+    std::error_code error;
+    fs::create_directories(directory, error);
+    fs::path target = baselinePath(directory, name);
+    if (error || !fs::copy_file(resultsPath, target, fs::copy_options::overwrite_existing, error)) {
+        std::cerr << "Cannot write " << target.string() << ": " << error.message() << std::endl;
+        return EXIT_ERROR;
+    }
+    std::cout << "Saved " << results.getBenchmarks().size() << " benchmarks as baseline '" << name << "' ("
+              << target.string() << ")" << std::endl;
+    return 0;
+}
+
+int listBaselines(const std::string& directory) {
+    std::error_code error;
+    std::vector<std::string> names;
+    for (const auto& entry : fs::directory_iterator(directory, error)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".json") {
+            names.push_back(entry.path().stem().string());
+        }
+    }
+    std::sort(names.begin(), names.end());
+    for (const auto& name : names) {
+        std::cout << name << '\n';
+    }
+    return 0;
+}
+
+int compareToBaseline(const std::string& directory, const std::string& baseline, const std::string& resultsPath,
+                      const util::BenchmarkCompareOptions& options, bool cpuTime, const std::string& filter) {
+    // A saved name takes precedence; anything else is read as a results file
+    fs::path baselineFile = baseline;
+    if (isValidName(baseline) && fs::exists(baselinePath(directory, baseline))) {
+        baselineFile = baselinePath(directory, baseline);
+    }
+
+    util::BenchmarkResults before;
+    util::BenchmarkResults after;
+    if (!before.load(baselineFile.string(), cpuTime)) {
+        std::cerr << "Baseline: " << before.getError() << std::endl;
+        return EXIT_ERROR;
+    }
+    if (!after.load(resultsPath, cpuTime)) {
+        std::cerr << after.getError() << std::endl;
+        return EXIT_ERROR;
+    }
+
+    int regressions = 0;
+    size_t fewestRepetitions = SIZE_MAX;
+    for (const auto& comparison : util::compareBenchmarks(before, after, options)) {
+        if (!filter.empty() && comparison.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        char line[256];
+        switch (comparison.verdict) {
+            case util::BenchmarkVerdict::ADDED:
+                std::snprintf(line, sizeof(line), "%-40s %12s %12s %8s %8s  added", comparison.name.c_str(), "-",
+                              formatTime(comparison.currentMedian).c_str(), "", "");
+                break;
+            case util::BenchmarkVerdict::REMOVED:
+                std::snprintf(line, sizeof(line), "%-40s %12s %12s %8s %8s  removed", comparison.name.c_str(),
+                              formatTime(comparison.baselineMedian).c_str(), "-", "", "");
+                break;
+            default:
+                std::snprintf(line, sizeof(line), "%-40s %12s %12s %+7.1f%% %7.1f%%  %-9s %s", comparison.name.c_str(),
+                              formatTime(comparison.baselineMedian).c_str(),
+                              formatTime(comparison.currentMedian).c_str(), comparison.change * 100.0,
+                              comparison.noise * 100.0, util::benchmarkVerdictName(comparison.verdict),
+                              formatAllocations(comparison.baselineAllocations, comparison.currentAllocations).c_str());
+                fewestRepetitions = std::min(fewestRepetitions, comparison.repetitions);
+                break;
+        }
+        std::cout << line << '\n';
+        if (comparison.verdict == util::BenchmarkVerdict::SLOWER) {
+            ++regressions;
+        }
+    }
+
+    if (fewestRepetitions < 3) {
+        std::cout << "\nNote: fewer than 3 repetitions, so noise is not estimated; "
+                  << "run with --benchmark_repetitions=5 or more" << std::endl;
+    }
+    if (regressions > 0) {
+        std::cout << '\n' << regressions << " benchmark(s) slower than " << baselineFile.string() << " by more than "
+                  << options.threshold * 100.0 << "% and the noise" << std::endl;
+        return EXIT_REGRESSION;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string directory = "bench_baselines";
+    std::string filter;
+    bool cpuTime = false;
+    util::BenchmarkCompareOptions options;
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--dir" && i + 1 < argc) {
+            directory = argv[++i];
+        } else if (arg == "--threshold" && i + 1 < argc) {
+            if (!parseNonNegative(argv[++i], options.threshold)) {
+                printUsage(argv[0]);
+                return EXIT_ERROR;
+            }
+            options.threshold /= 100.0;
+        } else if (arg == "--noise" && i + 1 < argc) {
+            if (!parseNonNegative(argv[++i], options.noiseFactor)) {
+                printUsage(argv[0]);
+                return EXIT_ERROR;
+            }
+        } else if (arg == "--cpu") {
+            cpuTime = true;
+        } else if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (!arg.empty() && arg[0] != '-') {
+            positional.push_back(arg);
+        } else {
+            printUsage(argv[0]);
+            return EXIT_ERROR;
+        }
+    }
+
+    const std::string command = positional.empty() ? "" : positional[0];
+    if (command == "save" && positional.size() == 3) {
+        return saveBaseline(directory, positional[1], positional[2]);
+    }
+    if (command == "compare" && positional.size() == 3) {
+        return compareToBaseline(directory, positional[1], positional[2], options, cpuTime, filter);
+    }
+    if (command == "list" && positional.size() == 1) {
+        return listBaselines(directory);
+    }
+    printUsage(argv[0]);
+    return EXIT_ERROR;
+}
@@ -0,0 +1,122 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "sim/batch_runner.h"
+#include "sim/mcts_policy.h"
+#include "sim/sim_driver.h"
+#include "util/logger.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace deckstiny;
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--enemies ID[,ID...]] [--character ID] [--deck ID[,ID...]]"
+              << " [--fights N] [--iterations N] [--time-ms MS] [--threads N] [--seed S] [--log]" << std::endl;
+}
+
+std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    sim::FightSpec spec;
+    spec.characterId = "ironclad";
+    spec.enemies = {"jaw_worm"};
+    sim::MctsOptions options;
+    size_t fights = 5;
+    uint64_t seed = 1;
+    bool logging = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        try {
+            if (arg == "--character" && hasValue) {
+                spec.characterId = argv[++i];
+            } else if (arg == "--enemies" && hasValue) {
+                spec.enemies = splitList(argv[++i]);
+            } else if (arg == "--deck" && hasValue) {
+                spec.deck = splitList(argv[++i]);
+            } else if (arg == "--fights" && hasValue) {
+                fights = std::stoull(argv[++i]);
+            } else if (arg == "--iterations" && hasValue) {
+                options.iterations = std::stoull(argv[++i]);
+            } else if (arg == "--time-ms" && hasValue) {
+                options.timeBudgetMs = std::stod(argv[++i]);
+            } else if (arg == "--threads" && hasValue) {
+                options.threads = std::stoull(argv[++i]);
+            } else if (arg == "--seed" && hasValue) {
+                seed = std::stoull(argv[++i]);
+            } else if (arg == "--log") {
+                logging = true;
+            } else {
+                printUsage(argv[0]);
+                return 2;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << std::endl;
+            return 2;
+        }
+    }
+
+    util::Logger::getInstance().setEnabled(logging);
+
+    sim::SimDriver driver;
+    if (!driver.initialize()) {
+        std::cerr << "Failed to initialize game" << std::endl;
+        return 1;
+    }
+
+    // Fights run one at a time so the search threads alone decide the core count
+    sim::BatchRunner runner(*driver.getGame(), 1);
+    if (!runner.validate(spec)) {
+        std::cerr << "Fight refers to unknown content (run with --log for details)" << std::endl;
+        return 1;
+    }
+    runner.setPolicyFactory([&](uint64_t batchSeed) {
+        return std::make_unique<sim::MctsPolicy>(options, batchSeed, spec.characterId);
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    sim::FightStats stats = runner.run(spec, fights, seed);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const auto& policies = runner.getPolicies();
+    auto* policy = policies.empty() ? nullptr : dynamic_cast<sim::MctsPolicy*>(policies.front().get());
+    if (!policy) {
+        std::cerr << "No fights were played" << std::endl;
+        return 1;
+    }
+
+    const sim::MctsStats& search = policy->getTotalStats();
+    size_t threads = policy->getOptions().threads;
+    double playoutsPerSecond = search.seconds > 0.0 ? static_cast<double>(search.playouts) / search.seconds : 0.0;
+    std::cout << stats.getFights() << " fights in " << seconds << " s, " << search.decisions << " decisions, "
+              << search.playouts << " playouts in " << search.seconds << " s of search\n";
+    std::cout << std::fixed << std::setprecision(0)
+              << playoutsPerSecond << " playouts/s on " << threads << " threads, "
+              << playoutsPerSecond / static_cast<double>(threads) << " playouts/s per thread\n";
+    std::cout << std::setprecision(2)
+              << "win rate " << 100.0 * stats.getWinRate() << "%, mean turns to kill " << stats.getMeanTurnsToKill()
+              << ", mean HP lost " << stats.getMeanHpLost() << std::endl;
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "util/content_pack.h"
+#include "util/logger.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace fs = std::filesystem;
+using namespace deckstiny;
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <data_dir> <output_pack>" << std::endl;
+        return 2;
+    }
+
+    util::Logger::getInstance().setConsoleEnabled(false);
+    util::Logger::getInstance().setFileEnabled(false);
+
+    const fs::path dataDir(argv[1]);
+    const std::string outputPath(argv[2]);
+
+    const util::ContentKind kinds[] = {
+        util::ContentKind::CHARACTER,
+        util::ContentKind::CARD,
+        util::ContentKind::ENEMY,
+        util::ContentKind::RELIC,
+        util::ContentKind::EVENT
+    };
+
+    util::ContentPackWriter writer;
+    int failed = 0;
+
+    for (util::ContentKind kind : kinds) {
+        fs::path dir = dataDir / util::contentKindDirectory(kind);
+        if (!fs::is_directory(dir)) {
+            std::cerr << "Missing content directory: " << dir.string() << std::endl;
+            return 1;
+        }
+
+        // Sorted so the pack is byte-identical for identical content
+        std::vector<fs::path> files;
+        for (const auto& entry : fs::directory_iterator(dir)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".json") {
+                files.push_back(entry.path());
+            }
+        }
+        std::sort(files.begin(), files.end());
+
+        for (const auto& path : files) {
+            std::ifstream file(path);
+            if (!file.is_open()) {
+                std::cerr << "Could not open " << path.string() << std::endl;
+                failed++;
+                continue;
+            }
+            try {
+                nlohmann::json document;
+                file >> document;
+                writer.addRecord(kind, path.stem().string(), document);
+            } catch (const nlohmann::json::exception& e) {
+                std::cerr << "JSON error in " << path.string() << ": " << e.what() << std::endl;
+                failed++;
+            }
+        }
+    }
+
+    if (failed > 0) {
+        std::cerr << failed << " content file(s) failed, pack not written" << std::endl;
+        return 1;
+    }
+
+    fs::path outputDir = fs::path(outputPath).parent_path();
+    if (!outputDir.empty()) {
+        std::error_code ec;
+        fs::create_directories(outputDir, ec);
+    }
+
+    if (!writer.writeToFile(outputPath)) {
+        std::cerr << "Failed to write " << outputPath << std::endl;
+        return 1;
+    }
+
+    std::cout << "Packed " << writer.getRecordCount() << " records (" << writer.getStringCount()
+              << " strings) into " << outputPath << std::endl;
+    return 0;
+}
@@ -0,0 +1,155 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "sim/bot_policy.h"
+#include "sim/mcts_policy.h"
+#include "sim/sim_driver.h"
+#include "util/logger.h"
+#include "util/metrics.h"
+#include "util/trace.h"
+#include "util/trace_spans.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace deckstiny;
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--runs N] [--seed S] [--character ID] [--acts N] [--max-steps N] [--policy greedy|mcts]"
+              << " [--iterations N] [--search-threads N] [--quiet] [--log] [--trace FILE]"
+              << " [--metrics FILE] [--metrics-interval SECONDS] [--spans FILE]"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int runs = 100;
+    std::string characterId;
+    bool quiet = false;
+    bool logging = false;
+    std::string tracePath;
+    std::string metricsPath;
+    std::string spansPath;
+    std::chrono::milliseconds metricsInterval(10000);
+    sim::SimOptions options;
+    std::string policyName = "greedy";
+    sim::MctsOptions mctsOptions;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        try {
+            if (arg == "--runs" && hasValue) {
+                runs = std::stoi(argv[++i]);
+            } else if (arg == "--seed" && hasValue) {
+                options.seed = std::stoull(argv[++i]);
+            } else if (arg == "--character" && hasValue) {
+                characterId = argv[++i];
+            } else if (arg == "--acts" && hasValue) {
+                options.maxActs = std::stoi(argv[++i]);
+            } else if (arg == "--max-steps" && hasValue) {
+                options.maxSteps = std::stoi(argv[++i]);
+            } else if (arg == "--policy" && hasValue) {
+                policyName = argv[++i];
+            } else if (arg == "--iterations" && hasValue) {
+                mctsOptions.iterations = std::stoull(argv[++i]);
+            } else if (arg == "--search-threads" && hasValue) {
+                mctsOptions.threads = std::stoull(argv[++i]);
+            } else if (arg == "--quiet") {
+                quiet = true;
+            } else if (arg == "--log") {
+                logging = true;
+            } else if (arg == "--trace" && hasValue) {
+                tracePath = argv[++i];
+            } else if (arg == "--metrics" && hasValue) {
+                metricsPath = argv[++i];
+            } else if (arg == "--metrics-interval" && hasValue) {
+                if (!util::MetricsExporter::parseInterval(argv[++i], metricsInterval)) {
+                    printUsage(argv[0]);
+                    return 2;
+                }
+            } else if (arg == "--spans" && hasValue) {
+                spansPath = argv[++i];
+            } else {
+                printUsage(argv[0]);
+                return 2;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << arg << std::endl;
+            return 2;
+        }
+    }
+
+    if (policyName != "greedy" && policyName != "mcts") {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    // Logging is formatted and written synchronously, so it is off unless asked for
+    util::Logger::getInstance().setEnabled(logging);
+    if (!tracePath.empty() && !util::Trace::open(tracePath)) {
+        std::cerr << "Failed to open trace file " << tracePath << std::endl;
+        return 1;
+    }
+    if (!spansPath.empty()) {
+        if (!DECKSTINY_TRACE_SPANS) {
+            std::cerr << "--spans needs a build with -DDECKSTINY_TRACE_SPANS=ON" << std::endl;
+        }
+        util::SpanTrace::start();
+    }
+    util::MetricsExporter metrics;
+    if (!metricsPath.empty() && !metrics.start(metricsPath, metricsInterval)) {
+        std::cerr << "Failed to write metrics file " << metricsPath << std::endl;
+        return 1;
+    }
+
+    sim::SimDriver driver(options);
+    if (!driver.initialize()) {
+        std::cerr << "Failed to initialize game" << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<sim::BotPolicy> policy;
+    if (policyName == "mcts") {
+        policy = std::make_unique<sim::MctsPolicy>(mctsOptions, options.seed, characterId);
+    } else {
+        policy = std::make_unique<sim::GreedyPolicy>(options.seed, characterId);
+    }
+    int victories = 0;
+    int stalled = 0;
+    long long totalSteps = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < runs; ++run) {
+        sim::RunResult result = driver.runOnce(*policy, run);
+        victories += result.victory ? 1 : 0;
+        stalled += result.stalled ? 1 : 0;
+        totalSteps += result.steps;
+
+        if (!quiet) {
+            std::cout << "run " << run << " seed " << result.seed << " " << result.characterId << ": "
+                      << (result.victory ? "victory" : (result.stalled ? "stalled" : "defeat"))
+                      << " act " << result.act << " floor " << result.floor
+                      << " combats " << result.combatsWon << " hp " << result.health
+                      << " gold " << result.gold << " deck " << result.deckSize
+                      << " score " << result.score << " steps " << result.steps << "\n";
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    util::Trace::close();
+    if (!spansPath.empty()) {
+        util::SpanTrace::stop(spansPath);
+    }
+
+    std::cout << runs << " runs (" << policy->getName() << ") in " << seconds << " s, "
+              << (seconds > 0.0 ? runs / seconds : 0.0) << " runs/s, "
+              << (seconds > 0.0 ? totalSteps / seconds : 0.0) << " inputs/s; "
+              << victories << " victories, " << stalled << " stalled" << std::endl;
+    return stalled == 0 ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "util/trace.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+using namespace deckstiny;
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " TRACE_FILE [--csv] [--event NAME]" << std::endl;
+}
+
+/**
+ * @struct EventFields
+ * @brief Names of the fields of one event type in text output
+ */
+struct EventFields {
+    const char* subject;    ///< Name of the subject, nullptr if unused
+    const char* object;     ///< Name of the object, nullptr if unused
+    const char* a;          ///< Name of the first value, nullptr if unused
+    const char* b;          ///< Name of the second value, nullptr if unused
+};
+
+/// Field names, in TraceEventType order
+constexpr EventFields EVENT_FIELDS[] = {
+    {"id", nullptr, nullptr, nullptr},
+    {"card", "target", "cost", "index"},
+    {"character", nullptr, "damage", "health_lost"},
+    {"character", "status", "stacks", "total"},
+    {"enemy", "move", "index", "value"},
+    {"from", "to", nullptr, nullptr}
+};
+
+static_assert(sizeof(EVENT_FIELDS) / sizeof(EVENT_FIELDS[0]) == static_cast<size_t>(util::TraceEventType::COUNT),
+              "every trace event needs field names");
+
+/// CSV field, quoted when it contains a separator or a quote
+std::string csvField(const std::string& text) {
+    if (text.find_first_of(",\"\n") == std::string::npos) {
+        return text;
+    }
+    std::string quoted = "\"";
+    for (char c : text) {
+        quoted += c;
+        if (c == '"') {
+            quoted += '"';
+        }
+    }
+    return quoted + "\"";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    std::string eventFilter;
+    bool csv = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--csv") {
+            csv = true;
+        } else if (arg == "--event" && i + 1 < argc) {
+            eventFilter = argv[++i];
+        } else if (path.empty() && !arg.empty() && arg[0] != '-') {
+            path = arg;
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (path.empty()) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    util::TraceReader reader;
+    if (!reader.open(path)) {
+        std::cerr << reader.getError() << std::endl;
+        return 1;
+    }
+
+    if (csv) {
+        std::cout << "time_ns,thread,event,subject,object,a,b\n";
+    }
+
+    util::TraceRecord record;
+    uint64_t count = 0;
+    char time[32];
+    while (reader.next(record)) {
+        util::TraceEventType type = static_cast<util::TraceEventType>(record.type);
+        const char* name = util::traceEventName(type);
+        if (!eventFilter.empty() && eventFilter != name) {
+            continue;
+        }
+        ++count;
+
+        const std::string& subject = reader.symbol(record.subject);
+        const std::string& object = reader.symbol(record.object);
+        if (csv) {
+            std::cout << record.time << ',' << record.thread << ',' << name << ',' << csvField(subject) << ','
+                      << csvField(object) << ',' << record.a << ',' << record.b << '\n';
+            continue;
+        }
+
+        std::snprintf(time, sizeof(time), "%.6f", static_cast<double>(record.time) / 1e9);
+        std::cout << time << " t" << record.thread << ' ' << name;
+        if (record.type < static_cast<uint16_t>(util::TraceEventType::COUNT)) {
+            const EventFields& fields = EVENT_FIELDS[record.type];
+            if (fields.subject) {
+                std::cout << ' ' << fields.subject << '=' << subject;
+            }
+            if (fields.object && !object.empty()) {
+                std::cout << ' ' << fields.object << '=' << object;
+            }
+            if (fields.a) {
+                std::cout << ' ' << fields.a << '=' << record.a;
+            }
+            if (fields.b) {
+                std::cout << ' ' << fields.b << '=' << record.b;
+            }
+        } else {
+            std::cout << ' ' << subject << ' ' << object << ' ' << record.a << ' ' << record.b;
+        }
+        std::cout << '\n';
+    }
+
+    if (!reader.getError().empty()) {
+        std::cerr << path << ": " << reader.getError() << " after " << count << " events" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -10,6 +10,8 @@
 #include "core/relic.h"
 #include "core/event.h"
 #include "util/logger.h"
+#include "util/metrics.h"
+#include "util/trace_spans.h"
 #include "util/path_util.h" 
 #include <SFML/Window/Event.hpp>
 #include <set>
@@ -428,6 +430,9 @@ void GraphicalUI::processEvent(const sf::Event& event) {
                 } else if (event.key.code == sf::Keyboard::E) {
                     LOG_DEBUG("graphical_ui_combat_input", "Sending 'end' input.");
                     if (inputCallback_) inputCallback_("end");
+                } else if (event.key.code == sf::Keyboard::U) {
+                    LOG_DEBUG("graphical_ui_combat_input", "Sending 'undo' input.");
+                    if (inputCallback_) inputCallback_("undo");
                 } else if (event.key.code == sf::Keyboard::Up) {
                     if (selectedIndex_ > 0) selectedIndex_--;
                     LOG_DEBUG("graphical_ui_combat_input", "Up arrow. new selectedIndex_: " + std::to_string(selectedIndex_));
@@ -1129,6 +1134,11 @@ void GraphicalUI::showShop(const std::vector<Card*>& cardsForSale,
 }
 
 void GraphicalUI::draw() {
+    TRACE_SCOPE("ui", "draw");
+    static util::Histogram& latency = util::MetricsRegistry::getInstance().histogram(
+        "deckstiny_ui_draw_seconds", "Time spent drawing a frame in GraphicalUI::draw");
+    util::ScopedLatency timer(latency);
+
     LOG_DEBUG("graphical_ui", "draw() called; screenType=" + std::to_string(static_cast<int>(screenType_)) + ", overlay=" + (isShowingRewardsOverlay_ ? "true" : "false"));
     window_.clear(sf::Color::Black);
     sf::Vector2u winSize = window_.getSize();
@@ -11,6 +11,7 @@
 #include "core/map.h"
 #include "core/event.h"
 #include "util/logger.h"
+#include "util/trace_spans.h"
 
 #include <iostream>
 #include <iomanip>
@@ -147,6 +148,7 @@ void TextUI::showMap(int currentRoomId,
 }
 
 void TextUI::showCombat(const Combat* combat) {
+    TRACE_SCOPE("ui", "show_combat");
     if (isTestingMode()) return;
     if (!combat) {
         return;
@@ -191,6 +193,7 @@ void TextUI::showCombat(const Combat* combat) {
         std::cout << "Available Actions: " << std::endl;
         std::cout << "  Type a card number (1-" << player->getHand().size() << ") to play that card" << std::endl;
         std::cout << "  Type 'end' to end your turn" << std::endl;
+        std::cout << "  Type 'undo' to take back the last card played this turn" << std::endl;
         std::cout << "  Type 'help' for more information" << std::endl;
     } else {
         std::cout << "Enemies are taking their turns..." << std::endl;
@@ -0,0 +1,225 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "util/bench_compare.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <utility>
+
+namespace deckstiny {
+namespace util {
+
+namespace {
+
+/// Scales a MAD to the standard deviation of normally distributed values
+constexpr double MAD_TO_SIGMA = 1.4826;
+
+/// Nanoseconds per unit of a time_unit field, 0 for unknown units
+double nanosecondsPer(const std::string& unit) {
+    if (unit == "ns") return 1.0;
+    if (unit == "us") return 1e3;
+    if (unit == "ms") return 1e6;
+    if (unit == "s") return 1e9;
+    return 0.0;
+}
+
+/// Replace the NaN and Infinity tokens Google Benchmark writes for empty aggregates with null,
+/// which strict JSON parsers accept
+std::string replaceNonFiniteNumbers(const std::string& text) {
+    static const std::string TOKENS[] = {"-Infinity", "Infinity", "NaN"};
+    std::string result;
+    result.reserve(text.size());
+    bool inString = false;
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (inString) {
+            result += c;
+            if (c == '\\' && i + 1 < text.size()) {
+                result += text[++i];
+            } else if (c == '"') {
+                inString = false;
+            }
+            continue;
+        }
+        if (c == '"') {
+            inString = true;
+        } else {
+            bool replaced = false;
+            for (const std::string& token : TOKENS) {
+                if (text.compare(i, token.size(), token) == 0) {
+                    result += "null";
+                    i += token.size() - 1;
+                    replaced = true;
+                    break;
+                }
+            }
+            if (replaced) {
+                continue;
+            }
+        }
+        result += c;
+    }
+    return result;
+}
+
+} // namespace
+
+bool BenchmarkResults::load(const std::string& path, bool cpuTime) {
+    benchmarks_.clear();
+    error_.clear();
+
+    std::ifstream in(path);
+    if (!in) {
+        error_ = "Cannot open " + path;
+        return false;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    nlohmann::json document = nlohmann::json::parse(replaceNonFiniteNumbers(text.str()), nullptr, false);
+    if (document.is_discarded() || !document.is_object() || !document.contains("benchmarks") ||
+        !document["benchmarks"].is_array()) {
+        error_ = path + " is not Google Benchmark JSON output";
+        return false;
+    }
+
+    const char* timeField = cpuTime ? "cpu_time" : "real_time";
+    for (const auto& entry : document["benchmarks"]) {
+        if (!entry.is_object() || entry.value("run_type", "iteration") != "iteration" ||
+            entry.value("error_occurred", false) || !entry.contains(timeField) || !entry[timeField].is_number()) {
+            continue;
+        }
+        double scale = nanosecondsPer(entry.value("time_unit", "ns"));
+        if (scale == 0.0) {
+            error_ = path + ": unknown time unit in " + entry.value("name", "");
+            return false;
+        }
+
+        // run_name is the name without repetition suffixes; older versions only write name
+        std::string name = entry.value("run_name", entry.value("name", ""));
+        BenchmarkSamples& samples = benchmarks_[name];
+        samples.times.push_back(entry[timeField].get<double>() * scale);
+        if (entry.contains("allocs/op") && entry["allocs/op"].is_number()) {
+            samples.allocations.push_back(entry["allocs/op"].get<double>());
+        }
+    }
+
+    if (benchmarks_.empty()) {
+        error_ = path + " holds no benchmark results";
+        return false;
+    }
+    return true;
+}
+
+const char* benchmarkVerdictName(BenchmarkVerdict verdict) {
+    switch (verdict) {
+        case BenchmarkVerdict::UNCHANGED: return "unchanged";
+        case BenchmarkVerdict::FASTER: return "faster";
+        case BenchmarkVerdict::SLOWER: return "slower";
+        case BenchmarkVerdict::NOISY: return "noisy";
+        case BenchmarkVerdict::ADDED: return "added";
+        case BenchmarkVerdict::REMOVED: return "removed";
+    }
+    return "unknown";
+}
+
+double median(std::vector<double> values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t middle = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + middle, values.end());
+    double upper = values[middle];
+    if (values.size() % 2 != 0) {
+        return upper;
+    }
+    double lower = *std::max_element(values.begin(), values.begin() + middle);
+    return (lower + upper) / 2.0;
+}
+
+double medianAbsoluteDeviation(const std::vector<double>& values) {
+    if (values.size() < 2) {
+        return 0.0;
+    }
+    double center = median(values);
+    std::vector<double> deviations;
+    deviations.reserve(values.size());
+    for (double value : values) {
+        deviations.push_back(std::abs(value - center));
+    }
+    return median(std::move(deviations));
+}
+
+std::vector<BenchmarkComparison> compareBenchmarks(const BenchmarkResults& baseline, const BenchmarkResults& current,
+                                                   const BenchmarkCompareOptions& options) {
+    std::vector<BenchmarkComparison> comparisons;
+    const auto& before = baseline.getBenchmarks();
+    const auto& after = current.getBenchmarks();
+
+    for (const auto& [name, samples] : before) {
+        BenchmarkComparison comparison;
+        comparison.name = name;
+        comparison.baselineMedian = median(samples.times);
+        if (!samples.allocations.empty()) {
+            comparison.baselineAllocations = median(samples.allocations);
+        }
+
+        auto it = after.find(name);
+        if (it == after.end()) {
+            comparison.verdict = BenchmarkVerdict::REMOVED;
+            comparisons.push_back(comparison);
+            continue;
+        }
+        const BenchmarkSamples& now = it->second;
+        comparison.currentMedian = median(now.times);
+        if (!now.allocations.empty()) {
+            comparison.currentAllocations = median(now.allocations);
+        }
+        comparison.repetitions = std::min(samples.times.size(), now.times.size());
+
+        if (comparison.baselineMedian <= 0.0) {
+            comparison.verdict = BenchmarkVerdict::NOISY;
+            comparisons.push_back(comparison);
+            continue;
+        }
+        double sigmaBefore = MAD_TO_SIGMA * medianAbsoluteDeviation(samples.times);
+        double sigmaAfter = MAD_TO_SIGMA * medianAbsoluteDeviation(now.times);
+        comparison.change = comparison.currentMedian / comparison.baselineMedian - 1.0;
+        comparison.noise = options.noiseFactor * std::sqrt(sigmaBefore * sigmaBefore + sigmaAfter * sigmaAfter) /
+                           comparison.baselineMedian;
+
+        double size = std::abs(comparison.change);
+        if (size <= options.threshold) {
+            comparison.verdict = BenchmarkVerdict::UNCHANGED;
+        } else if (size <= comparison.noise) {
+            comparison.verdict = BenchmarkVerdict::NOISY;
+        } else {
+            comparison.verdict = comparison.change > 0.0 ? BenchmarkVerdict::SLOWER : BenchmarkVerdict::FASTER;
+        }
+        comparisons.push_back(comparison);
+    }
+
+    for (const auto& [name, samples] : after) {
+        if (before.count(name)) {
+            continue;
+        }
+        BenchmarkComparison comparison;
+        comparison.name = name;
+        comparison.currentMedian = median(samples.times);
+        if (!samples.allocations.empty()) {
+            comparison.currentAllocations = median(samples.allocations);
+        }
+        comparison.verdict = BenchmarkVerdict::ADDED;
+        comparisons.push_back(comparison);
+    }
+
+    std::sort(comparisons.begin(), comparisons.end(),
+              [](const BenchmarkComparison& a, const BenchmarkComparison& b) { return a.name < b.name; });
+    return comparisons;
+}
+
+} // namespace util
+} // namespace deckstiny
@@ -0,0 +1,430 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "util/content_pack.h"
+#include "util/logger.h"
+
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define DECKSTINY_PACK_NO_MMAP
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace deckstiny {
+namespace util {
+
+namespace {
+
+// Pack layout (all integers little-endian):
+//   header        magic "DSPK", version, string count, record count,
+//                 positions of the string offsets, string data, record table
+//                 and value blob, total file size
+//   string table  (count + 1) u32 offsets followed by the characters
+//   record table  { u8 kind, 3 bytes padding, u32 id, u64 offset, u64 size }
+//   values        tagged value trees referenced by the record table
+constexpr char PACK_MAGIC[4] = {'D', 'S', 'P', 'K'};
+constexpr size_t HEADER_SIZE = 56;
+constexpr size_t RECORD_ENTRY_SIZE = 24;
+constexpr int MAX_VALUE_DEPTH = 64;
+
+enum ValueTag : uint8_t {
+    TAG_NULL = 0,
+    TAG_FALSE,
+    TAG_TRUE,
+    TAG_INT,
+    TAG_UINT,
+    TAG_FLOAT,
+    TAG_STRING,
+    TAG_ARRAY,
+    TAG_OBJECT
+};
+
+template <typename T>
+void writeLE(std::vector<uint8_t>& out, T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<uint8_t>((static_cast<uint64_t>(value) >> (8 * i)) & 0xFF));
+    }
+}
+
+template <typename T>
+T readLE(const uint8_t* data) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    return static_cast<T>(value);
+}
+
+} // namespace
+
+const char* contentKindDirectory(ContentKind kind) {
+    switch (kind) {
+        case ContentKind::CHARACTER: return "characters";
+        case ContentKind::CARD: return "cards";
+        case ContentKind::ENEMY: return "enemies";
+        case ContentKind::RELIC: return "relics";
+        case ContentKind::EVENT: return "events";
+    }
+    return "";
+}
+
+void ContentPackWriter::addRecord(ContentKind kind, const std::string& id, const nlohmann::json& data) {
+    Record record;
+    record.kind = kind;
+    record.idIndex = intern(id);
+    record.offset = values_.size();
+    encodeValue(data);
+    record.size = values_.size() - record.offset;
+    records_.push_back(record);
+}
+
+uint32_t ContentPackWriter::intern(const std::string& str) {
+    auto it = stringIndices_.find(str);
+    if (it != stringIndices_.end()) {
+        return it->second;
+    }
+    uint32_t index = static_cast<uint32_t>(strings_.size());
+    strings_.push_back(str);
+    stringIndices_.emplace(str, index);
+    return index;
+}
+
+void ContentPackWriter::encodeValue(const nlohmann::json& value) {
+    switch (value.type()) {
+        case nlohmann::json::value_t::boolean:
+            values_.push_back(value.get<bool>() ? TAG_TRUE : TAG_FALSE);
+            break;
+        case nlohmann::json::value_t::number_integer:
+            values_.push_back(TAG_INT);
+            writeLE<int64_t>(values_, value.get<int64_t>());
+            break;
+        case nlohmann::json::value_t::number_unsigned:
+            values_.push_back(TAG_UINT);
+            writeLE<uint64_t>(values_, value.get<uint64_t>());
+            break;
+        case nlohmann::json::value_t::number_float: {
+            double number = value.get<double>();
+            uint64_t bits = 0;
+            std::memcpy(&bits, &number, sizeof(bits));
+            values_.push_back(TAG_FLOAT);
+            writeLE<uint64_t>(values_, bits);
+            break;
+        }
+        case nlohmann::json::value_t::string:
+            values_.push_back(TAG_STRING);
+            writeLE<uint32_t>(values_, intern(value.get_ref<const std::string&>()));
+            break;
+        case nlohmann::json::value_t::array:
+            values_.push_back(TAG_ARRAY);
+            writeLE<uint32_t>(values_, static_cast<uint32_t>(value.size()));
+            for (const auto& element : value) {
+                encodeValue(element);
+            }
+            break;
+        case nlohmann::json::value_t::object:
+            values_.push_back(TAG_OBJECT);
+            writeLE<uint32_t>(values_, static_cast<uint32_t>(value.size()));
+            for (const auto& item : value.items()) {
+                writeLE<uint32_t>(values_, intern(item.key()));
+                encodeValue(item.value());
+            }
+            break;
+        default:
+            values_.push_back(TAG_NULL);
+            break;
+    }
+}
+
+bool ContentPackWriter::writeToFile(const std::string& path) const {
+    std::vector<uint8_t> stringTable;
+    uint32_t stringDataSize = 0;
+    for (const auto& str : strings_) {
+        writeLE<uint32_t>(stringTable, stringDataSize);
+        stringDataSize += static_cast<uint32_t>(str.size());
+    }
+    writeLE<uint32_t>(stringTable, stringDataSize);
+    for (const auto& str : strings_) {
+        stringTable.insert(stringTable.end(), str.begin(), str.end());
+    }
+
+    std::vector<uint8_t> recordTable;
+    recordTable.reserve(records_.size() * RECORD_ENTRY_SIZE);
+    for (const auto& record : records_) {
+        recordTable.push_back(static_cast<uint8_t>(record.kind));
+        recordTable.insert(recordTable.end(), 3, 0);
+        writeLE<uint32_t>(recordTable, record.idIndex);
+        writeLE<uint64_t>(recordTable, record.offset);
+        writeLE<uint64_t>(recordTable, record.size);
+    }
+
+    uint64_t stringOffsetsPos = HEADER_SIZE;
+    uint64_t stringDataPos = stringOffsetsPos + (strings_.size() + 1) * sizeof(uint32_t);
+    uint64_t recordTablePos = stringOffsetsPos + stringTable.size();
+    uint64_t valuesPos = recordTablePos + recordTable.size();
+    uint64_t fileSize = valuesPos + values_.size();
+
+    std::vector<uint8_t> header;
+    header.reserve(HEADER_SIZE);
+    header.insert(header.end(), PACK_MAGIC, PACK_MAGIC + sizeof(PACK_MAGIC));
+    writeLE<uint32_t>(header, ContentPack::FORMAT_VERSION);
+    writeLE<uint32_t>(header, static_cast<uint32_t>(strings_.size()));
+    writeLE<uint32_t>(header, static_cast<uint32_t>(records_.size()));
+    writeLE<uint64_t>(header, stringOffsetsPos);
+    writeLE<uint64_t>(header, stringDataPos);
+    writeLE<uint64_t>(header, recordTablePos);
+    writeLE<uint64_t>(header, valuesPos);
+    writeLE<uint64_t>(header, fileSize);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        LOG_ERROR("content_pack", "Could not open pack file for writing: " + path);
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(header.data()), header.size());
+    file.write(reinterpret_cast<const char*>(stringTable.data()), stringTable.size());
+    file.write(reinterpret_cast<const char*>(recordTable.data()), recordTable.size());
+    file.write(reinterpret_cast<const char*>(values_.data()), values_.size());
+    if (!file) {
+        LOG_ERROR("content_pack", "Failed to write pack file: " + path);
+        return false;
+    }
+    return true;
+}
+
+ContentPack::~ContentPack() {
+    close();
+}
+
+bool ContentPack::open(const std::string& path) {
+    close();
+
+#ifndef DECKSTINY_PACK_NO_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_DEBUG("content_pack", "Could not open pack file: " + path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(HEADER_SIZE)) {
+        ::close(fd);
+        LOG_ERROR("content_pack", "Pack file is too small or unreadable: " + path);
+        return false;
+    }
+    void* mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        LOG_ERROR("content_pack", "Failed to map pack file: " + path);
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(mapping);
+    size_ = static_cast<size_t>(st.st_size);
+    mapped_ = true;
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        LOG_DEBUG("content_pack", "Could not open pack file: " + path);
+        return false;
+    }
+    std::streamsize fileSize = file.tellg();
+    if (fileSize < static_cast<std::streamsize>(HEADER_SIZE)) {
+        LOG_ERROR("content_pack", "Pack file is too small: " + path);
+        return false;
+    }
+    buffer_.resize(static_cast<size_t>(fileSize));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(buffer_.data()), fileSize);
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+
+    if (std::memcmp(data_, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0) {
+        LOG_ERROR("content_pack", "Not a content pack: " + path);
+        close();
+        return false;
+    }
+    uint32_t version = readLE<uint32_t>(data_ + 4);
+    if (version != FORMAT_VERSION) {
+        LOG_WARNING("content_pack", "Unsupported pack version " + std::to_string(version) + " in " + path);
+        close();
+        return false;
+    }
+
+    stringCount_ = readLE<uint32_t>(data_ + 8);
+    recordCount_ = readLE<uint32_t>(data_ + 12);
+    stringOffsetsPos_ = readLE<uint64_t>(data_ + 16);
+    stringDataPos_ = readLE<uint64_t>(data_ + 24);
+    recordTablePos_ = readLE<uint64_t>(data_ + 32);
+    valuesPos_ = readLE<uint64_t>(data_ + 40);
+    uint64_t fileSize = readLE<uint64_t>(data_ + 48);
+
+    // Every position is checked against the file size before anything is added to it,
+    // so offsets from a corrupt header cannot wrap around
+    const uint64_t size = size_;
+    bool layoutValid = fileSize == size &&
+                       stringOffsetsPos_ >= HEADER_SIZE && stringOffsetsPos_ <= size &&
+                       static_cast<uint64_t>(stringCount_) + 1 <= (size - stringOffsetsPos_) / sizeof(uint32_t) &&
+                       stringDataPos_ == stringOffsetsPos_ + (static_cast<uint64_t>(stringCount_) + 1) * sizeof(uint32_t) &&
+                       recordTablePos_ >= stringDataPos_ && recordTablePos_ <= size &&
+                       recordCount_ <= (size - recordTablePos_) / RECORD_ENTRY_SIZE &&
+                       valuesPos_ == recordTablePos_ + static_cast<uint64_t>(recordCount_) * RECORD_ENTRY_SIZE;
+    if (layoutValid) {
+        uint32_t stringDataSize = readLE<uint32_t>(data_ + stringOffsetsPos_ + stringCount_ * sizeof(uint32_t));
+        layoutValid = stringDataSize == recordTablePos_ - stringDataPos_;
+    }
+    if (!layoutValid) {
+        LOG_ERROR("content_pack", "Corrupted pack layout in " + path);
+        close();
+        return false;
+    }
+
+    LOG_INFO("content_pack", "Opened content pack " + path + " with " + std::to_string(recordCount_) +
+             " records and " + std::to_string(stringCount_) + " strings");
+    return true;
+}
+
+void ContentPack::close() {
+#ifndef DECKSTINY_PACK_NO_MMAP
+    if (mapped_ && data_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    buffer_.clear();
+    stringCount_ = 0;
+    recordCount_ = 0;
+}
+
+ContentKind ContentPack::getRecordKind(size_t index) const {
+    if (!data_ || index >= recordCount_) {
+        return ContentKind::CHARACTER;
+    }
+    return static_cast<ContentKind>(data_[recordTablePos_ + index * RECORD_ENTRY_SIZE]);
+}
+
+std::string ContentPack::getRecordId(size_t index) const {
+    std::string id;
+    if (!data_ || index >= recordCount_) {
+        return id;
+    }
+    getString(readLE<uint32_t>(data_ + recordTablePos_ + index * RECORD_ENTRY_SIZE + 4), id);
+    return id;
+}
+
+bool ContentPack::decodeRecord(size_t index, nlohmann::json& out) const {
+    if (!data_ || index >= recordCount_) {
+        return false;
+    }
+    const uint8_t* entry = data_ + recordTablePos_ + index * RECORD_ENTRY_SIZE;
+    uint64_t offset = readLE<uint64_t>(entry + 8);
+    uint64_t size = readLE<uint64_t>(entry + 16);
+    uint64_t pos = valuesPos_ + offset;
+    uint64_t end = pos + size;
+    if (offset > size_ || end > size_ || end < pos) {
+        return false;
+    }
+    return decodeValue(pos, end, out, 0) && pos == end;
+}
+
+bool ContentPack::getString(uint32_t index, std::string& out) const {
+    if (index >= stringCount_) {
+        return false;
+    }
+    const uint8_t* offsets = data_ + stringOffsetsPos_;
+    uint32_t begin = readLE<uint32_t>(offsets + index * sizeof(uint32_t));
+    uint32_t end = readLE<uint32_t>(offsets + (index + 1) * sizeof(uint32_t));
+    if (end < begin || stringDataPos_ + end > recordTablePos_) {
+        return false;
+    }
+    out.assign(reinterpret_cast<const char*>(data_ + stringDataPos_ + begin), end - begin);
+    return true;
+}
+
+bool ContentPack::decodeValue(uint64_t& pos, uint64_t end, nlohmann::json& out, int depth) const {
+    if (pos >= end || depth > MAX_VALUE_DEPTH) {
+        return false;
+    }
+    uint8_t tag = data_[pos++];
+
+    switch (tag) {
+        case TAG_NULL:
+            out = nullptr;
+            return true;
+        case TAG_FALSE:
+            out = false;
+            return true;
+        case TAG_TRUE:
+            out = true;
+            return true;
+        case TAG_INT:
+            if (end - pos < sizeof(int64_t)) return false;
+            out = readLE<int64_t>(data_ + pos);
+            pos += sizeof(int64_t);
+            return true;
+        case TAG_UINT:
+            if (end - pos < sizeof(uint64_t)) return false;
+            out = readLE<uint64_t>(data_ + pos);
+            pos += sizeof(uint64_t);
+            return true;
+        case TAG_FLOAT: {
+            if (end - pos < sizeof(uint64_t)) return false;
+            uint64_t bits = readLE<uint64_t>(data_ + pos);
+            double number = 0.0;
+            std::memcpy(&number, &bits, sizeof(number));
+            out = number;
+            pos += sizeof(uint64_t);
+            return true;
+        }
+        case TAG_STRING: {
+            if (end - pos < sizeof(uint32_t)) return false;
+            std::string str;
+            if (!getString(readLE<uint32_t>(data_ + pos), str)) return false;
+            pos += sizeof(uint32_t);
+            out = std::move(str);
+            return true;
+        }
+        case TAG_ARRAY: {
+            if (end - pos < sizeof(uint32_t)) return false;
+            uint32_t count = readLE<uint32_t>(data_ + pos);
+            pos += sizeof(uint32_t);
+            // Every element takes at least its tag byte, so a larger count is corrupt
+            if (count > end - pos) return false;
+            out = nlohmann::json::array();
+            auto& array = out.get_ref<nlohmann::json::array_t&>();
+            array.reserve(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                array.emplace_back();
+                if (!decodeValue(pos, end, array.back(), depth + 1)) return false;
+            }
+            return true;
+        }
+        case TAG_OBJECT: {
+            if (end - pos < sizeof(uint32_t)) return false;
+            uint32_t count = readLE<uint32_t>(data_ + pos);
+            pos += sizeof(uint32_t);
+            // Every member takes at least a key index and a tag byte
+            if (count > (end - pos) / (sizeof(uint32_t) + 1)) return false;
+            out = nlohmann::json::object();
+            std::string key;
+            for (uint32_t i = 0; i < count; ++i) {
+                if (end - pos < sizeof(uint32_t)) return false;
+                if (!getString(readLE<uint32_t>(data_ + pos), key)) return false;
+                pos += sizeof(uint32_t);
+                if (!decodeValue(pos, end, out[key], depth + 1)) return false;
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+} // namespace util
+} // namespace deckstiny
@@ -1,15 +1,270 @@
-// Anisimov Vasiliy st129629@student.spbu.ru
-// Laboratory Work 2
-
 #include "util/logger.h"
+#include <algorithm>
+#include <condition_variable>
+#include <ctime>
 #include <filesystem>
 #include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace deckstiny {
 namespace util {
 
+namespace {
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug:   return "DEBUG";
+        case LogLevel::Info:    return "INFO";
+        case LogLevel::Warning: return "WARN";
+        case LogLevel::Error:   return "ERROR";
+        case LogLevel::Fatal:   return "FATAL";
+        default:               return "UNKNOWN";
+    }
+}
+
+int64_t nowMicroseconds() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+/**
+ * @class Logger::FileWriter
+ * @brief Bounded multi-producer queue of file records and the thread writing them
+ *
+ * The queue is a ring of slots with per-slot sequence numbers: a producer
+ * claims a position with one compare-and-swap on the tail and publishes the
+ * slot by bumping its sequence, so producers never take a lock. The single
+ * consumer is the writer thread, which drains everything published, writes
+ * it with one buffered stream per category and flushes the streams at the
+ * end of each batch. The thread is started when file logging is first
+ * enabled.
+ */
+class Logger::FileWriter {
+public:
+    FileWriter() : slots_(new Slot[QUEUE_CAPACITY]) {
+        for (size_t i = 0; i < QUEUE_CAPACITY; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~FileWriter() {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    /**
+     * @brief Start the writer thread if it is not running yet
+     *
+     * Called when a file sink is enabled, so processes that never log to
+     * files (simulations, tests, benchmarks) have no thread waking up.
+     */
+    void start() {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        if (!thread_.joinable() && !stopping_) {
+            thread_ = std::thread([this]() { run(); });
+        }
+    }
+
+    /**
+     * @brief Queue a record
+     * @param level Log level
+     * @param category Log category, selects the file
+     * @param message Message text
+     * @param wait Wait for room instead of dropping the record when full
+     */
+    void push(LogLevel level, const std::string& category, std::string&& message, bool wait) {
+        int64_t time = nowMicroseconds();
+        size_t position = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[position & (QUEUE_CAPACITY - 1)];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (difference == 0) {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.time = time;
+                    slot.level = level;
+                    slot.category = category;
+                    slot.message = std::move(message);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    break;
+                }
+            } else if (difference < 0) {
+                // Full: the writer has not freed the slot of the previous lap yet
+                if (!wait) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                wakeWriter();
+                std::this_thread::yield();
+                position = tail_.load(std::memory_order_relaxed);
+            } else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        if (idle_.load(std::memory_order_relaxed)) {
+            wakeWriter();
+        }
+    }
+
+    /**
+     * @brief Wait until every record queued before the call is written and flushed
+     */
+    void flush() {
+        size_t target = tail_.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        if (!thread_.joinable()) {
+            // Nothing can have been queued before the writer started
+            return;
+        }
+        ++flushWaiters_;
+        wake_.notify_one();
+        flushed_.wait(lock, [&]() { return flushedPosition_ >= target; });
+        --flushWaiters_;
+    }
+
+    void setDirectory(const std::string& directory) {
+        std::lock_guard<std::mutex> lock(directoryMutex_);
+        directory_ = directory;
+    }
+
+    size_t getDroppedCount() const {
+        return droppedTotal_.load(std::memory_order_relaxed) + dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * @struct Slot
+     * @brief One queued record
+     */
+    struct Slot {
+        std::atomic<size_t> sequence{0};    ///< Position + 1 once published, position + capacity once free
+        int64_t time = 0;                   ///< Microseconds since the epoch
+        LogLevel level = LogLevel::Debug;   ///< Log level
+        std::string category;               ///< Log category
+        std::string message;                ///< Message text
+    };
+
+    std::unique_ptr<Slot[]> slots_;                 ///< Ring of QUEUE_CAPACITY slots
+    alignas(64) std::atomic<size_t> tail_{0};       ///< Next position to claim
+    alignas(64) size_t head_ = 0;                   ///< Next position to write, writer thread only
+    std::atomic<size_t> dropped_{0};                ///< Dropped records not yet reported
+    std::atomic<size_t> droppedTotal_{0};           ///< Dropped records already reported
+    std::atomic<bool> idle_{false};                 ///< Whether the writer is waiting for records
+
+    std::mutex wakeMutex_;                          ///< Guards the fields below
+    std::condition_variable wake_;                  ///< Wakes the writer
+    std::condition_variable flushed_;               ///< Signals flushedPosition_ changes
+    bool stopping_ = false;                         ///< Set by the destructor
+    size_t flushWaiters_ = 0;                       ///< Threads inside flush()
+    size_t flushedPosition_ = 0;                    ///< Records written and flushed
+
+    std::mutex directoryMutex_;                     ///< Guards directory_
+    std::string directory_;                         ///< Directory of new log files
+    std::unordered_map<std::string, std::ofstream> files_;  ///< Open files, writer thread only
+    std::thread thread_;                            ///< Writer thread
+
+    // Cached formatting of the current second
+    int64_t cachedSecond_ = -1;
+    std::string cachedPrefix_;
+
+    void wakeWriter() {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        wake_.notify_one();
+    }
+
+    void run() {
+        for (;;) {
+            size_t written = drain();
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex_);
+                if (written > 0 || flushWaiters_ > 0) {
+                    flushedPosition_ = head_;
+                    flushed_.notify_all();
+                }
+                if (stopping_ && head_ == tail_.load(std::memory_order_acquire)) {
+                    return;
+                }
+                if (written == 0) {
+                    // Idle: wait for a producer, a flush or a short timeout that
+                    // picks up records whose wake-up raced with going idle. A
+                    // flush or shutdown waiting on a claimed but unpublished slot
+                    // polls every millisecond instead of spinning
+                    idle_.store(true, std::memory_order_relaxed);
+                    bool waitedOn = flushWaiters_ > 0 || stopping_;
+                    wake_.wait_for(lock, std::chrono::milliseconds(waitedOn ? 1 : 50));
+                    idle_.store(false, std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    // Write every published record, then flush the streams written to
+    size_t drain() {
+        size_t written = 0;
+        for (;;) {
+            Slot& slot = slots_[head_ & (QUEUE_CAPACITY - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != head_ + 1) {
+                break;
+            }
+            write(slot.time, slot.level, slot.category, slot.message);
+            slot.message.clear();
+            slot.sequence.store(head_ + QUEUE_CAPACITY, std::memory_order_release);
+            ++head_;
+            ++written;
+        }
+
+        size_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            droppedTotal_.fetch_add(dropped, std::memory_order_relaxed);
+            write(nowMicroseconds(), LogLevel::Warning, "logger",
+                  std::to_string(dropped) + " log messages dropped, the file queue was full");
+            ++written;
+        }
+
+        if (written > 0) {
+            for (auto& file : files_) {
+                file.second.flush();
+            }
+        }
+        return written;
+    }
+
+    void write(int64_t time, LogLevel level, const std::string& category, const std::string& message) {
+        auto it = files_.find(category);
+        if (it == files_.end() || !it->second.is_open()) {
+            std::string directory;
+            {
+                std::lock_guard<std::mutex> lock(directoryMutex_);
+                directory = directory_;
+            }
+            it = files_.emplace(category, std::ofstream()).first;
+            it->second.open(directory + "/" + category + ".log", std::ios::app);
+        }
+
+        // Date and time only change once a second; the milliseconds are appended per record
+        int64_t second = time / 1000000;
+        if (second != cachedSecond_) {
+            cachedSecond_ = second;
+            cachedPrefix_ = formatTimestamp(time).substr(0, 19);
+        }
+        char milliseconds[8];
+        std::snprintf(milliseconds, sizeof(milliseconds), ".%03d", static_cast<int>((time / 1000) % 1000));
+        it->second << cachedPrefix_ << milliseconds << " [" << levelName(level) << "] " << message << '\n';
+    }
+};
+
 std::unique_ptr<Logger> Logger::instance_;
 
 void Logger::init() {
@@ -56,69 +311,118 @@ bool Logger::isConsoleEnabled() const {
     return consoleEnabled_;
 }
 
-Logger::Logger() { }
+Logger::Logger() : writer_(new FileWriter()) {
+    updateThreshold();
+}
 
 Logger::~Logger() {
-    for (auto& file : logFiles_) {
-        if (file.second.is_open()) {
-            file.second.close();
-        }
-    }
+    // The writer drains the queue before its thread exits
+    writer_.reset();
 }
 
-void Logger::log(LogLevel level, const std::string& category, const std::string& message) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    std::string timestamp = getTimestamp();
-    std::string levelStr = getLevelString(level);
+void Logger::log(LogLevel level, const std::string& category, std::string message) {
+    if (!shouldLog(level)) {
+        return;
+    }
     
-    if (consoleEnabled_ && level >= consoleLevel_) {
-        std::string colorCode = getLevelColor(level);
-        std::cout << colorCode << timestamp << " [" << levelStr << "] " << category << ": " << message << "\033[0m" << std::endl;
+    int levelValue = static_cast<int>(level);
+    if (levelValue >= consoleThreshold_.load(std::memory_order_relaxed)) {
+        std::string timestamp = formatTimestamp(nowMicroseconds());
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::cout << getLevelColor(level) << timestamp << " [" << levelName(level) << "] " << category << ": " << message << "\033[0m" << std::endl;
     }
     
-    if (fileEnabled_ && level >= fileLevel_) {
-        openLogFile(category);
-        logFiles_[category] << timestamp << " [" << levelStr << "] " << message << std::endl;
+    if (levelValue >= fileThreshold_.load(std::memory_order_relaxed)) {
+        bool wait = level >= LogLevel::Error || overflowPolicy_.load(std::memory_order_relaxed) == OverflowPolicy::Block;
+        writer_->push(level, category, std::move(message), wait);
+        if (level == LogLevel::Fatal) {
+            writer_->flush();
+        }
     }
 }
 
+void Logger::flush() {
+    writer_->flush();
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::cout.flush();
+}
+
+void Logger::setOverflowPolicy(OverflowPolicy policy) {
+    overflowPolicy_.store(policy, std::memory_order_relaxed);
+}
+
+size_t Logger::getDroppedCount() const {
+    return writer_->getDroppedCount();
+}
+
 void Logger::setConsoleLevel(LogLevel level) {
+    std::lock_guard<std::mutex> lock(mutex_);
     consoleLevel_ = level;
+    updateThreshold();
 }
 
 void Logger::setFileLevel(LogLevel level) {
+    std::lock_guard<std::mutex> lock(mutex_);
     fileLevel_ = level;
+    updateThreshold();
 }
 
 void Logger::setConsoleEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(mutex_);
     consoleEnabled_ = enabled;
+    updateThreshold();
 }
 
 void Logger::setFileEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (enabled) {
+        writer_->start();
+    }
     fileEnabled_ = enabled;
+    updateThreshold();
+}
+
+void Logger::setEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    enabled_.store(enabled, std::memory_order_relaxed);
+    updateThreshold();
+}
+
+void Logger::updateThreshold() {
+    // One past Fatal: no level passes
+    int threshold = static_cast<int>(LogLevel::Fatal) + 1;
+    if (enabled_.load(std::memory_order_relaxed)) {
+        if (consoleEnabled_) {
+            threshold = std::min(threshold, static_cast<int>(consoleLevel_));
+        }
+        if (fileEnabled_) {
+            threshold = std::min(threshold, static_cast<int>(fileLevel_));
+        }
+    }
+    threshold_.store(threshold, std::memory_order_relaxed);
+    
+    int none = static_cast<int>(LogLevel::Fatal) + 1;
+    bool enabled = enabled_.load(std::memory_order_relaxed);
+    consoleThreshold_.store(enabled && consoleEnabled_ ? static_cast<int>(consoleLevel_) : none, std::memory_order_relaxed);
+    fileThreshold_.store(enabled && fileEnabled_ ? static_cast<int>(fileLevel_) : none, std::memory_order_relaxed);
+}
+
+bool Logger::isEnabled() const {
+    return enabled_.load(std::memory_order_relaxed);
 }
 
 void Logger::setLogDirectory(const std::string& directory) {
-    logDirectory_ = directory;
     std::filesystem::create_directories(directory);
+    std::lock_guard<std::mutex> lock(mutex_);
+    logDirectory_ = directory;
+    writer_->setDirectory(directory);
 }
 
 std::string Logger::getLogDirectory() const {
+    std::lock_guard<std::mutex> lock(mutex_);
     return logDirectory_;
 }
 
-std::string Logger::getLevelString(LogLevel level) {
-    switch (level) {
-        case LogLevel::Debug:   return "DEBUG";
-        case LogLevel::Info:    return "INFO";
-        case LogLevel::Warning: return "WARN";
-        case LogLevel::Error:   return "ERROR";
-        case LogLevel::Fatal:   return "FATAL";
-        default:               return "UNKNOWN";
-    }
-}
-
 std::string Logger::getLevelColor(LogLevel level) {
     switch (level) {
         case LogLevel::Debug:   return "\033[37m"; // White
@@ -130,22 +434,18 @@ std::string Logger::getLevelColor(LogLevel level) {
     }
 }
 
-std::string Logger::getTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
-    
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time), "%Y-%m-%d %H:%M:%S");
-    ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-    return ss.str();
-}
-
-void Logger::openLogFile(const std::string& category) {
-    if (logFiles_.find(category) == logFiles_.end() || !logFiles_[category].is_open()) {
-        std::string filename = logDirectory_ + "/" + category + ".log";
-        logFiles_[category].open(filename, std::ios::app);
-    }
+std::string Logger::formatTimestamp(int64_t microseconds) {
+    std::time_t time = static_cast<std::time_t>(microseconds / 1000000);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &time);
+#else
+    localtime_r(&time, &local);
+#endif
+    char buffer[32];
+    size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+    std::snprintf(buffer + length, sizeof(buffer) - length, ".%03d", static_cast<int>((microseconds / 1000) % 1000));
+    return buffer;
 }
 
 } // namespace util
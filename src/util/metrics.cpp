@@ -0,0 +1,344 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "util/metrics.h"
+#include "util/logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+namespace deckstiny {
+namespace util {
+
+namespace {
+
+std::atomic<size_t> nextShard{0};
+
+/// Prometheus label value with backslashes, quotes and newlines escaped
+std::string escapeLabelValue(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+/// Label block such as {kind="cards",le="0.001"}, empty when there are no labels
+std::string formatLabels(const MetricLabels& labels, const std::string& le = {}) {
+    if (labels.empty() && le.empty()) {
+        return {};
+    }
+    std::string text = "{";
+    for (const auto& [name, value] : labels) {
+        if (text.size() > 1) {
+            text += ',';
+        }
+        text += name + "=\"" + escapeLabelValue(value) + "\"";
+    }
+    if (!le.empty()) {
+        if (text.size() > 1) {
+            text += ',';
+        }
+        text += "le=\"" + le + "\"";
+    }
+    return text + "}";
+}
+
+std::string formatSeconds(uint64_t nanoseconds) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", static_cast<double>(nanoseconds) / 1e9);
+    return buffer;
+}
+
+} // namespace
+
+size_t metricShard() {
+    thread_local const size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % METRIC_SHARD_COUNT;
+    return shard;
+}
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const Shard& shard : shards_) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+HistogramSnapshot Histogram::snapshot() const {
+    HistogramSnapshot result;
+    result.buckets.assign(BUCKET_COUNT, 0);
+    for (const Shard& shard : shards_) {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            result.buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+        }
+        result.sumNanoseconds += shard.sum.load(std::memory_order_relaxed);
+    }
+    for (uint64_t bucket : result.buckets) {
+        result.count += bucket;
+    }
+    return result;
+}
+
+std::atomic<bool> MetricsRegistry::timingEnabled_{false};
+
+MetricsRegistry& MetricsRegistry::getInstance() {
+    static MetricsRegistry instance;
+    return instance;
+}
+
+MetricsRegistry::Entry* MetricsRegistry::findOrAdd(const std::string& name, const std::string& help,
+                                                   const MetricLabels& labels, MetricType type) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : entries_) {
+        if (entry->name == name && entry->labels == labels) {
+            return entry->type == type ? entry.get() : nullptr;
+        }
+        if (entry->name == name && entry->type != type) {
+            return nullptr;
+        }
+    }
+
+    auto entry = std::make_unique<Entry>();
+    entry->name = name;
+    entry->help = help;
+    entry->labels = labels;
+    entry->type = type;
+    switch (type) {
+        case MetricType::Counter:
+            entry->counter = std::make_unique<Counter>();
+            break;
+        case MetricType::Gauge:
+            entry->gauge = std::make_unique<Gauge>();
+            break;
+        case MetricType::Histogram:
+            entry->histogram = std::make_unique<Histogram>();
+            break;
+    }
+    entries_.push_back(std::move(entry));
+    return entries_.back().get();
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    if (Entry* entry = findOrAdd(name, help, labels, MetricType::Counter)) {
+        return *entry->counter;
+    }
+    LOG_ERROR("metrics", "Metric " + name + " is already registered with another type");
+    static Counter unregistered;
+    return unregistered;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    if (Entry* entry = findOrAdd(name, help, labels, MetricType::Gauge)) {
+        return *entry->gauge;
+    }
+    LOG_ERROR("metrics", "Metric " + name + " is already registered with another type");
+    static Gauge unregistered;
+    return unregistered;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    if (Entry* entry = findOrAdd(name, help, labels, MetricType::Histogram)) {
+        return *entry->histogram;
+    }
+    LOG_ERROR("metrics", "Metric " + name + " is already registered with another type");
+    static Histogram unregistered;
+    return unregistered;
+}
+
+std::string MetricsRegistry::snapshot(MetricsFormat format) const {
+    return format == MetricsFormat::Json ? toJson() : toPrometheus();
+}
+
+std::string MetricsRegistry::toPrometheus() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Metrics of one name are written together under a single HELP and TYPE
+    std::vector<const Entry*> sorted;
+    for (const auto& entry : entries_) {
+        sorted.push_back(entry.get());
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const Entry* a, const Entry* b) { return a->name < b->name; });
+
+    std::string text;
+    const std::string* family = nullptr;
+    for (const Entry* entry : sorted) {
+        if (!family || *family != entry->name) {
+            family = &entry->name;
+            const char* type = entry->type == MetricType::Counter ? "counter"
+                             : entry->type == MetricType::Gauge ? "gauge" : "histogram";
+            text += "# HELP " + entry->name + " " + entry->help + "\n";
+            text += "# TYPE " + entry->name + " " + type + "\n";
+        }
+
+        switch (entry->type) {
+            case MetricType::Counter:
+                text += entry->name + formatLabels(entry->labels) + " " + std::to_string(entry->counter->value()) + "\n";
+                break;
+            case MetricType::Gauge:
+                text += entry->name + formatLabels(entry->labels) + " " + std::to_string(entry->gauge->value()) + "\n";
+                break;
+            case MetricType::Histogram: {
+                HistogramSnapshot histogram = entry->histogram->snapshot();
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i < Histogram::BUCKET_COUNT; ++i) {
+                    cumulative += histogram.buckets[i];
+                    std::string le = i < Histogram::BOUNDS.size() ? formatSeconds(Histogram::BOUNDS[i]) : "+Inf";
+                    text += entry->name + "_bucket" + formatLabels(entry->labels, le) + " " +
+                            std::to_string(cumulative) + "\n";
+                }
+                text += entry->name + "_sum" + formatLabels(entry->labels) + " " +
+                        formatSeconds(histogram.sumNanoseconds) + "\n";
+                text += entry->name + "_count" + formatLabels(entry->labels) + " " +
+                        std::to_string(histogram.count) + "\n";
+                break;
+            }
+        }
+    }
+    return text;
+}
+
+std::string MetricsRegistry::toJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    nlohmann::json metrics = nlohmann::json::array();
+    for (const auto& entry : entries_) {
+        nlohmann::json metric;
+        metric["name"] = entry->name;
+        metric["help"] = entry->help;
+        nlohmann::json labels = nlohmann::json::object();
+        for (const auto& [name, value] : entry->labels) {
+            labels[name] = value;
+        }
+        metric["labels"] = labels;
+
+        switch (entry->type) {
+            case MetricType::Counter:
+                metric["type"] = "counter";
+                metric["value"] = entry->counter->value();
+                break;
+            case MetricType::Gauge:
+                metric["type"] = "gauge";
+                metric["value"] = entry->gauge->value();
+                break;
+            case MetricType::Histogram: {
+                HistogramSnapshot histogram = entry->histogram->snapshot();
+                metric["type"] = "histogram";
+                metric["count"] = histogram.count;
+                metric["sum_seconds"] = static_cast<double>(histogram.sumNanoseconds) / 1e9;
+                nlohmann::json buckets = nlohmann::json::array();
+                for (size_t i = 0; i < Histogram::BUCKET_COUNT; ++i) {
+                    nlohmann::json bucket;
+                    if (i < Histogram::BOUNDS.size()) {
+                        bucket["le_seconds"] = static_cast<double>(Histogram::BOUNDS[i]) / 1e9;
+                    } else {
+                        bucket["le_seconds"] = "+Inf";
+                    }
+                    bucket["count"] = histogram.buckets[i];
+                    buckets.push_back(bucket);
+                }
+                metric["buckets"] = buckets;
+                break;
+            }
+        }
+        metrics.push_back(metric);
+    }
+
+    nlohmann::json document;
+    document["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    document["metrics"] = metrics;
+    return document.dump(2) + "\n";
+}
+
+bool MetricsRegistry::writeSnapshot(const std::string& path, MetricsFormat format) const {
+    std::string text = snapshot(format);
+
+    // Write beside the target and rename, so readers never see half a snapshot
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file || !(file << text)) {
+            LOG_ERROR("metrics", "Failed to write metrics snapshot: " + temporary);
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        LOG_ERROR("metrics", "Failed to replace " + path + ": " + error.message());
+        return false;
+    }
+    return true;
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::parseInterval(const char* text, std::chrono::milliseconds& interval) {
+    char* end = nullptr;
+    double seconds = std::strtod(text, &end);
+    if (end == text || *end != '\0' || !std::isfinite(seconds) || seconds <= 0.0 || seconds > 1e6) {
+        return false;
+    }
+    interval = std::chrono::milliseconds(static_cast<int64_t>(seconds * 1000.0));
+    return true;
+}
+
+bool MetricsExporter::start(const std::string& path, std::chrono::milliseconds interval) {
+    stop();
+
+    path_ = path;
+    // A zero interval would rewrite the file in a tight loop
+    interval_ = std::max(interval, std::chrono::milliseconds(1));
+    format_ = std::filesystem::path(path).extension() == ".json" ? MetricsFormat::Json : MetricsFormat::Prometheus;
+    if (!MetricsRegistry::getInstance().writeSnapshot(path_, format_)) {
+        return false;
+    }
+    MetricsRegistry::setTimingEnabled(true);
+
+    stopping_ = false;
+    thread_ = std::thread(&MetricsExporter::run, this);
+    LOG_INFO("metrics", "Exporting metrics to " + path_);
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_one();
+    thread_.join();
+    MetricsRegistry::getInstance().writeSnapshot(path_, format_);
+}
+
+void MetricsExporter::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!wakeup_.wait_for(lock, interval_, [this]() { return stopping_; })) {
+        lock.unlock();
+        MetricsRegistry::getInstance().writeSnapshot(path_, format_);
+        lock.lock();
+    }
+}
+
+} // namespace util
+} // namespace deckstiny
@@ -0,0 +1,93 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "util/rng.h"
+
+#include <random>
+
+namespace deckstiny {
+namespace util {
+
+uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+Rng::Rng(uint64_t seed) {
+    this->seed(seed);
+}
+
+void Rng::seed(uint64_t seed) {
+    // SplitMix64 output is never all zero over four consecutive calls
+    for (auto& word : state_) {
+        word = splitMix64(seed);
+    }
+}
+
+uint64_t Rng::nextBelow(uint64_t bound) {
+    // Reject the low values that would make the modulo biased
+    uint64_t threshold = (0 - bound) % bound;
+    for (;;) {
+        uint64_t value = (*this)();
+        if (value >= threshold) {
+            return value % bound;
+        }
+    }
+}
+
+int Rng::uniformInt(int lo, int hi) {
+    uint64_t span = static_cast<uint64_t>(static_cast<int64_t>(hi) - lo) + 1;
+    return static_cast<int>(lo + static_cast<int64_t>(nextBelow(span)));
+}
+
+double Rng::uniformReal() {
+    return static_cast<double>((*this)() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+size_t Rng::weightedIndex(const std::vector<double>& weights) {
+    double total = 0.0;
+    for (double weight : weights) {
+        total += weight > 0.0 ? weight : 0.0;
+    }
+    if (total <= 0.0) {
+        return 0;
+    }
+
+    double roll = uniformReal() * total;
+    size_t last = 0;
+    for (size_t i = 0; i < weights.size(); ++i) {
+        if (weights[i] <= 0.0) {
+            continue;
+        }
+        last = i;
+        if (roll < weights[i]) {
+            return i;
+        }
+        roll -= weights[i];
+    }
+    // Rounding can leave a sliver past the last positive weight
+    return last;
+}
+
+Rng Rng::split(uint64_t streamId) const {
+    uint64_t mix = state_[0] ^ rotl(state_[1], 17) ^ rotl(state_[2], 31) ^ rotl(state_[3], 47);
+    mix ^= splitMix64(streamId);
+    Rng child;
+    for (auto& word : child.state_) {
+        word = splitMix64(mix);
+    }
+    return child;
+}
+
+Rng& defaultRng() {
+    thread_local Rng rng([] {
+        std::random_device device;
+        return (static_cast<uint64_t>(device()) << 32) ^ device();
+    }());
+    return rng;
+}
+
+} // namespace util
+} // namespace deckstiny
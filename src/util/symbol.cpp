@@ -0,0 +1,93 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "util/symbol.h"
+
+#include <stdexcept>
+
+namespace deckstiny {
+namespace util {
+
+Symbol Symbol::intern(std::string_view text) {
+    return SymbolTable::getInstance().intern(text);
+}
+
+Symbol Symbol::find(std::string_view text) {
+    return SymbolTable::getInstance().find(text);
+}
+
+const std::string& Symbol::str() const {
+    return SymbolTable::getInstance().getName(*this);
+}
+
+SymbolTable& SymbolTable::getInstance() {
+    static SymbolTable instance;
+    return instance;
+}
+
+SymbolTable::SymbolTable() {
+    const char* predefined[] = {
+        "",
+#define DECKSTINY_SYMBOL_NAME(name, text) text,
+        DECKSTINY_PREDEFINED_SYMBOLS(DECKSTINY_SYMBOL_NAME)
+#undef DECKSTINY_SYMBOL_NAME
+    };
+    static_assert(sizeof(predefined) / sizeof(predefined[0]) == symbols::PREDEFINED_COUNT,
+                  "predefined symbol names out of sync with their handles");
+
+    for (const char* text : predefined) {
+        intern(text);
+    }
+}
+
+Symbol SymbolTable::intern(std::string_view text) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(text);
+        if (it != ids_.end()) {
+            return Symbol(it->second);
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(text);
+    if (it != ids_.end()) {
+        return Symbol(it->second);
+    }
+
+    uint32_t id = count_.load(std::memory_order_relaxed);
+    size_t chunk = id >> CHUNK_BITS;
+    if (chunk >= MAX_CHUNKS) {
+        throw std::length_error("Symbol table is full");
+    }
+    if (!chunks_[chunk]) {
+        chunks_[chunk] = std::make_unique<std::string[]>(CHUNK_SIZE);
+    }
+
+    std::string& slot = chunks_[chunk][id & (CHUNK_SIZE - 1)];
+    slot.assign(text.data(), text.size());
+    ids_.emplace(std::string_view(slot), id);
+    count_.store(id + 1, std::memory_order_release);
+    return Symbol(id);
+}
+
+Symbol SymbolTable::find(std::string_view text) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(text);
+    return it != ids_.end() ? Symbol(it->second) : Symbol();
+}
+
+const std::string& SymbolTable::getName(Symbol symbol) const {
+    uint32_t id = symbol.getId();
+    if (id >= count_.load(std::memory_order_acquire)) {
+        return chunks_[0][0];
+    }
+    return chunks_[id >> CHUNK_BITS][id & (CHUNK_SIZE - 1)];
+}
+
+size_t SymbolTable::size() const {
+    return count_.load(std::memory_order_acquire);
+}
+
+} // namespace util
+} // namespace deckstiny
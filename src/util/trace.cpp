@@ -0,0 +1,285 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "util/trace.h"
+#include "util/logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <mutex>
+
+namespace deckstiny {
+namespace util {
+
+std::atomic<bool> Trace::enabled_{false};
+
+namespace {
+
+/// Event names, in TraceEventType order
+constexpr const char* TRACE_EVENT_NAMES[] = {
+    "SYMBOL",
+    "CARD_PLAYED",
+    "DAMAGE_DEALT",
+    "STATUS_APPLIED",
+    "INTENT_CHOSEN",
+    "STATE_CHANGED"
+};
+
+static_assert(sizeof(TRACE_EVENT_NAMES) / sizeof(TRACE_EVENT_NAMES[0]) == static_cast<size_t>(TraceEventType::COUNT),
+              "every trace event needs a name");
+
+/// Symbol texts are padded to this many bytes in the file
+constexpr size_t TEXT_ALIGNMENT = 8;
+
+/// Symbol ids up to this are accepted from any trace file, however short
+constexpr uint64_t MIN_SYMBOL_ID_LIMIT = 1 << 16;
+
+int64_t steadyNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct ThreadBuffer;
+
+/**
+ * @struct TraceFile
+ * @brief Open trace file and the buffers of the threads recording into it
+ */
+struct TraceFile {
+    std::mutex mutex;                       ///< Guards everything but the atomics
+    std::ofstream out;                      ///< Trace file
+    std::vector<bool> defined;              ///< Symbol ids already written to the file
+    std::vector<ThreadBuffer*> buffers;     ///< Buffers of live recording threads
+    std::string scratch;                    ///< Bytes of the batch being written
+    std::atomic<int64_t> start{0};          ///< Steady clock time of open(), in nanoseconds
+    std::atomic<uint32_t> generation{0};    ///< Changes on every open(), invalidating old buffers
+    std::atomic<uint32_t> nextThread{0};    ///< Index of the next thread to record
+};
+
+TraceFile& traceFile() {
+    static TraceFile file;
+    return file;
+}
+
+void writeBufferLocked(TraceFile& file, ThreadBuffer& buffer);
+
+/**
+ * @struct ThreadBuffer
+ * @brief Records of one thread not yet written to the file
+ */
+struct ThreadBuffer {
+    std::vector<TraceRecord> records;   ///< Pending records
+    uint32_t thread = 0;                ///< Index written into the records
+    uint32_t generation = 0;            ///< Trace the records belong to
+
+    ThreadBuffer() {
+        TraceFile& file = traceFile();
+        thread = file.nextThread.fetch_add(1, std::memory_order_relaxed);
+        records.reserve(Trace::BUFFER_RECORDS);
+        std::lock_guard<std::mutex> lock(file.mutex);
+        file.buffers.push_back(this);
+    }
+
+    ~ThreadBuffer() {
+        TraceFile& file = traceFile();
+        std::lock_guard<std::mutex> lock(file.mutex);
+        writeBufferLocked(file, *this);
+        file.buffers.erase(std::remove(file.buffers.begin(), file.buffers.end(), this), file.buffers.end());
+    }
+};
+
+ThreadBuffer& threadBuffer() {
+    thread_local ThreadBuffer buffer;
+    return buffer;
+}
+
+void defineSymbolLocked(TraceFile& file, uint32_t id, uint32_t thread, uint64_t time) {
+    if (id == 0) {
+        return;
+    }
+    if (id >= file.defined.size()) {
+        file.defined.resize(std::max<size_t>(id + 1, file.defined.size() * 2), false);
+    }
+    if (file.defined[id]) {
+        return;
+    }
+    file.defined[id] = true;
+
+    const std::string& text = Symbol(id).str();
+    size_t length = std::min<size_t>(text.size(), std::numeric_limits<uint16_t>::max());
+
+    TraceRecord record;
+    record.time = time;
+    record.thread = thread;
+    record.type = static_cast<uint16_t>(TraceEventType::SYMBOL);
+    record.length = static_cast<uint16_t>(length);
+    record.subject = id;
+    file.scratch.append(reinterpret_cast<const char*>(&record), sizeof(record));
+    file.scratch.append(text.data(), length);
+    file.scratch.append((TEXT_ALIGNMENT - length % TEXT_ALIGNMENT) % TEXT_ALIGNMENT, '\0');
+}
+
+void writeBufferLocked(TraceFile& file, ThreadBuffer& buffer) {
+    if (buffer.records.empty()) {
+        return;
+    }
+    // Records of a trace that has since been closed are dropped
+    if (file.out.is_open() && buffer.generation == file.generation.load(std::memory_order_relaxed)) {
+        file.scratch.clear();
+        for (const TraceRecord& record : buffer.records) {
+            defineSymbolLocked(file, record.subject, record.thread, record.time);
+            defineSymbolLocked(file, record.object, record.thread, record.time);
+            file.scratch.append(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+        file.out.write(file.scratch.data(), static_cast<std::streamsize>(file.scratch.size()));
+    }
+    buffer.records.clear();
+}
+
+} // namespace
+
+const char* traceEventName(TraceEventType type) {
+    size_t index = static_cast<size_t>(type);
+    return index < static_cast<size_t>(TraceEventType::COUNT) ? TRACE_EVENT_NAMES[index] : "UNKNOWN";
+}
+
+bool Trace::open(const std::string& path) {
+    close();
+
+    TraceFile& file = traceFile();
+    std::lock_guard<std::mutex> lock(file.mutex);
+    file.out.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.out) {
+        LOG_ERROR("trace", "Failed to open trace file: " + path);
+        return false;
+    }
+
+    TraceFileHeader header;
+    file.out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.defined.assign(file.defined.size(), false);
+    file.start.store(steadyNanoseconds(), std::memory_order_relaxed);
+    file.generation.fetch_add(1, std::memory_order_relaxed);
+    enabled_.store(true, std::memory_order_release);
+    LOG_INFO("trace", "Tracing to " + path);
+    return true;
+}
+
+void Trace::close() {
+    enabled_.store(false, std::memory_order_release);
+
+    TraceFile& file = traceFile();
+    std::lock_guard<std::mutex> lock(file.mutex);
+    if (!file.out.is_open()) {
+        return;
+    }
+    for (ThreadBuffer* buffer : file.buffers) {
+        writeBufferLocked(file, *buffer);
+    }
+    file.out.close();
+}
+
+void Trace::flush() {
+    TraceFile& file = traceFile();
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(file.mutex);
+    writeBufferLocked(file, buffer);
+    if (file.out.is_open()) {
+        file.out.flush();
+    }
+}
+
+void Trace::record(TraceEventType type, Symbol subject, Symbol object, int32_t a, int32_t b) {
+    TraceFile& file = traceFile();
+    ThreadBuffer& buffer = threadBuffer();
+
+    uint32_t generation = file.generation.load(std::memory_order_relaxed);
+    if (buffer.generation != generation) {
+        buffer.records.clear();
+        buffer.generation = generation;
+    }
+
+    TraceRecord record;
+    record.time = static_cast<uint64_t>(steadyNanoseconds() - file.start.load(std::memory_order_relaxed));
+    record.thread = buffer.thread;
+    record.type = static_cast<uint16_t>(type);
+    record.subject = subject.getId();
+    record.object = object.getId();
+    record.a = a;
+    record.b = b;
+    buffer.records.push_back(record);
+
+    if (buffer.records.size() >= BUFFER_RECORDS) {
+        std::lock_guard<std::mutex> lock(file.mutex);
+        writeBufferLocked(file, buffer);
+    }
+}
+
+bool TraceReader::open(const std::string& path) {
+    symbols_.clear();
+    error_.clear();
+    in_.close();
+    in_.open(path, std::ios::binary);
+    if (!in_) {
+        error_ = "cannot open " + path;
+        return false;
+    }
+
+    TraceFileHeader expected;
+    TraceFileHeader header;
+    if (!in_.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0) {
+        error_ = path + " is not a trace file";
+        return false;
+    }
+    if (header.version != expected.version || header.recordSize != expected.recordSize ||
+        header.byteOrder != expected.byteOrder) {
+        error_ = path + " was written by an incompatible build";
+        return false;
+    }
+
+    // Symbol ids index a vector, so a corrupt id must not size it; real ids stay far below
+    // the file size, with a floor for short traces of long-running processes
+    std::error_code sizeError;
+    uint64_t fileSize = std::filesystem::file_size(path, sizeError);
+    maxSymbolId_ = std::max<uint64_t>(sizeError ? 0 : fileSize, MIN_SYMBOL_ID_LIMIT);
+    return true;
+}
+
+bool TraceReader::next(TraceRecord& record) {
+    while (in_.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        if (record.type != static_cast<uint16_t>(TraceEventType::SYMBOL)) {
+            return true;
+        }
+
+        size_t padded = (record.length + TEXT_ALIGNMENT - 1) / TEXT_ALIGNMENT * TEXT_ALIGNMENT;
+        std::string text(padded, '\0');
+        if (!in_.read(&text[0], static_cast<std::streamsize>(padded))) {
+            break;
+        }
+        text.resize(record.length);
+        if (record.subject > maxSymbolId_) {
+            error_ = "symbol id " + std::to_string(record.subject) + " out of range";
+            return false;
+        }
+        if (record.subject >= symbols_.size()) {
+            symbols_.resize(record.subject + 1);
+        }
+        symbols_[record.subject] = std::move(text);
+    }
+
+    if (in_.gcount() != 0) {
+        error_ = "truncated record";
+    }
+    return false;
+}
+
+const std::string& TraceReader::symbol(uint32_t id) const {
+    static const std::string EMPTY;
+    return id < symbols_.size() ? symbols_[id] : EMPTY;
+}
+
+} // namespace util
+} // namespace deckstiny
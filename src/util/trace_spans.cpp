@@ -0,0 +1,203 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "util/trace_spans.h"
+#include "util/logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+namespace deckstiny {
+namespace util {
+
+std::atomic<bool> SpanTrace::enabled_{false};
+
+namespace {
+
+/**
+ * @struct Span
+ * @brief One finished span
+ */
+struct Span {
+    const char* category;   ///< Category literal
+    const char* name;       ///< Name literal
+    int64_t start;          ///< Start, nanoseconds on the span clock
+    int64_t end;            ///< End, nanoseconds on the span clock
+};
+
+struct ThreadSpans;
+
+/**
+ * @struct SpanCapture
+ * @brief State of the running capture and the buffers recording into it
+ */
+struct SpanCapture {
+    std::mutex mutex;                           ///< Guards everything but the atomics
+    std::vector<ThreadSpans*> buffers;          ///< Buffers of live threads
+    std::vector<std::pair<uint32_t, std::vector<Span>>> retired;  ///< Spans of exited threads, by thread
+    std::atomic<int64_t> start{0};              ///< Time of start()
+    std::atomic<uint32_t> generation{0};        ///< Changes on every start(), invalidating old buffers
+    std::atomic<uint32_t> nextThread{0};        ///< Index of the next thread to record
+    std::atomic<uint64_t> dropped{0};           ///< Spans over MAX_THREAD_SPANS
+};
+
+SpanCapture& spanCapture() {
+    static SpanCapture capture;
+    return capture;
+}
+
+/**
+ * @struct ThreadSpans
+ * @brief Spans of one thread
+ */
+struct ThreadSpans {
+    std::vector<Span> spans;    ///< Finished spans of the current capture
+    uint32_t thread = 0;        ///< Thread id written to the JSON
+    uint32_t generation = 0;    ///< Capture the spans belong to
+
+    ThreadSpans() {
+        SpanCapture& capture = spanCapture();
+        thread = capture.nextThread.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(capture.mutex);
+        capture.buffers.push_back(this);
+    }
+
+    ~ThreadSpans() {
+        SpanCapture& capture = spanCapture();
+        std::lock_guard<std::mutex> lock(capture.mutex);
+        if (!spans.empty() && generation == capture.generation.load(std::memory_order_relaxed)) {
+            capture.retired.emplace_back(thread, std::move(spans));
+        }
+        capture.buffers.erase(std::remove(capture.buffers.begin(), capture.buffers.end(), this),
+                              capture.buffers.end());
+    }
+};
+
+ThreadSpans& threadSpans() {
+    thread_local ThreadSpans buffer;
+    return buffer;
+}
+
+/// JSON string contents with quotes, backslashes and control characters escaped
+void appendEscaped(std::string& out, const char* text) {
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out += '\\';
+            out += *c;
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(*c));
+            out += escaped;
+        } else {
+            out += *c;
+        }
+    }
+}
+
+/// Complete ("X") event; Chrome trace times are microseconds
+void appendSpan(std::string& out, uint32_t thread, const Span& span, int64_t origin) {
+    char times[96];
+    std::snprintf(times, sizeof(times), "\"ts\":%.3f,\"dur\":%.3f",
+                  static_cast<double>(span.start - origin) / 1000.0,
+                  static_cast<double>(span.end - span.start) / 1000.0);
+    out += "{\"name\":\"";
+    appendEscaped(out, span.name);
+    out += "\",\"cat\":\"";
+    appendEscaped(out, span.category);
+    out += "\",\"ph\":\"X\",";
+    out += times;
+    out += ",\"pid\":1,\"tid\":" + std::to_string(thread) + "},\n";
+}
+
+void appendThreadName(std::string& out, uint32_t thread) {
+    out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(thread) +
+           ",\"args\":{\"name\":\"thread " + std::to_string(thread) + "\"}},\n";
+}
+
+} // namespace
+
+int64_t SpanTrace::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SpanTrace::start() {
+    SpanCapture& capture = spanCapture();
+    std::lock_guard<std::mutex> lock(capture.mutex);
+    capture.retired.clear();
+    capture.dropped.store(0, std::memory_order_relaxed);
+    capture.start.store(now(), std::memory_order_relaxed);
+    capture.generation.fetch_add(1, std::memory_order_relaxed);
+    enabled_.store(true, std::memory_order_release);
+}
+
+bool SpanTrace::stop(const std::string& path) {
+    enabled_.store(false, std::memory_order_release);
+
+    SpanCapture& capture = spanCapture();
+    std::lock_guard<std::mutex> lock(capture.mutex);
+    uint32_t generation = capture.generation.load(std::memory_order_relaxed);
+    int64_t origin = capture.start.load(std::memory_order_relaxed);
+
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    size_t count = 0;
+    auto appendThread = [&](uint32_t thread, const std::vector<Span>& spans) {
+        appendThreadName(out, thread);
+        for (const Span& span : spans) {
+            appendSpan(out, thread, span, origin);
+        }
+        count += spans.size();
+    };
+    for (ThreadSpans* buffer : capture.buffers) {
+        if (buffer->generation == generation && !buffer->spans.empty()) {
+            appendThread(buffer->thread, buffer->spans);
+        }
+        buffer->spans.clear();
+    }
+    for (const auto& [thread, spans] : capture.retired) {
+        appendThread(thread, spans);
+    }
+    capture.retired.clear();
+
+    // Drop the separator after the last event
+    if (out.size() >= 2 && out.compare(out.size() - 2, 2, ",\n") == 0) {
+        out.erase(out.size() - 2, 1);
+    }
+    out += "]}\n";
+
+    uint64_t dropped = capture.dropped.load(std::memory_order_relaxed);
+    if (dropped > 0) {
+        LOG_WARNING("trace", "Dropped " + std::to_string(dropped) + " spans over the per-thread limit");
+    }
+
+    std::ofstream file(path, std::ios::trunc);
+    if (!file || !(file << out)) {
+        LOG_ERROR("trace", "Failed to write span trace: " + path);
+        return false;
+    }
+    LOG_INFO("trace", "Wrote " + std::to_string(count) + " spans to " + path);
+    return true;
+}
+
+void SpanTrace::record(const char* category, const char* name, int64_t start, int64_t end) {
+    SpanCapture& capture = spanCapture();
+    ThreadSpans& buffer = threadSpans();
+
+    uint32_t generation = capture.generation.load(std::memory_order_relaxed);
+    if (buffer.generation != generation) {
+        buffer.spans.clear();
+        buffer.generation = generation;
+    }
+    if (buffer.spans.size() >= MAX_THREAD_SPANS) {
+        capture.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer.spans.push_back(Span{category, name, start, end});
+}
+
+} // namespace util
+} // namespace deckstiny
@@ -0,0 +1,116 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include "util/work_stealing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace deckstiny {
+namespace util {
+
+namespace {
+
+/**
+ * @struct Slice
+ * @brief Part of the range still owned by one worker
+ */
+struct Slice {
+    std::mutex mutex;   ///< Protects begin and end
+    size_t begin = 0;   ///< First unclaimed index
+    size_t end = 0;     ///< One past the last unclaimed index
+};
+
+} // namespace
+
+WorkStealingScheduler::WorkStealingScheduler(size_t threadCount)
+    : threadCount_(threadCount) {
+    if (threadCount_ == 0) {
+        threadCount_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+void WorkStealingScheduler::run(size_t count, size_t grain, const Body& body) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    size_t workers = std::min(threadCount_, (count + grain - 1) / grain);
+
+    std::unique_ptr<Slice[]> slices(new Slice[workers]);
+    for (size_t i = 0; i < workers; ++i) {
+        slices[i].begin = count * i / workers;
+        slices[i].end = count * (i + 1) / workers;
+    }
+
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto work = [&](size_t self) {
+        Slice& own = slices[self];
+        while (!failed.load(std::memory_order_relaxed)) {
+            size_t begin = 0;
+            size_t end = 0;
+            {
+                std::lock_guard<std::mutex> lock(own.mutex);
+                begin = own.begin;
+                end = std::min(own.end, begin + grain);
+                own.begin = end;
+            }
+
+            if (begin == end) {
+                // Own slice is empty: take the back half of the first busy worker's slice
+                for (size_t offset = 1; offset < workers && begin == end; ++offset) {
+                    Slice& victim = slices[(self + offset) % workers];
+                    std::lock_guard<std::mutex> lock(victim.mutex);
+                    size_t remaining = victim.end - victim.begin;
+                    if (remaining > 0) {
+                        begin = victim.end - (remaining + 1) / 2;
+                        end = victim.end;
+                        victim.end = begin;
+                    }
+                }
+                if (begin == end) {
+                    return;
+                }
+                std::lock_guard<std::mutex> lock(own.mutex);
+                own.begin = begin;
+                own.end = end;
+                continue;
+            }
+
+            try {
+                body(self, begin, end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (size_t i = 1; i < workers; ++i) {
+        threads.emplace_back(work, i);
+    }
+    work(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace util
+} // namespace deckstiny
@@ -0,0 +1,133 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include <gtest/gtest.h>
+#include "util/bench_compare.h"
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace deckstiny {
+namespace testing {
+
+class BenchCompareTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        for (const auto& path : files) {
+            std::filesystem::remove(path);
+        }
+    }
+
+    // Write Google Benchmark output with one repetition entry per time and a median aggregate
+    std::string writeResults(const std::string& fileName,
+                             const std::vector<std::pair<std::string, std::vector<double>>>& benchmarks,
+                             const std::string& timeUnit = "ns") {
+        nlohmann::json entries = nlohmann::json::array();
+        for (const auto& [name, times] : benchmarks) {
+            for (size_t i = 0; i < times.size(); ++i) {
+                entries.push_back({{"name", name}, {"run_name", name}, {"run_type", "iteration"},
+                                   {"repetition_index", i}, {"real_time", times[i]}, {"cpu_time", times[i] / 2},
+                                   {"time_unit", timeUnit}, {"allocs/op", 3.0}});
+            }
+            entries.push_back({{"name", name + "_median"}, {"run_name", name}, {"run_type", "aggregate"},
+                               {"real_time", 1e9}, {"cpu_time", 1e9}, {"time_unit", timeUnit}});
+        }
+
+        std::filesystem::path path = std::filesystem::temp_directory_path() / fileName;
+        std::ofstream(path) << nlohmann::json{{"context", nlohmann::json::object()}, {"benchmarks", entries}}.dump();
+        files.push_back(path);
+        return path.string();
+    }
+
+    std::vector<std::filesystem::path> files;
+};
+
+// Test the robust statistics on odd, even and degenerate inputs
+TEST_F(BenchCompareTest, MedianAndMad) {
+    EXPECT_DOUBLE_EQ(util::median({}), 0.0);
+    EXPECT_DOUBLE_EQ(util::median({5, 1, 3}), 3.0);
+    EXPECT_DOUBLE_EQ(util::median({4, 1, 3, 2}), 2.5);
+    EXPECT_DOUBLE_EQ(util::medianAbsoluteDeviation({7}), 0.0);
+    // Deviations from 3 are 2, 1, 0, 1, 97: median 1, unaffected by the outlier
+    EXPECT_DOUBLE_EQ(util::medianAbsoluteDeviation({1, 2, 3, 4, 100}), 1.0);
+}
+
+// Test that repetitions are read, aggregates skipped and units converted to nanoseconds
+TEST_F(BenchCompareTest, LoadsRepetitions) {
+    util::BenchmarkResults results;
+    ASSERT_TRUE(results.load(writeResults("bench_compare_us.json", {{"BM_A", {1.0, 2.0, 3.0}}}, "us")))
+        << results.getError();
+    ASSERT_EQ(results.getBenchmarks().size(), 1u);
+    const util::BenchmarkSamples& samples = results.getBenchmarks().at("BM_A");
+    EXPECT_EQ(samples.times, (std::vector<double>{1000.0, 2000.0, 3000.0}));
+    EXPECT_EQ(samples.allocations.size(), 3u);
+
+    ASSERT_TRUE(results.load(files.back().string(), true));
+    EXPECT_DOUBLE_EQ(results.getBenchmarks().at("BM_A").times[0], 500.0);
+
+    EXPECT_FALSE(results.load("/nonexistent/bench.json"));
+    EXPECT_FALSE(results.getError().empty());
+
+    // Google Benchmark writes bare NaN for counters of some aggregates
+    std::filesystem::path raw = std::filesystem::temp_directory_path() / "bench_compare_nan.json";
+    files.push_back(raw);
+    std::ofstream(raw) << R"({"benchmarks": [
+        {"name": "BM_NaN", "run_name": "BM_NaN", "run_type": "iteration", "real_time": 7, "time_unit": "ns"},
+        {"name": "BM_NaN_cv", "run_name": "BM_NaN", "run_type": "aggregate", "real_time": NaN, "allocs/op": -Infinity}
+    ]})";
+    ASSERT_TRUE(results.load(raw.string())) << results.getError();
+    EXPECT_EQ(results.getBenchmarks().at("BM_NaN").times, std::vector<double>{7.0});
+}
+
+// Test that only changes beyond both the threshold and the noise are verdicts
+TEST_F(BenchCompareTest, ClassifiesChanges) {
+    util::BenchmarkResults baseline;
+    util::BenchmarkResults current;
+    ASSERT_TRUE(baseline.load(writeResults("bench_compare_base.json", {
+        {"BM_Same", {100, 101, 99, 100, 100}},
+        {"BM_Slower", {100, 101, 99, 100, 100}},
+        {"BM_Faster", {100, 101, 99, 100, 100}},
+        {"BM_Noisy", {100, 60, 140, 100, 80}},
+        {"BM_Gone", {100}}
+    })));
+    ASSERT_TRUE(current.load(writeResults("bench_compare_new.json", {
+        {"BM_Same", {102, 103, 101, 102, 102}},
+        {"BM_Slower", {120, 121, 119, 120, 120}},
+        {"BM_Faster", {80, 81, 79, 80, 80}},
+        {"BM_Noisy", {120, 80, 160, 120, 100}},
+        {"BM_New", {100}}
+    })));
+
+    util::BenchmarkCompareOptions options;
+    options.threshold = 0.05;
+    std::vector<util::BenchmarkComparison> comparisons = util::compareBenchmarks(baseline, current, options);
+    ASSERT_EQ(comparisons.size(), 6u);
+
+    std::map<std::string, util::BenchmarkComparison> byName;
+    for (const auto& comparison : comparisons) {
+        byName[comparison.name] = comparison;
+    }
+    EXPECT_EQ(byName["BM_Same"].verdict, util::BenchmarkVerdict::UNCHANGED);
+    EXPECT_EQ(byName["BM_Slower"].verdict, util::BenchmarkVerdict::SLOWER);
+    EXPECT_NEAR(byName["BM_Slower"].change, 0.2, 1e-9);
+    EXPECT_EQ(byName["BM_Slower"].repetitions, 5u);
+    EXPECT_DOUBLE_EQ(byName["BM_Slower"].currentAllocations, 3.0);
+    EXPECT_EQ(byName["BM_Faster"].verdict, util::BenchmarkVerdict::FASTER);
+    EXPECT_EQ(byName["BM_Noisy"].verdict, util::BenchmarkVerdict::NOISY);
+    EXPECT_GT(byName["BM_Noisy"].noise, byName["BM_Noisy"].change);
+    EXPECT_EQ(byName["BM_Gone"].verdict, util::BenchmarkVerdict::REMOVED);
+    EXPECT_EQ(byName["BM_New"].verdict, util::BenchmarkVerdict::ADDED);
+
+    // A wider threshold absorbs the regression
+    options.threshold = 0.25;
+    for (const auto& comparison : util::compareBenchmarks(baseline, current, options)) {
+        EXPECT_NE(comparison.verdict, util::BenchmarkVerdict::SLOWER) << comparison.name;
+    }
+}
+
+} // namespace testing
+} // namespace deckstiny
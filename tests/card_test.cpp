@@ -130,5 +130,73 @@ TEST_F(CardTest, CardTargeting) {
     EXPECT_TRUE(selfTargetCard->canPlay(player.get(), -1, combat.get())); // No target (defaults to self)
 }
 
+// Test effect program compiled from JSON
+TEST_F(CardTest, EffectProgramFromJson) {
+    nlohmann::json cardJson = {
+        {"id", "bash"},
+        {"name", "Bash"},
+        {"type", "ATTACK"},
+        {"target", "SINGLE_ENEMY"},
+        {"cost", 2},
+        {"effects", {
+            {{"type", "damage"}, {"value", 8}, {"target", "enemy"}, {"upgraded_value", 10}},
+            {{"type", "status_effect"}, {"effect", "vulnerable"}, {"value", 2}, {"target", "enemy"}, {"upgraded_value", 3}}
+        }}
+    };
+
+    Card bash;
+    ASSERT_TRUE(bash.loadFromJson(cardJson));
+    ASSERT_TRUE(bash.hasEffectProgram());
+    ASSERT_EQ(bash.getEffects().size(), 2u);
+
+    EXPECT_EQ(bash.getEffects()[0].op, CardEffectOp::DAMAGE_TARGET);
+    EXPECT_EQ(bash.getEffects()[0].value, 8);
+    EXPECT_EQ(bash.getEffects()[1].op, CardEffectOp::STATUS_TARGET);
+    EXPECT_EQ(bash.getEffects()[1].status, "vulnerable");
+    EXPECT_EQ(bash.getEffects()[1].value, 2);
+
+    // Upgrading switches the program to the upgraded values
+    EXPECT_TRUE(bash.upgrade());
+    EXPECT_EQ(bash.getEffects()[0].value, 10);
+    EXPECT_EQ(bash.getEffects()[1].value, 3);
+
+    // Play the card without touching the data directory
+    auto combat = std::make_shared<Combat>(player.get());
+    combat->addEnemy(enemy);
+    player->addCardToDeck(bash.cloneCard());
+    player->beginCombat();
+    combat->start();
+
+    ASSERT_EQ(player->getHand().size(), 1u);
+    EXPECT_TRUE(combat->playCard(0, 0));
+    EXPECT_EQ(enemy->getHealth(), 40);
+    EXPECT_EQ(enemy->getStatusEffect("vulnerable"), 3);
+}
+
+// Test that clones share one definition while keeping their own state
+TEST_F(CardTest, SharedDefinition) {
+    auto copy = card->cloneCard();
+    EXPECT_EQ(copy->getDef(), card->getDef());
+
+    // Upgrading is per-instance and does not touch the definition
+    copy->upgrade();
+    EXPECT_TRUE(copy->isUpgraded());
+    EXPECT_FALSE(card->isUpgraded());
+    EXPECT_EQ(copy->getName(), "Test Card+");
+    EXPECT_EQ(card->getName(), "Test Card");
+    EXPECT_EQ(copy->getDef(), card->getDef());
+
+    // Setters detach the modified card from the shared definition
+    card->setName("Renamed Card");
+    EXPECT_NE(copy->getDef(), card->getDef());
+    EXPECT_EQ(copy->getName(), "Test Card+");
+
+    // Combat cost modifiers are cleared at the end of combat
+    card->setCombatCostModifier(-1);
+    EXPECT_EQ(card->getCost(), 0);
+    card->resetCombatState();
+    EXPECT_EQ(card->getCost(), 1);
+}
+
 } // namespace testing
 } // namespace deckstiny 
\ No newline at end of file
@@ -3,11 +3,15 @@
 
 #include <gtest/gtest.h>
 #include "core/character.h"
+#include "core/combat_state.h"
 #include "core/player.h"
 #include "core/enemy.h"
 #include "core/card.h"
 #include "core/relic.h"
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace deckstiny {
 namespace testing {
@@ -131,6 +135,61 @@ TEST_F(CharacterTest, StatusEffects) {
     EXPECT_EQ(character->getStatusEffect("Weak"), 0); // Not present
 }
 
+// Test that interned status effects and their string adapters agree
+TEST_F(CharacterTest, StatusEffectSymbols) {
+    EXPECT_EQ(util::Symbol::intern("weak"), util::symbols::WEAK);
+    EXPECT_EQ(util::symbols::WEAK.str(), "weak");
+    EXPECT_EQ(util::Symbol::intern("character_test_effect"), util::Symbol::intern("character_test_effect"));
+    EXPECT_FALSE(util::Symbol::find("character_test_never_interned").isValid());
+
+    character->addStatusEffect(util::symbols::WEAK, 2);
+    character->addStatusEffect("weak", 1);
+    EXPECT_EQ(character->getStatusEffect("weak"), 3);
+    EXPECT_EQ(character->getStatusEffect(util::symbols::WEAK), 3);
+    EXPECT_FALSE(character->hasStatusEffect("character_test_never_interned"));
+
+    character->addStatusEffect(util::symbols::WEAK, -3);
+    EXPECT_FALSE(character->hasStatusEffect("weak"));
+
+    // Zero stacks of an effect the character does not have add no entry
+    character->addStatusEffect("character_test_zero", 0);
+    CharacterState state;
+    ASSERT_TRUE(character->saveState(state));
+    EXPECT_EQ(state.customCount, 0u);
+    EXPECT_EQ(character->getIdSymbol().str(), "ironclad");
+}
+
+// Test that status effects are listed in a stable order
+TEST_F(CharacterTest, StatusEffectOrder) {
+    character->addStatusEffect("character_test_custom", 1);
+    character->addStatusEffect("strength", 2);
+    character->addStatusEffect(StatusEffect::WEAK, 1);
+    character->addStatusEffect("character_test_other", 4);
+
+    std::vector<std::string> names;
+    for (const auto& effect : character->getStatusEffects()) {
+        names.push_back(effect.first);
+    }
+    EXPECT_EQ(names, (std::vector<std::string>{"weak", "strength", "character_test_custom", "character_test_other"}));
+
+    // Expired custom effects keep their place when reapplied
+    character->addStatusEffect("character_test_custom", -1);
+    EXPECT_FALSE(character->hasStatusEffect("character_test_custom"));
+    EXPECT_EQ(character->getStatusEffects().size(), 3u);
+    character->addStatusEffect("character_test_custom", 5);
+    auto effects = character->getStatusEffects();
+    ASSERT_EQ(effects.size(), 4u);
+    EXPECT_EQ((effects.begin() + 2)->first, "character_test_custom");
+    EXPECT_EQ(effects.at("character_test_custom"), 5);
+    EXPECT_THROW(effects.at("vulnerable"), std::out_of_range);
+
+    // Removing more stacks than present clears the effect
+    character->addStatusEffect(StatusEffect::STRENGTH, -10);
+    EXPECT_EQ(character->getStatusEffect("strength"), 0);
+    character->addStatusEffect(StatusEffect::STRENGTH, 1);
+    EXPECT_EQ(character->getStatusEffect(StatusEffect::STRENGTH), 1);
+}
+
 // Player-specific tests
 class PlayerTest : public ::testing::Test {
 protected:
@@ -6,11 +6,18 @@
 #include "core/player.h"
 #include "core/enemy.h"
 #include "core/card.h"
+#include "core/combat_journal.h"
+#include "core/combat_state.h"
 #include "core/game.h"
 #include "ui/ui_interface.h"
 #include "mocks/MockUI.h"
 #include "util/logger.h"
+#include "util/rng.h"
+#include "util/trace.h"
+#include <filesystem>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace deckstiny {
 namespace testing {
@@ -61,7 +68,7 @@ protected:
         
         // Create the combat instance
         combat = std::make_unique<Combat>(player.get()); // Construct with player
-        combat->setGame(game.get()); // Set the game instance
+        combat->setHost(game.get()); // Set the game as content host
         combat->addEnemy(enemy);
 
         // Initialize player for combat (draws initial hand, sets energy)
@@ -239,6 +246,46 @@ TEST_F(CombatTest, DelayedActions) {
     EXPECT_TRUE(delayedActionExecuted);
 }
 
+// Test delayed action ordering on the timing wheel
+TEST_F(CombatTest, DelayedActionOrder) {
+    combat->start();
+
+    // Fixed source tags are interned once; text tags are interned per call
+    const util::Symbol low = util::Symbol::intern("low");
+    const util::Symbol high = util::Symbol::intern("high");
+    std::vector<int> order;
+    combat->addDelayedAction([&order]() { order.push_back(1); }, 0, 0, low);
+    combat->addDelayedAction([&order]() { order.push_back(2); }, 0, 5, high);
+    combat->addDelayedAction([&order]() { order.push_back(3); }, 0, 0, low);
+    combat->addDelayedAction([&order]() { order.push_back(4); }, 1, 9, "next");
+
+    // Same tick: highest priority first, ties in scheduling order
+    combat->processDelayedActions();
+    EXPECT_EQ(order, (std::vector<int>{2, 1, 3}));
+    combat->processDelayedActions();
+    EXPECT_EQ(order, (std::vector<int>{2, 1, 3, 4}));
+
+    // A delay longer than the wheel waits for its own tick, not the slot's
+    const int longDelay = static_cast<int>(DelayedActionWheel::SLOT_COUNT) + 2;
+    bool longActionExecuted = false;
+    combat->addDelayedAction([&longActionExecuted]() { longActionExecuted = true; }, longDelay);
+    for (int i = 0; i < longDelay; ++i) {
+        combat->processDelayedActions();
+    }
+    EXPECT_FALSE(longActionExecuted);
+    combat->processDelayedActions();
+    EXPECT_TRUE(longActionExecuted);
+
+    // An action scheduled with no delay while the wheel runs still runs this tick
+    bool chainedActionExecuted = false;
+    Combat* target = combat.get();
+    combat->addDelayedAction([target, &chainedActionExecuted]() {
+        target->addDelayedAction([&chainedActionExecuted]() { chainedActionExecuted = true; });
+    });
+    combat->processDelayedActions();
+    EXPECT_TRUE(chainedActionExecuted);
+}
+
 TEST_F(CombatTest, PlayerDealsDamageWithStrike) {
     combat->start(); // Start combat, player draws, enemy picks intent
     ASSERT_TRUE(player->getHand().size() > 0) << "Player should have cards in hand.";
@@ -317,5 +364,253 @@ TEST_F(CombatTest, PlayerPlaysUpgradedStrike) {
     EXPECT_EQ(enemy->getHealth(), enemyInitialHealth - expectedUpgradedDamage);
 }
 
+// Test that enemy moves are compiled at load time and run without JSON
+TEST_F(CombatTest, CompiledEnemyMoves) {
+    nlohmann::json enemyJson = {
+        {"id", "test_compiled"},
+        {"name", "Compiled Enemy"},
+        {"max_health", 30},
+        {"moves", {
+            {{"id", "bite"}, {"intent", {{"type", "attack_debuff"}, {"value", 6}, {"secondary_value", 2}, {"effect", "weak"}}}},
+            {{"id", "grow"}, {"intent", {{"type", "buff"}, {"value", 3}, {"effect", "strength"}, {"secondary_value", 4}}}},
+            {{"id", "call"}, {"effects", {{{"type", "summon"}, {"summon_type", "louse"}}}}, {"intent", {{"type", "summon"}, {"value", 1}}}}
+        }}
+    };
+    Enemy compiled;
+    ASSERT_TRUE(compiled.loadFromJson(enemyJson));
+    ASSERT_EQ(compiled.getPossibleMoves(), (std::vector<std::string>{"bite", "grow", "call"}));
+
+    EnemyMove bite = Enemy::compileMove("bite", {"attack_debuff", IntentKind::UNKNOWN, 6, 2, "player", "weak", util::Symbol()});
+    EXPECT_EQ(bite.intent.kind, IntentKind::ATTACK_DEBUFF);
+    ASSERT_EQ(bite.program.size(), 2u);
+    EXPECT_EQ(bite.program[0].op, MoveOp::ATTACK);
+    EXPECT_EQ(bite.program[1].op, MoveOp::STATUS_PLAYER);
+    EXPECT_EQ(bite.program[1].symbol, util::symbols::WEAK);
+    EXPECT_EQ(bite.description, "Attack: 6, Debuff (weak 2)");
+
+    // Intents set directly are compiled the same way
+    Intent grow;
+    grow.type = "buff";
+    grow.value = 3;
+    grow.effect = "strength";
+    grow.secondaryValue = 4;
+    compiled.setIntent(grow);
+    EXPECT_EQ(compiled.getIntent().kind, IntentKind::BUFF);
+    EXPECT_EQ(compiled.getIntentDescription(), "Buff (strength +3)");
+    compiled.takeTurn(combat.get(), player.get());
+    EXPECT_EQ(compiled.getStatusEffect(StatusEffect::STRENGTH), 3);
+    EXPECT_EQ(compiled.getBlock(), 4);
+
+    Intent attack;
+    attack.type = "attack_debuff";
+    attack.value = 6;
+    attack.secondaryValue = 2;
+    attack.effect = "weak";
+    compiled.setIntent(attack);
+    int healthBefore = player->getHealth();
+    compiled.takeTurn(combat.get(), player.get());
+    EXPECT_EQ(player->getHealth(), healthBefore - 6);
+    EXPECT_EQ(player->getStatusEffect(StatusEffect::WEAK), 2);
+
+    // Clones share the compiled moves
+    auto copy = compiled.cloneEnemy();
+    EXPECT_EQ(copy->getPossibleMoves(), compiled.getPossibleMoves());
+    copy->chooseNextMove(combat.get(), player.get());
+    EXPECT_NE(copy->getIntent().kind, IntentKind::UNKNOWN);
+    EXPECT_FALSE(copy->getIntentDescription().empty());
+}
+
+// Test that restoring a snapshot rewinds the combat and replays identically
+TEST_F(CombatTest, SnapshotRestore) {
+    util::Rng aiRng(5);
+    util::Rng shuffleRng(6);
+    combat->setRng(&aiRng);
+    player->setShuffleRng(&shuffleRng);
+    auto jawWorm = game->loadEnemy("jaw_worm");
+    ASSERT_NE(jawWorm, nullptr);
+    combat->addEnemy(jawWorm);
+    combat->start();
+    player->addStatusEffect(StatusEffect::WEAK, 2);
+
+    auto playTurn = [this]() {
+        if (!player->getHand().empty()) {
+            combat->playCard(0, 1);
+        }
+        combat->endPlayerTurn();
+    };
+
+    CombatState saved;
+    ASSERT_TRUE(combat->snapshot(saved));
+    std::vector<std::shared_ptr<Card>> handBefore = player->getHand();
+
+    playTurn();
+    CombatState after;
+    ASSERT_TRUE(combat->snapshot(after));
+    EXPECT_EQ(combat->getTurn(), 2);
+
+    ASSERT_TRUE(combat->restore(saved));
+    EXPECT_EQ(combat->getTurn(), 1);
+    EXPECT_TRUE(combat->isPlayerTurn());
+    EXPECT_EQ(player->getHealth(), saved.player.health);
+    EXPECT_EQ(player->getEnergy(), 3);
+    EXPECT_EQ(player->getStatusEffect(StatusEffect::WEAK), 2);
+    EXPECT_EQ(player->getHand(), handBefore);
+    EXPECT_EQ(jawWorm->getHealth(), jawWorm->getMaxHealth());
+
+    // Same streams, same actions: the second branch ends where the first did
+    playTurn();
+    CombatState replay;
+    ASSERT_TRUE(combat->snapshot(replay));
+    EXPECT_EQ(replay.turn, after.turn);
+    EXPECT_EQ(replay.player.health, after.player.health);
+    EXPECT_EQ(replay.player.block, after.player.block);
+    EXPECT_EQ(replay.pileSizes, after.pileSizes);
+    EXPECT_EQ(replay.pileCards, after.pileCards);
+    ASSERT_EQ(replay.enemyCount, after.enemyCount);
+    for (size_t i = 0; i < replay.enemyCount; ++i) {
+        EXPECT_EQ(replay.enemies[i].character.health, after.enemies[i].character.health);
+        EXPECT_EQ(replay.enemies[i].currentMove, after.enemies[i].currentMove);
+    }
+
+    // States are plain values
+    CombatState copy = saved;
+    ASSERT_TRUE(combat->restore(copy));
+    EXPECT_EQ(player->getHand(), handBefore);
+}
+
+// Test that rolling the journal back undoes cards, turns, shuffles and enemy moves
+TEST_F(CombatTest, JournalRollback) {
+    util::Rng aiRng(5);
+    util::Rng shuffleRng(6);
+    combat->setRng(&aiRng);
+    player->setShuffleRng(&shuffleRng);
+    auto jawWorm = game->loadEnemy("jaw_worm");
+    ASSERT_NE(jawWorm, nullptr);
+    combat->addEnemy(jawWorm);
+    combat->start();
+
+    CombatJournal journal;
+    combat->setJournal(&journal);
+    EXPECT_EQ(player->getJournal(), &journal);
+    EXPECT_EQ(jawWorm->getJournal(), &journal);
+
+    CombatState before;
+    ASSERT_TRUE(combat->snapshot(before));
+    std::vector<std::shared_ptr<Card>> handBefore = player->getHand();
+    std::vector<std::shared_ptr<Card>> drawBefore = player->getDrawPile();
+    util::Rng aiBefore = aiRng;
+    util::Rng shuffleBefore = shuffleRng;
+    CombatJournal::Mark mark = journal.mark();
+
+    player->addStatusEffect("journal_test", 3);
+    for (int turn = 0; turn < 3; ++turn) {
+        for (size_t i = 0; i < player->getHand().size(); ++i) {
+            if (combat->playCard(static_cast<int>(i), 0)) {
+                break;
+            }
+        }
+        combat->endPlayerTurn();
+    }
+    EXPECT_GT(combat->getTurn(), 1);
+    EXPECT_GT(journal.size(), 0u);
+
+    journal.rollback(mark);
+    EXPECT_EQ(journal.size(), mark.entries);
+    CombatState after;
+    ASSERT_TRUE(combat->snapshot(after));
+    EXPECT_EQ(after.turn, before.turn);
+    EXPECT_EQ(after.playerTurn, before.playerTurn);
+    EXPECT_EQ(after.inCombat, before.inCombat);
+    EXPECT_EQ(after.player.health, before.player.health);
+    EXPECT_EQ(after.player.block, before.player.block);
+    EXPECT_EQ(after.player.energy, before.player.energy);
+    EXPECT_EQ(after.player.statusStacks, before.player.statusStacks);
+    EXPECT_EQ(after.player.customCount, before.player.customCount);
+    EXPECT_EQ(after.enemies[0].character.health, before.enemies[0].character.health);
+    EXPECT_EQ(after.enemies[0].character.statusStacks, before.enemies[0].character.statusStacks);
+    EXPECT_EQ(after.enemies[0].currentMove, before.enemies[0].currentMove);
+    EXPECT_EQ(after.pileSizes, before.pileSizes);
+    EXPECT_EQ(player->getHand(), handBefore);
+    EXPECT_EQ(player->getDrawPile(), drawBefore);
+    EXPECT_EQ(aiRng(), aiBefore());
+    EXPECT_EQ(shuffleRng(), shuffleBefore());
+
+    combat->setJournal(nullptr);
+    EXPECT_EQ(player->getJournal(), nullptr);
+    size_t recorded = journal.size();
+    player->takeDamage(1);
+    EXPECT_EQ(journal.size(), recorded);
+
+    // Marks taken before a clear are rejected
+    journal.clear();
+    EXPECT_FALSE(journal.rollback(mark));
+    EXPECT_TRUE(journal.rollback(journal.mark()));
+}
+
+// Test that the chosen move is traced under the symbol interned when it was compiled
+TEST_F(CombatTest, TracesChosenMove) {
+    auto jawWorm = game->loadEnemy("jaw_worm");
+    ASSERT_NE(jawWorm, nullptr);
+    const std::string path = (std::filesystem::temp_directory_path() / "deckstiny_intent_trace.bin").string();
+
+    ASSERT_TRUE(util::Trace::open(path));
+    jawWorm->chooseNextMove(combat.get(), player.get());
+    util::Trace::close();
+    const EnemyMove* chosen = jawWorm->getMove(static_cast<size_t>(jawWorm->getCurrentMoveIndex()));
+    ASSERT_NE(chosen, nullptr);
+    const EnemyMove& move = *chosen;
+    EXPECT_EQ(move.idSymbol, util::Symbol::intern(move.id));
+
+    util::TraceReader reader;
+    ASSERT_TRUE(reader.open(path)) << reader.getError();
+    util::TraceRecord record;
+    bool found = false;
+    while (reader.next(record)) {
+        if (record.type == static_cast<uint16_t>(util::TraceEventType::INTENT_CHOSEN)) {
+            EXPECT_EQ(reader.symbol(record.object), move.id);
+            found = true;
+        }
+    }
+    EXPECT_TRUE(found);
+    std::filesystem::remove(path);
+}
+
+// Test that actions scheduled while the wheel runs are journaled without the running batch
+TEST_F(CombatTest, JournalRollbackOfChainedDelayedActions) {
+    combat->start();
+    CombatJournal journal;
+    combat->setJournal(&journal);
+
+    int outerRuns = 0;
+    int innerRuns = 0;
+    CombatJournal::Mark innerMark;
+    Combat* target = combat.get();
+    combat->addDelayedAction([target, &journal, &innerMark, &outerRuns, &innerRuns]() {
+        ++outerRuns;
+        innerMark = journal.mark();
+        target->addDelayedAction([&innerRuns]() { ++innerRuns; }, 1);
+    });
+
+    CombatJournal::Mark mark = journal.mark();
+    combat->processDelayedActions();
+    EXPECT_EQ(outerRuns, 1);
+
+    // Undo only the action scheduled from inside the batch: the batch that
+    // ran must not come back
+    journal.rollback(innerMark);
+    combat->processDelayedActions();
+    combat->processDelayedActions();
+    EXPECT_EQ(outerRuns, 1);
+    EXPECT_EQ(innerRuns, 0);
+
+    // Undo the whole advance: the outer action is pending again
+    journal.rollback(mark);
+    combat->processDelayedActions();
+    combat->processDelayedActions();
+    EXPECT_EQ(outerRuns, 2);
+    EXPECT_EQ(innerRuns, 1);
+    combat->setJournal(nullptr);
+}
+
 } // namespace testing
 } // namespace deckstiny 
\ No newline at end of file
@@ -0,0 +1,180 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include <gtest/gtest.h>
+#include "util/content_pack.h"
+#include "util/path_util.h"
+#include "core/card.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <nlohmann/json.hpp>
+
+namespace deckstiny {
+namespace testing {
+
+class ContentPackTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        packPath = (std::filesystem::temp_directory_path() / "deckstiny_content_pack_test.pack").string();
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        std::filesystem::remove(packPath, ec);
+    }
+
+    std::string packPath;
+};
+
+// Test that documents survive a write/read round trip
+TEST_F(ContentPackTest, RoundTrip) {
+    nlohmann::json enemy = {
+        {"id", "jaw_worm"},
+        {"name", "Jaw Worm"},
+        {"is_elite", false},
+        {"health", 42},
+        {"offset", -3},
+        {"scale", 1.5},
+        {"note", nullptr},
+        {"moves", {
+            {{"id", "chomp"}, {"intent", {{"type", "attack"}, {"value", 11}}}},
+            {{"id", "bellow"}, {"intent", {{"type", "buff"}, {"value", 3}}}}
+        }}
+    };
+    nlohmann::json card = {{"id", "strike"}, {"name", "Strike"}, {"type", "ATTACK"}, {"cost", 1}};
+
+    util::ContentPackWriter writer;
+    writer.addRecord(util::ContentKind::ENEMY, "jaw_worm", enemy);
+    writer.addRecord(util::ContentKind::CARD, "strike", card);
+    ASSERT_TRUE(writer.writeToFile(packPath));
+
+    // Keys and values shared between records are stored only once:
+    // 12 distinct keys and 9 distinct string values
+    EXPECT_EQ(writer.getStringCount(), 21u);
+
+    util::ContentPack pack;
+    ASSERT_TRUE(pack.open(packPath));
+    ASSERT_EQ(pack.getRecordCount(), 2u);
+
+    EXPECT_EQ(pack.getRecordKind(0), util::ContentKind::ENEMY);
+    EXPECT_EQ(pack.getRecordId(0), "jaw_worm");
+    EXPECT_EQ(pack.getRecordKind(1), util::ContentKind::CARD);
+    EXPECT_EQ(pack.getRecordId(1), "strike");
+
+    nlohmann::json decoded;
+    ASSERT_TRUE(pack.decodeRecord(0, decoded));
+    EXPECT_EQ(decoded, enemy);
+    ASSERT_TRUE(pack.decodeRecord(1, decoded));
+    EXPECT_EQ(decoded, card);
+    EXPECT_FALSE(pack.decodeRecord(2, decoded));
+}
+
+// Test that files which are not packs are rejected
+TEST_F(ContentPackTest, RejectsInvalidFile) {
+    {
+        std::ofstream file(packPath, std::ios::binary);
+        file << "{\"id\": \"not a pack, just some json that is long enough\"}";
+    }
+
+    util::ContentPack pack;
+    EXPECT_FALSE(pack.open(packPath));
+    EXPECT_FALSE(pack.isOpen());
+    EXPECT_FALSE(pack.open(packPath + ".missing"));
+}
+
+// Test that header offsets which wrap around are rejected before they are read
+TEST_F(ContentPackTest, RejectsCorruptHeader) {
+    util::ContentPackWriter writer;
+    writer.addRecord(util::ContentKind::CARD, "strike", {{"cost", 1}});
+    ASSERT_TRUE(writer.writeToFile(packPath));
+
+    std::string bytes;
+    {
+        std::ifstream file(packPath, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    // One string whose offset array starts 8 bytes below 2^64, so the string
+    // data position wraps around to 0
+    auto writeLE = [&bytes](size_t offset, uint64_t value, size_t width) {
+        for (size_t i = 0; i < width; ++i) {
+            bytes[offset + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    };
+    writeLE(8, 1, sizeof(uint32_t));
+    writeLE(16, ~uint64_t{0} - 7, sizeof(uint64_t));
+    writeLE(24, 0, sizeof(uint64_t));
+    {
+        std::ofstream file(packPath, std::ios::binary | std::ios::trunc);
+        file << bytes;
+    }
+
+    util::ContentPack pack;
+    EXPECT_FALSE(pack.open(packPath));
+    EXPECT_FALSE(pack.isOpen());
+}
+
+// Test that element counts larger than the record are rejected before decoding
+TEST_F(ContentPackTest, RejectsCorruptCount) {
+    util::ContentPackWriter writer;
+    writer.addRecord(util::ContentKind::CARD, "strike", {{"values", {6, 9}}});
+    ASSERT_TRUE(writer.writeToFile(packPath));
+
+    std::string bytes;
+    {
+        std::ifstream file(packPath, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    // Array tag, a little-endian count of 2 and the tag of the first integer
+    const std::string array("\x07\x02\x00\x00\x00\x03", 6);
+    size_t at = bytes.find(array);
+    ASSERT_NE(at, std::string::npos);
+    bytes.replace(at + 1, 4, "\xff\xff\xff\xff", 4);
+    {
+        std::ofstream file(packPath, std::ios::binary | std::ios::trunc);
+        file << bytes;
+    }
+
+    util::ContentPack pack;
+    ASSERT_TRUE(pack.open(packPath));
+    nlohmann::json decoded;
+    EXPECT_FALSE(pack.decodeRecord(0, decoded));
+}
+
+// Test that packed card data loads the same cards as the JSON files
+TEST_F(ContentPackTest, PackedCardsMatchJson) {
+    std::filesystem::path cardsDir = get_data_path_prefix() + "data/cards";
+    ASSERT_TRUE(std::filesystem::is_directory(cardsDir));
+
+    util::ContentPackWriter writer;
+    std::map<std::string, nlohmann::json> sources;
+    for (const auto& entry : std::filesystem::directory_iterator(cardsDir)) {
+        if (entry.path().extension() != ".json") {
+            continue;
+        }
+        std::ifstream file(entry.path());
+        nlohmann::json document;
+        file >> document;
+        sources[entry.path().stem().string()] = document;
+        writer.addRecord(util::ContentKind::CARD, entry.path().stem().string(), document);
+    }
+    ASSERT_TRUE(writer.writeToFile(packPath));
+
+    util::ContentPack pack;
+    ASSERT_TRUE(pack.open(packPath));
+    ASSERT_EQ(pack.getRecordCount(), sources.size());
+
+    for (size_t i = 0; i < pack.getRecordCount(); ++i) {
+        nlohmann::json decoded;
+        ASSERT_TRUE(pack.decodeRecord(i, decoded));
+        EXPECT_EQ(decoded, sources[pack.getRecordId(i)]);
+
+        Card card;
+        EXPECT_TRUE(card.loadFromJson(decoded));
+        EXPECT_EQ(card.getEffects().size(), sources[pack.getRecordId(i)]["effects"].size());
+    }
+}
+
+} // namespace testing
+} // namespace deckstiny
@@ -6,11 +6,18 @@
 #include "core/player.h"
 #include "core/enemy.h"
 #include "core/combat.h"
+#include "core/combat_state.h"
 #include "core/card.h"
 #include "core/relic.h"
 #include "core/map.h"
+#include "util/content_pack.h"
+#include "util/path_util.h"
 #include "mocks/MockUI.h"
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
 #include <memory>
+#include <algorithm>
 
 namespace deckstiny {
 namespace testing {
@@ -153,6 +160,57 @@ TEST_F(GameTest, CombatInitialization) {
     EXPECT_EQ(game->getCurrentCombat()->getEnemyCount(), 1);
 }
 
+// Test that the undo command takes back the last card played this turn
+TEST_F(GameTest, UndoLastCard) {
+    ASSERT_TRUE(game->initialize(mockUi));
+    game->start();
+    ASSERT_TRUE(game->createPlayer("ironclad", "TestPlayer"));
+    ASSERT_TRUE(game->startCombat({"jaw_worm"}));
+    Combat* combat = game->getCurrentCombat();
+    ASSERT_NE(combat, nullptr);
+    Player* player = game->getPlayer();
+    Enemy* enemy = combat->getEnemy(0);
+
+    std::vector<std::shared_ptr<Card>> hand = player->getHand();
+    int energy = player->getEnergy();
+    int enemyHealth = enemy->getHealth();
+
+    // The opening hand is shuffled, so pick an attack rather than the first card
+    auto attack = std::find_if(hand.begin(), hand.end(), [](const std::shared_ptr<Card>& card) {
+        return card->getType() == CardType::ATTACK;
+    });
+    ASSERT_NE(attack, hand.end());
+    EXPECT_TRUE(game->processInput(std::to_string(attack - hand.begin() + 1) + " 1"));
+    ASSERT_NE(player->getHand(), hand);
+    EXPECT_TRUE(game->processInput("undo"));
+    EXPECT_EQ(player->getHand(), hand);
+    EXPECT_EQ(player->getEnergy(), energy);
+    EXPECT_EQ(enemy->getHealth(), enemyHealth);
+
+    // Nothing is left to take back, and the enemy turn cannot be undone
+    mockUi->clearRecordedCalls();
+    EXPECT_TRUE(game->processInput("u"));
+    EXPECT_TRUE(mockUi->wasMethodCalled("showMessage"));
+    EXPECT_TRUE(game->processInput("end"));
+    int turn = combat->getTurn();
+    EXPECT_TRUE(game->processInput("undo"));
+    EXPECT_EQ(combat->getTurn(), turn);
+
+    // Restoring a snapshot clears the journal, so earlier plays cannot be taken back
+    CombatState state;
+    ASSERT_TRUE(combat->snapshot(state));
+    hand = player->getHand();
+    for (size_t i = 0; i < hand.size() && player->getHand() == hand; ++i) {
+        game->processInput(std::to_string(i + 1) + " 1");
+    }
+    ASSERT_NE(player->getHand(), hand);
+    ASSERT_TRUE(combat->restore(state));
+    EXPECT_EQ(player->getHand(), hand);
+    EXPECT_TRUE(game->processInput("undo"));
+    EXPECT_EQ(player->getHand(), hand);
+    EXPECT_EQ(combat->getTurn(), turn);
+}
+
 // Test input handling
 TEST_F(GameTest, InputHandling) {
     ASSERT_TRUE(game->initialize(mockUi));
@@ -174,6 +232,188 @@ TEST_F(GameTest, GameRunAndQuit) {
     ASSERT_TRUE(game->processInput("2")); // Process quit from main menu
 }
 
+// Test that parallel loading and reloading produce the same registries
+TEST_F(GameTest, ContentLoadingIsDeterministic) {
+    ASSERT_TRUE(game->initialize(mockUi));
+
+    auto otherGame = std::make_unique<Game>();
+    auto otherUi = std::make_shared<MockUI>();
+    ASSERT_TRUE(otherGame->initialize(otherUi));
+
+    ASSERT_EQ(game->getAllCards().size(), otherGame->getAllCards().size());
+    for (const auto& [id, card] : game->getAllCards()) {
+        auto otherCard = otherGame->getCardData(id);
+        ASSERT_NE(otherCard, nullptr) << "Card missing after reload: " << id;
+        EXPECT_EQ(card->getName(), otherCard->getName());
+        EXPECT_EQ(card->getEffects().size(), otherCard->getEffects().size());
+    }
+    EXPECT_EQ(game->getAllEnemies().size(), otherGame->getAllEnemies().size());
+    EXPECT_EQ(game->getAllRelics().size(), otherGame->getAllRelics().size());
+    EXPECT_EQ(game->getAllEvents().size(), otherGame->getAllEvents().size());
+
+    // Reloading a single registry replaces it instead of appending
+    size_t cardCount = game->getAllCards().size();
+    EXPECT_TRUE(game->loadAllCards());
+    EXPECT_EQ(game->getAllCards().size(), cardCount);
+
+    std::vector<std::string> characterIds;
+    for (const auto& [id, data] : game->getAllCharacterData()) {
+        characterIds.push_back(id);
+    }
+    std::vector<std::string> otherCharacterIds;
+    for (const auto& [id, data] : otherGame->getAllCharacterData()) {
+        otherCharacterIds.push_back(id);
+    }
+    EXPECT_EQ(characterIds, otherCharacterIds);
+}
+
+// Test that the encounter index agrees with filtering enemies by tier and floor
+TEST_F(GameTest, EncounterIndexSelection) {
+    ASSERT_TRUE(game->initialize(mockUi));
+    const EncounterIndex& index = game->getEncounterIndex();
+
+    size_t flagged = 0;
+    for (const auto& [id, enemy] : game->getAllEnemies()) {
+        flagged += std::max<size_t>(1, (enemy->isElite() ? 1 : 0) + (enemy->isBoss() ? 1 : 0));
+    }
+    size_t indexed = index.getCount(EncounterTier::NORMAL) + index.getCount(EncounterTier::ELITE) +
+                     index.getCount(EncounterTier::BOSS);
+    EXPECT_EQ(indexed, flagged);
+
+    for (int floor = -1; floor <= 20; ++floor) {
+        std::vector<std::string> normal;
+        std::vector<std::string> elite;
+        for (const auto& [id, enemy] : game->getAllEnemies()) {
+            if (floor < enemy->getMinFloor() || floor > enemy->getMaxFloor()) {
+                continue;
+            }
+            if (enemy->isElite()) {
+                elite.push_back(id);
+            } else if (!enemy->isBoss()) {
+                normal.push_back(id);
+            }
+        }
+        std::sort(normal.begin(), normal.end());
+        std::sort(elite.begin(), elite.end());
+        EXPECT_EQ(index.getCandidates(EncounterTier::NORMAL, floor), normal) << "floor " << floor;
+        EXPECT_EQ(index.getCandidates(EncounterTier::ELITE, floor), elite) << "floor " << floor;
+    }
+
+    // Weighted picks skip zero-weight enemies and honour floor ranges
+    auto common = std::make_shared<Enemy>("common", "Common", 10);
+    common->setFloorRange(0, 5);
+    common->setEncounterWeight(3);
+    auto never = std::make_shared<Enemy>("never", "Never", 10);
+    never->setFloorRange(0, 5);
+    never->setEncounterWeight(0);
+    auto late = std::make_shared<Enemy>("late", "Late", 10);
+    late->setFloorRange(6, 9);
+
+    EncounterIndex custom;
+    custom.build({{"common", common}, {"never", never}, {"late", late}});
+
+    util::Rng rng(42);
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(custom.pick(EncounterTier::NORMAL, 3, rng), "common");
+        EXPECT_EQ(custom.pick(EncounterTier::NORMAL, 7, rng), "late");
+        EXPECT_NE(custom.pickAny(EncounterTier::NORMAL, rng, "late"), "late");
+    }
+    EXPECT_EQ(custom.pick(EncounterTier::NORMAL, 10, rng), "");
+    EXPECT_EQ(custom.pick(EncounterTier::ELITE, 3, rng), "");
+
+    // The floor-less fallback honours weights too: zero-weight enemies never come back
+    int commonPicks = 0;
+    for (int i = 0; i < 400; ++i) {
+        std::string any = custom.pickAny(EncounterTier::NORMAL, rng);
+        EXPECT_NE(any, "never");
+        commonPicks += any == "common" ? 1 : 0;
+        EXPECT_EQ(custom.pickAny(EncounterTier::NORMAL, rng, "late"), "common");
+        EXPECT_EQ(custom.pickAny(EncounterTier::NORMAL, rng, "common"), "late");
+    }
+    EXPECT_GT(commonPicks, 240);
+    EXPECT_LT(commonPicks, 360);
+    EncounterIndex unweighted;
+    unweighted.build({{"never", never}});
+    EXPECT_EQ(unweighted.pickAny(EncounterTier::NORMAL, rng), "");
+
+    // An enemy flagged both elite and boss can be met in elite and boss rooms
+    auto champion = std::make_shared<Enemy>("champion", "Champion", 10);
+    champion->setElite(true);
+    champion->setBoss(true);
+    custom.build({{"common", common}, {"champion", champion}});
+    EXPECT_EQ(custom.getCount(EncounterTier::NORMAL), 1u);
+    EXPECT_EQ(custom.pick(EncounterTier::ELITE, 3, rng), "champion");
+    EXPECT_EQ(custom.pick(EncounterTier::BOSS, 3, rng), "champion");
+}
+
+// Test that seeded rewards and shop offers do not depend on how content was loaded
+TEST_F(GameTest, SeededPicksIgnoreContentSource) {
+    namespace fs = std::filesystem;
+    const fs::path dataDir = fs::absolute(get_data_path_prefix() + "data");
+    const fs::path root = fs::temp_directory_path() / "deckstiny_seeded_picks_test";
+    const fs::path directoriesRoot = root / "directories";
+    const fs::path packRoot = root / "pack";
+    fs::remove_all(root);
+    fs::create_directories(directoriesRoot / "data");
+    fs::create_directories(packRoot / "data");
+
+    // One tree holds only the JSON directories, the other only a content pack
+    const util::ContentKind kinds[] = {util::ContentKind::CHARACTER, util::ContentKind::CARD,
+                                       util::ContentKind::ENEMY, util::ContentKind::RELIC,
+                                       util::ContentKind::EVENT};
+    util::ContentPackWriter writer;
+    for (util::ContentKind kind : kinds) {
+        const char* directory = util::contentKindDirectory(kind);
+        fs::create_directory_symlink(dataDir / directory, directoriesRoot / "data" / directory);
+        for (const auto& entry : fs::directory_iterator(dataDir / directory)) {
+            if (entry.path().extension() == ".json") {
+                std::ifstream file(entry.path());
+                nlohmann::json document;
+                file >> document;
+                writer.addRecord(kind, entry.path().stem().string(), document);
+            }
+        }
+    }
+    ASSERT_TRUE(writer.writeToFile((packRoot / "data" / util::ContentPack::DEFAULT_FILE_NAME).string()));
+
+    const fs::path workingDirectory = fs::current_path();
+    auto seededPicks = [&workingDirectory](const fs::path& contentRoot) {
+        std::vector<std::string> picks;
+        fs::current_path(contentRoot);
+        if (get_data_path_prefix().empty()) {
+            auto ui = std::make_shared<MockUI>();
+            Game seeded;
+            seeded.setSeed(7);
+            if (seeded.initialize(ui)) {
+                seeded.processInput("1");
+                seeded.processInput("1");
+                for (int i = 0; i < 10; ++i) {
+                    picks.push_back(seeded.getRandomCardFromMasterList()->getId());
+                    picks.push_back(seeded.getRandomRelicFromMasterList()->getId());
+                }
+                seeded.setState(GameState::SHOP);
+                for (Card* card : ui->lastCardsForSale_) {
+                    picks.push_back(card->getId());
+                }
+                for (Relic* relic : ui->lastRelicsForSale_) {
+                    picks.push_back(relic->getId());
+                }
+            }
+        }
+        fs::current_path(workingDirectory);
+        return picks;
+    };
+
+    std::vector<std::string> fromDirectories = seededPicks(directoriesRoot);
+    std::vector<std::string> fromPack = seededPicks(packRoot);
+    fs::remove_all(root);
+    if (fromDirectories.empty() && fromPack.empty()) {
+        GTEST_SKIP() << "A user data directory takes precedence over the working directory";
+    }
+    ASSERT_EQ(fromDirectories.size(), 24u);
+    EXPECT_EQ(fromDirectories, fromPack);
+}
+
 
 } // namespace testing
 } // namespace deckstiny 
\ No newline at end of file
@@ -0,0 +1,122 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include <gtest/gtest.h>
+#include "util/logger.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace deckstiny {
+namespace testing {
+
+class LoggerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        logger = &util::Logger::getInstance();
+        logger->flush();
+        // The writer keeps the file open, so tests count lines added since SetUp
+        path = std::filesystem::path(logger->getLogDirectory()) / "logger_test.log";
+    }
+
+    void TearDown() override {
+        logger->setOverflowPolicy(util::OverflowPolicy::Drop);
+    }
+
+    // Count lines of the test log containing a marker
+    size_t countLines(const std::string& marker) const {
+        std::ifstream file(path);
+        size_t count = 0;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.find(marker) != std::string::npos) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    util::Logger* logger = nullptr;
+    std::filesystem::path path;
+};
+
+// Test that flush() waits until earlier messages are in the file
+TEST_F(LoggerTest, FlushWritesQueuedMessages) {
+    size_t before = countLines("[INFO] flush marker");
+    logger->log(util::LogLevel::Info, "logger_test", "flush marker");
+    logger->flush();
+    EXPECT_EQ(countLines("[INFO] flush marker"), before + 1);
+}
+
+// Test that blocking producers on several threads lose no message
+TEST_F(LoggerTest, ConcurrentProducersBlock) {
+    logger->setOverflowPolicy(util::OverflowPolicy::Block);
+    size_t before = countLines("block marker");
+    const size_t threadCount = 4;
+    const size_t perThread = util::Logger::QUEUE_CAPACITY;
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([this, t, perThread]() {
+            for (size_t i = 0; i < perThread; ++i) {
+                logger->log(util::LogLevel::Debug, "logger_test", "block marker " + std::to_string(t));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    logger->flush();
+    EXPECT_EQ(countLines("block marker"), before + threadCount * perThread);
+}
+
+// Test that dropped messages are counted rather than lost silently
+TEST_F(LoggerTest, DropPolicyAccountsForEveryMessage) {
+    const size_t total = 4 * util::Logger::QUEUE_CAPACITY;
+    size_t before = countLines("drop marker");
+    size_t droppedBefore = logger->getDroppedCount();
+    for (size_t i = 0; i < total; ++i) {
+        logger->log(util::LogLevel::Debug, "logger_test", "drop marker");
+    }
+    logger->flush();
+    size_t dropped = logger->getDroppedCount() - droppedBefore;
+    EXPECT_EQ(countLines("drop marker") - before + dropped, total);
+}
+
+// Test the format-string helper behind LOG_*F
+TEST_F(LoggerTest, FormatLog) {
+    EXPECT_EQ(util::formatLog("{} cost {}", std::string("Bash"), 2), "Bash cost 2");
+    EXPECT_EQ(util::formatLog("{} {} {} {}", "text", true, size_t(7), -3), "text true 7 -3");
+    EXPECT_EQ(util::formatLog("{} left, {}", 1.5), "1.5 left, {}");
+    EXPECT_EQ(util::formatLog("no placeholders", 1), "no placeholders");
+    EXPECT_EQ(util::formatLog("{}", util::LogLevel::Warning), "2");
+
+    // Pointers print their address rather than converting to bool
+    int* pointer = reinterpret_cast<int*>(uintptr_t(0x1234));
+    EXPECT_EQ(util::formatLog("at {}", pointer), "at 0x1234");
+    EXPECT_EQ(util::formatLog("{}", nullptr), "(null)");
+    EXPECT_EQ(util::formatLog("{}", static_cast<const char*>(nullptr)), "(null)");
+}
+
+// Test that filtered statements do not evaluate their arguments
+TEST_F(LoggerTest, FilteredStatementsAreLazy) {
+    int evaluations = 0;
+    auto message = [&evaluations]() {
+        ++evaluations;
+        return std::string("lazy marker");
+    };
+
+    logger->setEnabled(false);
+    LOG_ERROR("logger_test", message());
+    LOG_ERRORF("logger_test", "{}", message());
+    logger->setEnabled(true);
+    EXPECT_EQ(evaluations, 0);
+
+    LOG_ERROR("logger_test", message());
+    EXPECT_EQ(evaluations, 1);
+}
+
+} // namespace testing
+} // namespace deckstiny
@@ -225,5 +225,26 @@ TEST_F(MapTest, RoomTypeString) {
     EXPECT_EQ(map->getRoomTypeString(RoomType::TREASURE), "TREASURE");
 }
 
+// Test that a seed always generates the same map
+TEST_F(MapTest, SeededGeneration) {
+    GameMap first;
+    GameMap second;
+    ASSERT_TRUE(first.generate(1, 12345));
+    ASSERT_TRUE(second.generate(1, 12345));
+    EXPECT_EQ(first.getSeed(), 12345u);
+
+    const auto& firstRooms = first.getAllRooms();
+    const auto& secondRooms = second.getAllRooms();
+    ASSERT_EQ(firstRooms.size(), secondRooms.size());
+    for (const auto& [id, room] : firstRooms) {
+        auto it = secondRooms.find(id);
+        ASSERT_NE(it, secondRooms.end());
+        EXPECT_EQ(room.type, it->second.type);
+        EXPECT_EQ(room.x, it->second.x);
+        EXPECT_EQ(room.y, it->second.y);
+        EXPECT_EQ(room.nextRooms, it->second.nextRooms);
+    }
+}
+
 } // namespace testing
 } // namespace deckstiny 
\ No newline at end of file
@@ -0,0 +1,113 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include <gtest/gtest.h>
+#include "util/metrics.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace deckstiny {
+namespace testing {
+
+// Test that counts from several threads add up and that lookups return the same metric
+TEST(MetricsTest, CounterSumsThreads) {
+    util::MetricsRegistry& registry = util::MetricsRegistry::getInstance();
+    util::Counter& counter = registry.counter("metrics_test_events_total", "Test events");
+    EXPECT_EQ(&registry.counter("metrics_test_events_total", "Test events"), &counter);
+    EXPECT_NE(&registry.counter("metrics_test_events_total", "Test events", {{"kind", "other"}}), &counter);
+
+    uint64_t before = counter.value();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&counter]() {
+            for (int i = 0; i < 10000; ++i) {
+                counter.add();
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(counter.value(), before + 40000);
+}
+
+// Test that observations land in the right buckets and export as cumulative Prometheus buckets
+TEST(MetricsTest, HistogramBucketsAndPrometheusText) {
+    util::MetricsRegistry& registry = util::MetricsRegistry::getInstance();
+    util::Histogram& histogram = registry.histogram("metrics_test_latency_seconds", "Test latency", {{"kind", "a\"b"}});
+    histogram.observe(500);             // <= 1 us
+    histogram.observe(1000);            // <= 1 us, bounds are inclusive
+    histogram.observe(50000);           // <= 64 us
+    histogram.observe(10000000000ULL);  // +Inf
+
+    util::HistogramSnapshot snapshot = histogram.snapshot();
+    ASSERT_EQ(snapshot.buckets.size(), util::Histogram::BUCKET_COUNT);
+    EXPECT_EQ(snapshot.count, 4u);
+    EXPECT_EQ(snapshot.buckets[0], 2u);
+    EXPECT_EQ(snapshot.buckets[3], 1u);
+    EXPECT_EQ(snapshot.buckets.back(), 1u);
+    EXPECT_EQ(snapshot.sumNanoseconds, 10000051500ULL);
+
+    std::string text = registry.snapshot(util::MetricsFormat::Prometheus);
+    EXPECT_NE(text.find("# TYPE metrics_test_latency_seconds histogram\n"), std::string::npos);
+    EXPECT_NE(text.find("metrics_test_latency_seconds_bucket{kind=\"a\\\"b\",le=\"1e-06\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("metrics_test_latency_seconds_bucket{kind=\"a\\\"b\",le=\"6.4e-05\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("metrics_test_latency_seconds_bucket{kind=\"a\\\"b\",le=\"+Inf\"} 4\n"), std::string::npos);
+    EXPECT_NE(text.find("metrics_test_latency_seconds_count{kind=\"a\\\"b\"} 4\n"), std::string::npos);
+
+    // A name cannot be reused for another type
+    util::Gauge& clash = registry.gauge("metrics_test_latency_seconds", "Clash");
+    clash.set(7);
+    EXPECT_EQ(registry.snapshot(util::MetricsFormat::Prometheus).find("metrics_test_latency_seconds 7"),
+              std::string::npos);
+}
+
+// Test that the exporter writes a JSON snapshot that parses back
+TEST(MetricsTest, ExporterWritesJson) {
+    util::MetricsRegistry& registry = util::MetricsRegistry::getInstance();
+    registry.gauge("metrics_test_depth", "Test gauge").set(-3);
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "deckstiny_metrics_test.json";
+    {
+        util::MetricsExporter exporter;
+        ASSERT_TRUE(exporter.start(path.string(), std::chrono::milliseconds(10)));
+        registry.gauge("metrics_test_depth", "Test gauge").set(5);
+    }
+
+    std::ifstream file(path);
+    nlohmann::json document = nlohmann::json::parse(file, nullptr, false);
+    ASSERT_FALSE(document.is_discarded());
+    ASSERT_TRUE(document.contains("metrics"));
+
+    bool found = false;
+    for (const auto& metric : document["metrics"]) {
+        if (metric["name"] == "metrics_test_depth") {
+            found = true;
+            EXPECT_EQ(metric["type"], "gauge");
+            // stop() writes a last snapshot
+            EXPECT_EQ(metric["value"], 5);
+        }
+    }
+    EXPECT_TRUE(found);
+    std::filesystem::remove(path);
+}
+
+// Test that command line intervals are read as seconds and garbage is rejected
+TEST(MetricsTest, ParsesInterval) {
+    std::chrono::milliseconds interval(0);
+    EXPECT_TRUE(util::MetricsExporter::parseInterval("2.5", interval));
+    EXPECT_EQ(interval.count(), 2500);
+    for (const char* bad : {"", "abc", "5s", "0", "-1", "nan", "inf", "1e7"}) {
+        EXPECT_FALSE(util::MetricsExporter::parseInterval(bad, interval)) << bad;
+    }
+    EXPECT_EQ(interval.count(), 2500);
+}
+
+} // namespace testing
+} // namespace deckstiny
@@ -205,6 +205,88 @@ TEST_F(RelicEffectTest, BurningBloodEffect) {
     EXPECT_EQ(player->getHealth(), std::min(maxHp, healthAfterDamage + 6));
 }
 
+// Test that relics only subscribe to the triggers their data names
+TEST_F(RelicEffectTest, TriggerBusSubscriptions) {
+    game = std::make_shared<Game>();
+    mockUi = std::make_shared<MockUI>();
+    ASSERT_TRUE(game->initialize(mockUi));
+
+    auto loadedBurningBlood = game->loadRelic("burning_blood");
+    ASSERT_NE(loadedBurningBlood, nullptr);
+    EXPECT_TRUE(loadedBurningBlood->hasTrigger(Trigger::COMBAT_END));
+    EXPECT_FALSE(loadedBurningBlood->hasTrigger(Trigger::TURN_START));
+
+    player->addRelic(loadedBurningBlood);
+    EXPECT_TRUE(player->getTriggers().hasHandlers(Trigger::COMBAT_END));
+    EXPECT_FALSE(player->getTriggers().hasHandlers(Trigger::COMBAT_START));
+    EXPECT_FALSE(player->getTriggers().hasHandlers(Trigger::TURN_START));
+    EXPECT_FALSE(player->getTriggers().hasHandlers(Trigger::ON_DAMAGE_DEALT));
+
+    // The COMBAT_END subscription heals through the bus, after a win only
+    player->takeDamage(10);
+    int healthAfterDamage = player->getHealth();
+    player->endCombat(false);
+    EXPECT_EQ(player->getHealth(), healthAfterDamage);
+    player->endCombat(true);
+    EXPECT_EQ(player->getHealth(), std::min(player->getMaxHealth(), healthAfterDamage + 6));
+
+    // Damage triggers may change the amount
+    struct HalvingRelic : Relic {
+        HalvingRelic() : Relic("halving", "Halving", "", RelicRarity::EVENT) {
+            addTrigger(Trigger::ON_DAMAGE_TAKEN);
+        }
+        int onTakeDamage(Player*, int damage, Combat*) override { return damage / 2; }
+    };
+    player->addRelic(std::make_shared<HalvingRelic>());
+    TriggerContext context;
+    context.amount = 10;
+    player->fireTrigger(Trigger::ON_DAMAGE_TAKEN, context);
+    EXPECT_EQ(context.amount, 5);
+}
+
+// Test that relic effects are compiled from JSON and run by their trigger
+TEST_F(RelicEffectTest, CompiledEffects) {
+    nlohmann::json json = {
+        {"id", "test_data_relic"},
+        {"name", "Test Data Relic"},
+        {"effects", {
+            {{"trigger", "TURN_START"}, {"type", "block"}, {"value", 4}, {"target", "player"}},
+            {{"trigger", "COMBAT_START"}, {"type", "status_effect"}, {"effect", "strength"}, {"value", 2}, {"target", "player"}},
+            {{"trigger", "COMBAT_START"}, {"type", "status_effect"}, {"effect", "weak"}, {"value", 1}, {"target", "all_enemies"}},
+            {{"trigger", "NEVER"}, {"type", "heal"}, {"value", 99}}
+        }}
+    };
+    Relic dataRelic;
+    ASSERT_TRUE(dataRelic.loadFromJson(json));
+    ASSERT_EQ(dataRelic.getEffects().size(), 3u);
+    EXPECT_TRUE(dataRelic.hasTrigger(Trigger::TURN_START));
+    EXPECT_TRUE(dataRelic.hasTrigger(Trigger::COMBAT_START));
+    EXPECT_FALSE(dataRelic.hasTrigger(Trigger::COMBAT_END));
+
+    auto combat = std::make_shared<Combat>(player.get());
+    combat->addEnemy(enemy);
+    player->addRelic(dataRelic.cloneRelic());
+    player->setCurrentCombat(combat.get());
+
+    player->beginCombat();
+    EXPECT_EQ(player->getStatusEffect(StatusEffect::STRENGTH), 2);
+    EXPECT_EQ(enemy->getStatusEffect(StatusEffect::WEAK), 1);
+    EXPECT_EQ(player->getBlock(), 0);
+
+    player->startTurn();
+    EXPECT_EQ(player->getBlock(), 4);
+
+    // COMBAT_END effects only run after a win
+    player->takeDamage(20);
+    int health = player->getHealth();
+    burningBlood->loadFromJson({{"id", "burning_blood"}, {"name", "Burning Blood"},
+                                {"effects", {{{"trigger", "COMBAT_END"}, {"type", "heal"}, {"value", 6}}}}});
+    burningBlood->onCombatEnd(player.get(), false, combat.get());
+    EXPECT_EQ(player->getHealth(), health);
+    burningBlood->onCombatEnd(player.get(), true, combat.get());
+    EXPECT_EQ(player->getHealth(), health + 6);
+}
+
 // Test pen nib counter
 TEST_F(RelicEffectTest, PenNibCounter) {
     // Setup initial counter
@@ -0,0 +1,182 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include <gtest/gtest.h>
+#include "sim/batch_runner.h"
+#include "sim/lane_batch_runner.h"
+#include "sim/sim_driver.h"
+#include "sim/bot_policy.h"
+#include "sim/mcts_policy.h"
+#include "core/game.h"
+#include "util/rng.h"
+#include <memory>
+
+namespace deckstiny {
+namespace testing {
+
+class SimTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        driver = std::make_unique<sim::SimDriver>();
+        ASSERT_TRUE(driver->initialize());
+    }
+
+    void TearDown() override {
+        driver.reset();
+    }
+
+    std::unique_ptr<sim::SimDriver> driver;
+};
+
+// Test that the headless driver plays complete runs to an outcome
+TEST_F(SimTest, GreedyRunsFinish) {
+    sim::GreedyPolicy policy(7, "ironclad");
+
+    for (int run = 0; run < 3; ++run) {
+        sim::RunResult result = driver->runOnce(policy, run);
+        EXPECT_FALSE(result.stalled) << "run " << run;
+        EXPECT_EQ(result.characterId, "ironclad");
+        EXPECT_GT(result.steps, 2);
+        EXPECT_GE(result.act, 1);
+        EXPECT_TRUE(result.victory || result.health == 0) << "run " << run;
+        EXPECT_TRUE(driver->getGame()->isRunning());
+    }
+}
+
+// Test that a run replays exactly from its seed and index
+TEST_F(SimTest, SeededRunsReplay) {
+    sim::GreedyPolicy policy(11, "ironclad");
+
+    sim::RunResult first = driver->runOnce(policy, 4);
+    sim::RunResult other = driver->runOnce(policy, 5);
+    sim::RunResult replay = driver->runOnce(policy, 4);
+
+    EXPECT_NE(first.seed, other.seed);
+    EXPECT_EQ(first.seed, replay.seed);
+    EXPECT_EQ(driver->getGame()->getSeed(), replay.seed);
+    EXPECT_EQ(first.victory, replay.victory);
+    EXPECT_EQ(first.act, replay.act);
+    EXPECT_EQ(first.floor, replay.floor);
+    EXPECT_EQ(first.combatsWon, replay.combatsWon);
+    EXPECT_EQ(first.health, replay.health);
+    EXPECT_EQ(first.gold, replay.gold);
+    EXPECT_EQ(first.deckSize, replay.deckSize);
+    EXPECT_EQ(first.steps, replay.steps);
+}
+
+// Test that batch totals do not depend on how fights are spread over threads
+TEST_F(SimTest, BatchRunnerThreadIndependent) {
+    sim::FightSpec spec;
+    spec.characterId = "ironclad";
+    spec.enemies = {"jaw_worm"};
+
+    sim::BatchRunner single(*driver->getGame(), 1);
+    sim::BatchRunner parallel(*driver->getGame(), 4);
+    ASSERT_TRUE(single.validate(spec));
+
+    sim::FightStats first = single.run(spec, 300, 21);
+    sim::FightStats second = parallel.run(spec, 300, 21);
+
+    EXPECT_EQ(first.getFights(), 300u);
+    EXPECT_EQ(first.getWins(), second.getWins());
+    EXPECT_EQ(first.getTurnsToKill(), second.getTurnsToKill());
+    EXPECT_EQ(first.getHpLost(), second.getHpLost());
+    EXPECT_GT(first.getMeanTurnsToKill(), 0.0);
+
+    sim::FightStats merged;
+    merged.merge(first);
+    merged.merge(second);
+    EXPECT_EQ(merged.getFights(), 600u);
+    EXPECT_DOUBLE_EQ(merged.getWinRate(), first.getWinRate());
+
+    spec.enemies = {"no_such_enemy"};
+    EXPECT_FALSE(single.validate(spec));
+}
+
+// Test that the tree search wins fights and replays them from its seed on several threads
+TEST_F(SimTest, MctsPolicyFights) {
+    sim::FightSpec spec;
+    spec.characterId = "ironclad";
+    spec.enemies = {"jaw_worm"};
+
+    sim::MctsOptions options;
+    options.iterations = 40;
+    options.threads = 2;
+    sim::BatchRunner runner(*driver->getGame(), 1);
+    runner.setPolicyFactory([&](uint64_t seed) {
+        return std::make_unique<sim::MctsPolicy>(options, seed, spec.characterId);
+    });
+
+    sim::FightStats first = runner.run(spec, 2, 5);
+    ASSERT_EQ(runner.getPolicies().size(), 1u);
+    auto* policy = dynamic_cast<sim::MctsPolicy*>(runner.getPolicies().front().get());
+    ASSERT_NE(policy, nullptr);
+    EXPECT_EQ(policy->getName(), "mcts");
+    EXPECT_EQ(policy->getOptions().threads, 2u);
+    EXPECT_GT(policy->getTotalStats().decisions, 0u);
+    EXPECT_GT(policy->getTotalStats().playouts, 0u);
+    EXPECT_EQ(first.getWins(), 2u);
+
+    sim::FightStats second = runner.run(spec, 2, 5);
+    EXPECT_EQ(first.getTurnsToKill(), second.getTurnsToKill());
+    EXPECT_EQ(first.getHpLost(), second.getHpLost());
+}
+
+// Test that the lane engine plays every fight exactly like the scalar combat
+TEST_F(SimTest, LaneBatchMatchesScalarFights) {
+    std::vector<sim::FightSpec> specs(4);
+    specs[0].characterId = "ironclad";
+    specs[0].enemies = {"jaw_worm"};
+    specs[1].characterId = "silent";
+    specs[1].enemies = {"snake_plant"};
+    // Flex fails its program, neutralize is dropped by its class restriction
+    specs[2].characterId = "ironclad";
+    specs[2].deck = {"bash", "bash", "heavy_strike", "iron_wave_ic", "flex_ic", "strike", "strike", "neutralize"};
+    specs[2].enemies = {"gremlin_nob", "cultist", "acid_slime"};
+    specs[3].characterId = "watcher";
+    specs[3].enemies = {"mushroom_warrior", "louse"};
+    specs[3].maxTurns = 4;
+
+    sim::BatchRunner scalar(*driver->getGame(), 1);
+    sim::LaneBatchRunner lanes(*driver->getGame(), 1, 48);
+    const util::Rng root(13);
+    std::vector<uint64_t> seeds;
+    for (size_t i = 0; i < 100; ++i) {
+        seeds.push_back(root.split(i)());
+    }
+
+    for (size_t s = 0; s < specs.size(); ++s) {
+        ASSERT_TRUE(lanes.validate(specs[s])) << "spec " << s;
+        std::vector<sim::FightOutcome> outcomes = lanes.runFights(specs[s], seeds);
+        ASSERT_EQ(outcomes.size(), seeds.size());
+
+        sim::GreedyPolicy policy(13, specs[s].characterId);
+        int wins = 0;
+        for (size_t i = 0; i < seeds.size(); ++i) {
+            sim::FightOutcome expected = scalar.runFight(specs[s], policy, seeds[i]);
+            EXPECT_EQ(outcomes[i].victory, expected.victory) << "spec " << s << ", fight " << i;
+            EXPECT_EQ(outcomes[i].turns, expected.turns) << "spec " << s << ", fight " << i;
+            EXPECT_EQ(outcomes[i].hpLost, expected.hpLost) << "spec " << s << ", fight " << i;
+            wins += expected.victory ? 1 : 0;
+        }
+        if (s < 2) {
+            EXPECT_GT(wins, 0) << "spec " << s;
+        }
+    }
+
+    sim::FightStats expected = scalar.run(specs[0], 100, 13);
+    sim::FightStats stats = sim::LaneBatchRunner(*driver->getGame(), 2, 16).run(specs[0], 100, 13);
+    EXPECT_EQ(stats.getFights(), 100u);
+    EXPECT_EQ(stats.getWins(), expected.getWins());
+    EXPECT_EQ(stats.getTurnsToKill(), expected.getTurnsToKill());
+    EXPECT_EQ(stats.getHpLost(), expected.getHpLost());
+
+    sim::FightSpec summoner;
+    summoner.characterId = "ironclad";
+    summoner.enemies = {"collector"};
+    EXPECT_TRUE(scalar.validate(summoner));
+    EXPECT_FALSE(lanes.validate(summoner));
+}
+
+} // namespace testing
+} // namespace deckstiny
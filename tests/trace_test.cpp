@@ -0,0 +1,186 @@
+// Anisimov Vasiliy st129629@student.spbu.ru
+// Laboratory Work 2
+
+#include <gtest/gtest.h>
+#include "core/player.h"
+#include "util/trace.h"
+#include "util/trace_spans.h"
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace deckstiny {
+namespace testing {
+
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = std::filesystem::temp_directory_path() / "deckstiny_trace_test.bin";
+    }
+
+    void TearDown() override {
+        util::Trace::close();
+        std::filesystem::remove(path);
+    }
+
+    // Read every event record of the trace
+    std::vector<util::TraceRecord> readAll(util::TraceReader& reader) const {
+        std::vector<util::TraceRecord> records;
+        EXPECT_TRUE(reader.open(path.string())) << reader.getError();
+        util::TraceRecord record;
+        while (reader.next(record)) {
+            records.push_back(record);
+        }
+        EXPECT_TRUE(reader.getError().empty()) << reader.getError();
+        return records;
+    }
+
+    std::filesystem::path path;
+};
+
+// Test that character events are recorded with their strings and read back
+TEST_F(TraceTest, RecordsCharacterEvents) {
+    Player player("ironclad", "Ironclad", 50, 3, 5);
+
+    // Nothing is recorded while no trace is open
+    player.takeDamage(1);
+
+    ASSERT_TRUE(util::Trace::open(path.string()));
+    EXPECT_TRUE(util::Trace::isEnabled());
+    player.addBlock(3);
+    player.takeDamage(8);
+    player.addStatusEffect("vulnerable", 2);
+    {
+        // Suspended threads, such as tree search playouts, record nothing
+        util::TraceSuspension suspension;
+        EXPECT_FALSE(util::Trace::isEnabled());
+        player.takeDamage(2);
+    }
+    EXPECT_TRUE(util::Trace::isEnabled());
+    util::Trace::close();
+    EXPECT_FALSE(util::Trace::isEnabled());
+    player.takeDamage(1);
+
+    util::TraceReader reader;
+    std::vector<util::TraceRecord> records = readAll(reader);
+    ASSERT_EQ(records.size(), 2u);
+
+    EXPECT_EQ(records[0].type, static_cast<uint16_t>(util::TraceEventType::DAMAGE_DEALT));
+    EXPECT_EQ(reader.symbol(records[0].subject), "ironclad");
+    EXPECT_EQ(records[0].a, 8);
+    EXPECT_EQ(records[0].b, 5);
+
+    EXPECT_EQ(records[1].type, static_cast<uint16_t>(util::TraceEventType::STATUS_APPLIED));
+    EXPECT_EQ(reader.symbol(records[1].subject), "ironclad");
+    EXPECT_EQ(reader.symbol(records[1].object), "vulnerable");
+    EXPECT_EQ(records[1].a, 2);
+    EXPECT_EQ(records[1].b, 2);
+    EXPECT_LE(records[0].time, records[1].time);
+}
+
+// Test that buffers of several threads, including full ones, all reach the file
+TEST_F(TraceTest, WritesEveryThreadBuffer) {
+    constexpr int THREADS = 3;
+    const int perThread = static_cast<int>(util::Trace::BUFFER_RECORDS) + 100;
+
+    ASSERT_TRUE(util::Trace::open(path.string()));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([t, perThread]() {
+            util::Symbol thread = util::Symbol::intern("trace_thread_" + std::to_string(t));
+            for (int i = 0; i < perThread; ++i) {
+                TRACE_RECORD(CARD_PLAYED, thread, util::Symbol(), t, i);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    util::Trace::close();
+
+    util::TraceReader reader;
+    std::vector<util::TraceRecord> records = readAll(reader);
+    ASSERT_EQ(records.size(), static_cast<size_t>(THREADS * perThread));
+
+    std::vector<int> next(THREADS, 0);
+    for (const util::TraceRecord& record : records) {
+        ASSERT_GE(record.a, 0);
+        ASSERT_LT(record.a, THREADS);
+        EXPECT_EQ(reader.symbol(record.subject), "trace_thread_" + std::to_string(record.a));
+        // Each thread's records keep their order
+        EXPECT_EQ(record.b, next[record.a]++);
+    }
+}
+
+// Test that a corrupt symbol id is a decode error instead of a huge allocation
+TEST_F(TraceTest, RejectsOutOfRangeSymbolId) {
+    {
+        std::ofstream out(path, std::ios::binary);
+        util::TraceFileHeader header;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        util::TraceRecord record;
+        record.type = static_cast<uint16_t>(util::TraceEventType::SYMBOL);
+        record.subject = 0xFFFFFFF0u;
+        out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+
+    util::TraceReader reader;
+    ASSERT_TRUE(reader.open(path.string())) << reader.getError();
+    util::TraceRecord record;
+    EXPECT_FALSE(reader.next(record));
+    EXPECT_NE(reader.getError().find("out of range"), std::string::npos);
+}
+
+// Test that spans of live and exited threads are written as Chrome trace events
+TEST(SpanTraceTest, WritesChromeTraceJson) {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "deckstiny_spans_test.json";
+
+    // Spans outside a capture are not recorded
+    { util::ScopedSpan ignored("test", "before"); }
+
+    util::SpanTrace::start();
+    {
+        util::ScopedSpan outer("test", "outer");
+        util::ScopedSpan inner("test", "inner \"quoted\"");
+    }
+    std::thread worker([]() { util::ScopedSpan span("test", "worker"); });
+    worker.join();
+    // TRACE_SCOPE compiles in either build mode
+    { TRACE_SCOPE("test", "macro"); }
+    ASSERT_TRUE(util::SpanTrace::stop(path.string()));
+    EXPECT_FALSE(util::SpanTrace::isEnabled());
+
+    std::ifstream file(path);
+    nlohmann::json document = nlohmann::json::parse(file, nullptr, false);
+    ASSERT_FALSE(document.is_discarded());
+
+    std::map<std::string, nlohmann::json> spans;
+    for (const auto& event : document["traceEvents"]) {
+        if (event["ph"] == "X") {
+            spans[event["name"].get<std::string>()] = event;
+        }
+    }
+    EXPECT_EQ(spans.count("before"), 0u);
+    ASSERT_EQ(spans.count("outer"), 1u);
+    ASSERT_EQ(spans.count("inner \"quoted\""), 1u);
+    ASSERT_EQ(spans.count("worker"), 1u);
+    EXPECT_EQ(spans.count("macro"), DECKSTINY_TRACE_SPANS ? 1u : 0u);
+
+    const nlohmann::json& outer = spans["outer"];
+    const nlohmann::json& inner = spans["inner \"quoted\""];
+    EXPECT_EQ(outer["cat"], "test");
+    EXPECT_EQ(outer["tid"], inner["tid"]);
+    EXPECT_NE(outer["tid"], spans["worker"]["tid"]);
+    EXPECT_LE(outer["ts"].get<double>(), inner["ts"].get<double>());
+    // Times are rounded to nanoseconds in the file
+    EXPECT_GE(outer["ts"].get<double>() + outer["dur"].get<double>() + 0.002,
+              inner["ts"].get<double>() + inner["dur"].get<double>());
+    std::filesystem::remove(path);
+}
+
+} // namespace testing
+} // namespace deckstiny